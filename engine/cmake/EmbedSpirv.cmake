@@ -0,0 +1,31 @@
+# Turns a SPIR-V binary into a header holding it as a constexpr word array.
+#
+# cmake -DINPUT=<file.spv> -DOUTPUT=<file.spv.hpp> -DSYMBOL=<identifier> -P EmbedSpirv.cmake
+
+file(READ "${INPUT}" SPIRV_HEX HEX)
+
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+if(SPIRV_HEX_LENGTH EQUAL 0 OR NOT SPIRV_REMAINDER EQUAL 0)
+    message(FATAL_ERROR "${INPUT} is not a SPIR-V module")
+endif()
+
+# SPIR-V words are little endian, reverse the bytes of every group of four.
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " SPIRV_WORDS "${SPIRV_HEX}")
+string(REGEX REPLACE "((0x........u, ){8})" "\\1\n        " SPIRV_WORDS "${SPIRV_WORDS}")
+
+file(WRITE "${OUTPUT}"
+"// Generated from ${INPUT}, do not edit.
+#ifndef __ENGINE_SHADER_${SYMBOL}_HPP__
+#define __ENGINE_SHADER_${SYMBOL}_HPP__
+
+#include <cstdint>
+
+namespace Engine::Shaders {
+    inline constexpr uint32_t ${SYMBOL}[] = {
+        ${SPIRV_WORDS}
+    };
+}
+
+#endif
+")
@@ -0,0 +1,173 @@
+#ifndef __ENGINE_BYTE_STREAM_HPP__
+#define __ENGINE_BYTE_STREAM_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace Engine {
+    /**
+     * Little-endian serializer into a caller-owned buffer of fixed capacity.
+     *
+     * Writing past the end sets overflowed() and drops the bytes instead of failing at every
+     * call, the caller checks once after serializing a whole message. Variable-length
+     * integers are LEB128, signed ones zigzag-encoded first so small magnitudes stay short.
+     */
+    class ByteWriter {
+    public:
+        ByteWriter(uint8_t *p_data, size_t p_capacity) :
+                m_data(p_data), m_capacity(p_capacity) {}
+
+        void writeU8(uint8_t p_value) { writeRaw(&p_value, 1); }
+
+        void writeU16(uint16_t p_value) {
+            const uint8_t bytes[2] = { static_cast<uint8_t>(p_value), static_cast<uint8_t>(p_value >> 8) };
+            writeRaw(bytes, sizeof(bytes));
+        }
+
+        void writeU32(uint32_t p_value) {
+            writeU16(static_cast<uint16_t>(p_value));
+            writeU16(static_cast<uint16_t>(p_value >> 16));
+        }
+
+        void writeU64(uint64_t p_value) {
+            writeU32(static_cast<uint32_t>(p_value));
+            writeU32(static_cast<uint32_t>(p_value >> 32));
+        }
+
+        void writeVarU64(uint64_t p_value) {
+            uint8_t bytes[10];
+            size_t count = 0;
+            do {
+                const uint8_t low = p_value & 0x7f;
+                p_value >>= 7;
+                bytes[count++] = low | (p_value ? 0x80 : 0);
+            } while (p_value);
+            writeRaw(bytes, count);
+        }
+
+        void writeVarU32(uint32_t p_value) { writeVarU64(p_value); }
+        void writeVarS32(int32_t p_value) { writeVarU64((static_cast<uint32_t>(p_value) << 1) ^ static_cast<uint32_t>(p_value >> 31)); }
+
+        void writeBytes(std::span<const uint8_t> p_bytes) { writeRaw(p_bytes.data(), p_bytes.size()); }
+
+        uint8_t *data() const { return m_data; }
+        size_t size() const { return m_size; }
+        size_t remaining() const { return m_capacity - m_size; }
+        bool overflowed() const { return m_overflowed; }
+
+        /** Drops everything written after `p_size`, e.g. a record that did not fit a budget. */
+        void truncate(size_t p_size) {
+            if (p_size < m_size) {
+                m_size = p_size;
+            }
+            m_overflowed = false;
+        }
+
+    private:
+        uint8_t *m_data;
+        size_t m_capacity;
+        size_t m_size = 0;
+        bool m_overflowed = false;
+
+        void writeRaw(const void *p_bytes, size_t p_count) {
+            if (p_count > m_capacity - m_size) {
+                m_overflowed = true;
+                return;
+            }
+            if (p_count) {
+                std::memcpy(m_data + m_size, p_bytes, p_count);
+            }
+            m_size += p_count;
+        }
+    };
+
+    /** Counterpart of ByteWriter. Reading past the end returns zeroes and sets failed(). */
+    class ByteReader {
+    public:
+        explicit ByteReader(std::span<const uint8_t> p_data) :
+                m_data(p_data) {}
+
+        uint8_t readU8() {
+            uint8_t value = 0;
+            readRaw(&value, 1);
+            return value;
+        }
+
+        uint16_t readU16() {
+            uint8_t bytes[2] = {};
+            readRaw(bytes, sizeof(bytes));
+            return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+        }
+
+        uint32_t readU32() {
+            const uint32_t low = readU16();
+            return low | static_cast<uint32_t>(readU16()) << 16;
+        }
+
+        uint64_t readU64() {
+            const uint64_t low = readU32();
+            return low | static_cast<uint64_t>(readU32()) << 32;
+        }
+
+        uint64_t readVarU64() {
+            uint64_t value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = readU8();
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            m_failed = true;
+            return 0;
+        }
+
+        uint32_t readVarU32() {
+            const uint64_t value = readVarU64();
+            if (value > UINT32_MAX) {
+                m_failed = true;
+                return 0;
+            }
+            return static_cast<uint32_t>(value);
+        }
+
+        int32_t readVarS32() {
+            const uint32_t value = readVarU32();
+            return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+        }
+
+        /** View into the source buffer, empty on underflow. */
+        std::span<const uint8_t> readBytes(size_t p_count) {
+            if (p_count > remaining()) {
+                m_failed = true;
+                m_offset = m_data.size();
+                return {};
+            }
+            const std::span<const uint8_t> bytes = m_data.subspan(m_offset, p_count);
+            m_offset += p_count;
+            return bytes;
+        }
+
+        size_t remaining() const { return m_data.size() - m_offset; }
+        bool failed() const { return m_failed; }
+
+    private:
+        std::span<const uint8_t> m_data;
+        size_t m_offset = 0;
+        bool m_failed = false;
+
+        void readRaw(void *p_bytes, size_t p_count) {
+            if (p_count > remaining()) {
+                m_failed = true;
+                m_offset = m_data.size();
+                return;
+            }
+            std::memcpy(p_bytes, m_data.data() + m_offset, p_count);
+            m_offset += p_count;
+        }
+    };
+}
+
+#endif
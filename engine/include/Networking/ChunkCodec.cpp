@@ -0,0 +1,174 @@
+#include "ChunkCodec.hpp"
+
+#include "ByteStream.hpp"
+#include "LzCodec.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Engine {
+    namespace {
+        enum class SectionFormat : uint8_t {
+            Uniform = 0,
+            Palette = 1,
+        };
+
+        /** Largest encoding of a header: format, palette size and 4096 palette entries as varints. */
+        constexpr size_t MAX_HEADER_SIZE = 1 + 3 + CHUNK_SECTION_VOLUME * 3;
+
+        uint64_t mix64(uint64_t p_value) {
+            p_value ^= p_value >> 33;
+            p_value *= 0xff51afd7ed558ccdull;
+            p_value ^= p_value >> 33;
+            p_value *= 0xc4ceb9fe1a85ec53ull;
+            p_value ^= p_value >> 33;
+            return p_value;
+        }
+
+        uint32_t bitsFor(uint32_t p_paletteSize) {
+            return static_cast<uint32_t>(std::bit_width(p_paletteSize - 1));
+        }
+    }
+
+    uint64_t ChunkCodec::contentHash(const ChunkBlocks &p_blocks) {
+        /** Four independent lanes over 8-byte words, so the multiplies pipeline. */
+        const uint8_t *bytes = reinterpret_cast<const uint8_t *>(p_blocks.data());
+        constexpr size_t WORDS = sizeof(ChunkBlocks) / sizeof(uint64_t);
+        uint64_t lanes[4] = { 0x9e3779b97f4a7c15ull, 0xbf58476d1ce4e5b9ull, 0x94d049bb133111ebull, 0x2545f4914f6cdd1dull };
+
+        for (size_t i = 0; i < WORDS; i += 4) {
+            for (size_t lane = 0; lane < 4; lane++) {
+                uint64_t word;
+                std::memcpy(&word, bytes + (i + lane) * sizeof(uint64_t), sizeof(word));
+                lanes[lane] = (lanes[lane] ^ word) * 0x100000001b3ull;
+                lanes[lane] ^= lanes[lane] >> 29;
+            }
+        }
+
+        return mix64(mix64(lanes[0]) ^ std::rotl(mix64(lanes[1]), 16) ^ std::rotl(mix64(lanes[2]), 32) ^ std::rotl(mix64(lanes[3]), 48));
+    }
+
+    void ChunkCodec::encode(const ChunkBlocks &p_blocks, std::vector<uint8_t> &p_output) {
+        /**
+         * Palette in first-seen order, looked up through a direct table over all 65536 ids.
+         * The table is per thread and only the entries used are reset, so it is filled once.
+         */
+        thread_local std::vector<uint16_t> slot(UINT16_MAX + 1, UINT16_MAX);
+        uint16_t palette[CHUNK_SECTION_VOLUME];
+        uint32_t paletteSize = 0;
+        for (uint16_t block : p_blocks) {
+            if (slot[block] == UINT16_MAX) {
+                slot[block] = static_cast<uint16_t>(paletteSize);
+                palette[paletteSize++] = block;
+            }
+        }
+
+        uint8_t header[MAX_HEADER_SIZE];
+        ByteWriter writer(header, sizeof(header));
+
+        if (paletteSize == 1) {
+            slot[palette[0]] = UINT16_MAX;
+            writer.writeU8(static_cast<uint8_t>(SectionFormat::Uniform));
+            writer.writeU16(palette[0]);
+            p_output.insert(p_output.end(), header, header + writer.size());
+            return;
+        }
+
+        writer.writeU8(static_cast<uint8_t>(SectionFormat::Palette));
+        writer.writeVarU32(paletteSize);
+        for (uint32_t i = 0; i < paletteSize; i++) {
+            writer.writeVarU32(palette[i]);
+        }
+        p_output.insert(p_output.end(), header, header + writer.size());
+
+        /** Indices packed LSB-first; a 4096-block section always fills whole bytes. */
+        const uint32_t bits = bitsFor(paletteSize);
+        uint8_t packed[CHUNK_SECTION_VOLUME * 12 / 8];
+        uint32_t accumulator = 0;
+        uint32_t pending = 0;
+        size_t out = 0;
+        for (uint16_t block : p_blocks) {
+            accumulator |= static_cast<uint32_t>(slot[block]) << pending;
+            pending += bits;
+            while (pending >= 8) {
+                packed[out++] = static_cast<uint8_t>(accumulator);
+                accumulator >>= 8;
+                pending -= 8;
+            }
+        }
+
+        for (uint32_t i = 0; i < paletteSize; i++) {
+            slot[palette[i]] = UINT16_MAX;
+        }
+
+        LzCodec::compress(std::span<const uint8_t>(packed, out), p_output);
+    }
+
+    bool ChunkCodec::decode(std::span<const uint8_t> p_data, ChunkBlocks &p_blocks) {
+        ByteReader reader(p_data);
+        const uint8_t format = reader.readU8();
+
+        if (format == static_cast<uint8_t>(SectionFormat::Uniform)) {
+            const uint16_t block = reader.readU16();
+            if (reader.failed() || reader.remaining() != 0) {
+                return false;
+            }
+            p_blocks.fill(block);
+            return true;
+        }
+
+        if (format != static_cast<uint8_t>(SectionFormat::Palette)) {
+            return false;
+        }
+
+        const uint32_t paletteSize = reader.readVarU32();
+        if (reader.failed() || paletteSize < 2 || paletteSize > CHUNK_SECTION_VOLUME) {
+            return false;
+        }
+
+        uint16_t palette[CHUNK_SECTION_VOLUME];
+        for (uint32_t i = 0; i < paletteSize; i++) {
+            const uint32_t block = reader.readVarU32();
+            if (block > UINT16_MAX) {
+                return false;
+            }
+            palette[i] = static_cast<uint16_t>(block);
+        }
+        if (reader.failed()) {
+            return false;
+        }
+
+        const uint32_t bits = bitsFor(paletteSize);
+        uint8_t packed[CHUNK_SECTION_VOLUME * 12 / 8];
+        const std::span<uint8_t> packedSpan(packed, CHUNK_SECTION_VOLUME * bits / 8);
+        if (!LzCodec::decompress(reader.readBytes(reader.remaining()), packedSpan)) {
+            return false;
+        }
+
+        const uint32_t mask = (1u << bits) - 1;
+        uint32_t accumulator = 0;
+        uint32_t available = 0;
+        size_t in = 0;
+        for (uint16_t &block : p_blocks) {
+            while (available < bits) {
+                accumulator |= static_cast<uint32_t>(packed[in++]) << available;
+                available += 8;
+            }
+            const uint32_t index = accumulator & mask;
+            accumulator >>= bits;
+            available -= bits;
+            if (index >= paletteSize) {
+                return false;
+            }
+            block = palette[index];
+        }
+        return true;
+    }
+
+    EncodedSection ChunkCodec::encodeSection(const ChunkCoord &p_coord, const ChunkBlocks &p_blocks) {
+        auto data = std::make_shared<std::vector<uint8_t>>();
+        encode(p_blocks, *data);
+        return { p_coord, contentHash(p_blocks), std::move(data) };
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef __ENGINE_CHUNK_CODEC_HPP__
+#define __ENGINE_CHUNK_CODEC_HPP__
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Engine {
+    inline constexpr uint32_t CHUNK_SECTION_EDGE = 16;
+    inline constexpr uint32_t CHUNK_SECTION_VOLUME = CHUNK_SECTION_EDGE * CHUNK_SECTION_EDGE * CHUNK_SECTION_EDGE;
+
+    /** Block ids of one section, indexed by ChunkCodec::blockIndex(). Same ids as BlockChangedEvent. */
+    using ChunkBlocks = std::array<uint16_t, CHUNK_SECTION_VOLUME>;
+
+    /** Section coordinates, in sections and not blocks. */
+    struct ChunkCoord {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+
+        bool operator==(const ChunkCoord &p_other) const = default;
+
+        /** 21 bits per axis, unique for coordinates within +-1M sections. */
+        uint64_t key() const {
+            constexpr uint64_t MASK = (1u << 21) - 1;
+            return (static_cast<uint64_t>(x) & MASK) | (static_cast<uint64_t>(y) & MASK) << 21 | (static_cast<uint64_t>(z) & MASK) << 42;
+        }
+    };
+
+    /** A section encoded once on the server and shared by every client it is sent to. */
+    struct EncodedSection {
+        ChunkCoord coord;
+        uint64_t hash = 0;
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+
+    /**
+     * Wire encoding of chunk sections.
+     *
+     * A section holding one block id is three bytes. Otherwise the distinct ids form a
+     * palette, each block is stored as a palette index of ceil(log2(palette size)) bits and
+     * the packed indices go through LzCodec. Blocks are ordered y-major, so the horizontal
+     * layers of terrain (stone, dirt, grass, air) become long runs of identical bytes.
+     * The content hash identifies a section by its blocks alone, it keys the client cache.
+     */
+    class ChunkCodec {
+    public:
+        static uint32_t blockIndex(uint32_t p_x, uint32_t p_y, uint32_t p_z) {
+            return (p_y * CHUNK_SECTION_EDGE + p_z) * CHUNK_SECTION_EDGE + p_x;
+        }
+
+        static uint64_t contentHash(const ChunkBlocks &p_blocks);
+
+        /** Appends the encoding of `p_blocks` to `p_output`. */
+        static void encode(const ChunkBlocks &p_blocks, std::vector<uint8_t> &p_output);
+
+        /** False when `p_data` is not exactly one well-formed encoding. */
+        static bool decode(std::span<const uint8_t> p_data, ChunkBlocks &p_blocks);
+
+        /** Encodes and hashes in one go, ready to hand to ChunkSender::offer(). */
+        static EncodedSection encodeSection(const ChunkCoord &p_coord, const ChunkBlocks &p_blocks);
+    };
+}
+
+#endif
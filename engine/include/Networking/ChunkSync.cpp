@@ -0,0 +1,481 @@
+#include "ChunkSync.hpp"
+
+#include "../logger.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+    namespace {
+        /** Far from the small message types games start at, the caller dispatches on the first byte. */
+        enum class ChunkMessage : uint8_t {
+            Offer = 0x40,
+            Unload,
+            Delta,
+            Data,
+            Request,
+        };
+
+        /** An encoded section never gets near this, larger announced sizes are rejected. */
+        constexpr uint32_t MAX_ENCODED_SECTION = 64 * 1024;
+        /** Corrupt loads of one offer that are requested again, past this the section stays missing until the next offer. */
+        constexpr uint32_t MAX_FAILED_LOADS = 3;
+
+        void writeCoord(ByteWriter &p_writer, const ChunkCoord &p_coord) {
+            p_writer.writeVarS32(p_coord.x);
+            p_writer.writeVarS32(p_coord.y);
+            p_writer.writeVarS32(p_coord.z);
+        }
+
+        ChunkCoord readCoord(ByteReader &p_reader) {
+            ChunkCoord coord;
+            coord.x = p_reader.readVarS32();
+            coord.y = p_reader.readVarS32();
+            coord.z = p_reader.readVarS32();
+            return coord;
+        }
+
+        /**
+         * Packs records into messages of one type, each starting with the type, an optional
+         * section coordinate and a 16-bit record count. A record that overflows the message
+         * is rewritten into a fresh one.
+         */
+        class RecordBatch {
+        public:
+            RecordBatch(NetTransport &p_transport, ConnectionId p_connection, ChunkMessage p_type, const ChunkCoord *p_coord = nullptr) :
+                    m_transport(p_transport), m_connection(p_connection), m_type(p_type), m_coord(p_coord), m_writer(m_buffer, sizeof(m_buffer)) {
+                begin();
+            }
+
+            /** `p_write(writer, first)`, where `first` tells a record it opens a message. */
+            template <typename F>
+            void add(F &&p_write) {
+                const size_t start = m_writer.size();
+                p_write(m_writer, m_count == 0);
+                if (m_writer.overflowed() || m_count == UINT16_MAX) {
+                    m_writer.truncate(start);
+                    send();
+                    p_write(m_writer, true);
+                }
+                m_count++;
+            }
+
+            /** Sends what is left, returns the bytes of every message sent. */
+            size_t finish() {
+                if (m_count) {
+                    send();
+                }
+                return m_bytes;
+            }
+
+        private:
+            NetTransport &m_transport;
+            ConnectionId m_connection;
+            ChunkMessage m_type;
+            const ChunkCoord *m_coord;
+            uint8_t m_buffer[NetTransport::MAX_MESSAGE_SIZE];
+            ByteWriter m_writer;
+            size_t m_countOffset = 0;
+            uint32_t m_count = 0;
+            size_t m_bytes = 0;
+
+            void begin() {
+                m_writer.truncate(0);
+                m_writer.writeU8(static_cast<uint8_t>(m_type));
+                if (m_coord) {
+                    writeCoord(m_writer, *m_coord);
+                }
+                m_countOffset = m_writer.size();
+                m_writer.writeU16(0);
+                m_count = 0;
+            }
+
+            void send() {
+                m_buffer[m_countOffset] = static_cast<uint8_t>(m_count);
+                m_buffer[m_countOffset + 1] = static_cast<uint8_t>(m_count >> 8);
+                m_transport.send(m_connection, NetChannel::Reliable, std::span<const uint8_t>(m_buffer, m_writer.size()));
+                m_bytes += m_writer.size();
+                begin();
+            }
+        };
+
+        bool isChunkMessage(std::span<const uint8_t> p_payload) {
+            return !p_payload.empty() && p_payload[0] >= static_cast<uint8_t>(ChunkMessage::Offer) && p_payload[0] <= static_cast<uint8_t>(ChunkMessage::Request);
+        }
+    }
+
+    std::shared_ptr<const std::vector<uint8_t>> ChunkCache::find(uint64_t p_hash) {
+        const auto found = m_entries.find(p_hash);
+        if (found == m_entries.end()) {
+            return nullptr;
+        }
+        m_lru.splice(m_lru.begin(), m_lru, found->second);
+        return found->second->data;
+    }
+
+    void ChunkCache::insert(uint64_t p_hash, std::shared_ptr<const std::vector<uint8_t>> p_data) {
+        const auto found = m_entries.find(p_hash);
+        if (found != m_entries.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, found->second);
+            return;
+        }
+
+        m_bytes += p_data->size();
+        m_lru.push_front({ p_hash, std::move(p_data) });
+        m_entries.emplace(p_hash, m_lru.begin());
+
+        while (m_bytes > m_capacityBytes && m_lru.size() > 1) {
+            m_bytes -= m_lru.back().data->size();
+            m_entries.erase(m_lru.back().hash);
+            m_lru.pop_back();
+        }
+    }
+
+    void ChunkCache::erase(uint64_t p_hash) {
+        const auto found = m_entries.find(p_hash);
+        if (found == m_entries.end()) {
+            return;
+        }
+
+        m_bytes -= found->second->data->size();
+        m_lru.erase(found->second);
+        m_entries.erase(found);
+    }
+
+    void ChunkCache::clear() {
+        m_lru.clear();
+        m_entries.clear();
+        m_bytes = 0;
+    }
+
+    void ChunkSender::offer(const EncodedSection &p_section) {
+        m_offered[p_section.coord.key()] = p_section;
+        m_offers.push_back(p_section);
+        m_statistics.sectionsOffered++;
+    }
+
+    void ChunkSender::blockChanged(const ChunkCoord &p_coord, uint32_t p_index, uint16_t p_block) {
+        if (p_index >= CHUNK_SECTION_VOLUME) {
+            ENGINE_CLOG_ERROR(Net, "Chunks: block index {} is outside a section", p_index)
+            return;
+        }
+        if (!m_offered.contains(p_coord.key())) {
+            return;
+        }
+
+        auto &edits = m_edits[p_coord.key()];
+        edits.first = p_coord;
+        edits.second.push_back(p_index << 16 | p_block);
+    }
+
+    void ChunkSender::unload(const ChunkCoord &p_coord) {
+        const uint64_t key = p_coord.key();
+        if (m_offered.erase(key) == 0) {
+            return;
+        }
+
+        m_edits.erase(key);
+        std::erase_if(m_offers, [&](const EncodedSection &p_section) { return p_section.coord == p_coord; });
+        std::erase_if(m_requested, [&](const Transfer &p_transfer) { return p_transfer.section.coord == p_coord; });
+        m_unloads.push_back(p_coord);
+    }
+
+    bool ChunkSender::handleMessage(std::span<const uint8_t> p_payload) {
+        if (!isChunkMessage(p_payload)) {
+            return false;
+        }
+
+        ByteReader reader(p_payload);
+        if (reader.readU8() != static_cast<uint8_t>(ChunkMessage::Request)) {
+            ENGINE_CLOG_WARNING(Net, "Chunks: unexpected message {:#x} from client {}", p_payload[0], m_connection)
+            return true;
+        }
+
+        const uint16_t count = reader.readU16();
+        for (uint16_t i = 0; i < count && !reader.failed(); i++) {
+            const ChunkCoord coord = readCoord(reader);
+            const uint64_t hash = reader.readU64();
+
+            /** Requests for content since replaced or unloaded are stale, the newer offer is in flight. */
+            const auto offered = m_offered.find(coord.key());
+            if (!reader.failed() && offered != m_offered.end() && offered->second.hash == hash) {
+                m_requested.push_back({ offered->second, 0 });
+            }
+        }
+        return true;
+    }
+
+    void ChunkSender::flush(size_t p_dataBudget) {
+        if (!m_unloads.empty()) {
+            RecordBatch batch(m_transport, m_connection, ChunkMessage::Unload);
+            for (const ChunkCoord &coord : m_unloads) {
+                batch.add([&](ByteWriter &p_writer, bool) { writeCoord(p_writer, coord); });
+            }
+            m_statistics.controlBytes += batch.finish();
+            m_unloads.clear();
+        }
+
+        if (!m_offers.empty()) {
+            RecordBatch batch(m_transport, m_connection, ChunkMessage::Offer);
+            for (const EncodedSection &section : m_offers) {
+                batch.add([&](ByteWriter &p_writer, bool) {
+                    writeCoord(p_writer, section.coord);
+                    p_writer.writeU64(section.hash);
+                });
+            }
+            m_statistics.controlBytes += batch.finish();
+            m_offers.clear();
+        }
+
+        for (auto &[key, edits] : m_edits) {
+            /** Sorted by index keeping the edit order, then only the last edit of each block. */
+            std::vector<uint32_t> &list = edits.second;
+            std::stable_sort(list.begin(), list.end(), [](uint32_t p_a, uint32_t p_b) { return p_a >> 16 < p_b >> 16; });
+
+            RecordBatch batch(m_transport, m_connection, ChunkMessage::Delta, &edits.first);
+            uint32_t previousIndex = 0;
+            for (size_t i = 0; i < list.size(); i++) {
+                if (i + 1 < list.size() && list[i + 1] >> 16 == list[i] >> 16) {
+                    continue;
+                }
+                const uint32_t index = list[i] >> 16;
+                const uint32_t block = list[i] & UINT16_MAX;
+                batch.add([&](ByteWriter &p_writer, bool p_first) {
+                    /** Every message restarts the index deltas, so each one decodes on its own. */
+                    p_writer.writeVarU32(p_first ? index : index - previousIndex);
+                    p_writer.writeVarU32(block);
+                });
+                previousIndex = index;
+                m_statistics.editsSent++;
+            }
+            m_statistics.controlBytes += batch.finish();
+        }
+        m_edits.clear();
+
+        uint8_t buffer[NetTransport::MAX_MESSAGE_SIZE];
+        while (!m_requested.empty() && p_dataBudget > 0) {
+            Transfer &transfer = m_requested.front();
+            const std::vector<uint8_t> &data = *transfer.section.data;
+
+            ByteWriter writer(buffer, sizeof(buffer));
+            writer.writeU8(static_cast<uint8_t>(ChunkMessage::Data));
+            writeCoord(writer, transfer.section.coord);
+            writer.writeU64(transfer.section.hash);
+            writer.writeVarU32(static_cast<uint32_t>(data.size()));
+            writer.writeVarU32(static_cast<uint32_t>(transfer.offset));
+
+            const size_t chunk = std::min(writer.remaining(), data.size() - transfer.offset);
+            writer.writeBytes(std::span<const uint8_t>(data.data() + transfer.offset, chunk));
+            m_transport.send(m_connection, NetChannel::Reliable, std::span<const uint8_t>(buffer, writer.size()));
+
+            transfer.offset += chunk;
+            m_statistics.sectionBytes += writer.size();
+            p_dataBudget -= std::min(p_dataBudget, writer.size());
+
+            if (transfer.offset == data.size()) {
+                m_statistics.sectionsSent++;
+                m_requested.pop_front();
+            }
+        }
+    }
+
+    bool ChunkReceiver::handleMessage(std::span<const uint8_t> p_payload) {
+        if (!isChunkMessage(p_payload)) {
+            return false;
+        }
+
+        ByteReader reader(p_payload);
+        switch (static_cast<ChunkMessage>(reader.readU8())) {
+            case ChunkMessage::Offer:
+                handleOffers(reader);
+                break;
+            case ChunkMessage::Unload:
+                handleUnloads(reader);
+                break;
+            case ChunkMessage::Delta:
+                handleDelta(reader);
+                break;
+            case ChunkMessage::Data:
+                handleData(reader);
+                break;
+            default:
+                ENGINE_CLOG_WARNING(Net, "Chunks: unexpected message {:#x} from the server", p_payload[0])
+                break;
+        }
+        return true;
+    }
+
+    void ChunkReceiver::flush() {
+        if (m_requests.empty()) {
+            return;
+        }
+
+        RecordBatch batch(m_transport, m_connection, ChunkMessage::Request);
+        for (const auto &[coord, hash] : m_requests) {
+            batch.add([&](ByteWriter &p_writer, bool) {
+                writeCoord(p_writer, coord);
+                p_writer.writeU64(hash);
+            });
+        }
+        batch.finish();
+        m_requests.clear();
+    }
+
+    const ChunkBlocks *ChunkReceiver::section(const ChunkCoord &p_coord) const {
+        const auto found = m_sections.find(p_coord.key());
+        return found != m_sections.end() ? found->second.blocks.get() : nullptr;
+    }
+
+    std::vector<ChunkCoord> ChunkReceiver::takeChanged() {
+        std::vector<ChunkCoord> changed;
+        changed.swap(m_changed);
+        return changed;
+    }
+
+    void ChunkReceiver::handleOffers(ByteReader &p_reader) {
+        const uint16_t count = p_reader.readU16();
+        for (uint16_t i = 0; i < count; i++) {
+            const ChunkCoord coord = readCoord(p_reader);
+            const uint64_t hash = p_reader.readU64();
+            if (p_reader.failed()) {
+                return;
+            }
+
+            Section &section = m_sections[coord.key()];
+            if (section.blocks) {
+                m_loaded--;
+            }
+            section = Section();
+            section.coord = coord;
+            section.hash = hash;
+
+            if (const auto cached = m_cache.find(hash)) {
+                m_statistics.cacheHits++;
+                load(section, *cached);
+            } else {
+                m_statistics.cacheMisses++;
+                m_requests.emplace_back(coord, hash);
+            }
+        }
+    }
+
+    void ChunkReceiver::handleUnloads(ByteReader &p_reader) {
+        const uint16_t count = p_reader.readU16();
+        for (uint16_t i = 0; i < count; i++) {
+            const ChunkCoord coord = readCoord(p_reader);
+            const auto found = m_sections.find(coord.key());
+            if (p_reader.failed() || found == m_sections.end()) {
+                continue;
+            }
+
+            /** An edited section is cached under its new content, the server offers that one next time. */
+            Section &section = found->second;
+            if (section.blocks) {
+                if (section.dirty) {
+                    auto data = std::make_shared<std::vector<uint8_t>>();
+                    ChunkCodec::encode(*section.blocks, *data);
+                    m_cache.insert(ChunkCodec::contentHash(*section.blocks), std::move(data));
+                }
+                m_loaded--;
+            }
+            m_sections.erase(found);
+        }
+    }
+
+    void ChunkReceiver::handleDelta(ByteReader &p_reader) {
+        const ChunkCoord coord = readCoord(p_reader);
+        const uint16_t count = p_reader.readU16();
+        const auto found = m_sections.find(coord.key());
+
+        uint32_t index = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            index += p_reader.readVarU32();
+            const uint32_t block = p_reader.readVarU32();
+            if (p_reader.failed() || index >= CHUNK_SECTION_VOLUME || block > UINT16_MAX) {
+                ENGINE_CLOG_WARNING(Net, "Chunks: malformed block delta for section ({}, {}, {})", coord.x, coord.y, coord.z)
+                return;
+            }
+            if (found == m_sections.end()) {
+                continue;
+            }
+
+            Section &section = found->second;
+            if (section.blocks) {
+                applyEdit(section, index << 16 | block);
+            } else {
+                section.pendingEdits.push_back(index << 16 | block);
+            }
+        }
+
+        if (found != m_sections.end() && found->second.blocks && count) {
+            m_changed.push_back(coord);
+        }
+    }
+
+    void ChunkReceiver::handleData(ByteReader &p_reader) {
+        const ChunkCoord coord = readCoord(p_reader);
+        const uint64_t hash = p_reader.readU64();
+        const uint32_t total = p_reader.readVarU32();
+        const uint32_t offset = p_reader.readVarU32();
+        const std::span<const uint8_t> bytes = p_reader.readBytes(p_reader.remaining());
+        if (p_reader.failed() || total > MAX_ENCODED_SECTION || offset > total || bytes.size() > total - offset) {
+            ENGINE_CLOG_WARNING(Net, "Chunks: malformed section data for ({}, {}, {})", coord.x, coord.y, coord.z)
+            return;
+        }
+
+        /** Fragments of content the server replaced since are dropped, the newer offer decides. */
+        const auto found = m_sections.find(coord.key());
+        if (found == m_sections.end() || found->second.blocks || found->second.hash != hash) {
+            return;
+        }
+
+        Section &section = found->second;
+        section.assembly.resize(total);
+        std::copy(bytes.begin(), bytes.end(), section.assembly.begin() + offset);
+        section.received += bytes.size();
+        m_statistics.sectionBytes += bytes.size();
+
+        if (section.received < total) {
+            return;
+        }
+
+        auto data = std::make_shared<std::vector<uint8_t>>(std::move(section.assembly));
+        section.assembly = {};
+        load(section, *data);
+        if (section.blocks) {
+            m_cache.insert(hash, std::move(data));
+        }
+    }
+
+    void ChunkReceiver::load(Section &p_section, std::span<const uint8_t> p_data) {
+        auto blocks = std::make_unique<ChunkBlocks>();
+        if (!ChunkCodec::decode(p_data, *blocks) || ChunkCodec::contentHash(*blocks) != p_section.hash) {
+            ENGINE_CLOG_ERROR(Net, "Chunks: section ({}, {}, {}) does not decode to its hash", p_section.coord.x, p_section.coord.y, p_section.coord.z)
+            m_statistics.corruptSections++;
+
+            /** A bad cached copy must not be found again, and the section must not stay missing: the server sends a fresh one. */
+            m_cache.erase(p_section.hash);
+            p_section.received = 0;
+            if (++p_section.failedLoads <= MAX_FAILED_LOADS) {
+                m_requests.emplace_back(p_section.coord, p_section.hash);
+            }
+            return;
+        }
+
+        p_section.blocks = std::move(blocks);
+        for (uint32_t edit : p_section.pendingEdits) {
+            applyEdit(p_section, edit);
+        }
+        p_section.pendingEdits = {};
+        m_loaded++;
+        m_changed.push_back(p_section.coord);
+    }
+
+    void ChunkReceiver::applyEdit(Section &p_section, uint32_t p_edit) {
+        uint16_t &block = (*p_section.blocks)[p_edit >> 16];
+        if (block != static_cast<uint16_t>(p_edit)) {
+            block = static_cast<uint16_t>(p_edit);
+            p_section.dirty = true;
+        }
+        m_statistics.editsApplied++;
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef __ENGINE_CHUNK_SYNC_HPP__
+#define __ENGINE_CHUNK_SYNC_HPP__
+
+#include "ByteStream.hpp"
+#include "ChunkCodec.hpp"
+#include "Transport.hpp"
+
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+namespace Engine {
+    /**
+     * Client store of encoded sections keyed by content hash, least recently used first out.
+     * A section that scrolls out of view and back, or that another part of the world shares
+     * (empty air, solid stone), is rebuilt from here instead of downloaded again.
+     */
+    class ChunkCache {
+    public:
+        explicit ChunkCache(size_t p_capacityBytes = 64 * 1024 * 1024) :
+                m_capacityBytes(p_capacityBytes) {}
+
+        /** Null on a miss, a hit becomes the most recently used entry. */
+        std::shared_ptr<const std::vector<uint8_t>> find(uint64_t p_hash);
+
+        void insert(uint64_t p_hash, std::shared_ptr<const std::vector<uint8_t>> p_data);
+        void erase(uint64_t p_hash);
+        void clear();
+
+        size_t size() const { return m_entries.size(); }
+        size_t bytes() const { return m_bytes; }
+
+    private:
+        struct Entry {
+            uint64_t hash;
+            std::shared_ptr<const std::vector<uint8_t>> data;
+        };
+
+        size_t m_capacityBytes;
+        size_t m_bytes = 0;
+        std::list<Entry> m_lru;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> m_entries;
+    };
+
+    struct ChunkSenderStatistics {
+        uint64_t sectionsOffered = 0;
+        uint64_t sectionsSent = 0;
+        uint64_t sectionBytes = 0;
+        uint64_t editsSent = 0;
+        /** Offers, unloads and block deltas. */
+        uint64_t controlBytes = 0;
+    };
+
+    struct ChunkReceiverStatistics {
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+        uint64_t sectionBytes = 0;
+        uint64_t editsApplied = 0;
+        uint64_t corruptSections = 0;
+    };
+
+    /**
+     * Server side of the chunk replication to one client, over the reliable channel.
+     *
+     * A section is offered by coordinate and content hash; the client answers with a request
+     * only when its ChunkCache misses, and the encoded section then follows in fragments of
+     * at most one message. Edits are sent as block deltas (sorted index delta and block id
+     * varints, last write wins) that the client applies on top, buffering them while the
+     * section itself is still in flight. Offers, unloads and deltas are small and always go
+     * out at flush(); section data is paced by the byte budget given to it.
+     */
+    class ChunkSender {
+    public:
+        ChunkSender(NetTransport &p_transport, ConnectionId p_connection) :
+                m_transport(p_transport), m_connection(p_connection) {}
+
+        /** Makes the section visible to the client, or replaces the content it has. */
+        void offer(const EncodedSection &p_section);
+
+        /** Block `p_index` (ChunkCodec::blockIndex) of an offered section became `p_block`. */
+        void blockChanged(const ChunkCoord &p_coord, uint32_t p_index, uint16_t p_block);
+
+        /** The section left the client's view, it moves into the client cache. */
+        void unload(const ChunkCoord &p_coord);
+
+        /** Consumes the chunk messages of this client, returns false for any other message. */
+        bool handleMessage(std::span<const uint8_t> p_payload);
+
+        /** Queues the pending messages on the transport, section data up to `p_dataBudget` bytes. */
+        void flush(size_t p_dataBudget = SIZE_MAX);
+
+        /** Sections requested and not fully sent yet. */
+        size_t pendingSections() const { return m_requested.size(); }
+
+        const ChunkSenderStatistics &statistics() const { return m_statistics; }
+
+    private:
+        struct Transfer {
+            EncodedSection section;
+            size_t offset = 0;
+        };
+
+        NetTransport &m_transport;
+        ConnectionId m_connection;
+
+        /** Sections visible to the client, kept to answer requests. */
+        std::unordered_map<uint64_t, EncodedSection> m_offered;
+        std::vector<EncodedSection> m_offers;
+        std::vector<ChunkCoord> m_unloads;
+        /** Per section, index << 16 | block in edit order. */
+        std::unordered_map<uint64_t, std::pair<ChunkCoord, std::vector<uint32_t>>> m_edits;
+        std::deque<Transfer> m_requested;
+
+        ChunkSenderStatistics m_statistics;
+    };
+
+    /** Client side, keeps the sections of one server connection and answers its offers. */
+    class ChunkReceiver {
+    public:
+        ChunkReceiver(NetTransport &p_transport, ConnectionId p_connection, ChunkCache &p_cache) :
+                m_transport(p_transport), m_connection(p_connection), m_cache(p_cache) {}
+
+        /** Consumes the chunk messages of the server, returns false for any other message. */
+        bool handleMessage(std::span<const uint8_t> p_payload);
+
+        /** Queues the requests for the sections the cache missed. */
+        void flush();
+
+        /** Null until the section arrived. */
+        const ChunkBlocks *section(const ChunkCoord &p_coord) const;
+
+        /** Sections loaded or edited since the last call. */
+        std::vector<ChunkCoord> takeChanged();
+
+        size_t loadedSections() const { return m_loaded; }
+
+        const ChunkReceiverStatistics &statistics() const { return m_statistics; }
+
+    private:
+        struct Section {
+            ChunkCoord coord;
+            uint64_t hash = 0;
+            std::unique_ptr<ChunkBlocks> blocks;
+            /** Edited since it arrived, the cached encoding no longer matches. */
+            bool dirty = false;
+            std::vector<uint8_t> assembly;
+            size_t received = 0;
+            /** Deltas that arrived before the section, index << 16 | block. */
+            std::vector<uint32_t> pendingEdits;
+            /** Loads that did not decode to `hash`, each one requests the section again. */
+            uint32_t failedLoads = 0;
+        };
+
+        NetTransport &m_transport;
+        ConnectionId m_connection;
+        ChunkCache &m_cache;
+
+        std::unordered_map<uint64_t, Section> m_sections;
+        size_t m_loaded = 0;
+        std::vector<std::pair<ChunkCoord, uint64_t>> m_requests;
+        std::vector<ChunkCoord> m_changed;
+
+        ChunkReceiverStatistics m_statistics;
+
+        void handleOffers(ByteReader &p_reader);
+        void handleUnloads(ByteReader &p_reader);
+        void handleDelta(ByteReader &p_reader);
+        void handleData(ByteReader &p_reader);
+        void load(Section &p_section, std::span<const uint8_t> p_data);
+        void applyEdit(Section &p_section, uint32_t p_edit);
+    };
+}
+
+#endif
@@ -0,0 +1,330 @@
+#include "Interest.hpp"
+
+#include "../logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Engine {
+    namespace {
+        /** Snapshot id, baseline age and the two list counts, as varints of at most five bytes. */
+        constexpr uint32_t SNAPSHOT_HEADER_BOUND = 4 * 5;
+
+        uint32_t varintSize(uint32_t p_value) {
+            return 1 + (std::bit_width(p_value) - (p_value != 0)) / 7;
+        }
+
+        /**
+         * Bytes SnapshotEncoder spends on the entity against `p_previous` at most: the id delta,
+         * which is below the id whatever else is selected, the mask and the changed words.
+         */
+        uint32_t costBound(uint32_t p_id, const uint32_t *p_previous, const uint32_t *p_current) {
+            uint32_t cost = varintSize(p_id) + 1;
+            for (uint32_t word = 0; word < SNAPSHOT_ENTITY_WORDS; word++) {
+                if (p_current[word] != p_previous[word]) {
+                    const int32_t delta = static_cast<int32_t>(p_current[word] - p_previous[word]);
+                    cost += varintSize((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31));
+                }
+            }
+            return cost;
+        }
+    }
+
+    void SpatialHash::update(uint32_t p_item, float p_x, float p_z) {
+        if (p_item >= m_placements.size()) {
+            m_placements.resize(p_item + 1);
+        }
+
+        const uint64_t cell = cellKey(cellCoord(p_x), cellCoord(p_z));
+        Placement &placement = m_placements[p_item];
+        if (placement.placed && placement.cell == cell) {
+            return;
+        }
+
+        remove(p_item);
+        std::vector<uint32_t> &items = m_cells[cell];
+        placement = { true, cell, static_cast<uint32_t>(items.size()) };
+        items.push_back(p_item);
+    }
+
+    void SpatialHash::remove(uint32_t p_item) {
+        if (p_item >= m_placements.size() || !m_placements[p_item].placed) {
+            return;
+        }
+
+        Placement &placement = m_placements[p_item];
+        std::vector<uint32_t> &items = m_cells[placement.cell];
+        const uint32_t last = items.back();
+        items[placement.index] = last;
+        m_placements[last].index = placement.index;
+        items.pop_back();
+        placement.placed = false;
+    }
+
+    InterestManager::InterestManager(const InterestConfig &p_config, WorkerThreadPool *p_pool) :
+            m_config(p_config), m_pool(p_pool), m_grid(p_config.cellSize) {
+        if (m_config.leaveRadius < m_config.enterRadius) {
+            ENGINE_CLOG_WARNING(Net, "Interest: leave radius {} is below the enter radius {}, using the enter radius", m_config.leaveRadius, m_config.enterRadius)
+            m_config.leaveRadius = m_config.enterRadius;
+        }
+        m_config.bytesPerUpdate = std::min(m_config.bytesPerUpdate, NetTransport::MAX_MESSAGE_SIZE);
+
+        m_scratch.resize(m_pool ? m_pool->threadCount() : 1);
+        m_updateClient = [this](uint32_t p_index, uint32_t p_threadIndex) {
+            updateClient(*m_active[p_index], m_scratch[p_threadIndex]);
+        };
+    }
+
+    void InterestManager::updateEntity(const SnapshotEntity &p_state, float p_x, float p_y, float p_z, float p_priority) {
+        auto [found, inserted] = m_slotsById.try_emplace(p_state.id, 0);
+        if (inserted) {
+            if (m_freeSlots.empty()) {
+                found->second = static_cast<uint32_t>(m_entities.size());
+                m_entities.emplace_back();
+            } else {
+                found->second = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+        }
+
+        const uint32_t slot = found->second;
+        m_entities[slot] = { p_state, p_x, p_y, p_z, p_priority };
+        m_grid.update(slot, p_x, p_z);
+    }
+
+    void InterestManager::removeEntity(uint32_t p_id) {
+        const auto found = m_slotsById.find(p_id);
+        if (found == m_slotsById.end()) {
+            return;
+        }
+
+        m_grid.remove(found->second);
+        m_freeSlots.push_back(found->second);
+        m_slotsById.erase(found);
+    }
+
+    void InterestManager::addClient(ConnectionId p_client) {
+        if (p_client >= m_clients.size()) {
+            m_clients.resize(p_client + 1);
+        }
+        if (!m_clients[p_client]) {
+            m_clients[p_client] = std::make_unique<Client>();
+        }
+    }
+
+    void InterestManager::removeClient(ConnectionId p_client) {
+        if (p_client < m_clients.size()) {
+            m_clients[p_client].reset();
+        }
+    }
+
+    void InterestManager::setViewer(ConnectionId p_client, float p_x, float p_y, float p_z) {
+        Client *viewer = client(p_client);
+        if (!viewer) {
+            ENGINE_CLOG_ERROR(Net, "Interest: no client {}", p_client)
+            return;
+        }
+        viewer->x = p_x;
+        viewer->y = p_y;
+        viewer->z = p_z;
+    }
+
+    void InterestManager::acknowledge(ConnectionId p_client, uint32_t p_id) {
+        if (Client *viewer = client(p_client)) {
+            viewer->encoder.acknowledge(p_id);
+        }
+    }
+
+    void InterestManager::update() {
+        m_active.clear();
+        for (const std::unique_ptr<Client> &current : m_clients) {
+            if (current) {
+                m_active.push_back(current.get());
+            }
+        }
+
+        if (m_pool && m_active.size() > 1) {
+            m_pool->parallelFor(static_cast<uint32_t>(m_active.size()), m_updateClient);
+        } else {
+            for (Client *current : m_active) {
+                updateClient(*current, m_scratch.back());
+            }
+        }
+    }
+
+    std::span<const uint8_t> InterestManager::message(ConnectionId p_client) const {
+        const Client *viewer = client(p_client);
+        return viewer ? std::span<const uint8_t>(viewer->message, viewer->messageSize) : std::span<const uint8_t>();
+    }
+
+    std::span<const SnapshotEntity> InterestManager::snapshot(ConnectionId p_client) const {
+        const Client *viewer = client(p_client);
+        return viewer ? std::span<const SnapshotEntity>(viewer->snapshot) : std::span<const SnapshotEntity>();
+    }
+
+    const InterestClientStatistics *InterestManager::statistics(ConnectionId p_client) const {
+        const Client *viewer = client(p_client);
+        return viewer ? &viewer->statistics : nullptr;
+    }
+
+    void InterestManager::updateRelevance(Client &p_client, Scratch &p_scratch) {
+        InterestClientStatistics &statistics = p_client.statistics;
+
+        /** Everything within the leave radius, by id to merge with the previous set. */
+        const float leaveSquared = m_config.leaveRadius * m_config.leaveRadius;
+        const float enterSquared = m_config.enterRadius * m_config.enterRadius;
+        std::vector<Candidate> &candidates = p_scratch.candidates;
+        candidates.clear();
+        m_grid.query(p_client.x, p_client.z, m_config.leaveRadius, [&](uint32_t p_slot) {
+            const Entity &entity = m_entities[p_slot];
+            const float dx = entity.x - p_client.x;
+            const float dy = entity.y - p_client.y;
+            const float dz = entity.z - p_client.z;
+            const float distanceSquared = dx * dx + dy * dy + dz * dz;
+            if (distanceSquared <= leaveSquared) {
+                candidates.push_back({ entity.state.id, p_slot, distanceSquared });
+            }
+        });
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &p_a, const Candidate &p_b) { return p_a.id < p_b.id; });
+
+        /** Known entities still in range stay, new ones need the smaller enter radius, the rest left. */
+        std::vector<Relevant> &merged = p_scratch.merged;
+        merged.clear();
+        const std::vector<Relevant> &previous = p_client.relevant;
+        size_t known = 0;
+        for (const Candidate &candidate : candidates) {
+            while (known < previous.size() && previous[known].id < candidate.id) {
+                known++;
+                statistics.left++;
+            }
+
+            Relevant *relevant = nullptr;
+            if (known < previous.size() && previous[known].id == candidate.id) {
+                relevant = &merged.emplace_back(previous[known++]);
+            } else if (candidate.distanceSquared <= enterSquared) {
+                relevant = &merged.emplace_back();
+                relevant->id = candidate.id;
+                relevant->accumulator = m_config.enterBoost;
+                statistics.entered++;
+            } else {
+                continue;
+            }
+
+            relevant->slot = candidate.slot;
+            relevant->weight = m_entities[candidate.slot].priority / (1.0f + std::sqrt(candidate.distanceSquared) / m_config.falloffDistance);
+        }
+        statistics.left += static_cast<uint32_t>(previous.size() - known);
+        p_client.relevant.swap(merged);
+    }
+
+    void InterestManager::updateClient(Client &p_client, Scratch &p_scratch) {
+        InterestClientStatistics &statistics = p_client.statistics;
+        statistics = {};
+        updateRelevance(p_client, p_scratch);
+
+        /** Both sorted by id; baseline entities that are no longer relevant will be removed. */
+        std::vector<Relevant> &relevant = p_client.relevant;
+        const std::span<const SnapshotEntity> baseline = p_client.encoder.baseline();
+        std::vector<Pending> &pending = p_scratch.pending;
+        std::vector<uint32_t> &stale = p_scratch.stale;
+        pending.clear();
+        stale.clear();
+
+        size_t base = 0;
+        for (uint32_t i = 0; i < relevant.size(); i++) {
+            Relevant &current = relevant[i];
+            for (; base < baseline.size() && baseline[base].id < current.id; base++) {
+                pending.push_back({ Pending::LEFT, &baseline[base], false });
+            }
+            const SnapshotEntity *held = base < baseline.size() && baseline[base].id == current.id ? &baseline[base++] : nullptr;
+
+            const SnapshotEntity &state = m_entities[current.slot].state;
+            if (!held || std::memcmp(held->words, state.words, sizeof(state.words)) != 0) {
+                current.accumulator += current.weight;
+                stale.push_back(static_cast<uint32_t>(pending.size()));
+            }
+            pending.push_back({ i, held, false });
+        }
+        for (; base < baseline.size(); base++) {
+            pending.push_back({ Pending::LEFT, &baseline[base], false });
+        }
+
+        /**
+         * Every cost below is an upper bound, so whatever is selected fits the budget. Removals
+         * go first, those that do not fit leave the entity with the client for another update.
+         */
+        uint32_t budget = m_config.bytesPerUpdate - std::min(SNAPSHOT_HEADER_BOUND, m_config.bytesPerUpdate);
+        for (Pending &candidate : pending) {
+            if (candidate.relevant != Pending::LEFT) {
+                continue;
+            }
+
+            const uint32_t cost = varintSize(candidate.baseline->id);
+            if (cost > budget) {
+                statistics.removalsDeferred++;
+                continue;
+            }
+            budget -= cost;
+            candidate.selected = true;
+        }
+
+        std::sort(stale.begin(), stale.end(), [&](uint32_t p_a, uint32_t p_b) {
+            return relevant[pending[p_a].relevant].accumulator > relevant[pending[p_b].relevant].accumulator;
+        });
+
+        static const uint32_t s_zeroWords[SNAPSHOT_ENTITY_WORDS] = {};
+        for (uint32_t index : stale) {
+            Pending &candidate = pending[index];
+            const Relevant &current = relevant[candidate.relevant];
+            const uint32_t cost = costBound(current.id, candidate.baseline ? candidate.baseline->words : s_zeroWords,
+                                            m_entities[current.slot].state.words);
+            if (cost > budget) {
+                statistics.deferred++;
+                continue;
+            }
+
+            budget -= cost;
+            candidate.selected = true;
+        }
+        statistics.relevant = static_cast<uint32_t>(relevant.size());
+        statistics.estimatedBytes = m_config.bytesPerUpdate - budget;
+
+        /** Entities the client holds and that were not picked are repeated as it holds them. */
+        p_client.snapshot.clear();
+        for (const Pending &candidate : pending) {
+            if (candidate.relevant == Pending::LEFT) {
+                if (!candidate.selected) {
+                    p_client.snapshot.push_back(*candidate.baseline);
+                }
+            } else if (candidate.selected) {
+                p_client.snapshot.push_back(m_entities[relevant[candidate.relevant].slot].state);
+            } else if (candidate.baseline) {
+                p_client.snapshot.push_back(*candidate.baseline);
+            }
+        }
+
+        ByteWriter writer(p_client.message, sizeof(p_client.message));
+        if (!p_client.encoder.encode(p_client.snapshot, writer)) {
+            /** Nothing went out, the selected entities keep their accumulators and compete again. */
+            ENGINE_CLOG_ERROR(Net, "Interest: the snapshot of {} entities did not encode within its {} byte bound",
+                              p_client.snapshot.size(), statistics.estimatedBytes)
+            p_client.messageSize = 0;
+            statistics.deferred = static_cast<uint32_t>(stale.size());
+            return;
+        }
+        p_client.messageSize = static_cast<uint32_t>(writer.size());
+        statistics.snapshotBytes = p_client.messageSize;
+
+        for (uint32_t index : stale) {
+            if (pending[index].selected) {
+                relevant[pending[index].relevant].accumulator = 0.0f;
+                statistics.sent++;
+            }
+        }
+    }
+
+    InterestManager::Client *InterestManager::client(ConnectionId p_client) const {
+        return p_client < m_clients.size() ? m_clients[p_client].get() : nullptr;
+    }
+}
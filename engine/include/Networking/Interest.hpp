@@ -0,0 +1,220 @@
+#ifndef __ENGINE_INTEREST_HPP__
+#define __ENGINE_INTEREST_HPP__
+
+#include "Snapshot.hpp"
+#include "Transport.hpp"
+#include "../core/Threading/WorkerThreadPool.hpp"
+
+#include <cmath>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    /**
+     * Loose uniform grid over the horizontal plane. An item is filed under the cell holding
+     * its position and only changes cell when it crosses a boundary, so moving inside a cell
+     * costs a comparison. Queries visit every item of the cells overlapping the square around
+     * the point, the caller does the exact distance test. Cells are kept once created, so an
+     * item oscillating over a boundary does not allocate.
+     */
+    class SpatialHash {
+    public:
+        explicit SpatialHash(float p_cellSize) :
+                m_inverseCellSize(1.0f / p_cellSize) {}
+
+        /** Adds or moves `p_item`, a small dense index. */
+        void update(uint32_t p_item, float p_x, float p_z);
+        void remove(uint32_t p_item);
+
+        template <typename F>
+        void query(float p_x, float p_z, float p_radius, F &&p_visit) const {
+            const int32_t minX = cellCoord(p_x - p_radius);
+            const int32_t maxX = cellCoord(p_x + p_radius);
+            const int32_t minZ = cellCoord(p_z - p_radius);
+            const int32_t maxZ = cellCoord(p_z + p_radius);
+            for (int32_t z = minZ; z <= maxZ; z++) {
+                for (int32_t x = minX; x <= maxX; x++) {
+                    const auto cell = m_cells.find(cellKey(x, z));
+                    if (cell == m_cells.end()) {
+                        continue;
+                    }
+                    for (uint32_t item : cell->second) {
+                        p_visit(item);
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Placement {
+            bool placed = false;
+            uint64_t cell = 0;
+            uint32_t index = 0;
+        };
+
+        float m_inverseCellSize;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+        std::vector<Placement> m_placements;
+
+        int32_t cellCoord(float p_value) const { return static_cast<int32_t>(std::floor(p_value * m_inverseCellSize)); }
+
+        static uint64_t cellKey(int32_t p_x, int32_t p_z) {
+            return static_cast<uint64_t>(static_cast<uint32_t>(p_x)) << 32 | static_cast<uint32_t>(p_z);
+        }
+    };
+
+    struct InterestConfig {
+        float cellSize = 32.0f;
+        /** Entities closer than this to a viewer become relevant to it. */
+        float enterRadius = 128.0f;
+        /** They stay relevant up to this distance, so entities on the border do not flicker. */
+        float leaveRadius = 144.0f;
+        /** Distance at which the priority of an entity has halved. */
+        float falloffDistance = 32.0f;
+        /** Starting accumulator of an entity entering the set, it is sent ahead of the known ones. */
+        float enterBoost = 100.0f;
+        /** Snapshot bytes each client may spend per update, at most a message. */
+        uint32_t bytesPerUpdate = 900;
+    };
+
+    /** What the last update() did for one client. */
+    struct InterestClientStatistics {
+        uint32_t relevant = 0;
+        uint32_t entered = 0;
+        uint32_t left = 0;
+        uint32_t sent = 0;
+        /** Stale entities that did not fit the budget, their accumulators keep growing. */
+        uint32_t deferred = 0;
+        /** Entities that left the set but whose removal did not fit, the client keeps them one more update. */
+        uint32_t removalsDeferred = 0;
+        /** Upper bound of the snapshot size, never above the budget. */
+        uint32_t estimatedBytes = 0;
+        /** Size of the encoded snapshot, 0 when encoding failed and nothing was sent. */
+        uint32_t snapshotBytes = 0;
+    };
+
+    /**
+     * Decides which entity states each client receives and encodes its snapshots.
+     *
+     * Entities sit in a SpatialHash, and every update() rebuilds the relevance set of each
+     * client from the cells around its viewer, merged against the previous set so entering
+     * and leaving entities are known without touching the rest of the world.
+     *
+     * Each client has its own SnapshotEncoder, and an entity is stale for a client while its
+     * state differs from the acknowledged baseline. Stale entities accumulate their priority,
+     * scaled down with distance, every update; the highest accumulators go into the snapshot
+     * with their current state until the byte budget is spent and restart from zero. The
+     * others are written with their baseline state, which delta-encodes to nothing, so
+     * distant or low-priority entities refresh less often but never starve, and an update
+     * lost on the way stays stale and competes again. Costs are counted at their worst-case
+     * varint sizes, so a selection always encodes within the budget.
+     *
+     * Clients are selected and encoded in parallel on the pool when one is given.
+     */
+    class InterestManager {
+    public:
+        explicit InterestManager(const InterestConfig &p_config = {}, WorkerThreadPool *p_pool = nullptr);
+
+        /** Adds or updates an entity, `p_priority` weighs it against the others (players > debris). */
+        void updateEntity(const SnapshotEntity &p_state, float p_x, float p_y, float p_z, float p_priority = 1.0f);
+        void removeEntity(uint32_t p_id);
+
+        void addClient(ConnectionId p_client);
+        void removeClient(ConnectionId p_client);
+        void setViewer(ConnectionId p_client, float p_x, float p_y, float p_z);
+
+        /** The client decoded snapshot `p_id` (SnapshotDecoder::latestId() echoed back). */
+        void acknowledge(ConnectionId p_client, uint32_t p_id);
+
+        /** Recomputes relevance, picks the states to send and encodes a snapshot for every client. */
+        void update();
+
+        /** Encoded snapshot of the last update() for `p_client`, empty when there is none. */
+        std::span<const uint8_t> message(ConnectionId p_client) const;
+
+        /** Entities in that snapshot, sorted by id. */
+        std::span<const SnapshotEntity> snapshot(ConnectionId p_client) const;
+
+        const InterestClientStatistics *statistics(ConnectionId p_client) const;
+
+        uint32_t entityCount() const { return static_cast<uint32_t>(m_slotsById.size()); }
+
+    private:
+        struct Entity {
+            SnapshotEntity state;
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+            float priority = 1.0f;
+        };
+
+        struct Relevant {
+            uint32_t id = 0;
+            uint32_t slot = 0;
+            float accumulator = 0.0f;
+            /** Priority scaled by the distance of this update. */
+            float weight = 0.0f;
+        };
+
+        struct Client {
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+            /** Sorted by id. */
+            std::vector<Relevant> relevant;
+            SnapshotEncoder encoder;
+            std::vector<SnapshotEntity> snapshot;
+            uint8_t message[NetTransport::MAX_MESSAGE_SIZE];
+            uint32_t messageSize = 0;
+            InterestClientStatistics statistics;
+        };
+
+        struct Candidate {
+            uint32_t id;
+            uint32_t slot;
+            float distanceSquared;
+        };
+
+        /** A relevant entity, or one the client holds that left the set, during one update. */
+        struct Pending {
+            static constexpr uint32_t LEFT = UINT32_MAX;
+
+            /** Index into the relevant set, LEFT when the entity is only in the baseline. */
+            uint32_t relevant;
+            /** Null when the client holds no state for it. */
+            const SnapshotEntity *baseline;
+            /** Its state, or for LEFT its removal, goes into this snapshot. */
+            bool selected;
+        };
+
+        /** Per worker thread, reused between clients. */
+        struct Scratch {
+            std::vector<Candidate> candidates;
+            std::vector<Relevant> merged;
+            std::vector<Pending> pending;
+            std::vector<uint32_t> stale;
+        };
+
+        InterestConfig m_config;
+        WorkerThreadPool *m_pool;
+
+        SpatialHash m_grid;
+        std::vector<Entity> m_entities;
+        std::vector<uint32_t> m_freeSlots;
+        std::unordered_map<uint32_t, uint32_t> m_slotsById;
+
+        /** Indexed by connection id, null for unknown clients. */
+        std::vector<std::unique_ptr<Client>> m_clients;
+        std::vector<Client *> m_active;
+        std::vector<Scratch> m_scratch;
+        WorkerThreadPool::Task m_updateClient;
+
+        void updateRelevance(Client &p_client, Scratch &p_scratch);
+        void updateClient(Client &p_client, Scratch &p_scratch);
+        Client *client(ConnectionId p_client) const;
+    };
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "LzCodec.hpp"
+
+#include <cstring>
+
+namespace Engine {
+    namespace {
+        constexpr uint32_t MIN_MATCH = 4;
+        constexpr uint32_t HASH_BITS = 12;
+        constexpr uint32_t MAX_OFFSET = UINT16_MAX;
+
+        uint32_t read32(const uint8_t *p_data) {
+            uint32_t value;
+            std::memcpy(&value, p_data, sizeof(value));
+            return value;
+        }
+
+        uint32_t hash32(uint32_t p_value) {
+            return (p_value * 2654435761u) >> (32 - HASH_BITS);
+        }
+
+        /** 15 in the nibble, then 255s, then the remainder. */
+        void writeLength(std::vector<uint8_t> &p_output, size_t p_length) {
+            for (; p_length >= 255; p_length -= 255) {
+                p_output.push_back(255);
+            }
+            p_output.push_back(static_cast<uint8_t>(p_length));
+        }
+
+        void writeSequence(std::vector<uint8_t> &p_output, const uint8_t *p_literals, size_t p_literalCount, uint32_t p_offset, size_t p_matchLength) {
+            const size_t matchCode = p_matchLength ? p_matchLength - MIN_MATCH : 0;
+            p_output.push_back(static_cast<uint8_t>((p_literalCount < 15 ? p_literalCount : 15) << 4 | (matchCode < 15 ? matchCode : 15)));
+            if (p_literalCount >= 15) {
+                writeLength(p_output, p_literalCount - 15);
+            }
+            p_output.insert(p_output.end(), p_literals, p_literals + p_literalCount);
+
+            if (p_matchLength) {
+                p_output.push_back(static_cast<uint8_t>(p_offset));
+                p_output.push_back(static_cast<uint8_t>(p_offset >> 8));
+                if (matchCode >= 15) {
+                    writeLength(p_output, matchCode - 15);
+                }
+            }
+        }
+    }
+
+    void LzCodec::compress(std::span<const uint8_t> p_input, std::vector<uint8_t> &p_output) {
+        const uint8_t *input = p_input.data();
+        const size_t size = p_input.size();
+
+        /** Position + 1 of the last occurrence of each hashed 4-byte prefix, 0 for none. */
+        uint32_t table[1u << HASH_BITS] = {};
+        size_t anchor = 0;
+        size_t position = 0;
+
+        while (size >= MIN_MATCH && position <= size - MIN_MATCH) {
+            const uint32_t prefix = read32(input + position);
+            const uint32_t hash = hash32(prefix);
+            const size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET || read32(input + candidate - 1) != prefix) {
+                position++;
+                continue;
+            }
+
+            const size_t match = candidate - 1;
+            size_t length = MIN_MATCH;
+            while (position + length < size && input[match + length] == input[position + length]) {
+                length++;
+            }
+
+            writeSequence(p_output, input + anchor, position - anchor, static_cast<uint32_t>(position - match), length);
+            position += length;
+            anchor = position;
+        }
+
+        /** Trailing literals, the decoder knows it is done when the input ends after them. */
+        if (anchor < size || size == 0) {
+            writeSequence(p_output, input + anchor, size - anchor, 0, 0);
+        }
+    }
+
+    bool LzCodec::decompress(std::span<const uint8_t> p_input, std::span<uint8_t> p_output) {
+        const uint8_t *input = p_input.data();
+        const uint8_t *inputEnd = input + p_input.size();
+        uint8_t *output = p_output.data();
+        uint8_t *const outputStart = output;
+        uint8_t *const outputEnd = output + p_output.size();
+
+        auto readLength = [&](size_t &p_length) {
+            for (;;) {
+                if (input == inputEnd) {
+                    return false;
+                }
+                const uint8_t byte = *input++;
+                p_length += byte;
+                if (byte != 255) {
+                    return true;
+                }
+            }
+        };
+
+        while (input < inputEnd) {
+            const uint8_t token = *input++;
+
+            size_t literals = token >> 4;
+            if (literals == 15 && !readLength(literals)) {
+                return false;
+            }
+            if (literals > static_cast<size_t>(inputEnd - input) || literals > static_cast<size_t>(outputEnd - output)) {
+                return false;
+            }
+            std::memcpy(output, input, literals);
+            input += literals;
+            output += literals;
+
+            if (input == inputEnd) {
+                break;
+            }
+
+            if (inputEnd - input < 2) {
+                return false;
+            }
+            const size_t offset = input[0] | input[1] << 8;
+            input += 2;
+
+            size_t length = token & 15;
+            if (length == 15 && !readLength(length)) {
+                return false;
+            }
+            length += MIN_MATCH;
+
+            if (offset == 0 || offset > static_cast<size_t>(output - outputStart) || length > static_cast<size_t>(outputEnd - output)) {
+                return false;
+            }
+
+            /** Byte by byte, a match may overlap the bytes it produces (runs). */
+            const uint8_t *source = output - offset;
+            for (size_t i = 0; i < length; i++) {
+                output[i] = source[i];
+            }
+            output += length;
+        }
+
+        return output == outputEnd;
+    }
+}
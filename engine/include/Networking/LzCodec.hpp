@@ -0,0 +1,26 @@
+#ifndef __ENGINE_LZ_CODEC_HPP__
+#define __ENGINE_LZ_CODEC_HPP__
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Engine {
+    /**
+     * Byte-oriented LZ77 codec in the style of the LZ4 block format: sequences of a token
+     * (literal and match length nibbles), the literals, a 16-bit match offset and extra length
+     * bytes. Single pass with a 4096-entry hash table for the compressor, a bounds-checked
+     * copy loop for the decompressor, no entropy stage; it trades ratio for speed on data
+     * that is mostly long runs and repeats, like packed voxel indices.
+     */
+    class LzCodec {
+    public:
+        /** Appends the compressed form of `p_input` to `p_output`. */
+        static void compress(std::span<const uint8_t> p_input, std::vector<uint8_t> &p_output);
+
+        /** Fills exactly `p_output`, false when the input is malformed or does not decode to that size. */
+        static bool decompress(std::span<const uint8_t> p_input, std::span<uint8_t> p_output);
+    };
+}
+
+#endif
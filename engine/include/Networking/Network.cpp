@@ -1 +1,288 @@
+#include "Network.hpp"
 
+#include "../logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Engine {
+    namespace {
+        /** Receive buffer asked of the kernel, enough to absorb a burst from hundreds of clients between updates. */
+        constexpr int SOCKET_BUFFER_BYTES = 4 * 1024 * 1024;
+        /** Datagrams per sendmmsg()/recvmmsg() call. */
+        constexpr uint32_t SYSCALL_BATCH = 64;
+
+#ifdef _WIN32
+        using SocketHandle = SOCKET;
+        using SocketLength = int;
+
+        void initializeSockets() {
+            static std::once_flag s_once;
+            std::call_once(s_once, [] {
+                WSADATA data;
+                WSAStartup(MAKEWORD(2, 2), &data);
+            });
+        }
+
+        bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+        void closeHandle(SocketHandle p_handle) { closesocket(p_handle); }
+#else
+        using SocketHandle = int;
+        using SocketLength = socklen_t;
+
+        void initializeSockets() {}
+        bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+        void closeHandle(SocketHandle p_handle) { ::close(p_handle); }
+#endif
+
+        sockaddr_in toSockaddr(const NetAddress &p_address) {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(p_address.host);
+            address.sin_port = htons(p_address.port);
+            return address;
+        }
+
+        NetAddress fromSockaddr(const sockaddr_in &p_address) {
+            return { ntohl(p_address.sin_addr.s_addr), ntohs(p_address.sin_port) };
+        }
+    }
+
+    std::optional<NetAddress> NetAddress::parse(std::string_view p_text) {
+        NetAddress address;
+        const char *cursor = p_text.data();
+        const char *end = p_text.data() + p_text.size();
+
+        for (int part = 0; part < 4; part++) {
+            uint32_t value = 0;
+            const std::from_chars_result result = std::from_chars(cursor, end, value);
+            if (result.ec != std::errc() || value > 255) {
+                return std::nullopt;
+            }
+            address.host = address.host << 8 | value;
+            cursor = result.ptr;
+            if (part < 3) {
+                if (cursor == end || *cursor != '.') {
+                    return std::nullopt;
+                }
+                cursor++;
+            }
+        }
+
+        if (cursor != end) {
+            if (*cursor != ':') {
+                return std::nullopt;
+            }
+            const std::from_chars_result result = std::from_chars(cursor + 1, end, address.port);
+            if (result.ec != std::errc() || result.ptr != end) {
+                return std::nullopt;
+            }
+        }
+        return address;
+    }
+
+    std::string NetAddress::toString() const {
+        return std::to_string(host >> 24) + "." + std::to_string(host >> 16 & 0xff) + "." + std::to_string(host >> 8 & 0xff) + "." +
+                std::to_string(host & 0xff) + ":" + std::to_string(port);
+    }
+
+    UdpSocket::~UdpSocket() {
+        close();
+    }
+
+    UdpSocket::UdpSocket(UdpSocket &&p_other) noexcept :
+            m_handle(p_other.m_handle), m_syscalls(p_other.m_syscalls) {
+        p_other.m_handle = INVALID_HANDLE;
+    }
+
+    UdpSocket &UdpSocket::operator=(UdpSocket &&p_other) noexcept {
+        if (this != &p_other) {
+            close();
+            m_handle = p_other.m_handle;
+            m_syscalls = p_other.m_syscalls;
+            p_other.m_handle = INVALID_HANDLE;
+        }
+        return *this;
+    }
+
+    bool UdpSocket::open(const NetAddress &p_bind) {
+        close();
+        initializeSockets();
+
+        const SocketHandle handle = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+        if (handle == INVALID_SOCKET) {
+#else
+        if (handle < 0) {
+#endif
+            ENGINE_CLOG_ERROR(Net, "Net: cannot create a UDP socket")
+            return false;
+        }
+
+        const int bufferBytes = SOCKET_BUFFER_BYTES;
+        setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char *>(&bufferBytes), sizeof(bufferBytes));
+        setsockopt(handle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char *>(&bufferBytes), sizeof(bufferBytes));
+
+        const sockaddr_in address = toSockaddr(p_bind);
+        if (::bind(handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            ENGINE_CLOG_ERROR(Net, "Net: cannot bind UDP socket to {}", p_bind.toString())
+            closeHandle(handle);
+            return false;
+        }
+
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        const bool configured = ioctlsocket(handle, FIONBIO, &nonBlocking) == 0;
+#else
+        const bool configured = fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+        if (!configured) {
+            ENGINE_CLOG_ERROR(Net, "Net: cannot make UDP socket non-blocking")
+            closeHandle(handle);
+            return false;
+        }
+
+        m_handle = static_cast<intptr_t>(handle);
+        return true;
+    }
+
+    void UdpSocket::close() {
+        if (isOpen()) {
+            closeHandle(static_cast<SocketHandle>(m_handle));
+            m_handle = INVALID_HANDLE;
+        }
+    }
+
+    NetAddress UdpSocket::localAddress() const {
+        sockaddr_in address{};
+        SocketLength length = sizeof(address);
+        if (!isOpen() || getsockname(static_cast<SocketHandle>(m_handle), reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+            return {};
+        }
+        return fromSockaddr(address);
+    }
+
+    uint32_t UdpSocket::sendBatch(std::span<const Datagram> p_datagrams) {
+        if (!isOpen()) {
+            return 0;
+        }
+
+        const SocketHandle handle = static_cast<SocketHandle>(m_handle);
+        uint32_t sent = 0;
+#ifdef __linux__
+        while (sent < p_datagrams.size()) {
+            const uint32_t count = std::min<uint32_t>(SYSCALL_BATCH, static_cast<uint32_t>(p_datagrams.size()) - sent);
+            mmsghdr messages[SYSCALL_BATCH];
+            iovec buffers[SYSCALL_BATCH];
+            sockaddr_in addresses[SYSCALL_BATCH];
+
+            for (uint32_t i = 0; i < count; i++) {
+                const Datagram &datagram = p_datagrams[sent + i];
+                addresses[i] = toSockaddr(datagram.address);
+                buffers[i] = { const_cast<uint8_t *>(datagram.data), datagram.size };
+                messages[i] = {};
+                messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = &buffers[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            m_syscalls++;
+            const int result = sendmmsg(handle, messages, count, 0);
+            if (result <= 0) {
+                if (result < 0 && !wouldBlock()) {
+                    ENGINE_CLOG_WARNING(Net, "Net: sendmmsg failed (errno {})", errno)
+                }
+                break;
+            }
+            sent += static_cast<uint32_t>(result);
+            if (static_cast<uint32_t>(result) < count) {
+                break;
+            }
+        }
+#else
+        for (; sent < p_datagrams.size(); sent++) {
+            const Datagram &datagram = p_datagrams[sent];
+            const sockaddr_in address = toSockaddr(datagram.address);
+            m_syscalls++;
+            if (::sendto(handle, reinterpret_cast<const char *>(datagram.data), static_cast<int>(datagram.size), 0,
+                        reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) {
+                break;
+            }
+        }
+#endif
+        return sent;
+    }
+
+    uint32_t UdpSocket::receiveBatch(std::span<Datagram> p_datagrams) {
+        if (!isOpen()) {
+            return 0;
+        }
+
+        const SocketHandle handle = static_cast<SocketHandle>(m_handle);
+        uint32_t received = 0;
+#ifdef __linux__
+        while (received < p_datagrams.size()) {
+            const uint32_t count = std::min<uint32_t>(SYSCALL_BATCH, static_cast<uint32_t>(p_datagrams.size()) - received);
+            mmsghdr messages[SYSCALL_BATCH];
+            iovec buffers[SYSCALL_BATCH];
+            sockaddr_in addresses[SYSCALL_BATCH];
+
+            for (uint32_t i = 0; i < count; i++) {
+                buffers[i] = { p_datagrams[received + i].data, NET_MAX_DATAGRAM };
+                messages[i] = {};
+                messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = &buffers[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            m_syscalls++;
+            const int result = recvmmsg(handle, messages, count, MSG_DONTWAIT, nullptr);
+            if (result <= 0) {
+                break;
+            }
+
+            for (int i = 0; i < result; i++) {
+                Datagram &datagram = p_datagrams[received + i];
+                datagram.address = fromSockaddr(addresses[i]);
+                /** Truncated datagrams are not ours, an empty one is dropped by the parser. */
+                datagram.size = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : messages[i].msg_len;
+            }
+            received += static_cast<uint32_t>(result);
+            if (static_cast<uint32_t>(result) < count) {
+                break;
+            }
+        }
+#else
+        for (; received < p_datagrams.size(); received++) {
+            Datagram &datagram = p_datagrams[received];
+            sockaddr_in address{};
+            SocketLength length = sizeof(address);
+            m_syscalls++;
+            const int result = ::recvfrom(handle, reinterpret_cast<char *>(datagram.data), NET_MAX_DATAGRAM, 0,
+                                          reinterpret_cast<sockaddr *>(&address), &length);
+            if (result < 0) {
+                break;
+            }
+            datagram.address = fromSockaddr(address);
+            datagram.size = static_cast<uint32_t>(result);
+        }
+#endif
+        return received;
+    }
+}
@@ -1 +1,83 @@
+#ifndef __ENGINE_NETWORK_HPP__
+#define __ENGINE_NETWORK_HPP__
 
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Engine {
+    /** Largest datagram the transport sends, below the usual path MTU so nothing fragments at the IP level. */
+    inline constexpr uint32_t NET_MAX_DATAGRAM = 1200;
+
+    /** IPv4 endpoint, host and port in host byte order. */
+    struct NetAddress {
+        uint32_t host = 0;
+        uint16_t port = 0;
+
+        static NetAddress loopback(uint16_t p_port) { return { 0x7f000001, p_port }; }
+        static NetAddress any(uint16_t p_port) { return { 0, p_port }; }
+
+        /** "a.b.c.d:port", the port being optional. */
+        static std::optional<NetAddress> parse(std::string_view p_text);
+
+        std::string toString() const;
+
+        /** Unique per endpoint, for hashing. */
+        uint64_t key() const { return static_cast<uint64_t>(host) << 16 | port; }
+
+        bool operator==(const NetAddress &p_other) const { return host == p_other.host && port == p_other.port; }
+        bool operator!=(const NetAddress &p_other) const { return !(*this == p_other); }
+    };
+
+    struct Datagram {
+        NetAddress address;
+        uint32_t size = 0;
+        uint8_t data[NET_MAX_DATAGRAM];
+
+        std::span<const uint8_t> bytes() const { return { data, size }; }
+    };
+
+    /**
+     * Non-blocking UDP socket with batched I/O.
+     *
+     * On Linux a batch costs one sendmmsg()/recvmmsg() call, elsewhere it falls back to one
+     * sendto()/recvfrom() per datagram. syscalls() counts the calls made, which together with
+     * the datagram counts of the transport gives the per-packet kernel cost.
+     */
+    class UdpSocket {
+    public:
+        UdpSocket() = default;
+        ~UdpSocket();
+
+        UdpSocket(const UdpSocket &) = delete;
+        UdpSocket &operator=(const UdpSocket &) = delete;
+
+        UdpSocket(UdpSocket &&p_other) noexcept;
+        UdpSocket &operator=(UdpSocket &&p_other) noexcept;
+
+        /** Port 0 lets the system pick one, see localAddress(). */
+        bool open(const NetAddress &p_bind);
+        void close();
+        bool isOpen() const { return m_handle != INVALID_HANDLE; }
+
+        NetAddress localAddress() const;
+
+        /** Returns how many of `p_datagrams` were handed to the kernel, stopping at the first refusal. */
+        uint32_t sendBatch(std::span<const Datagram> p_datagrams);
+
+        /** Fills up to `p_datagrams.size()` entries and returns how many, 0 when nothing is pending. */
+        uint32_t receiveBatch(std::span<Datagram> p_datagrams);
+
+        uint64_t syscalls() const { return m_syscalls; }
+
+    private:
+        static constexpr intptr_t INVALID_HANDLE = -1;
+
+        intptr_t m_handle = INVALID_HANDLE;
+        uint64_t m_syscalls = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "PacketSimulator.hpp"
+
+#include "../logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <string_view>
+
+namespace Engine {
+    namespace {
+        bool laterThan(const auto &p_a, const auto &p_b) {
+            return p_a.due != p_b.due ? p_a.due > p_b.due : p_a.order > p_b.order;
+        }
+    }
+
+    PacketSimulatorConfig PacketSimulatorConfig::fromEnvironment() {
+        PacketSimulatorConfig config;
+        const char *value = std::getenv("ENGINE_NET_SIMULATE");
+        if (!value) {
+            return config;
+        }
+
+        std::string_view text(value);
+        while (!text.empty()) {
+            const size_t comma = text.find(',');
+            const std::string_view entry = text.substr(0, comma);
+            text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+            const size_t equals = entry.find('=');
+            double number = 0.0;
+            const std::string_view key = entry.substr(0, equals);
+            const std::string_view digits = equals == std::string_view::npos ? std::string_view() : entry.substr(equals + 1);
+            const std::from_chars_result result = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+            if (digits.empty() || result.ec != std::errc() || result.ptr != digits.data() + digits.size() || number < 0.0) {
+                ENGINE_CLOG_WARNING(Net, "Ignoring ENGINE_NET_SIMULATE entry \"{}\", expected key=number", entry)
+                continue;
+            }
+
+            if (key == "loss") {
+                config.loss = std::min(number / 100.0, 1.0);
+            } else if (key == "duplicate") {
+                config.duplicate = std::min(number / 100.0, 1.0);
+            } else if (key == "latency") {
+                config.latencySeconds = number / 1000.0;
+            } else if (key == "jitter") {
+                config.jitterSeconds = number / 1000.0;
+            } else {
+                ENGINE_CLOG_WARNING(Net, "Ignoring ENGINE_NET_SIMULATE entry \"{}\", expected loss, duplicate, latency or jitter", entry)
+            }
+        }
+        return config;
+    }
+
+    PacketSimulator::PacketSimulator(const PacketSimulatorConfig &p_config, uint64_t p_seed) :
+            m_config(p_config), m_random(p_seed) {}
+
+    void PacketSimulator::submit(std::span<const Datagram> p_datagrams, double p_time) {
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        for (const Datagram &datagram : p_datagrams) {
+            if (unit(m_random) < m_config.loss) {
+                m_dropped++;
+                continue;
+            }
+
+            const int copies = unit(m_random) < m_config.duplicate ? 2 : 1;
+            for (int copy = 0; copy < copies; copy++) {
+                push(datagram, p_time + m_config.latencySeconds + unit(m_random) * m_config.jitterSeconds);
+            }
+        }
+    }
+
+    void PacketSimulator::flush(UdpSocket &p_socket, double p_time) {
+        m_due.clear();
+        while (!m_queue.empty() && m_queue.front().due <= p_time) {
+            std::pop_heap(m_queue.begin(), m_queue.end(), [](const Delayed &p_a, const Delayed &p_b) { return laterThan(p_a, p_b); });
+            m_due.push_back(m_queue.back().datagram);
+            m_queue.pop_back();
+        }
+
+        if (!m_due.empty()) {
+            /** A full kernel buffer loses the rest, as a congested link would. */
+            m_dropped += m_due.size() - p_socket.sendBatch(m_due);
+        }
+    }
+
+    void PacketSimulator::push(const Datagram &p_datagram, double p_due) {
+        m_queue.push_back({ p_due, m_order++, p_datagram });
+        std::push_heap(m_queue.begin(), m_queue.end(), [](const Delayed &p_a, const Delayed &p_b) { return laterThan(p_a, p_b); });
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef __ENGINE_PACKET_SIMULATOR_HPP__
+#define __ENGINE_PACKET_SIMULATOR_HPP__
+
+#include "Network.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace Engine {
+    struct PacketSimulatorConfig {
+        /** Probabilities in [0, 1]. */
+        double loss = 0.0;
+        double duplicate = 0.0;
+        /** One-way delay added to every datagram, plus a uniform random [0, jitter]. */
+        double latencySeconds = 0.0;
+        double jitterSeconds = 0.0;
+
+        bool isActive() const { return loss > 0.0 || duplicate > 0.0 || latencySeconds > 0.0 || jitterSeconds > 0.0; }
+
+        /**
+         * Reads ENGINE_NET_SIMULATE, e.g. "loss=5,latency=80,jitter=20,duplicate=1" with
+         * percentages and milliseconds. Unset means a perfect link.
+         */
+        static PacketSimulatorConfig fromEnvironment();
+    };
+
+    /**
+     * Bad network in a box for loopback testing: sits in front of a socket's send path and
+     * drops, delays, reorders (through jitter) and duplicates outgoing datagrams.
+     *
+     * Put one on each side of a loopback connection to simulate both directions. The random
+     * generator is seeded explicitly so a failing run can be replayed.
+     */
+    class PacketSimulator {
+    public:
+        explicit PacketSimulator(const PacketSimulatorConfig &p_config = {}, uint64_t p_seed = 1);
+
+        const PacketSimulatorConfig &config() const { return m_config; }
+        void setConfig(const PacketSimulatorConfig &p_config) { m_config = p_config; }
+
+        /** Queues the datagrams that survive the loss roll, due at `p_time` plus their delay. */
+        void submit(std::span<const Datagram> p_datagrams, double p_time);
+
+        /** Hands the datagrams due at `p_time` to the socket in one batch. */
+        void flush(UdpSocket &p_socket, double p_time);
+
+        uint64_t dropped() const { return m_dropped; }
+        uint32_t inFlight() const { return static_cast<uint32_t>(m_queue.size()); }
+
+    private:
+        struct Delayed {
+            double due;
+            /** Tie-breaker keeping datagrams with the same due time in submission order. */
+            uint64_t order;
+            Datagram datagram;
+        };
+
+        PacketSimulatorConfig m_config;
+        std::mt19937_64 m_random;
+        /** Min-heap on (due, order). */
+        std::vector<Delayed> m_queue;
+        std::vector<Datagram> m_due;
+        uint64_t m_order = 0;
+        uint64_t m_dropped = 0;
+
+        void push(const Datagram &p_datagram, double p_due);
+    };
+}
+
+#endif
@@ -0,0 +1,185 @@
+#include "Snapshot.hpp"
+
+#include <cstring>
+
+namespace Engine {
+    namespace {
+        const SnapshotEntity ZERO_ENTITY;
+    }
+
+    bool SnapshotEncoder::encode(std::span<const SnapshotEntity> p_entities, ByteWriter &p_writer) {
+        const uint32_t id = m_nextId;
+        const bool hasBaseline = usableBaseline();
+        static const std::vector<SnapshotEntity> s_empty;
+        const std::vector<SnapshotEntity> &baseline = hasBaseline ? m_history[m_baselineId % SNAPSHOT_HISTORY].entities : s_empty;
+
+        /** Merge walk of two id-sorted lists. */
+        m_removed.clear();
+        m_updated.clear();
+        m_updatedBases.clear();
+        size_t base = 0;
+        for (size_t i = 0; i < p_entities.size(); i++) {
+            const SnapshotEntity &entity = p_entities[i];
+            if (i > 0 && entity.id <= p_entities[i - 1].id) {
+                return false;
+            }
+
+            while (base < baseline.size() && baseline[base].id < entity.id) {
+                m_removed.push_back(baseline[base++].id);
+            }
+
+            if (base < baseline.size() && baseline[base].id == entity.id) {
+                const SnapshotEntity &previous = baseline[base++];
+                if (std::memcmp(previous.words, entity.words, sizeof(entity.words)) != 0) {
+                    m_updated.push_back(static_cast<uint32_t>(i));
+                    m_updatedBases.push_back(&previous);
+                }
+            } else {
+                m_updated.push_back(static_cast<uint32_t>(i));
+                m_updatedBases.push_back(&ZERO_ENTITY);
+            }
+        }
+        while (base < baseline.size()) {
+            m_removed.push_back(baseline[base++].id);
+        }
+
+        const size_t start = p_writer.size();
+        p_writer.writeVarU32(id);
+        p_writer.writeVarU32(hasBaseline ? id - m_baselineId : 0);
+
+        p_writer.writeVarU32(static_cast<uint32_t>(m_removed.size()));
+        uint32_t previousId = 0;
+        for (uint32_t removed : m_removed) {
+            p_writer.writeVarU32(removed - previousId);
+            previousId = removed;
+        }
+
+        p_writer.writeVarU32(static_cast<uint32_t>(m_updated.size()));
+        previousId = 0;
+        for (size_t i = 0; i < m_updated.size(); i++) {
+            const SnapshotEntity &entity = p_entities[m_updated[i]];
+            const SnapshotEntity &previous = *m_updatedBases[i];
+
+            uint8_t mask = 0;
+            for (uint32_t word = 0; word < SNAPSHOT_ENTITY_WORDS; word++) {
+                mask |= (entity.words[word] != previous.words[word]) << word;
+            }
+
+            p_writer.writeVarU32(entity.id - previousId);
+            p_writer.writeU8(mask);
+            for (uint32_t word = 0; word < SNAPSHOT_ENTITY_WORDS; word++) {
+                if (mask >> word & 1) {
+                    p_writer.writeVarS32(static_cast<int32_t>(entity.words[word] - previous.words[word]));
+                }
+            }
+            previousId = entity.id;
+        }
+
+        if (p_writer.overflowed()) {
+            p_writer.truncate(start);
+            return false;
+        }
+
+        Stored &stored = m_history[id % SNAPSHOT_HISTORY];
+        stored.id = id;
+        stored.entities.assign(p_entities.begin(), p_entities.end());
+        m_nextId++;
+        return true;
+    }
+
+    std::span<const SnapshotEntity> SnapshotEncoder::baseline() const {
+        if (!usableBaseline()) {
+            return {};
+        }
+        return m_history[m_baselineId % SNAPSHOT_HISTORY].entities;
+    }
+
+    bool SnapshotEncoder::usableBaseline() const {
+        return m_baselineId != 0 && m_nextId - m_baselineId < SNAPSHOT_HISTORY &&
+                m_history[m_baselineId % SNAPSHOT_HISTORY].id == m_baselineId;
+    }
+
+    void SnapshotEncoder::acknowledge(uint32_t p_id) {
+        if (p_id > m_baselineId && p_id < m_nextId && m_history[p_id % SNAPSHOT_HISTORY].id == p_id) {
+            m_baselineId = p_id;
+        }
+    }
+
+    const std::vector<SnapshotEntity> *SnapshotDecoder::decode(ByteReader &p_reader) {
+        const uint32_t id = p_reader.readVarU32();
+        const uint32_t baselineAge = p_reader.readVarU32();
+        if (p_reader.failed() || id == 0 || id <= m_latestId || baselineAge >= SNAPSHOT_HISTORY || baselineAge > id) {
+            return nullptr;
+        }
+
+        static const std::vector<SnapshotEntity> s_empty;
+        const uint32_t baselineId = id - baselineAge;
+        if (baselineAge != 0 && m_history[baselineId % SNAPSHOT_HISTORY].id != baselineId) {
+            return nullptr;
+        }
+        const std::vector<SnapshotEntity> &baseline = baselineAge != 0 ? m_history[baselineId % SNAPSHOT_HISTORY].entities : s_empty;
+
+        const uint32_t removedCount = p_reader.readVarU32();
+        if (removedCount > baseline.size()) {
+            return nullptr;
+        }
+        m_removed.clear();
+        uint32_t previousId = 0;
+        for (uint32_t i = 0; i < removedCount; i++) {
+            previousId += p_reader.readVarU32();
+            m_removed.push_back(previousId);
+        }
+
+        /** The baseline slot is never the one written, the age is below the history size. */
+        Stored &stored = m_history[id % SNAPSHOT_HISTORY];
+        stored.id = 0;
+        std::vector<SnapshotEntity> &entities = stored.entities;
+        entities.clear();
+
+        size_t base = 0;
+        size_t removed = 0;
+        auto copyBaselineBelow = [&](uint64_t p_id) {
+            for (; base < baseline.size() && baseline[base].id < p_id; base++) {
+                while (removed < m_removed.size() && m_removed[removed] < baseline[base].id) {
+                    removed++;
+                }
+                if (removed < m_removed.size() && m_removed[removed] == baseline[base].id) {
+                    continue;
+                }
+                entities.push_back(baseline[base]);
+            }
+        };
+
+        const uint32_t updatedCount = p_reader.readVarU32();
+        previousId = 0;
+        for (uint32_t i = 0; i < updatedCount && !p_reader.failed(); i++) {
+            const uint32_t delta = p_reader.readVarU32();
+            if (i > 0 && delta == 0) {
+                return nullptr;
+            }
+            const uint32_t entityId = previousId + delta;
+            previousId = entityId;
+
+            copyBaselineBelow(entityId);
+            SnapshotEntity entity = base < baseline.size() && baseline[base].id == entityId ? baseline[base++] : ZERO_ENTITY;
+            entity.id = entityId;
+
+            const uint8_t mask = p_reader.readU8();
+            for (uint32_t word = 0; word < SNAPSHOT_ENTITY_WORDS; word++) {
+                if (mask >> word & 1) {
+                    entity.words[word] += static_cast<uint32_t>(p_reader.readVarS32());
+                }
+            }
+            entities.push_back(entity);
+        }
+        copyBaselineBelow(UINT64_MAX);
+
+        if (p_reader.failed()) {
+            return nullptr;
+        }
+
+        stored.id = id;
+        m_latestId = id;
+        return &entities;
+    }
+}
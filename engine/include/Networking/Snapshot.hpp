@@ -0,0 +1,94 @@
+#ifndef __ENGINE_SNAPSHOT_HPP__
+#define __ENGINE_SNAPSHOT_HPP__
+
+#include "ByteStream.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Engine {
+    inline constexpr uint32_t SNAPSHOT_ENTITY_WORDS = 8;
+
+    /**
+     * Replicated state of one entity. The game quantizes its fields into integer words
+     * (fixed-point positions, angles in 1/65536 turn, packed flags) so that the change between
+     * two snapshots is a small integer.
+     */
+    struct SnapshotEntity {
+        uint32_t id = 0;
+        uint32_t words[SNAPSHOT_ENTITY_WORDS] = {};
+    };
+
+    /** Snapshots older than this many encodes can no longer serve as a baseline. */
+    inline constexpr uint32_t SNAPSHOT_HISTORY = 32;
+
+    /**
+     * Server side of the delta-compressed entity snapshots sent to one client.
+     *
+     * Every snapshot is encoded against the newest one the client acknowledged (it echoes
+     * SnapshotDecoder::latestId() back, e.g. with its input). Entities identical to the
+     * baseline cost nothing, changed ones cost their id delta, a mask of the changed words
+     * and one zigzag varint per changed word; removed ones cost their id delta. Without a
+     * usable baseline, after loss longer than the history, the snapshot is sent in full.
+     */
+    class SnapshotEncoder {
+    public:
+        /**
+         * Appends a snapshot of `p_entities`, which must be sorted by id without duplicates.
+         * Returns false and leaves the writer unchanged when it does not fit.
+         */
+        bool encode(std::span<const SnapshotEntity> p_entities, ByteWriter &p_writer);
+
+        /** The client received snapshot `p_id`, it becomes the baseline if it is newer than the current one. */
+        void acknowledge(uint32_t p_id);
+
+        uint32_t baselineId() const { return m_baselineId; }
+
+        /** Entities of the current baseline, what the client is known to hold; empty without one. */
+        std::span<const SnapshotEntity> baseline() const;
+
+    private:
+        struct Stored {
+            uint32_t id = 0;
+            std::vector<SnapshotEntity> entities;
+        };
+
+        Stored m_history[SNAPSHOT_HISTORY];
+        uint32_t m_nextId = 1;
+        /** 0 when there is none. */
+        uint32_t m_baselineId = 0;
+
+        std::vector<uint32_t> m_removed;
+        std::vector<const SnapshotEntity *> m_updatedBases;
+        std::vector<uint32_t> m_updated;
+
+        /** The acknowledged snapshot is still in the history and within reach of the next id. */
+        bool usableBaseline() const;
+    };
+
+    /** Client side, rebuilds the full entity list of every snapshot from the stream. */
+    class SnapshotDecoder {
+    public:
+        /**
+         * Decodes one snapshot, returning its entities sorted by id. Null when the data is
+         * malformed, the baseline was already dropped or the snapshot is older than latestId().
+         */
+        const std::vector<SnapshotEntity> *decode(ByteReader &p_reader);
+
+        /** Newest snapshot decoded, 0 before the first one. */
+        uint32_t latestId() const { return m_latestId; }
+
+    private:
+        struct Stored {
+            uint32_t id = 0;
+            std::vector<SnapshotEntity> entities;
+        };
+
+        Stored m_history[SNAPSHOT_HISTORY];
+        uint32_t m_latestId = 0;
+        std::vector<uint32_t> m_removed;
+    };
+}
+
+#endif
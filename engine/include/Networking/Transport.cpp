@@ -0,0 +1,550 @@
+#include "Transport.hpp"
+
+#include "ByteStream.hpp"
+#include "../logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Engine {
+    namespace {
+        /** Datagrams read per receiveBatch() call. */
+        constexpr uint32_t RECEIVE_BATCH = 64;
+        /** Floor of the resend delay, the actual one follows the round trip. */
+        constexpr double RESEND_MIN_SECONDS = 0.03;
+        /** Disconnect packets are not acknowledged, a few copies make it likely one arrives. */
+        constexpr int DISCONNECT_COPIES = 3;
+
+        bool sequenceGreater(uint16_t p_a, uint16_t p_b) {
+            return static_cast<int16_t>(p_a - p_b) > 0;
+        }
+
+        class CpuTimer {
+        public:
+            explicit CpuTimer(double &p_total) :
+                    m_total(p_total), m_start(std::chrono::steady_clock::now()) {}
+            ~CpuTimer() { m_total += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(); }
+
+        private:
+            double &m_total;
+            std::chrono::steady_clock::time_point m_start;
+        };
+    }
+
+    NetTransport::NetTransport(const NetTransportConfig &p_config) :
+            m_config(p_config), m_simulator(p_config.simulator, p_config.simulatorSeed), m_random(std::random_device()()) {
+        m_incoming.resize(RECEIVE_BATCH);
+    }
+
+    NetTransport::~NetTransport() = default;
+
+    bool NetTransport::listen(const NetAddress &p_bind) {
+        if (!m_socket.open(p_bind)) {
+            return false;
+        }
+        m_listening = true;
+        ENGINE_CLOG_INFO(Net, "Net: listening on {}", m_socket.localAddress().toString())
+        return true;
+    }
+
+    ConnectionId NetTransport::connect(const NetAddress &p_server, const NetAddress &p_bind) {
+        if (!m_socket.isOpen() && !m_socket.open(p_bind)) {
+            return INVALID_CONNECTION;
+        }
+        /** Zero is never a valid salt, which keeps a zeroed datagram from matching anything. */
+        return allocateConnection(p_server, m_random() | 1, State::Connecting);
+    }
+
+    void NetTransport::disconnect(ConnectionId p_connection) {
+        Connection *target = connection(p_connection);
+        if (!target) {
+            return;
+        }
+        for (int copy = 0; copy < DISCONNECT_COPIES; copy++) {
+            sendControl(*target, PacketType::Disconnect);
+        }
+        freeConnection(p_connection, false);
+    }
+
+    bool NetTransport::send(ConnectionId p_connection, NetChannel p_channel, std::span<const uint8_t> p_payload) {
+        Connection *target = connection(p_connection);
+        if (!target || target->state != State::Connected) {
+            return false;
+        }
+        if (p_payload.size() > MAX_MESSAGE_SIZE) {
+            ENGINE_CLOG_ERROR(Net, "Net: message of {} bytes exceeds the {} byte limit", p_payload.size(), MAX_MESSAGE_SIZE)
+            return false;
+        }
+
+        if (p_channel == NetChannel::Unreliable) {
+            uint8_t length[5];
+            ByteWriter writer(length, sizeof(length));
+            writer.writeVarU32(static_cast<uint32_t>(p_payload.size()));
+            target->unreliable.insert(target->unreliable.end(), length, length + writer.size());
+            target->unreliable.insert(target->unreliable.end(), p_payload.begin(), p_payload.end());
+            return true;
+        }
+
+        if (target->backlog.empty() && static_cast<uint16_t>(target->nextReliableId - target->oldestUnacked) < RELIABLE_WINDOW) {
+            OutgoingReliable &message = target->outgoing[target->nextReliableId % RELIABLE_WINDOW];
+            message.used = true;
+            message.id = target->nextReliableId++;
+            message.lastSent = -1.0;
+            message.payload.assign(p_payload.begin(), p_payload.end());
+        } else {
+            target->backlog.emplace_back(p_payload.begin(), p_payload.end());
+        }
+        return true;
+    }
+
+    void NetTransport::receive(double p_time) {
+        CpuTimer timer(m_statistics.cpuSeconds);
+
+        /** The previous events are gone, events queued by flush() (disconnections) have no payload and stay. */
+        m_eventBytes.clear();
+
+        if (m_simulator.config().isActive()) {
+            m_simulator.flush(m_socket, p_time);
+        }
+
+        for (;;) {
+            const uint32_t count = m_socket.receiveBatch(m_incoming);
+            for (uint32_t i = 0; i < count; i++) {
+                handleDatagram(m_incoming[i], p_time);
+            }
+            if (count < m_incoming.size()) {
+                break;
+            }
+        }
+
+        m_events.clear();
+        for (const PendingEvent &pending : m_pendingEvents) {
+            m_events.push_back({ pending.type, pending.connection, pending.channel,
+                                 std::span<const uint8_t>(m_eventBytes.data() + pending.offset, pending.size) });
+        }
+        m_pendingEvents.clear();
+    }
+
+    void NetTransport::flush(double p_time) {
+        CpuTimer timer(m_statistics.cpuSeconds);
+
+        for (ConnectionId id = 0; id < m_connections.size(); id++) {
+            Connection &current = *m_connections[id];
+            if (current.state == State::Free) {
+                continue;
+            }
+
+            if (current.lastReceive < 0.0) {
+                current.lastReceive = p_time;
+            }
+            if (p_time - current.lastReceive > m_config.timeoutSeconds) {
+                ENGINE_CLOG_INFO(Net, "Net: connection {} to {} timed out", id, current.address.toString())
+                freeConnection(id, true);
+                continue;
+            }
+
+            if (current.state == State::Connecting) {
+                if (current.lastConnectAttempt < 0.0 || p_time - current.lastConnectAttempt >= m_config.connectRetrySeconds) {
+                    sendControl(current, PacketType::ConnectRequest);
+                    current.lastConnectAttempt = p_time;
+                }
+                continue;
+            }
+
+            flushConnection(current, p_time);
+        }
+
+        sendOutgoing(p_time);
+    }
+
+    bool NetTransport::isConnected(ConnectionId p_connection) const {
+        const Connection *target = connection(p_connection);
+        return target && target->state == State::Connected;
+    }
+
+    NetAddress NetTransport::remoteAddress(ConnectionId p_connection) const {
+        const Connection *target = connection(p_connection);
+        return target ? target->address : NetAddress();
+    }
+
+    const NetConnectionStatistics *NetTransport::connectionStatistics(ConnectionId p_connection) const {
+        const Connection *target = connection(p_connection);
+        return target ? &target->statistics : nullptr;
+    }
+
+    NetTransportStatistics NetTransport::statistics() const {
+        NetTransportStatistics statistics = m_statistics;
+        statistics.syscalls = m_socket.syscalls();
+        return statistics;
+    }
+
+    ConnectionId NetTransport::allocateConnection(const NetAddress &p_address, uint32_t p_salt, State p_state) {
+        ConnectionId id = INVALID_CONNECTION;
+        for (ConnectionId i = 0; i < m_connections.size(); i++) {
+            if (m_connections[i]->state == State::Free) {
+                id = i;
+                break;
+            }
+        }
+        if (id == INVALID_CONNECTION) {
+            if (m_connections.size() >= m_config.maxConnections) {
+                return INVALID_CONNECTION;
+            }
+            id = static_cast<ConnectionId>(m_connections.size());
+            m_connections.push_back(std::make_unique<Connection>());
+        }
+
+        Connection &created = *m_connections[id];
+        created.state = p_state;
+        created.address = p_address;
+        created.salt = p_salt;
+        created.lastReceive = -1.0;
+        m_connectionsByAddress[p_address.key()] = id;
+        m_connectionCount++;
+        return id;
+    }
+
+    void NetTransport::freeConnection(ConnectionId p_connection, bool p_notify) {
+        Connection &freed = *m_connections[p_connection];
+        m_connectionsByAddress.erase(freed.address.key());
+        freed = Connection();
+        m_connectionCount--;
+
+        if (p_notify) {
+            pushEvent(NetEventType::Disconnected, p_connection, NetChannel::Unreliable, {});
+        }
+    }
+
+    NetTransport::Connection *NetTransport::connection(ConnectionId p_connection) const {
+        if (p_connection >= m_connections.size() || m_connections[p_connection]->state == State::Free) {
+            return nullptr;
+        }
+        return m_connections[p_connection].get();
+    }
+
+    void NetTransport::handleDatagram(const Datagram &p_datagram, double p_time) {
+        ByteReader reader(p_datagram.bytes());
+        const uint32_t protocolId = reader.readU32();
+        const PacketType type = static_cast<PacketType>(reader.readU8());
+        const uint32_t salt = reader.readU32();
+        if (reader.failed() || protocolId != m_config.protocolId || salt == 0) {
+            return;
+        }
+
+        m_statistics.packetsReceived++;
+        m_statistics.bytesReceived += p_datagram.size;
+
+        const auto found = m_connectionsByAddress.find(p_datagram.address.key());
+        ConnectionId id = found != m_connectionsByAddress.end() ? found->second : INVALID_CONNECTION;
+        Connection *source = id != INVALID_CONNECTION ? m_connections[id].get() : nullptr;
+
+        if (type == PacketType::ConnectRequest) {
+            if (!m_listening) {
+                return;
+            }
+            if (source && source->salt == salt) {
+                /** Our accept got lost. */
+                sendControl(*source, PacketType::ConnectAccept);
+                return;
+            }
+            if (source) {
+                /** Same address, new salt: the client restarted before its old connection timed out. */
+                freeConnection(id, true);
+            }
+
+            id = allocateConnection(p_datagram.address, salt, State::Connected);
+            if (id == INVALID_CONNECTION) {
+                ENGINE_CLOG_WARNING(Net, "Net: refusing {}, all {} connection slots are in use", p_datagram.address.toString(), m_config.maxConnections)
+                return;
+            }
+            Connection &accepted = *m_connections[id];
+            accepted.lastReceive = p_time;
+            sendControl(accepted, PacketType::ConnectAccept);
+            pushEvent(NetEventType::Connected, id, NetChannel::Unreliable, {});
+            return;
+        }
+
+        if (!source || source->salt != salt) {
+            return;
+        }
+        source->statistics.bytesReceived += p_datagram.size;
+
+        switch (type) {
+            case PacketType::ConnectAccept:
+                if (source->state == State::Connecting) {
+                    source->state = State::Connected;
+                    source->lastReceive = p_time;
+                    pushEvent(NetEventType::Connected, id, NetChannel::Unreliable, {});
+                }
+                break;
+            case PacketType::Payload:
+                if (source->state == State::Connected) {
+                    handlePayload(id, *source, reader.readBytes(reader.remaining()), p_time);
+                }
+                break;
+            case PacketType::Disconnect:
+                freeConnection(id, true);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void NetTransport::handlePayload(ConnectionId p_id, Connection &p_connection, std::span<const uint8_t> p_body, double p_time) {
+        ByteReader reader(p_body);
+        const uint16_t sequence = reader.readU16();
+        const uint16_t ack = reader.readU16();
+        const uint32_t ackBits = reader.readU32();
+        if (reader.failed()) {
+            return;
+        }
+
+        /** Record the sequence for our acknowledgements, dropping duplicates and packets older than the history. */
+        if (!p_connection.receivedAny) {
+            p_connection.receivedAny = true;
+            p_connection.remoteSequence = sequence;
+            p_connection.remoteAckBits = 0;
+        } else if (sequenceGreater(sequence, p_connection.remoteSequence)) {
+            const uint16_t shift = static_cast<uint16_t>(sequence - p_connection.remoteSequence);
+            if (shift < 32) {
+                p_connection.remoteAckBits = p_connection.remoteAckBits << shift | 1u << (shift - 1);
+            } else {
+                p_connection.remoteAckBits = shift == 32 ? 1u << 31 : 0;
+            }
+            p_connection.remoteSequence = sequence;
+        } else {
+            const uint16_t age = static_cast<uint16_t>(p_connection.remoteSequence - sequence);
+            if (age == 0 || age > 32 || (p_connection.remoteAckBits >> (age - 1) & 1)) {
+                return;
+            }
+            p_connection.remoteAckBits |= 1u << (age - 1);
+        }
+
+        p_connection.lastReceive = p_time;
+        p_connection.statistics.packetsReceived++;
+
+        acknowledge(p_connection, ack, p_time);
+        for (uint32_t bit = 0; bit < 32; bit++) {
+            if (ackBits >> bit & 1) {
+                acknowledge(p_connection, static_cast<uint16_t>(ack - 1 - bit), p_time);
+            }
+        }
+        countLosses(p_connection, ack);
+
+        while (p_connection.oldestUnacked != p_connection.nextReliableId &&
+               !p_connection.outgoing[p_connection.oldestUnacked % RELIABLE_WINDOW].used) {
+            p_connection.oldestUnacked++;
+        }
+
+        while (reader.remaining() > 0) {
+            const NetChannel channel = static_cast<NetChannel>(reader.readU8());
+            const uint16_t id = channel == NetChannel::Reliable ? reader.readU16() : 0;
+            const uint32_t size = reader.readVarU32();
+            const std::span<const uint8_t> payload = reader.readBytes(size);
+            if (reader.failed()) {
+                break;
+            }
+
+            if (channel == NetChannel::Unreliable) {
+                pushEvent(NetEventType::Message, p_id, channel, payload);
+                continue;
+            }
+
+            /** Acknowledge even what we already have, the sender is waiting for it. */
+            p_connection.ackPending = true;
+            if (static_cast<uint16_t>(id - p_connection.nextDelivery) < RELIABLE_WINDOW) {
+                IncomingReliable &slot = p_connection.incoming[id % RELIABLE_WINDOW];
+                if (!slot.used) {
+                    slot.used = true;
+                    slot.payload.assign(payload.begin(), payload.end());
+                }
+            }
+        }
+
+        for (;;) {
+            IncomingReliable &next = p_connection.incoming[p_connection.nextDelivery % RELIABLE_WINDOW];
+            if (!next.used) {
+                break;
+            }
+            pushEvent(NetEventType::Message, p_id, NetChannel::Reliable, next.payload);
+            next.used = false;
+            p_connection.nextDelivery++;
+        }
+    }
+
+    void NetTransport::acknowledge(Connection &p_connection, uint16_t p_sequence, double p_time) {
+        SentPacket &packet = p_connection.sent[p_sequence % SENT_PACKET_WINDOW];
+        if (!packet.used || packet.acked || packet.sequence != p_sequence) {
+            return;
+        }
+
+        packet.acked = true;
+        NetConnectionStatistics &statistics = p_connection.statistics;
+        statistics.packetsAcked++;
+        const double sample = p_time - packet.time;
+        statistics.rttSeconds = statistics.rttSeconds == 0.0 ? sample : statistics.rttSeconds + 0.1 * (sample - statistics.rttSeconds);
+
+        for (uint16_t i = 0; i < packet.reliableCount; i++) {
+            OutgoingReliable &message = p_connection.outgoing[packet.reliableIds[i] % RELIABLE_WINDOW];
+            if (message.used && message.id == packet.reliableIds[i]) {
+                message.used = false;
+                message.payload.clear();
+            }
+        }
+    }
+
+    void NetTransport::countLosses(Connection &p_connection, uint16_t p_ack) {
+        /** The header acknowledges `p_ack` and the 32 before it, anything older still unacknowledged never will be. */
+        const uint16_t horizon = static_cast<uint16_t>(p_ack - 32);
+        if (static_cast<uint16_t>(p_connection.nextSequence - p_connection.lossCursor) > SENT_PACKET_WINDOW) {
+            p_connection.lossCursor = static_cast<uint16_t>(p_connection.nextSequence - SENT_PACKET_WINDOW);
+        }
+
+        while (p_connection.lossCursor != p_connection.nextSequence && sequenceGreater(horizon, p_connection.lossCursor)) {
+            SentPacket &packet = p_connection.sent[p_connection.lossCursor % SENT_PACKET_WINDOW];
+            if (packet.used && !packet.acked && packet.sequence == p_connection.lossCursor) {
+                /** Unused from here on, a late acknowledgement or the next packet in the slot does not count it again. */
+                packet.used = false;
+                p_connection.statistics.packetsLost++;
+            }
+            p_connection.lossCursor++;
+        }
+    }
+
+    void NetTransport::pushEvent(NetEventType p_type, ConnectionId p_connection, NetChannel p_channel, std::span<const uint8_t> p_payload) {
+        m_pendingEvents.push_back({ p_type, p_connection, p_channel, m_eventBytes.size(), p_payload.size() });
+        m_eventBytes.insert(m_eventBytes.end(), p_payload.begin(), p_payload.end());
+    }
+
+    void NetTransport::flushConnection(Connection &p_connection, double p_time) {
+        while (!p_connection.backlog.empty() &&
+               static_cast<uint16_t>(p_connection.nextReliableId - p_connection.oldestUnacked) < RELIABLE_WINDOW) {
+            OutgoingReliable &message = p_connection.outgoing[p_connection.nextReliableId % RELIABLE_WINDOW];
+            message.used = true;
+            message.id = p_connection.nextReliableId++;
+            message.lastSent = -1.0;
+            message.payload.assign(p_connection.backlog.front().begin(), p_connection.backlog.front().end());
+            p_connection.backlog.pop_front();
+        }
+
+        NetConnectionStatistics &statistics = p_connection.statistics;
+        const double resendDelay = std::max(RESEND_MIN_SECONDS, statistics.rttSeconds * 1.25);
+        uint16_t reliableCursor = p_connection.oldestUnacked;
+        size_t unreliableOffset = 0;
+        bool sentAny = false;
+
+        for (;;) {
+            Datagram &datagram = beginDatagram(p_connection, PacketType::Payload);
+            ByteWriter writer(datagram.data + datagram.size, NET_MAX_DATAGRAM - datagram.size);
+
+            const uint16_t sequence = p_connection.nextSequence;
+            writer.writeU16(sequence);
+            writer.writeU16(p_connection.remoteSequence);
+            writer.writeU32(p_connection.remoteAckBits);
+            const size_t headerSize = writer.size();
+
+            SentPacket &packet = p_connection.sent[sequence % SENT_PACKET_WINDOW];
+            const bool overwritesUnacked = packet.used && !packet.acked;
+            packet.reliableCount = 0;
+
+            for (; reliableCursor != p_connection.nextReliableId && packet.reliableCount < MAX_RELIABLE_PER_PACKET; reliableCursor++) {
+                OutgoingReliable &message = p_connection.outgoing[reliableCursor % RELIABLE_WINDOW];
+                if (!message.used || (message.lastSent >= 0.0 && p_time - message.lastSent < resendDelay)) {
+                    continue;
+                }
+
+                const size_t before = writer.size();
+                writer.writeU8(static_cast<uint8_t>(NetChannel::Reliable));
+                writer.writeU16(message.id);
+                writer.writeVarU32(static_cast<uint32_t>(message.payload.size()));
+                writer.writeBytes(message.payload);
+                if (writer.overflowed()) {
+                    writer.truncate(before);
+                    break;
+                }
+
+                if (message.lastSent >= 0.0) {
+                    statistics.messagesResent++;
+                }
+                message.lastSent = p_time;
+                packet.reliableIds[packet.reliableCount++] = message.id;
+            }
+
+            while (unreliableOffset < p_connection.unreliable.size()) {
+                ByteReader record(std::span<const uint8_t>(p_connection.unreliable).subspan(unreliableOffset));
+                const uint32_t size = record.readVarU32();
+                const std::span<const uint8_t> payload = record.readBytes(size);
+
+                const size_t before = writer.size();
+                writer.writeU8(static_cast<uint8_t>(NetChannel::Unreliable));
+                writer.writeVarU32(size);
+                writer.writeBytes(payload);
+                if (writer.overflowed()) {
+                    writer.truncate(before);
+                    break;
+                }
+                unreliableOffset = p_connection.unreliable.size() - record.remaining();
+            }
+
+            const bool hasMessages = writer.size() > headerSize;
+            const bool needed = hasMessages || (!sentAny && (p_connection.ackPending || p_time - p_connection.lastSend >= m_config.keepAliveSeconds));
+            if (!needed) {
+                m_outgoing.pop_back();
+                break;
+            }
+
+            datagram.size += static_cast<uint32_t>(writer.size());
+            if (overwritesUnacked) {
+                statistics.packetsLost++;
+            }
+            packet.sequence = sequence;
+            packet.used = true;
+            packet.acked = false;
+            packet.time = p_time;
+
+            p_connection.nextSequence++;
+            p_connection.lastSend = p_time;
+            statistics.packetsSent++;
+            statistics.bytesSent += datagram.size;
+            sentAny = true;
+
+            if (reliableCursor == p_connection.nextReliableId && unreliableOffset == p_connection.unreliable.size()) {
+                break;
+            }
+        }
+
+        p_connection.unreliable.clear();
+        p_connection.ackPending = false;
+    }
+
+    Datagram &NetTransport::beginDatagram(const Connection &p_connection, PacketType p_type) {
+        Datagram &datagram = m_outgoing.emplace_back();
+        datagram.address = p_connection.address;
+
+        ByteWriter writer(datagram.data, NET_MAX_DATAGRAM);
+        writer.writeU32(m_config.protocolId);
+        writer.writeU8(static_cast<uint8_t>(p_type));
+        writer.writeU32(p_connection.salt);
+        datagram.size = static_cast<uint32_t>(writer.size());
+        return datagram;
+    }
+
+    void NetTransport::sendControl(const Connection &p_connection, PacketType p_type) {
+        beginDatagram(p_connection, p_type);
+    }
+
+    void NetTransport::sendOutgoing(double p_time) {
+        for (const Datagram &datagram : m_outgoing) {
+            m_statistics.bytesSent += datagram.size;
+        }
+        m_statistics.packetsSent += m_outgoing.size();
+
+        if (m_simulator.config().isActive()) {
+            m_simulator.submit(m_outgoing, p_time);
+            m_simulator.flush(m_socket, p_time);
+        } else if (!m_outgoing.empty()) {
+            m_socket.sendBatch(m_outgoing);
+        }
+        m_outgoing.clear();
+    }
+}
@@ -0,0 +1,255 @@
+#ifndef __ENGINE_TRANSPORT_HPP__
+#define __ENGINE_TRANSPORT_HPP__
+
+#include "Network.hpp"
+#include "PacketSimulator.hpp"
+
+#include <deque>
+#include <memory>
+#include <random>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    using ConnectionId = uint32_t;
+    inline constexpr ConnectionId INVALID_CONNECTION = UINT32_MAX;
+
+    enum class NetChannel : uint8_t {
+        /** Sent once, may be lost, duplicates are filtered. For state that is resent anyway (snapshots, input). */
+        Unreliable,
+        /** Resent until acknowledged and delivered in sending order. For events (chat, block edits, spawns). */
+        Reliable,
+    };
+
+    enum class NetEventType : uint8_t {
+        Connected,
+        Disconnected,
+        Message,
+    };
+
+    struct NetEvent {
+        NetEventType type;
+        ConnectionId connection;
+        NetChannel channel;
+        /** Message bytes, valid until the next receive(). */
+        std::span<const uint8_t> payload;
+    };
+
+    struct NetConnectionStatistics {
+        uint64_t packetsSent = 0;
+        uint64_t packetsReceived = 0;
+        uint64_t packetsAcked = 0;
+        /** Sent packets the acknowledgements of the other side moved past, or that left the send window, unacknowledged. */
+        uint64_t packetsLost = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t messagesResent = 0;
+        /** Smoothed round trip, from packet acknowledgements. */
+        double rttSeconds = 0.0;
+    };
+
+    struct NetTransportStatistics {
+        uint64_t packetsSent = 0;
+        uint64_t packetsReceived = 0;
+        uint64_t bytesSent = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t syscalls = 0;
+        /** Wall time spent inside receive() and flush(). */
+        double cpuSeconds = 0.0;
+
+        double cpuSecondsPerPacket() const {
+            const uint64_t packets = packetsSent + packetsReceived;
+            return packets ? cpuSeconds / static_cast<double>(packets) : 0.0;
+        }
+    };
+
+    struct NetTransportConfig {
+        /** First word of every datagram, strays from other programs or protocol versions are dropped. */
+        uint32_t protocolId = 0x31564f4c;
+        uint32_t maxConnections = 256;
+        double timeoutSeconds = 5.0;
+        /** Idle connections send an empty packet this often, which carries the acknowledgements. */
+        double keepAliveSeconds = 0.1;
+        double connectRetrySeconds = 0.2;
+        /** ENGINE_NET_SIMULATE by default, so any transport can be put on a bad link without a rebuild. */
+        PacketSimulatorConfig simulator = PacketSimulatorConfig::fromEnvironment();
+        uint64_t simulatorSeed = 1;
+    };
+
+    /**
+     * Connection-oriented game transport over one UDP socket.
+     *
+     * Every datagram carries a 16-bit sequence, the latest received sequence and a 32-bit
+     * history of the ones before it, so each packet acknowledges up to 33 packets of the
+     * other side and acknowledgements survive loss without being sent on their own. Reliable
+     * messages are resent in later packets until a packet carrying them is acknowledged and
+     * are delivered in order. All messages queued for a connection between two flush() calls
+     * are packed into as few datagrams as fit, and all datagrams of a flush leave in one
+     * batched syscall.
+     *
+     * A transport is a server after listen() and a client after connect(). Typical frame:
+     * receive(), handle events(), send(), flush().
+     */
+    class NetTransport {
+    public:
+        /** Largest message payload, a message never spans datagrams. */
+        static constexpr uint32_t MAX_MESSAGE_SIZE = NET_MAX_DATAGRAM - 32;
+
+        explicit NetTransport(const NetTransportConfig &p_config = {});
+        ~NetTransport();
+
+        NetTransport(const NetTransport &) = delete;
+        NetTransport &operator=(const NetTransport &) = delete;
+
+        /** Accepts connections on `p_bind`. */
+        bool listen(const NetAddress &p_bind);
+
+        /** Starts connecting, a Connected or Disconnected event tells how it went. */
+        ConnectionId connect(const NetAddress &p_server, const NetAddress &p_bind = NetAddress::any(0));
+
+        /** Tells the other side and frees the connection without a Disconnected event. */
+        void disconnect(ConnectionId p_connection);
+
+        /** Queues a message for the next flush(), false when it cannot be sent. */
+        bool send(ConnectionId p_connection, NetChannel p_channel, std::span<const uint8_t> p_payload);
+
+        /** Reads every pending datagram and rebuilds events(). `p_time` is in seconds on any monotonic clock. */
+        void receive(double p_time);
+
+        /** Sends the queued messages, resends and keep-alives, and expires silent connections. */
+        void flush(double p_time);
+
+        std::span<const NetEvent> events() const { return m_events; }
+
+        bool isConnected(ConnectionId p_connection) const;
+        uint32_t connectionCount() const { return m_connectionCount; }
+        NetAddress localAddress() const { return m_socket.localAddress(); }
+        NetAddress remoteAddress(ConnectionId p_connection) const;
+
+        const NetConnectionStatistics *connectionStatistics(ConnectionId p_connection) const;
+        NetTransportStatistics statistics() const;
+
+        PacketSimulator &simulator() { return m_simulator; }
+
+    private:
+        static constexpr uint32_t SENT_PACKET_WINDOW = 256;
+        static constexpr uint32_t RELIABLE_WINDOW = 256;
+        static constexpr uint32_t MAX_RELIABLE_PER_PACKET = 32;
+
+        enum class PacketType : uint8_t {
+            ConnectRequest = 1,
+            ConnectAccept,
+            Payload,
+            Disconnect,
+        };
+
+        enum class State : uint8_t {
+            Free,
+            Connecting,
+            Connected,
+        };
+
+        struct SentPacket {
+            uint16_t sequence = 0;
+            bool used = false;
+            bool acked = false;
+            double time = 0.0;
+            uint16_t reliableCount = 0;
+            uint16_t reliableIds[MAX_RELIABLE_PER_PACKET];
+        };
+
+        struct OutgoingReliable {
+            bool used = false;
+            uint16_t id = 0;
+            /** Negative until the first send. */
+            double lastSent = -1.0;
+            std::vector<uint8_t> payload;
+        };
+
+        struct IncomingReliable {
+            bool used = false;
+            std::vector<uint8_t> payload;
+        };
+
+        struct Connection {
+            State state = State::Free;
+            NetAddress address;
+            uint32_t salt = 0;
+            double lastReceive = 0.0;
+            double lastSend = 0.0;
+            double lastConnectAttempt = -1.0;
+            bool ackPending = false;
+
+            uint16_t nextSequence = 0;
+            /**
+             * Until the first packet arrives we acknowledge 65535 with no history, a sequence the
+             * other side cannot have sent yet. Starting at 0 would acknowledge its first packet unseen.
+             */
+            uint16_t remoteSequence = UINT16_MAX;
+            uint32_t remoteAckBits = 0;
+            bool receivedAny = false;
+            SentPacket sent[SENT_PACKET_WINDOW];
+            /** Oldest sent sequence not yet known to be acknowledged or lost. */
+            uint16_t lossCursor = 0;
+
+            uint16_t nextReliableId = 0;
+            uint16_t oldestUnacked = 0;
+            OutgoingReliable outgoing[RELIABLE_WINDOW];
+            /** Reliable messages waiting for room in the window. */
+            std::deque<std::vector<uint8_t>> backlog;
+
+            uint16_t nextDelivery = 0;
+            IncomingReliable incoming[RELIABLE_WINDOW];
+
+            /** Queued unreliable messages, as varint length + bytes records. */
+            std::vector<uint8_t> unreliable;
+
+            NetConnectionStatistics statistics;
+        };
+
+        /** Where an event's payload sits in m_eventBytes until the spans are built. */
+        struct PendingEvent {
+            NetEventType type;
+            ConnectionId connection;
+            NetChannel channel;
+            size_t offset;
+            size_t size;
+        };
+
+        NetTransportConfig m_config;
+        UdpSocket m_socket;
+        PacketSimulator m_simulator;
+        bool m_listening = false;
+        std::mt19937 m_random;
+
+        std::vector<std::unique_ptr<Connection>> m_connections;
+        std::unordered_map<uint64_t, ConnectionId> m_connectionsByAddress;
+        uint32_t m_connectionCount = 0;
+
+        std::vector<Datagram> m_incoming;
+        std::vector<Datagram> m_outgoing;
+        std::vector<PendingEvent> m_pendingEvents;
+        std::vector<uint8_t> m_eventBytes;
+        std::vector<NetEvent> m_events;
+
+        NetTransportStatistics m_statistics;
+
+        ConnectionId allocateConnection(const NetAddress &p_address, uint32_t p_salt, State p_state);
+        void freeConnection(ConnectionId p_connection, bool p_notify);
+        Connection *connection(ConnectionId p_connection) const;
+
+        void handleDatagram(const Datagram &p_datagram, double p_time);
+        void handlePayload(ConnectionId p_id, Connection &p_connection, std::span<const uint8_t> p_body, double p_time);
+        void acknowledge(Connection &p_connection, uint16_t p_sequence, double p_time);
+        void countLosses(Connection &p_connection, uint16_t p_ack);
+        void pushEvent(NetEventType p_type, ConnectionId p_connection, NetChannel p_channel, std::span<const uint8_t> p_payload);
+
+        void flushConnection(Connection &p_connection, double p_time);
+        Datagram &beginDatagram(const Connection &p_connection, PacketType p_type);
+        void sendControl(const Connection &p_connection, PacketType p_type);
+        void sendOutgoing(double p_time);
+    };
+}
+
+#endif
@@ -0,0 +1,284 @@
+#include "BindlessTextureHeap.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine {
+    namespace {
+        /**
+         * A view replaced at frame N is still in the copies of the set written before N, and the
+         * last frame using such a copy is retired MAX_FRAMES_IN_FLIGHT frames after that copy
+         * is rewritten.
+         */
+        constexpr uint64_t RETIRE_LATENCY = 2 * MAX_FRAMES_IN_FLIGHT;
+    }
+
+    BindlessTextureHeap::BindlessTextureHeap(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                                             UploadRing &uploadRing)
+        : m_physicalDevice(physicalDevice), m_device(device), m_uploadRing(uploadRing) {
+        const auto properties = physicalDevice.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan12Properties>();
+        const auto &indexingProperties = properties.get<vk::PhysicalDeviceVulkan12Properties>();
+
+        m_capacity = std::min({MAX_TEXTURES, indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                               indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages});
+
+        createDescriptors();
+        createFallbackTexture();
+    }
+
+    void BindlessTextureHeap::createDescriptors() {
+        vk::SamplerCreateInfo samplerInfo{};
+        samplerInfo.magFilter = vk::Filter::eNearest;
+        samplerInfo.minFilter = vk::Filter::eNearest;
+        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
+        samplerInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.addressModeV = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.addressModeW = vk::SamplerAddressMode::eRepeat;
+        samplerInfo.minLod = 0.0f;
+        samplerInfo.maxLod = vk::LodClampNone;
+        m_sampler = vk::raii::Sampler(m_device, samplerInfo);
+
+        vk::DescriptorSetLayoutBinding binding(0, vk::DescriptorType::eCombinedImageSampler, m_capacity,
+                                               vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute);
+        const vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                                                        vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+        bindingFlagsInfo.bindingCount = 1;
+        bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+        vk::DescriptorSetLayoutCreateInfo layoutInfo{};
+        layoutInfo.pNext = &bindingFlagsInfo;
+        layoutInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
+        layoutInfo.bindingCount = 1;
+        layoutInfo.pBindings = &binding;
+        m_setLayout = vk::raii::DescriptorSetLayout(m_device, layoutInfo);
+
+        vk::DescriptorPoolSize poolSize(vk::DescriptorType::eCombinedImageSampler, m_capacity * MAX_FRAMES_IN_FLIGHT);
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet | vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind;
+        poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        m_pool = vk::raii::DescriptorPool(m_device, poolInfo);
+
+        std::array<vk::DescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+        layouts.fill(*m_setLayout);
+
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.descriptorPool = *m_pool;
+        allocInfo.descriptorSetCount = MAX_FRAMES_IN_FLIGHT;
+        allocInfo.pSetLayouts = layouts.data();
+        m_sets = m_device.allocateDescriptorSets(allocInfo);
+    }
+
+    void BindlessTextureHeap::createFallbackTexture() {
+        /** Magenta and black checker, visible at a glance when a texture is missing. */
+        constexpr uint32_t MAGENTA = 0xFFFF00FF;
+        constexpr uint32_t BLACK = 0xFF000000;
+        const std::array<uint32_t, 4> pixels = {MAGENTA, BLACK, BLACK, MAGENTA};
+
+        const BindlessTextureIndex index = createTexture(vk::Format::eR8G8B8A8Unorm, vk::Extent2D(2, 2), 1);
+        Texture &texture = m_textures[index];
+
+        if (m_uploadRing.uploadImage(*texture.image.image, vk::ImageAspectFlagBits::eColor, texture.image.extent, 0, 0,
+                                     pixels.data(), sizeof(pixels), vk::ImageLayout::eShaderReadOnlyOptimal,
+                                     vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                                     vk::AccessFlagBits2::eShaderSampledRead) == 0) {
+            throw std::runtime_error("failed to stage the fallback texture!");
+        }
+
+        /** Published right away, the first frame waits for the upload before it samples anything. */
+        texture.residentMask = 1;
+        updateVisibleRange(index, 0);
+    }
+
+    BindlessTextureIndex BindlessTextureHeap::createTexture(vk::Format format, vk::Extent2D extent, uint32_t mipLevels) {
+        BindlessTextureIndex index;
+        if (!m_freeSlots.empty()) {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else if (m_textures.size() < m_capacity) {
+            index = static_cast<BindlessTextureIndex>(m_textures.size());
+            m_textures.emplace_back();
+        } else {
+            return INVALID_BINDLESS_TEXTURE;
+        }
+
+        vk::ImageCreateInfo imageInfo{};
+        imageInfo.imageType = vk::ImageType::e2D;
+        imageInfo.format = format;
+        imageInfo.extent = vk::Extent3D(extent.width, extent.height, 1);
+        imageInfo.mipLevels = mipLevels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = vk::SampleCountFlagBits::e1;
+        imageInfo.tiling = vk::ImageTiling::eOptimal;
+        imageInfo.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
+        imageInfo.sharingMode = vk::SharingMode::eExclusive;
+        imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+
+        Texture &texture = m_textures[index];
+        texture.image = Engine::createImage(m_physicalDevice, m_device, imageInfo, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        texture.view = nullptr;
+        texture.residentMask = 0;
+        texture.firstVisibleMip = mipLevels;
+        texture.pending.clear();
+        texture.writableAtFrame = 0;
+        texture.live = true;
+
+        markDirty(index);
+        return index;
+    }
+
+    bool BindlessTextureHeap::uploadMip(BindlessTextureIndex index, uint32_t mipLevel, const void *data, vk::DeviceSize size) {
+        Texture &texture = m_textures[index];
+
+        if (mipLevel >= texture.firstVisibleMip) {
+            return true;
+        }
+
+        if (m_frameNumber < texture.writableAtFrame) {
+            return false;
+        }
+
+        const vk::Extent3D extent(std::max(1u, texture.image.extent.width >> mipLevel),
+                                  std::max(1u, texture.image.extent.height >> mipLevel), 1);
+        const uint64_t ticket = m_uploadRing.uploadImage(*texture.image.image, vk::ImageAspectFlagBits::eColor, extent, mipLevel, 0,
+                                                         data, size, vk::ImageLayout::eShaderReadOnlyOptimal,
+                                                         vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                                                         vk::AccessFlagBits2::eShaderSampledRead);
+        if (ticket == 0) {
+            return false;
+        }
+
+        texture.pending.push_back({mipLevel, ticket});
+        return true;
+    }
+
+    void BindlessTextureHeap::evictMips(BindlessTextureIndex index, uint32_t firstMip) {
+        Texture &texture = m_textures[index];
+        if (firstMip <= texture.firstVisibleMip || index == FALLBACK_TEXTURE) {
+            return;
+        }
+
+        firstMip = std::min(firstMip, texture.image.mipLevels);
+        texture.residentMask &= ~((1u << firstMip) - 1);
+        std::erase_if(texture.pending, [firstMip](const PendingMip &pending) { return pending.mipLevel < firstMip; });
+        texture.writableAtFrame = m_frameNumber + RETIRE_LATENCY;
+
+        updateVisibleRange(index, firstMip);
+    }
+
+    void BindlessTextureHeap::releaseTexture(BindlessTextureIndex index) {
+        if (index == FALLBACK_TEXTURE || !m_textures[index].live) {
+            return;
+        }
+
+        Texture &texture = m_textures[index];
+        m_retired.push_back({std::move(texture.image), std::move(texture.view), m_frameNumber});
+        texture.image = VulkanImage{};
+        texture.view = nullptr;
+        texture.pending.clear();
+        texture.live = false;
+
+        markDirty(index);
+        m_freeSlots.push_back(index);
+    }
+
+    void BindlessTextureHeap::publishCompletedUploads() {
+        for (BindlessTextureIndex index = 0; index < m_textures.size(); ++index) {
+            Texture &texture = m_textures[index];
+            if (texture.pending.empty()) {
+                continue;
+            }
+
+            std::erase_if(texture.pending, [&](const PendingMip &pending) {
+                if (!m_uploadRing.isRetired(pending.ticket)) {
+                    return false;
+                }
+
+                texture.residentMask |= 1u << pending.mipLevel;
+                return true;
+            });
+
+            /** Only a contiguous tail of the chain can be viewed, a finer mip waits for the coarser ones. */
+            uint32_t firstMip = texture.image.mipLevels;
+            while (firstMip > 0 && (texture.residentMask & (1u << (firstMip - 1)))) {
+                firstMip--;
+            }
+
+            if (firstMip < texture.firstVisibleMip) {
+                updateVisibleRange(index, firstMip);
+            }
+        }
+    }
+
+    void BindlessTextureHeap::updateVisibleRange(BindlessTextureIndex index, uint32_t firstMip) {
+        Texture &texture = m_textures[index];
+
+        if (*texture.view) {
+            m_retired.push_back({VulkanImage{}, std::move(texture.view), m_frameNumber});
+            texture.view = nullptr;
+        }
+
+        texture.firstVisibleMip = firstMip;
+        if (firstMip < texture.image.mipLevels) {
+            vk::ImageViewCreateInfo viewInfo{};
+            viewInfo.image = *texture.image.image;
+            viewInfo.viewType = vk::ImageViewType::e2D;
+            viewInfo.format = texture.image.format;
+            viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, firstMip,
+                                                                  texture.image.mipLevels - firstMip, 0, 1);
+            texture.view = vk::raii::ImageView(m_device, viewInfo);
+        }
+
+        markDirty(index);
+    }
+
+    void BindlessTextureHeap::markDirty(BindlessTextureIndex index) {
+        for (std::vector<BindlessTextureIndex> &dirty : m_dirtySlots) {
+            dirty.push_back(index);
+        }
+    }
+
+    vk::ImageView BindlessTextureHeap::slotView(BindlessTextureIndex index) const {
+        const Texture &texture = m_textures[index];
+        return texture.live && *texture.view ? *texture.view : *m_textures[FALLBACK_TEXTURE].view;
+    }
+
+    void BindlessTextureHeap::beginFrame(uint32_t frameIndex, uint64_t submittedFrames) {
+        m_frameNumber = submittedFrames;
+        while (!m_retired.empty() && m_retired.front().retiredAtFrame + RETIRE_LATENCY <= m_frameNumber) {
+            m_retired.pop_front();
+        }
+
+        publishCompletedUploads();
+
+        std::vector<BindlessTextureIndex> &dirty = m_dirtySlots[frameIndex];
+        if (!dirty.empty()) {
+            std::sort(dirty.begin(), dirty.end());
+            dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+            std::vector<vk::DescriptorImageInfo> imageInfos;
+            std::vector<vk::WriteDescriptorSet> writes;
+            imageInfos.reserve(dirty.size());
+            writes.reserve(dirty.size());
+
+            for (BindlessTextureIndex index : dirty) {
+                imageInfos.emplace_back(*m_sampler, slotView(index), vk::ImageLayout::eShaderReadOnlyOptimal);
+
+                vk::WriteDescriptorSet write{};
+                write.dstSet = *m_sets[frameIndex];
+                write.dstBinding = 0;
+                write.dstArrayElement = index;
+                write.descriptorCount = 1;
+                write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+                write.pImageInfo = &imageInfos.back();
+                writes.push_back(write);
+            }
+
+            m_device.updateDescriptorSets(writes, {});
+            dirty.clear();
+        }
+    }
+}
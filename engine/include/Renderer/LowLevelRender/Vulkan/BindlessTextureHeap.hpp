@@ -0,0 +1,155 @@
+#ifndef __ENGINE_BINDLESS_TEXTURE_HEAP_HPP__
+#define __ENGINE_BINDLESS_TEXTURE_HEAP_HPP__
+
+#include "Vulkan.hpp"
+#include "UploadRing.hpp"
+
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace Engine {
+    using BindlessTextureIndex = uint32_t;
+
+    constexpr BindlessTextureIndex INVALID_BINDLESS_TEXTURE = ~0u;
+
+    /**
+     * Chunk mesh vertex, 8 bytes. The material is the bindless index of the block texture,
+     * so a whole chunk draws with a single descriptor set bound. Mirrors unpackBlockVertex()
+     * in Shaders/BindlessTextures.glsl.
+     */
+    struct PackedBlockVertex {
+        /** x:6 y:6 z:6 face:3 ambientOcclusion:2 corner:2, position is local to the chunk. */
+        uint32_t position;
+
+        /** texture:16 tint:16 */
+        uint32_t material;
+
+        static constexpr uint32_t X_SHIFT = 0;
+        static constexpr uint32_t Y_SHIFT = 6;
+        static constexpr uint32_t Z_SHIFT = 12;
+        static constexpr uint32_t FACE_SHIFT = 18;
+        static constexpr uint32_t AMBIENT_OCCLUSION_SHIFT = 21;
+        static constexpr uint32_t CORNER_SHIFT = 23;
+        static constexpr uint32_t TINT_SHIFT = 16;
+
+        static constexpr PackedBlockVertex pack(uint32_t x, uint32_t y, uint32_t z, uint32_t face, uint32_t ambientOcclusion,
+                                                uint32_t corner, BindlessTextureIndex texture, uint32_t tint = 0) {
+            return {(x & 0x3F) << X_SHIFT | (y & 0x3F) << Y_SHIFT | (z & 0x3F) << Z_SHIFT | (face & 0x7) << FACE_SHIFT |
+                        (ambientOcclusion & 0x3) << AMBIENT_OCCLUSION_SHIFT | (corner & 0x3) << CORNER_SHIFT,
+                    (texture & 0xFFFF) | (tint & 0xFFFF) << TINT_SHIFT};
+        }
+    };
+
+    static_assert(sizeof(PackedBlockVertex) == 8);
+
+    /**
+     * Bindless heap of every block and item texture.
+     *
+     * All textures live in one runtime-sized combined image sampler array indexed from the
+     * shaders, so materials are switched by the index in the vertex instead of by rebinding.
+     * The set uses update-after-bind and partially bound descriptors; one copy is kept per
+     * frame in flight and a changed slot is rewritten into each copy when its frame begins,
+     * never while a submitted frame may still read it.
+     *
+     * Textures are created with their full mip chain but only the resident tail is visible:
+     * streamed mips are published by rewriting the slot with a view over the new range and
+     * evicted the same way, so neither pipelines nor materials change. Slot 0 is a fallback
+     * texture that unused and not yet resident slots point at.
+     *
+     * Not thread safe, call from the render thread.
+     */
+    class BindlessTextureHeap {
+    public:
+        static constexpr uint32_t MAX_TEXTURES = 4096;
+        static constexpr BindlessTextureIndex FALLBACK_TEXTURE = 0;
+
+        BindlessTextureHeap(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device, UploadRing &uploadRing);
+
+        BindlessTextureHeap(const BindlessTextureHeap &) = delete;
+        BindlessTextureHeap &operator=(const BindlessTextureHeap &) = delete;
+
+        /** Reserves a slot with storage for `mipLevels` mips. It samples the fallback until its smallest mip is resident. */
+        BindlessTextureIndex createTexture(vk::Format format, vk::Extent2D extent, uint32_t mipLevels);
+
+        /**
+         * Streams one mip level through the upload ring. Returns false when the ring is full or
+         * the mip was evicted too recently, the upload should then be retried on a later frame.
+         * Mips that are already visible are left untouched.
+         */
+        bool uploadMip(BindlessTextureIndex index, uint32_t mipLevel, const void *data, vk::DeviceSize size);
+
+        /** Drops every mip finer than `firstMip` from the visible range, the memory stays allocated. */
+        void evictMips(BindlessTextureIndex index, uint32_t firstMip);
+
+        void releaseTexture(BindlessTextureIndex index);
+
+        /**
+         * Publishes finished uploads and writes changed slots into this frame's set.
+         * Call after waiting for the frame's fence and before recording. `submittedFrames`
+         * counts the frames actually submitted so far, retired objects age on it and not on
+         * calls, so frames skipped before submission do not free what the GPU still uses.
+         */
+        void beginFrame(uint32_t frameIndex, uint64_t submittedFrames);
+
+        const vk::raii::DescriptorSetLayout &descriptorSetLayout() const { return m_setLayout; }
+        vk::DescriptorSet descriptorSet(uint32_t frameIndex) const { return *m_sets[frameIndex]; }
+
+        uint32_t capacity() const { return m_capacity; }
+        uint32_t textureCount() const { return static_cast<uint32_t>(m_textures.size() - m_freeSlots.size()); }
+
+        /** First mip of the range shaders currently see, mipLevels when nothing is resident. */
+        uint32_t firstResidentMip(BindlessTextureIndex index) const { return m_textures[index].firstVisibleMip; }
+
+    private:
+        struct PendingMip {
+            uint32_t mipLevel;
+            uint64_t ticket;
+        };
+
+        struct Texture {
+            VulkanImage image;
+            vk::raii::ImageView view = nullptr;
+            uint32_t residentMask = 0;
+            uint32_t firstVisibleMip = 0;
+            std::vector<PendingMip> pending;
+
+            /** Evicted mips may still be sampled by frames in flight until this frame. */
+            uint64_t writableAtFrame = 0;
+            bool live = false;
+        };
+
+        /** Objects a submitted frame may still reference through an older copy of the set. */
+        struct Retired {
+            VulkanImage image;
+            vk::raii::ImageView view = nullptr;
+            uint64_t retiredAtFrame;
+        };
+
+        const vk::raii::PhysicalDevice &m_physicalDevice;
+        const vk::raii::Device &m_device;
+        UploadRing &m_uploadRing;
+        uint32_t m_capacity;
+
+        vk::raii::Sampler m_sampler = nullptr;
+        vk::raii::DescriptorSetLayout m_setLayout = nullptr;
+        vk::raii::DescriptorPool m_pool = nullptr;
+        std::vector<vk::raii::DescriptorSet> m_sets;
+
+        std::vector<Texture> m_textures;
+        std::vector<BindlessTextureIndex> m_freeSlots;
+        std::array<std::vector<BindlessTextureIndex>, MAX_FRAMES_IN_FLIGHT> m_dirtySlots;
+        std::deque<Retired> m_retired;
+        /** Submitted frames before the one being prepared, as given to the last beginFrame(). */
+        uint64_t m_frameNumber = 0;
+
+        void createDescriptors();
+        void createFallbackTexture();
+        void publishCompletedUploads();
+        void updateVisibleRange(BindlessTextureIndex index, uint32_t firstMip);
+        void markDirty(BindlessTextureIndex index);
+        vk::ImageView slotView(BindlessTextureIndex index) const;
+    };
+}
+
+#endif
@@ -0,0 +1,577 @@
+#include "ChunkCuller.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ENGINE_CULL_SSE 1
+#else
+#define ENGINE_CULL_SSE 0
+#endif
+
+namespace Engine {
+    ChunkCuller::ChunkCuller(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                             uint32_t maxChunks, bool computeAvailable, ShaderLibrary &shaderLibrary)
+        : m_physicalDevice(physicalDevice), m_device(device), m_shaderLibrary(shaderLibrary), m_maxChunks(maxChunks), m_usesCompute(computeAvailable) {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        m_bounds = createBuffer(physicalDevice, device, sizeof(ChunkDrawBounds) * maxChunks,
+                                vk::BufferUsageFlagBits::eStorageBuffer, hostVisible);
+        m_inputDraws = createBuffer(physicalDevice, device, sizeof(vk::DrawIndexedIndirectCommand) * maxChunks,
+                                    vk::BufferUsageFlagBits::eStorageBuffer, hostVisible);
+
+        if (m_usesCompute) {
+            try {
+                createPipelines();
+            } catch (const std::exception &exception) {
+                ENGINE_CLOG_WARNING(Render, "GPU chunk culling unavailable, falling back to the CPU culler: {}", exception.what())
+                m_usesCompute = false;
+            }
+        }
+
+        createFrameResources();
+
+        if (m_usesCompute) {
+            createPyramid(nullptr, vk::ImageLayout::eUndefined, {1, 1});
+            for (FrameResources &frame : m_frames) {
+                writeCullDescriptors(frame);
+            }
+        }
+    }
+
+    void ChunkCuller::createFrameResources() {
+        const vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        /** The GPU path keeps the compacted draws in device memory, the CPU path writes them directly. */
+        const vk::MemoryPropertyFlags outputProperties = m_usesCompute ? vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal) : hostVisible;
+
+        for (FrameResources &frame : m_frames) {
+            frame.uniforms = createBuffer(m_physicalDevice, m_device, sizeof(CullUniforms),
+                                          vk::BufferUsageFlagBits::eUniformBuffer, hostVisible);
+            frame.uniformsMapped = frame.uniforms.memory.mapMemory(0, sizeof(CullUniforms));
+
+            frame.outputDraws = createBuffer(m_physicalDevice, m_device, sizeof(vk::DrawIndexedIndirectCommand) * m_maxChunks,
+                                             vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+                                             outputProperties);
+            if (!m_usesCompute) {
+                frame.outputMapped = frame.outputDraws.memory.mapMemory(0, frame.outputDraws.size);
+            }
+
+            frame.counters = createBuffer(m_physicalDevice, m_device, sizeof(GpuCounters),
+                                          vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+                                          hostVisible);
+            frame.countersMapped = static_cast<GpuCounters *>(frame.counters.memory.mapMemory(0, sizeof(GpuCounters)));
+            std::memset(frame.countersMapped, 0, sizeof(GpuCounters));
+        }
+    }
+
+    void ChunkCuller::createPipelines() {
+        /** Reduce sets for the current pyramid and one retired per frame in flight. */
+        constexpr uint32_t reduceSets = (MAX_FRAMES_IN_FLIGHT + 1) * MAX_PYRAMID_LEVELS;
+        std::array<vk::DescriptorPoolSize, 5> poolSizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, MAX_FRAMES_IN_FLIGHT),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 4 * MAX_FRAMES_IN_FLIGHT),
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, MAX_FRAMES_IN_FLIGHT + reduceSets),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, reduceSets),
+            vk::DescriptorPoolSize(vk::DescriptorType::eSampler, 1)
+        };
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet;
+        poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT + reduceSets;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+        m_descriptorPool = vk::raii::DescriptorPool(m_device, poolInfo);
+
+        std::array<vk::DescriptorSetLayoutBinding, 6> cullBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(4, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(5, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute)
+        };
+        vk::DescriptorSetLayoutCreateInfo cullLayoutInfo{};
+        cullLayoutInfo.bindingCount = static_cast<uint32_t>(cullBindings.size());
+        cullLayoutInfo.pBindings = cullBindings.data();
+        m_cullSetLayout = vk::raii::DescriptorSetLayout(m_device, cullLayoutInfo);
+
+        std::array<vk::DescriptorSetLayoutBinding, 2> reduceBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute)
+        };
+        vk::DescriptorSetLayoutCreateInfo reduceLayoutInfo{};
+        reduceLayoutInfo.bindingCount = static_cast<uint32_t>(reduceBindings.size());
+        reduceLayoutInfo.pBindings = reduceBindings.data();
+        m_reduceSetLayout = vk::raii::DescriptorSetLayout(m_device, reduceLayoutInfo);
+
+        vk::PipelineLayoutCreateInfo cullPipelineLayoutInfo{};
+        cullPipelineLayoutInfo.setLayoutCount = 1;
+        cullPipelineLayoutInfo.pSetLayouts = &*m_cullSetLayout;
+        m_cullPipelineLayout = vk::raii::PipelineLayout(m_device, cullPipelineLayoutInfo);
+
+        vk::PushConstantRange reducePushRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof(HiZPushConstants));
+        vk::PipelineLayoutCreateInfo reducePipelineLayoutInfo{};
+        reducePipelineLayoutInfo.setLayoutCount = 1;
+        reducePipelineLayoutInfo.pSetLayouts = &*m_reduceSetLayout;
+        reducePipelineLayoutInfo.pushConstantRangeCount = 1;
+        reducePipelineLayoutInfo.pPushConstantRanges = &reducePushRange;
+        m_reducePipelineLayout = vk::raii::PipelineLayout(m_device, reducePipelineLayoutInfo);
+
+        buildPipelines();
+
+        m_shaderLibrary.onReload({"ChunkCull.comp", "HiZReduce.comp"}, [this]() { buildPipelines(); });
+
+        vk::SamplerCreateInfo samplerInfo{};
+        samplerInfo.magFilter = vk::Filter::eNearest;
+        samplerInfo.minFilter = vk::Filter::eNearest;
+        samplerInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+        samplerInfo.addressModeU = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+        samplerInfo.maxLod = vk::LodClampNone;
+        m_pyramidSampler = vk::raii::Sampler(m_device, samplerInfo);
+    }
+
+    void ChunkCuller::buildPipelines() {
+        const vk::raii::ShaderModule cullModule = m_shaderLibrary.createModule("ChunkCull.comp");
+        const vk::raii::ShaderModule reduceModule = m_shaderLibrary.createModule("HiZReduce.comp");
+
+        vk::ComputePipelineCreateInfo cullPipelineInfo{};
+        cullPipelineInfo.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, *cullModule, "main");
+        cullPipelineInfo.layout = *m_cullPipelineLayout;
+        vk::raii::Pipeline cullPipeline(m_device, nullptr, cullPipelineInfo);
+
+        vk::ComputePipelineCreateInfo reducePipelineInfo{};
+        reducePipelineInfo.stage = vk::PipelineShaderStageCreateInfo({}, vk::ShaderStageFlagBits::eCompute, *reduceModule, "main");
+        reducePipelineInfo.layout = *m_reducePipelineLayout;
+        vk::raii::Pipeline reducePipeline(m_device, nullptr, reducePipelineInfo);
+
+        /** On a reload the old pipelines may still be used by frames in flight. */
+        if (*m_cullPipeline) {
+            m_shaderLibrary.retire(std::move(m_cullPipeline));
+            m_shaderLibrary.retire(std::move(m_reducePipeline));
+        }
+
+        m_cullPipeline = std::move(cullPipeline);
+        m_reducePipeline = std::move(reducePipeline);
+    }
+
+    void ChunkCuller::createPyramid(vk::ImageView depthView, vk::ImageLayout depthLayout, vk::Extent2D extent) {
+        /** At most one pyramid retires per recorded frame, one no frame recorded against goes right away. */
+        if (m_pyramidRecorded) {
+            RetiredPyramid retired;
+            retired.image = std::move(m_pyramid);
+            retired.view = std::move(m_pyramidView);
+            retired.levelViews = std::move(m_pyramidLevelViews);
+            retired.reduceSets = std::move(m_reduceSets);
+            retired.retiredAtFrame = m_frameNumber;
+            m_retiredPyramids.push_back(std::move(retired));
+        }
+        m_reduceSets.clear();
+        m_pyramidLevelViews.clear();
+        m_pyramidView = nullptr;
+        m_pyramidRecorded = false;
+        m_pyramidGeneration++;
+
+        m_pyramidValid = static_cast<bool>(depthView);
+        m_pyramidExtent = m_pyramidValid ? extent : vk::Extent2D{1, 1};
+        const uint32_t levels = std::min(MAX_PYRAMID_LEVELS,
+                                         static_cast<uint32_t>(std::floor(std::log2(std::max(m_pyramidExtent.width, m_pyramidExtent.height)))) + 1);
+
+        vk::ImageCreateInfo imageInfo{};
+        imageInfo.imageType = vk::ImageType::e2D;
+        imageInfo.format = vk::Format::eR32Sfloat;
+        imageInfo.extent = vk::Extent3D(m_pyramidExtent.width, m_pyramidExtent.height, 1);
+        imageInfo.mipLevels = levels;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = vk::SampleCountFlagBits::e1;
+        imageInfo.tiling = vk::ImageTiling::eOptimal;
+        imageInfo.usage = vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled;
+        imageInfo.sharingMode = vk::SharingMode::eExclusive;
+        imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+        m_pyramid = createImage(m_physicalDevice, m_device, imageInfo, vk::MemoryPropertyFlagBits::eDeviceLocal);
+        m_pyramidInitialized = false;
+
+        vk::ImageViewCreateInfo viewInfo{};
+        viewInfo.image = *m_pyramid.image;
+        viewInfo.viewType = vk::ImageViewType::e2D;
+        viewInfo.format = vk::Format::eR32Sfloat;
+        viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levels, 0, 1);
+        m_pyramidView = vk::raii::ImageView(m_device, viewInfo);
+
+        if (!m_pyramidValid) {
+            return;
+        }
+
+        for (uint32_t level = 0; level < levels; ++level) {
+            viewInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1);
+            m_pyramidLevelViews.emplace_back(m_device, viewInfo);
+        }
+
+        std::vector<vk::DescriptorSetLayout> layouts(levels, *m_reduceSetLayout);
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.descriptorPool = *m_descriptorPool;
+        allocInfo.descriptorSetCount = levels;
+        allocInfo.pSetLayouts = layouts.data();
+        for (auto &descriptorSet : vk::raii::DescriptorSets(m_device, allocInfo)) {
+            m_reduceSets.push_back(std::move(descriptorSet));
+        }
+
+        for (uint32_t level = 0; level < levels; ++level) {
+            vk::DescriptorImageInfo sourceInfo{};
+            sourceInfo.sampler = *m_pyramidSampler;
+            sourceInfo.imageView = level == 0 ? depthView : *m_pyramidLevelViews[level - 1];
+            sourceInfo.imageLayout = level == 0 ? depthLayout : vk::ImageLayout::eGeneral;
+
+            vk::DescriptorImageInfo destinationInfo{};
+            destinationInfo.imageView = *m_pyramidLevelViews[level];
+            destinationInfo.imageLayout = vk::ImageLayout::eGeneral;
+
+            std::array<vk::WriteDescriptorSet, 2> writes{};
+            writes[0].dstSet = *m_reduceSets[level];
+            writes[0].dstBinding = 0;
+            writes[0].descriptorCount = 1;
+            writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+            writes[0].pImageInfo = &sourceInfo;
+            writes[1].dstSet = *m_reduceSets[level];
+            writes[1].dstBinding = 1;
+            writes[1].descriptorCount = 1;
+            writes[1].descriptorType = vk::DescriptorType::eStorageImage;
+            writes[1].pImageInfo = &destinationInfo;
+            m_device.updateDescriptorSets(writes, nullptr);
+        }
+    }
+
+    void ChunkCuller::writeCullDescriptors(FrameResources &frame) {
+        if (!*frame.descriptorSet) {
+            vk::DescriptorSetAllocateInfo allocInfo{};
+            allocInfo.descriptorPool = *m_descriptorPool;
+            allocInfo.descriptorSetCount = 1;
+            allocInfo.pSetLayouts = &*m_cullSetLayout;
+            frame.descriptorSet = std::move(vk::raii::DescriptorSets(m_device, allocInfo).front());
+        }
+
+        std::array<vk::DescriptorBufferInfo, 5> bufferInfos = {
+            vk::DescriptorBufferInfo(*frame.uniforms.buffer, 0, vk::WholeSize),
+            vk::DescriptorBufferInfo(*m_bounds.buffer, 0, vk::WholeSize),
+            vk::DescriptorBufferInfo(*m_inputDraws.buffer, 0, vk::WholeSize),
+            vk::DescriptorBufferInfo(*frame.outputDraws.buffer, 0, vk::WholeSize),
+            vk::DescriptorBufferInfo(*frame.counters.buffer, 0, vk::WholeSize)
+        };
+        vk::DescriptorImageInfo pyramidInfo(*m_pyramidSampler, *m_pyramidView, vk::ImageLayout::eGeneral);
+
+        std::array<vk::WriteDescriptorSet, 6> writes{};
+        for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+            writes[binding].dstSet = *frame.descriptorSet;
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+
+            if (binding == 0) {
+                writes[binding].descriptorType = vk::DescriptorType::eUniformBuffer;
+                writes[binding].pBufferInfo = &bufferInfos[binding];
+            } else if (binding < 5) {
+                writes[binding].descriptorType = vk::DescriptorType::eStorageBuffer;
+                writes[binding].pBufferInfo = &bufferInfos[binding];
+            } else {
+                writes[binding].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+                writes[binding].pImageInfo = &pyramidInfo;
+            }
+        }
+        m_device.updateDescriptorSets(writes, nullptr);
+        frame.pyramidGeneration = m_pyramidGeneration;
+    }
+
+    void ChunkCuller::setChunks(const std::vector<ChunkDrawBounds> &bounds, const std::vector<vk::DrawIndexedIndirectCommand> &draws) {
+        m_chunkCount = static_cast<uint32_t>(std::min<size_t>({bounds.size(), draws.size(), m_maxChunks}));
+        if (m_chunkCount < bounds.size()) {
+            ENGINE_CLOG_WARNING(Render, "Chunk culler capacity exceeded, dropping {} chunks", bounds.size() - m_chunkCount)
+        }
+
+        void *boundsMapped = m_bounds.memory.mapMemory(0, m_bounds.size);
+        std::memcpy(boundsMapped, bounds.data(), sizeof(ChunkDrawBounds) * m_chunkCount);
+        m_bounds.memory.unmapMemory();
+
+        void *drawsMapped = m_inputDraws.memory.mapMemory(0, m_inputDraws.size);
+        std::memcpy(drawsMapped, draws.data(), sizeof(vk::DrawIndexedIndirectCommand) * m_chunkCount);
+        m_inputDraws.memory.unmapMemory();
+
+        m_draws.assign(draws.begin(), draws.begin() + m_chunkCount);
+
+        std::vector<float> *columns[6] = {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ};
+        for (std::vector<float> *column : columns) {
+            column->resize(m_chunkCount);
+        }
+
+        for (uint32_t i = 0; i < m_chunkCount; ++i) {
+            m_minX[i] = bounds[i].minimum.x;
+            m_minY[i] = bounds[i].minimum.y;
+            m_minZ[i] = bounds[i].minimum.z;
+            m_maxX[i] = bounds[i].maximum.x;
+            m_maxY[i] = bounds[i].maximum.y;
+            m_maxZ[i] = bounds[i].maximum.z;
+        }
+    }
+
+    void ChunkCuller::setDepthSource(vk::ImageView depthView, vk::ImageLayout depthLayout, vk::Extent2D extent) {
+        if (!m_usesCompute) {
+            return;
+        }
+
+        createPyramid(depthView, depthLayout, extent);
+    }
+
+    void ChunkCuller::readStatistics(uint32_t frameIndex) {
+        FrameResources &frame = m_frames[frameIndex];
+        if (!frame.submitted) {
+            return;
+        }
+
+        m_statistics.visible = frame.countersMapped->drawCount;
+        m_statistics.tested = frame.countersMapped->tested;
+        m_statistics.frustumRejected = frame.countersMapped->frustumRejected;
+        m_statistics.occlusionRejected = frame.countersMapped->occlusionRejected;
+    }
+
+    std::array<glm::vec4, 6> ChunkCuller::extractFrustumPlanes(const glm::mat4 &viewProjection) {
+        const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        /** Vulkan clip space, depth in [0, w]. */
+        std::array<glm::vec4, 6> planes = {
+            row3 + row0,
+            row3 - row0,
+            row3 + row1,
+            row3 - row1,
+            row2,
+            row3 - row2
+        };
+
+        for (glm::vec4 &plane : planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return planes;
+    }
+
+    void ChunkCuller::buildHiZ(const vk::raii::CommandBuffer &commandBuffer) {
+        if (!m_usesCompute || !m_pyramidValid) {
+            return;
+        }
+
+        const uint32_t levels = static_cast<uint32_t>(m_pyramidLevelViews.size());
+
+        /** The whole pyramid is rewritten, so its previous contents are discarded. */
+        vk::ImageMemoryBarrier2 discardBarrier{};
+        discardBarrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        discardBarrier.srcAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+        discardBarrier.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        discardBarrier.dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+        discardBarrier.oldLayout = vk::ImageLayout::eUndefined;
+        discardBarrier.newLayout = vk::ImageLayout::eGeneral;
+        discardBarrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+        discardBarrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+        discardBarrier.image = *m_pyramid.image;
+        discardBarrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, levels, 0, 1);
+
+        vk::DependencyInfo discardDependency{};
+        discardDependency.imageMemoryBarrierCount = 1;
+        discardDependency.pImageMemoryBarriers = &discardBarrier;
+        commandBuffer.pipelineBarrier2(discardDependency);
+        m_pyramidInitialized = true;
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *m_reducePipeline);
+
+        glm::ivec2 sourceSize(m_pyramidExtent.width, m_pyramidExtent.height);
+        for (uint32_t level = 0; level < levels; ++level) {
+            const glm::ivec2 destinationSize(std::max(1u, m_pyramidExtent.width >> level),
+                                             std::max(1u, m_pyramidExtent.height >> level));
+
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *m_reducePipelineLayout, 0, *m_reduceSets[level], nullptr);
+
+            HiZPushConstants pushConstants{sourceSize, destinationSize};
+            commandBuffer.pushConstants<HiZPushConstants>(*m_reducePipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, pushConstants);
+            commandBuffer.dispatch((destinationSize.x + 7) / 8, (destinationSize.y + 7) / 8, 1);
+
+            vk::ImageMemoryBarrier2 levelBarrier{};
+            levelBarrier.srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+            levelBarrier.srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+            levelBarrier.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+            levelBarrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+            levelBarrier.oldLayout = vk::ImageLayout::eGeneral;
+            levelBarrier.newLayout = vk::ImageLayout::eGeneral;
+            levelBarrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+            levelBarrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+            levelBarrier.image = *m_pyramid.image;
+            levelBarrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1);
+
+            vk::DependencyInfo levelDependency{};
+            levelDependency.imageMemoryBarrierCount = 1;
+            levelDependency.pImageMemoryBarriers = &levelBarrier;
+            commandBuffer.pipelineBarrier2(levelDependency);
+
+            sourceSize = destinationSize;
+        }
+    }
+
+    void ChunkCuller::recordCull(const vk::raii::CommandBuffer &commandBuffer, uint32_t frameIndex, const glm::mat4 &viewProjection) {
+        if (!m_usesCompute) {
+            return;
+        }
+
+        /** This slot's previous frame has retired, so its descriptor set can move to the current pyramid. */
+        while (!m_retiredPyramids.empty() && m_retiredPyramids.front().retiredAtFrame + MAX_FRAMES_IN_FLIGHT <= m_frameNumber) {
+            m_retiredPyramids.pop_front();
+        }
+
+        readStatistics(frameIndex);
+
+        FrameResources &frame = m_frames[frameIndex];
+        if (frame.pyramidGeneration != m_pyramidGeneration) {
+            writeCullDescriptors(frame);
+        }
+        m_pyramidRecorded = true;
+
+        CullUniforms uniforms{};
+        uniforms.viewProjection = viewProjection;
+        const std::array<glm::vec4, 6> planes = extractFrustumPlanes(viewProjection);
+        std::copy(planes.begin(), planes.end(), uniforms.planes);
+        uniforms.pyramidSize = glm::vec2(m_pyramidExtent.width, m_pyramidExtent.height);
+        uniforms.chunkCount = m_chunkCount;
+        uniforms.occlusionEnabled = m_pyramidValid && m_pyramidInitialized ? 1 : 0;
+        std::memcpy(frame.uniformsMapped, &uniforms, sizeof(uniforms));
+        std::memset(frame.countersMapped, 0, sizeof(GpuCounters));
+
+        if (!m_pyramidInitialized) {
+            vk::ImageMemoryBarrier2 initBarrier{};
+            initBarrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+            initBarrier.dstStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+            initBarrier.dstAccessMask = vk::AccessFlagBits2::eShaderSampledRead;
+            initBarrier.oldLayout = vk::ImageLayout::eUndefined;
+            initBarrier.newLayout = vk::ImageLayout::eGeneral;
+            initBarrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+            initBarrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+            initBarrier.image = *m_pyramid.image;
+            initBarrier.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, m_pyramid.mipLevels, 0, 1);
+
+            vk::DependencyInfo initDependency{};
+            initDependency.imageMemoryBarrierCount = 1;
+            initDependency.pImageMemoryBarriers = &initBarrier;
+            commandBuffer.pipelineBarrier2(initDependency);
+            m_pyramidInitialized = true;
+        }
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, *m_cullPipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, *m_cullPipelineLayout, 0, *frame.descriptorSet, nullptr);
+        commandBuffer.dispatch((m_chunkCount + 63) / 64, 1, 1);
+
+        std::array<vk::BufferMemoryBarrier2, 2> barriers{};
+        barriers[0].srcStageMask = vk::PipelineStageFlagBits2::eComputeShader;
+        barriers[0].srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite;
+        barriers[0].dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect;
+        barriers[0].dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead;
+        barriers[0].srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+        barriers[0].dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+        barriers[0].buffer = *frame.outputDraws.buffer;
+        barriers[0].size = vk::WholeSize;
+
+        /** The counters are also read back by the host once the frame's fence signalled. */
+        barriers[1] = barriers[0];
+        barriers[1].srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eShaderStorageRead;
+        barriers[1].dstStageMask = vk::PipelineStageFlagBits2::eDrawIndirect | vk::PipelineStageFlagBits2::eHost;
+        barriers[1].dstAccessMask = vk::AccessFlagBits2::eIndirectCommandRead | vk::AccessFlagBits2::eHostRead;
+        barriers[1].buffer = *frame.counters.buffer;
+
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+        dependencyInfo.pBufferMemoryBarriers = barriers.data();
+        commandBuffer.pipelineBarrier2(dependencyInfo);
+
+        frame.submitted = true;
+        m_frameNumber++;
+    }
+
+    void ChunkCuller::cullOnCpu(uint32_t frameIndex, const glm::mat4 &viewProjection) {
+        if (m_usesCompute) {
+            return;
+        }
+
+        FrameResources &frame = m_frames[frameIndex];
+        auto *output = static_cast<vk::DrawIndexedIndirectCommand *>(frame.outputMapped);
+        const std::array<glm::vec4, 6> planes = extractFrustumPlanes(viewProjection);
+
+        uint32_t visible = 0;
+        uint32_t rejected = 0;
+        uint32_t i = 0;
+
+#if ENGINE_CULL_SSE
+        /** Four boxes per iteration, the positive vertex is selected per plane from the normal's signs. */
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 4 <= m_chunkCount; i += 4) {
+            const __m128 minX = _mm_loadu_ps(&m_minX[i]);
+            const __m128 minY = _mm_loadu_ps(&m_minY[i]);
+            const __m128 minZ = _mm_loadu_ps(&m_minZ[i]);
+            const __m128 maxX = _mm_loadu_ps(&m_maxX[i]);
+            const __m128 maxY = _mm_loadu_ps(&m_maxY[i]);
+            const __m128 maxZ = _mm_loadu_ps(&m_maxZ[i]);
+
+            __m128 outside = zero;
+            for (const glm::vec4 &plane : planes) {
+                const __m128 px = plane.x > 0.0f ? maxX : minX;
+                const __m128 py = plane.y > 0.0f ? maxY : minY;
+                const __m128 pz = plane.z > 0.0f ? maxZ : minZ;
+
+                __m128 distance = _mm_mul_ps(px, _mm_set1_ps(plane.x));
+                distance = _mm_add_ps(distance, _mm_mul_ps(py, _mm_set1_ps(plane.y)));
+                distance = _mm_add_ps(distance, _mm_mul_ps(pz, _mm_set1_ps(plane.z)));
+                distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+            }
+
+            const int outsideMask = _mm_movemask_ps(outside);
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                if (outsideMask & (1 << lane)) {
+                    rejected++;
+                } else {
+                    output[visible++] = m_draws[i + lane];
+                }
+            }
+        }
+#endif
+
+        for (; i < m_chunkCount; ++i) {
+            bool inside = true;
+            for (const glm::vec4 &plane : planes) {
+                const float px = plane.x > 0.0f ? m_maxX[i] : m_minX[i];
+                const float py = plane.y > 0.0f ? m_maxY[i] : m_minY[i];
+                const float pz = plane.z > 0.0f ? m_maxZ[i] : m_minZ[i];
+
+                if (px * plane.x + py * plane.y + pz * plane.z + plane.w < 0.0f) {
+                    inside = false;
+                    break;
+                }
+            }
+
+            if (inside) {
+                output[visible++] = m_draws[i];
+            } else {
+                rejected++;
+            }
+        }
+
+        frame.countersMapped->drawCount = visible;
+        frame.countersMapped->tested = m_chunkCount;
+        frame.countersMapped->frustumRejected = rejected;
+        frame.countersMapped->occlusionRejected = 0;
+
+        m_statistics.visible = visible;
+        m_statistics.tested = m_chunkCount;
+        m_statistics.frustumRejected = rejected;
+        m_statistics.occlusionRejected = 0;
+    }
+}
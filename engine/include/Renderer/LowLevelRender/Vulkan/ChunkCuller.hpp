@@ -0,0 +1,174 @@
+#ifndef __ENGINE_CHUNK_CULLER_HPP__
+#define __ENGINE_CHUNK_CULLER_HPP__
+
+#include "Vulkan.hpp"
+#include "ShaderLibrary.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <deque>
+#include <vector>
+
+namespace Engine {
+    /** World-space bounds of one chunk draw, std430 compatible. */
+    struct ChunkDrawBounds {
+        glm::vec4 minimum;
+        glm::vec4 maximum;
+    };
+
+    /** Per-frame culling counters. `visible` is the number of draws written to the indirect buffer. */
+    struct CullStatistics {
+        uint32_t visible = 0;
+        uint32_t tested = 0;
+        uint32_t frustumRejected = 0;
+        uint32_t occlusionRejected = 0;
+    };
+
+    /**
+     * Culls chunk draws and compacts the survivors into an indirect buffer consumed with
+     * drawIndexedIndirectCount().
+     *
+     * With compute available the test runs on the GPU against the frustum and a Hi-Z pyramid
+     * built from the previous frame's depth. Otherwise an SSE frustum culler fills the same
+     * buffers from the CPU, so draw submission does not depend on the path taken.
+     *
+     * The occlusion test stays off until setDepthSource() is given a depth target. The scene
+     * pass renders without depth for now, so only frustum culling runs.
+     */
+    class ChunkCuller {
+    public:
+        ChunkCuller(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                    uint32_t maxChunks, bool computeAvailable, ShaderLibrary &shaderLibrary);
+
+        ChunkCuller(const ChunkCuller &) = delete;
+        ChunkCuller &operator=(const ChunkCuller &) = delete;
+
+        bool usesCompute() const { return m_usesCompute; }
+
+        /** Replaces the chunk set. Must not be called while a frame using the culler is in flight. */
+        void setChunks(const std::vector<ChunkDrawBounds> &bounds, const std::vector<vk::DrawIndexedIndirectCommand> &draws);
+
+        /**
+         * Points the Hi-Z pyramid at a new depth target, typically after a swapchain resize.
+         * `depthLayout` is the layout the depth image is in when buildHiZ() is recorded.
+         * The previous pyramid is released once the frames in flight that used it retired,
+         * and each frame slot switches to the new one the next time it records its cull.
+         */
+        void setDepthSource(vk::ImageView depthView, vk::ImageLayout depthLayout, vk::Extent2D extent);
+
+        /** Records the pyramid build from this frame's depth, it is used by the next frame's cull. */
+        void buildHiZ(const vk::raii::CommandBuffer &commandBuffer);
+
+        /** Records the GPU cull. Must be recorded outside a rendering scope. */
+        void recordCull(const vk::raii::CommandBuffer &commandBuffer, uint32_t frameIndex, const glm::mat4 &viewProjection);
+
+        /** CPU fallback, fills the frame's indirect buffer directly. */
+        void cullOnCpu(uint32_t frameIndex, const glm::mat4 &viewProjection);
+
+        vk::Buffer indirectBuffer(uint32_t frameIndex) const { return *m_frames[frameIndex].outputDraws.buffer; }
+
+        /** Draw count lives at offset 0 of this buffer. */
+        vk::Buffer countBuffer(uint32_t frameIndex) const { return *m_frames[frameIndex].counters.buffer; }
+
+        uint32_t maxChunks() const { return m_maxChunks; }
+
+        /** Statistics of the most recent frame whose results are available. */
+        const CullStatistics &statistics() const { return m_statistics; }
+
+        static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4 &viewProjection);
+
+    private:
+        struct CullUniforms {
+            glm::mat4 viewProjection;
+            glm::vec4 planes[6];
+            glm::vec2 pyramidSize;
+            uint32_t chunkCount;
+            uint32_t occlusionEnabled;
+        };
+
+        struct GpuCounters {
+            uint32_t drawCount;
+            uint32_t tested;
+            uint32_t frustumRejected;
+            uint32_t occlusionRejected;
+        };
+
+        struct HiZPushConstants {
+            glm::ivec2 sourceSize;
+            glm::ivec2 destinationSize;
+        };
+
+        struct FrameResources {
+            VulkanBuffer uniforms;
+            VulkanBuffer outputDraws;
+            VulkanBuffer counters;
+            void *uniformsMapped = nullptr;
+            void *outputMapped = nullptr;
+            GpuCounters *countersMapped = nullptr;
+            vk::raii::DescriptorSet descriptorSet = nullptr;
+            /** Pyramid the descriptor set points at, rewritten when the slot records with a newer one. */
+            uint64_t pyramidGeneration = 0;
+            bool submitted = false;
+        };
+
+        /** Pyramid replaced by setDepthSource(), kept while a frame in flight may still use it. */
+        struct RetiredPyramid {
+            VulkanImage image;
+            vk::raii::ImageView view = nullptr;
+            std::vector<vk::raii::ImageView> levelViews;
+            std::vector<vk::raii::DescriptorSet> reduceSets;
+            uint64_t retiredAtFrame = 0;
+        };
+
+        static constexpr uint32_t MAX_PYRAMID_LEVELS = 16;
+
+        const vk::raii::PhysicalDevice &m_physicalDevice;
+        const vk::raii::Device &m_device;
+        ShaderLibrary &m_shaderLibrary;
+        uint32_t m_maxChunks;
+        uint32_t m_chunkCount = 0;
+        bool m_usesCompute;
+
+        VulkanBuffer m_bounds;
+        VulkanBuffer m_inputDraws;
+        std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> m_frames;
+        CullStatistics m_statistics;
+
+        /** Structure-of-arrays copy of the bounds for the SIMD CPU path. */
+        std::vector<float> m_minX, m_minY, m_minZ, m_maxX, m_maxY, m_maxZ;
+        std::vector<vk::DrawIndexedIndirectCommand> m_draws;
+
+        vk::raii::DescriptorPool m_descriptorPool = nullptr;
+        vk::raii::DescriptorSetLayout m_cullSetLayout = nullptr;
+        vk::raii::PipelineLayout m_cullPipelineLayout = nullptr;
+        vk::raii::Pipeline m_cullPipeline = nullptr;
+
+        vk::raii::DescriptorSetLayout m_reduceSetLayout = nullptr;
+        vk::raii::PipelineLayout m_reducePipelineLayout = nullptr;
+        vk::raii::Pipeline m_reducePipeline = nullptr;
+
+        vk::raii::Sampler m_pyramidSampler = nullptr;
+        VulkanImage m_pyramid;
+        vk::raii::ImageView m_pyramidView = nullptr;
+        std::vector<vk::raii::ImageView> m_pyramidLevelViews;
+        std::vector<vk::raii::DescriptorSet> m_reduceSets;
+        vk::Extent2D m_pyramidExtent{1, 1};
+        bool m_pyramidValid = false;
+        bool m_pyramidInitialized = false;
+        /** A frame was recorded against the current pyramid, so replacing it must wait for that frame. */
+        bool m_pyramidRecorded = false;
+        uint64_t m_pyramidGeneration = 0;
+        std::deque<RetiredPyramid> m_retiredPyramids;
+        uint64_t m_frameNumber = 0;
+
+        void createFrameResources();
+        void createPipelines();
+        void buildPipelines();
+        void createPyramid(vk::ImageView depthView, vk::ImageLayout depthLayout, vk::Extent2D extent);
+        void writeCullDescriptors(FrameResources &frame);
+        void readStatistics(uint32_t frameIndex);
+    };
+}
+
+#endif
@@ -0,0 +1,186 @@
+#include "DeviceQueues.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Engine {
+    namespace {
+        constexpr float GRAPHICS_PRIORITY = 1.0f;
+        constexpr float COMPUTE_PRIORITY = 0.75f;
+        constexpr float TRANSFER_PRIORITY = 0.5f;
+    }
+
+    DeviceQueues::DeviceQueues(const vk::raii::PhysicalDevice &physicalDevice, vk::SurfaceKHR surface) {
+        const std::vector<vk::QueueFamilyProperties> queueFamilyProperties = physicalDevice.getQueueFamilyProperties();
+
+        uint32_t graphicsFamily = ~0u;
+        for (uint32_t familyIndex = 0; familyIndex < queueFamilyProperties.size(); ++familyIndex) {
+            if ((queueFamilyProperties[familyIndex].queueFlags & vk::QueueFlagBits::eGraphics) &&
+                physicalDevice.getSurfaceSupportKHR(familyIndex, surface)) {
+                graphicsFamily = familyIndex;
+                break;
+            }
+        }
+
+        if (graphicsFamily == ~0u) {
+            throw std::runtime_error("Could not find a queue for graphics and present -> terminating");
+        }
+
+        for (const vk::QueueFamilyProperties &properties : queueFamilyProperties) {
+            m_familyFlags.push_back(properties.queueFlags);
+        }
+
+        assignSlot(QueueType::Graphics, graphicsFamily, GRAPHICS_PRIORITY, queueFamilyProperties);
+        assignSlot(QueueType::Compute, findComputeFamily(queueFamilyProperties, graphicsFamily),
+                   COMPUTE_PRIORITY, queueFamilyProperties);
+        assignSlot(QueueType::Transfer, findTransferFamily(queueFamilyProperties, graphicsFamily),
+                   TRANSFER_PRIORITY, queueFamilyProperties);
+
+        /** One create info per family, its priorities ordered by queue index. */
+        for (uint32_t slotIndex = 0; slotIndex < m_slotCount; ++slotIndex) {
+            const Slot &current = m_slots[slotIndex];
+            if (current.index != 0) {
+                continue;
+            }
+
+            std::vector<float> &priorities = m_priorities.emplace_back();
+            for (uint32_t other = slotIndex; other < m_slotCount; ++other) {
+                if (m_slots[other].family == current.family) {
+                    priorities.push_back(m_slots[other].priority);
+                }
+            }
+        }
+
+        uint32_t familyIndex = 0;
+        for (uint32_t slotIndex = 0; slotIndex < m_slotCount; ++slotIndex) {
+            if (m_slots[slotIndex].index != 0) {
+                continue;
+            }
+
+            vk::DeviceQueueCreateInfo createInfo{};
+            createInfo.queueFamilyIndex = m_slots[slotIndex].family;
+            createInfo.queueCount = static_cast<uint32_t>(m_priorities[familyIndex].size());
+            createInfo.pQueuePriorities = m_priorities[familyIndex].data();
+            m_createInfos.push_back(createInfo);
+            familyIndex++;
+        }
+
+        for (size_t type = 0; type < QUEUE_TYPE_COUNT; ++type) {
+            const QueueType queueType = static_cast<QueueType>(type);
+            const Slot &assigned = slot(queueType);
+            ENGINE_CLOG_INFO(Render, "{} queue: family {} index {}{}", typeName(queueType), assigned.family, assigned.index,
+                            isDedicated(queueType) ? "" : " (shared)")
+        }
+    }
+
+    void DeviceQueues::assignSlot(QueueType type, uint32_t family, float priority,
+                                  const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties) {
+        uint32_t usedInFamily = 0;
+        uint32_t lastInFamily = ~0u;
+        for (uint32_t slotIndex = 0; slotIndex < m_slotCount; ++slotIndex) {
+            if (m_slots[slotIndex].family == family) {
+                usedInFamily++;
+                lastInFamily = slotIndex;
+            }
+        }
+
+        /** The family is out of queues, share the one created last and keep the higher priority. */
+        if (usedInFamily == queueFamilyProperties[family].queueCount) {
+            m_slotOfType[static_cast<size_t>(type)] = lastInFamily;
+            m_slots[lastInFamily].priority = std::max(m_slots[lastInFamily].priority, priority);
+            return;
+        }
+
+        Slot &created = m_slots[m_slotCount];
+        created.family = family;
+        created.index = usedInFamily;
+        created.priority = priority;
+        m_slotOfType[static_cast<size_t>(type)] = m_slotCount++;
+    }
+
+    void DeviceQueues::retrieve(const vk::raii::Device &device) {
+        for (uint32_t slotIndex = 0; slotIndex < m_slotCount; ++slotIndex) {
+            m_slots[slotIndex].queue = vk::raii::Queue(device, m_slots[slotIndex].family, m_slots[slotIndex].index);
+        }
+    }
+
+    bool DeviceQueues::isDedicated(QueueType type) const {
+        const uint32_t slotIndex = m_slotOfType[static_cast<size_t>(type)];
+
+        for (size_t other = 0; other < QUEUE_TYPE_COUNT; ++other) {
+            if (other != static_cast<size_t>(type) && m_slotOfType[other] == slotIndex) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void DeviceQueues::submit(QueueType type, const vk::SubmitInfo2 &submitInfo, vk::Fence fence) {
+        Slot &target = slot(type);
+        std::lock_guard<std::mutex> lock(target.mutex);
+        target.queue.submit2(submitInfo, fence);
+    }
+
+    vk::Result DeviceQueues::present(const vk::PresentInfoKHR &presentInfo) {
+        Slot &target = slot(QueueType::Graphics);
+        std::lock_guard<std::mutex> lock(target.mutex);
+        return target.queue.presentKHR(presentInfo);
+    }
+
+    const char *DeviceQueues::typeName(QueueType type) {
+        switch (type) {
+            case QueueType::Graphics: {
+                return "Graphics";
+            }
+
+            case QueueType::Compute: {
+                return "Compute";
+            }
+
+            case QueueType::Transfer: {
+                return "Transfer";
+            }
+        }
+
+        return "Unknown";
+    }
+
+    uint32_t DeviceQueues::findComputeFamily(const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties,
+                                             uint32_t graphicsFamily) {
+        /** A compute family without graphics runs on the async compute engines. */
+        for (uint32_t familyIndex = 0; familyIndex < queueFamilyProperties.size(); ++familyIndex) {
+            const vk::QueueFlags flags = queueFamilyProperties[familyIndex].queueFlags;
+            if ((flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics)) {
+                return familyIndex;
+            }
+        }
+
+        return graphicsFamily;
+    }
+
+    uint32_t DeviceQueues::findTransferFamily(const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties,
+                                              uint32_t graphicsFamily) {
+        /** Prefer a transfer-only family (DMA engine), then any family without graphics. */
+        uint32_t fallback = graphicsFamily;
+
+        for (uint32_t familyIndex = 0; familyIndex < queueFamilyProperties.size(); ++familyIndex) {
+            const vk::QueueFlags flags = queueFamilyProperties[familyIndex].queueFlags;
+            if (!(flags & vk::QueueFlagBits::eTransfer) || (flags & vk::QueueFlagBits::eGraphics)) {
+                continue;
+            }
+
+            if (!(flags & vk::QueueFlagBits::eCompute)) {
+                return familyIndex;
+            }
+
+            if (fallback == graphicsFamily) {
+                fallback = familyIndex;
+            }
+        }
+
+        return fallback;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef __ENGINE_DEVICE_QUEUES_HPP__
+#define __ENGINE_DEVICE_QUEUES_HPP__
+
+#include "Vulkan.hpp"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace Engine {
+    enum class QueueType : uint8_t {
+        /** Graphics, compute, transfer and present. */
+        Graphics,
+        /** Async compute, overlapping the graphics queue when the device has a compute-only family. */
+        Compute,
+        /** Copies, on the DMA engine when the device has a transfer-only family. */
+        Transfer
+    };
+
+    constexpr size_t QUEUE_TYPE_COUNT = 3;
+
+    /**
+     * Discovers the graphics, async compute and transfer queue families of a device and
+     * owns the queues created for them.
+     *
+     * Every type gets its own queue when the device allows it, otherwise it shares the
+     * queue of another type: compute falls back to the graphics queue and transfer to the
+     * compute or graphics queue. Graphics runs at the highest priority so background work
+     * never delays the frame. Queue access must be externally synchronised in Vulkan, so
+     * submissions go through submit()/present(), which lock the target queue and may be
+     * called from any thread.
+     *
+     * Construct before the device, pass createInfos() to vk::DeviceCreateInfo and call
+     * retrieve() once the device exists.
+     */
+    class DeviceQueues {
+    public:
+        /** Throws std::runtime_error when no family can both draw and present to `surface`. */
+        DeviceQueues(const vk::raii::PhysicalDevice &physicalDevice, vk::SurfaceKHR surface);
+
+        DeviceQueues(const DeviceQueues &) = delete;
+        DeviceQueues &operator=(const DeviceQueues &) = delete;
+
+        /** Queue create infos for the device, valid while this object lives. */
+        const std::vector<vk::DeviceQueueCreateInfo> &createInfos() const { return m_createInfos; }
+
+        void retrieve(const vk::raii::Device &device);
+
+        const vk::raii::Queue &queue(QueueType type) const { return slot(type).queue; }
+        uint32_t family(QueueType type) const { return slot(type).family; }
+        vk::QueueFlags familyFlags(QueueType type) const { return m_familyFlags[family(type)]; }
+
+        /** True when `type` has a queue of its own instead of sharing another type's queue. */
+        bool isDedicated(QueueType type) const;
+
+        /** True when `type` lives in another family than graphics and shared resources need ownership transfers. */
+        bool isSeparateFamily(QueueType type) const { return family(type) != family(QueueType::Graphics); }
+
+        void submit(QueueType type, const vk::SubmitInfo2 &submitInfo, vk::Fence fence = nullptr);
+
+        /** Presents on the graphics queue. vk::OutOfDateKHRError propagates to the caller. */
+        vk::Result present(const vk::PresentInfoKHR &presentInfo);
+
+        static const char *typeName(QueueType type);
+
+    private:
+        struct Slot {
+            uint32_t family = ~0u;
+            uint32_t index = 0;
+            float priority = 0.0f;
+            vk::raii::Queue queue = nullptr;
+            std::mutex mutex;
+        };
+
+        std::array<Slot, QUEUE_TYPE_COUNT> m_slots;
+        std::array<uint32_t, QUEUE_TYPE_COUNT> m_slotOfType{};
+        uint32_t m_slotCount = 0;
+
+        std::vector<vk::QueueFlags> m_familyFlags;
+        std::vector<std::vector<float>> m_priorities;
+        std::vector<vk::DeviceQueueCreateInfo> m_createInfos;
+
+        Slot &slot(QueueType type) { return m_slots[m_slotOfType[static_cast<size_t>(type)]]; }
+        const Slot &slot(QueueType type) const { return m_slots[m_slotOfType[static_cast<size_t>(type)]]; }
+
+        void assignSlot(QueueType type, uint32_t family, float priority,
+                        const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties);
+
+        static uint32_t findComputeFamily(const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties,
+                                          uint32_t graphicsFamily);
+        static uint32_t findTransferFamily(const std::vector<vk::QueueFamilyProperties> &queueFamilyProperties,
+                                           uint32_t graphicsFamily);
+    };
+}
+
+#endif
@@ -0,0 +1,255 @@
+#include "DeviceSelector.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace Engine {
+    namespace {
+        /** The device type dominates, the other terms only order devices of the same type. */
+        int64_t typeScore(vk::PhysicalDeviceType type) {
+            switch (type) {
+                case vk::PhysicalDeviceType::eDiscreteGpu: {
+                    return 100000;
+                }
+
+                case vk::PhysicalDeviceType::eIntegratedGpu: {
+                    return 50000;
+                }
+
+                case vk::PhysicalDeviceType::eVirtualGpu: {
+                    return 20000;
+                }
+
+                case vk::PhysicalDeviceType::eCpu: {
+                    return 0;
+                }
+
+                default: {
+                    return 10000;
+                }
+            }
+        }
+
+        constexpr int64_t DEDICATED_COMPUTE_SCORE = 2000;
+        constexpr int64_t DEDICATED_TRANSFER_SCORE = 1000;
+        constexpr int64_t OPTIONAL_FEATURE_SCORE = 500;
+        constexpr vk::DeviceSize BYTES_PER_MEMORY_POINT = 64ull * 1024ull * 1024ull;
+
+        std::string lowercase(std::string_view text) {
+            std::string result(text);
+            std::ranges::transform(result, result.begin(), [](unsigned char character) {
+                return static_cast<char>(std::tolower(character));
+            });
+            return result;
+        }
+    }
+
+    DeviceSelector::DeviceSelector(const std::vector<const char *> &requiredExtensions, vk::SurfaceKHR surface)
+        : m_requiredExtensions(requiredExtensions), m_surface(surface) {
+    }
+
+    vk::raii::PhysicalDevice DeviceSelector::select(const vk::raii::Instance &instance) const {
+        std::vector<vk::raii::PhysicalDevice> devices = instance.enumeratePhysicalDevices();
+        std::vector<DeviceEvaluation> evaluations;
+
+        for (size_t index = 0; index < devices.size(); ++index) {
+            DeviceEvaluation evaluation = evaluate(devices[index]);
+            const uint64_t memoryMiB = evaluation.deviceLocalBytes / (1024ull * 1024ull);
+
+            if (evaluation.suitable()) {
+                std::string strengths;
+                for (const std::string &strength : evaluation.strengths) {
+                    strengths += strengths.empty() ? strength : ", " + strength;
+                }
+                ENGINE_CLOG_INFO(Render, "GPU {}: {} ({}, {} MiB) accepted, score {}{}{}", index, evaluation.name,
+                                typeName(evaluation.type), memoryMiB, evaluation.score,
+                                strengths.empty() ? "" : ": ", strengths)
+            } else {
+                std::string missing;
+                for (const std::string &requirement : evaluation.missing) {
+                    missing += missing.empty() ? requirement : ", " + requirement;
+                }
+                ENGINE_CLOG_INFO(Render, "GPU {}: {} ({}, {} MiB) rejected, missing {}", index, evaluation.name,
+                                typeName(evaluation.type), memoryMiB, missing)
+            }
+
+            evaluations.push_back(std::move(evaluation));
+        }
+
+        size_t chosen = devices.size();
+
+        if (const char *value = std::getenv("ENGINE_GPU")) {
+            for (size_t index = 0; index < devices.size(); ++index) {
+                if (!matchesOverride(value, index, evaluations[index].name)) {
+                    continue;
+                }
+
+                if (evaluations[index].suitable()) {
+                    chosen = index;
+                    break;
+                }
+
+                ENGINE_CLOG_WARNING(Render, "ENGINE_GPU=\"{}\" matches {}, which cannot run the engine", value, evaluations[index].name)
+            }
+
+            if (chosen == devices.size()) {
+                ENGINE_CLOG_WARNING(Render, "ENGINE_GPU=\"{}\" matches no suitable GPU, falling back to the best ranked one", value)
+            }
+        }
+
+        if (chosen == devices.size()) {
+            for (size_t index = 0; index < devices.size(); ++index) {
+                if (evaluations[index].suitable() && (chosen == devices.size() || evaluations[index].score > evaluations[chosen].score)) {
+                    chosen = index;
+                }
+            }
+        }
+
+        if (chosen == devices.size()) {
+            throw std::runtime_error("failed to find a suitable GPU!");
+        }
+
+        ENGINE_CLOG_INFO(Render, "Selected GPU {}: {}", chosen, evaluations[chosen].name)
+        return devices[chosen];
+    }
+
+    DeviceEvaluation DeviceSelector::evaluate(const vk::raii::PhysicalDevice &device) const {
+        DeviceEvaluation evaluation;
+
+        const vk::PhysicalDeviceProperties properties = device.getProperties();
+        evaluation.name = properties.deviceName.data();
+        evaluation.type = properties.deviceType;
+
+        const vk::PhysicalDeviceMemoryProperties memoryProperties = device.getMemoryProperties();
+        for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; ++heapIndex) {
+            const vk::MemoryHeap &heap = memoryProperties.memoryHeaps[heapIndex];
+            if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal) {
+                evaluation.deviceLocalBytes = std::max(evaluation.deviceLocalBytes, heap.size);
+            }
+        }
+
+        if (properties.apiVersion < VK_API_VERSION_1_3) {
+            evaluation.missing.emplace_back("Vulkan 1.3");
+        }
+
+        const std::vector<vk::QueueFamilyProperties> queueFamilies = device.getQueueFamilyProperties();
+        bool drawsAndPresents = false;
+        bool dedicatedCompute = false;
+        bool dedicatedTransfer = false;
+        for (uint32_t familyIndex = 0; familyIndex < queueFamilies.size(); ++familyIndex) {
+            const vk::QueueFlags flags = queueFamilies[familyIndex].queueFlags;
+
+            if ((flags & vk::QueueFlagBits::eGraphics) && device.getSurfaceSupportKHR(familyIndex, m_surface)) {
+                drawsAndPresents = true;
+            }
+
+            if ((flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics)) {
+                dedicatedCompute = true;
+            }
+
+            if ((flags & vk::QueueFlagBits::eTransfer) && !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+                dedicatedTransfer = true;
+            }
+        }
+
+        if (!drawsAndPresents) {
+            evaluation.missing.emplace_back("a graphics queue that can present");
+        }
+
+        const std::vector<vk::ExtensionProperties> availableExtensions = device.enumerateDeviceExtensionProperties();
+        auto hasExtension = [&](const char *name) {
+            return std::ranges::any_of(availableExtensions, [name](const vk::ExtensionProperties &extension) {
+                return strcmp(extension.extensionName, name) == 0;
+            });
+        };
+
+        for (const char *extension : m_requiredExtensions) {
+            if (!hasExtension(extension)) {
+                evaluation.missing.emplace_back(extension);
+            }
+        }
+
+        auto features = device.template getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+        const auto &features12 = features.template get<vk::PhysicalDeviceVulkan12Features>();
+        const auto &features13 = features.template get<vk::PhysicalDeviceVulkan13Features>();
+        const auto &dynamicStateFeatures = features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+        const auto &coreFeatures = features.template get<vk::PhysicalDeviceFeatures2>().features;
+
+        auto require = [&](bool supported, const char *name) {
+            if (!supported) {
+                evaluation.missing.emplace_back(name);
+            }
+        };
+
+        require(features12.timelineSemaphore, "timelineSemaphore");
+        require(features12.drawIndirectCount, "drawIndirectCount");
+        require(features12.descriptorIndexing, "descriptorIndexing");
+        require(features12.runtimeDescriptorArray, "runtimeDescriptorArray");
+        require(features12.descriptorBindingPartiallyBound, "descriptorBindingPartiallyBound");
+        require(features12.descriptorBindingSampledImageUpdateAfterBind, "descriptorBindingSampledImageUpdateAfterBind");
+        require(features12.shaderSampledImageArrayNonUniformIndexing, "shaderSampledImageArrayNonUniformIndexing");
+        require(features13.dynamicRendering, "dynamicRendering");
+        require(features13.synchronization2, "synchronization2");
+        require(dynamicStateFeatures.extendedDynamicState, "extendedDynamicState");
+
+        evaluation.score = typeScore(properties.deviceType);
+
+        auto prefer = [&](bool supported, int64_t score, const char *name) {
+            if (supported) {
+                evaluation.score += score;
+                evaluation.strengths.emplace_back(name);
+            }
+        };
+
+        prefer(dedicatedCompute, DEDICATED_COMPUTE_SCORE, "async compute queue");
+        prefer(dedicatedTransfer, DEDICATED_TRANSFER_SCORE, "transfer queue");
+        prefer(coreFeatures.multiDrawIndirect, OPTIONAL_FEATURE_SCORE, "multiDrawIndirect");
+        prefer(coreFeatures.samplerAnisotropy, OPTIONAL_FEATURE_SCORE, "samplerAnisotropy");
+        prefer(properties.limits.timestampComputeAndGraphics, OPTIONAL_FEATURE_SCORE, "timestamps");
+        prefer(hasExtension(vk::EXTMemoryBudgetExtensionName), OPTIONAL_FEATURE_SCORE, "memory budget");
+
+        evaluation.score += static_cast<int64_t>(evaluation.deviceLocalBytes / BYTES_PER_MEMORY_POINT);
+
+        return evaluation;
+    }
+
+    const char *DeviceSelector::typeName(vk::PhysicalDeviceType type) {
+        switch (type) {
+            case vk::PhysicalDeviceType::eDiscreteGpu: {
+                return "discrete";
+            }
+
+            case vk::PhysicalDeviceType::eIntegratedGpu: {
+                return "integrated";
+            }
+
+            case vk::PhysicalDeviceType::eVirtualGpu: {
+                return "virtual";
+            }
+
+            case vk::PhysicalDeviceType::eCpu: {
+                return "cpu";
+            }
+
+            default: {
+                return "other";
+            }
+        }
+    }
+
+    bool DeviceSelector::matchesOverride(std::string_view value, size_t index, const std::string &name) {
+        size_t requestedIndex = 0;
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), requestedIndex);
+        if (error == std::errc() && end == value.data() + value.size()) {
+            return requestedIndex == index;
+        }
+
+        return !value.empty() && lowercase(name).find(lowercase(value)) != std::string::npos;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef __ENGINE_DEVICE_SELECTOR_HPP__
+#define __ENGINE_DEVICE_SELECTOR_HPP__
+
+#include "Vulkan.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Engine {
+    struct DeviceEvaluation {
+        std::string name;
+        vk::PhysicalDeviceType type = vk::PhysicalDeviceType::eOther;
+        vk::DeviceSize deviceLocalBytes = 0;
+
+        /** Empty when the device can run the engine. */
+        std::vector<std::string> missing;
+
+        /** Ranking among suitable devices, higher is better. */
+        int64_t score = 0;
+        std::vector<std::string> strengths;
+
+        bool suitable() const { return missing.empty(); }
+    };
+
+    /**
+     * Picks the physical device to render with.
+     *
+     * Devices lacking Vulkan 1.3, a required extension or feature, or a family that can both
+     * draw and present to the surface are rejected. The rest are ranked by device type
+     * (discrete over integrated over virtual over CPU implementations such as lavapipe),
+     * then dedicated compute and transfer queue families, optional features and device-local
+     * memory. Every device is logged with the reason it was accepted or rejected.
+     *
+     * ENGINE_GPU overrides the ranking with a device index or a case-insensitive part of its
+     * name. An override that matches no suitable device is reported and ignored.
+     */
+    class DeviceSelector {
+    public:
+        DeviceSelector(const std::vector<const char *> &requiredExtensions, vk::SurfaceKHR surface);
+
+        /** Throws std::runtime_error when no device is suitable. */
+        vk::raii::PhysicalDevice select(const vk::raii::Instance &instance) const;
+
+        DeviceEvaluation evaluate(const vk::raii::PhysicalDevice &device) const;
+
+        static const char *typeName(vk::PhysicalDeviceType type);
+
+    private:
+        std::vector<const char *> m_requiredExtensions;
+        vk::SurfaceKHR m_surface;
+
+        static bool matchesOverride(std::string_view value, size_t index, const std::string &name);
+    };
+}
+
+#endif
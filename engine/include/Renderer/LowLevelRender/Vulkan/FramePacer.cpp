@@ -0,0 +1,267 @@
+#include "FramePacer.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+
+namespace Engine {
+    FramePacer FramePacer::fromEnvironment() {
+        PacingMode mode = PacingMode::Mailbox;
+        double targetFramesPerSecond = 0.0;
+
+        if (const char *value = std::getenv("ENGINE_FRAME_PACING")) {
+            if (!parseMode(value, mode, targetFramesPerSecond)) {
+                ENGINE_CLOG_WARNING(Render, "Ignoring ENGINE_FRAME_PACING=\"{}\", expected uncapped, fifo, mailbox or cap:<fps>", value)
+                mode = PacingMode::Mailbox;
+                targetFramesPerSecond = 0.0;
+            }
+        }
+
+        return FramePacer(mode, targetFramesPerSecond);
+    }
+
+    FramePacer::FramePacer(PacingMode mode, double targetFramesPerSecond)
+        : m_mode(mode), m_targetFramesPerSecond(targetFramesPerSecond) {
+    }
+
+    bool FramePacer::parseMode(std::string_view text, PacingMode &mode, double &targetFramesPerSecond) {
+        if (text == "uncapped") {
+            mode = PacingMode::Uncapped;
+        } else if (text == "fifo") {
+            mode = PacingMode::Fifo;
+        } else if (text == "mailbox") {
+            mode = PacingMode::Mailbox;
+        } else if (text.starts_with("cap:")) {
+            const std::string_view number = text.substr(4);
+            uint32_t framesPerSecond = 0;
+            const auto [end, error] = std::from_chars(number.data(), number.data() + number.size(), framesPerSecond);
+            if (error != std::errc() || end != number.data() + number.size() || framesPerSecond == 0) {
+                return false;
+            }
+
+            mode = PacingMode::Capped;
+            targetFramesPerSecond = framesPerSecond;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    const char *FramePacer::modeName(PacingMode mode) {
+        switch (mode) {
+            case PacingMode::Uncapped: {
+                return "uncapped";
+            }
+
+            case PacingMode::Fifo: {
+                return "fifo";
+            }
+
+            case PacingMode::Mailbox: {
+                return "mailbox";
+            }
+
+            case PacingMode::Capped: {
+                return "capped";
+            }
+        }
+
+        return "unknown";
+    }
+
+    void FramePacer::setMode(PacingMode mode, double targetFramesPerSecond) {
+        /** Capped and uncapped differ only in the limiter, every other switch changes the present mode. */
+        const bool presentModeChanges = mode != m_mode &&
+            !((mode == PacingMode::Capped && m_mode == PacingMode::Uncapped) || (mode == PacingMode::Uncapped && m_mode == PacingMode::Capped));
+
+        m_mode = mode;
+        m_targetFramesPerSecond = targetFramesPerSecond;
+        m_nextFrameStart = {};
+        m_swapChainChanged = m_swapChainChanged || presentModeChanges;
+
+        /** Measurements of the previous mode say nothing about this one. */
+        m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+        m_measuredFrameTime.fill(0.0);
+        m_windowFrames = 0;
+        m_windowFrameTime = 0.0;
+        m_windowFenceWait = 0.0;
+        m_windowsSinceProbe = 0;
+    }
+
+    void FramePacer::setAdaptiveFramesInFlight(bool adaptive) {
+        m_adaptive = adaptive;
+        if (!adaptive) {
+            m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+        }
+    }
+
+    vk::PresentModeKHR FramePacer::choosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes) const {
+        auto supports = [&](vk::PresentModeKHR presentMode) {
+            return std::ranges::find(availablePresentModes, presentMode) != availablePresentModes.end();
+        };
+
+        switch (m_mode) {
+            case PacingMode::Uncapped:
+            case PacingMode::Capped: {
+                if (supports(vk::PresentModeKHR::eImmediate)) {
+                    return vk::PresentModeKHR::eImmediate;
+                }
+
+                return supports(vk::PresentModeKHR::eMailbox) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo;
+            }
+
+            case PacingMode::Mailbox: {
+                return supports(vk::PresentModeKHR::eMailbox) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo;
+            }
+
+            case PacingMode::Fifo: {
+                return vk::PresentModeKHR::eFifo;
+            }
+        }
+
+        return vk::PresentModeKHR::eFifo;
+    }
+
+    uint32_t FramePacer::chooseImageCount(const vk::SurfaceCapabilitiesKHR &capabilities) const {
+        /** Mailbox needs a spare image to replace, the other modes queue less with two. */
+        const uint32_t wanted = m_mode == PacingMode::Mailbox ? 3u : 2u;
+        uint32_t imageCount = std::max(wanted, capabilities.minImageCount);
+
+        if (capabilities.maxImageCount > 0) {
+            imageCount = std::min(imageCount, capabilities.maxImageCount);
+        }
+
+        return imageCount;
+    }
+
+    bool FramePacer::consumeSwapChainChange() {
+        return std::exchange(m_swapChainChanged, false);
+    }
+
+    void FramePacer::waitForFrameSlot() {
+        if (m_mode != PacingMode::Capped || m_targetFramesPerSecond <= 0.0) {
+            return;
+        }
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFramesPerSecond));
+        Clock::time_point now = Clock::now();
+
+        if (m_nextFrameStart > now) {
+            /** The OS sleep granularity is coarse, so only sleep while far away and spin the rest. */
+            const auto remaining = m_nextFrameStart - now;
+            if (remaining > SPIN_THRESHOLD) {
+                std::this_thread::sleep_for(remaining - SPIN_THRESHOLD);
+            }
+
+            while ((now = Clock::now()) < m_nextFrameStart) {
+                std::this_thread::yield();
+            }
+        }
+
+        /** After a long frame restart the schedule instead of rushing to catch up. */
+        m_nextFrameStart = std::max(m_nextFrameStart + period, now);
+    }
+
+    void FramePacer::markInputSampled() {
+        m_inputSampled = Clock::now();
+    }
+
+    void FramePacer::recordFenceWait(double milliseconds) {
+        m_windowFenceWait += milliseconds;
+    }
+
+    void FramePacer::markPresented() {
+        const Clock::time_point now = Clock::now();
+
+        if (m_lastPresent != Clock::time_point{}) {
+            const double frameTime = std::chrono::duration<double, std::milli>(now - m_lastPresent).count();
+            const double latency = std::chrono::duration<double, std::milli>(now - m_inputSampled).count();
+
+            m_frameTimes[m_historyHead] = static_cast<float>(frameTime);
+            m_latencies[m_historyHead] = static_cast<float>(latency);
+            m_historyHead = (m_historyHead + 1) % HISTORY_SIZE;
+            m_historyCount = std::min(m_historyCount + 1, HISTORY_SIZE);
+
+            m_windowFrameTime += frameTime;
+            if (++m_windowFrames == ADAPT_WINDOW) {
+                adaptFramesInFlight();
+            }
+        }
+
+        m_lastPresent = now;
+    }
+
+    void FramePacer::adaptFramesInFlight() {
+        const double average = m_windowFrameTime / m_windowFrames;
+        const double averageFenceWait = m_windowFenceWait / m_windowFrames;
+        m_windowFrames = 0;
+        m_windowFrameTime = 0.0;
+        m_windowFenceWait = 0.0;
+
+        if (!m_adaptive) {
+            return;
+        }
+
+        m_measuredFrameTime[m_framesInFlight] = average;
+        const double baseline = m_measuredFrameTime[MAX_FRAMES_IN_FLIGHT];
+        const uint32_t previous = m_framesInFlight;
+
+        if (m_framesInFlight == MAX_FRAMES_IN_FLIGHT) {
+            /** Probe right after measuring a fresh baseline, then again every REPROBE_WINDOWS windows. */
+            if (m_windowsSinceProbe == 0 || ++m_windowsSinceProbe > REPROBE_WINDOWS) {
+                m_framesInFlight--;
+                m_windowsSinceProbe = 1;
+            }
+        } else if (average > baseline * 1.05) {
+            m_framesInFlight++;
+            m_windowsSinceProbe = 1;
+        } else if (++m_windowsSinceProbe > REPROBE_WINDOWS) {
+            /** Conditions change, measure the full depth again before settling. */
+            m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+            m_windowsSinceProbe = 0;
+        } else if (m_framesInFlight > 1) {
+            m_framesInFlight--;
+        }
+
+        if (m_framesInFlight != previous) {
+            ENGINE_CLOG_DEBUG(Render, "Frame pacing: {} -> {} frames in flight ({:.2f} ms/frame, {:.2f} ms fence wait, baseline {:.2f} ms)",
+                             previous, m_framesInFlight, average, averageFenceWait, baseline)
+        }
+    }
+
+    FramePacingStatistics FramePacer::statistics() const {
+        FramePacingStatistics statistics;
+        statistics.framesInFlight = m_framesInFlight;
+
+        if (m_historyCount == 0) {
+            return statistics;
+        }
+
+        double frameSum = 0.0;
+        double latencySum = 0.0;
+        for (size_t i = 0; i < m_historyCount; ++i) {
+            frameSum += m_frameTimes[i];
+            latencySum += m_latencies[i];
+            statistics.worstFrameMilliseconds = std::max<double>(statistics.worstFrameMilliseconds, m_frameTimes[i]);
+            statistics.worstLatencyMilliseconds = std::max<double>(statistics.worstLatencyMilliseconds, m_latencies[i]);
+        }
+
+        statistics.averageFrameMilliseconds = frameSum / m_historyCount;
+        statistics.averageLatencyMilliseconds = latencySum / m_historyCount;
+
+        double variance = 0.0;
+        for (size_t i = 0; i < m_historyCount; ++i) {
+            const double delta = m_frameTimes[i] - statistics.averageFrameMilliseconds;
+            variance += delta * delta;
+        }
+        statistics.frameTimeDeviationMilliseconds = std::sqrt(variance / m_historyCount);
+
+        return statistics;
+    }
+}
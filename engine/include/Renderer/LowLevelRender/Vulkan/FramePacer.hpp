@@ -0,0 +1,112 @@
+#ifndef __ENGINE_FRAME_PACER_HPP__
+#define __ENGINE_FRAME_PACER_HPP__
+
+#include "Vulkan.hpp"
+
+#include <array>
+#include <chrono>
+#include <string_view>
+
+namespace Engine {
+    enum class PacingMode : uint8_t {
+        /** Immediate presentation when available, frames are never held back. */
+        Uncapped,
+        Fifo,
+        Mailbox,
+        /** CPU frame-rate limiter on top of mailbox (or immediate) presentation. */
+        Capped
+    };
+
+    struct FramePacingStatistics {
+        double averageFrameMilliseconds = 0.0;
+        double frameTimeDeviationMilliseconds = 0.0;
+        double worstFrameMilliseconds = 0.0;
+        double averageLatencyMilliseconds = 0.0;
+        double worstLatencyMilliseconds = 0.0;
+        uint32_t framesInFlight = MAX_FRAMES_IN_FLIGHT;
+    };
+
+    /**
+     * Chooses the present mode and swapchain depth for the selected pacing mode, limits the
+     * frame rate in Capped mode and measures frame times and input-to-present latency.
+     *
+     * Latency is measured from the input poll feeding a frame to the return of its present
+     * call, the part of the pipeline the engine controls. When adaptive, the pacer probes
+     * running with fewer frames in flight and keeps the lower depth while it costs less than
+     * 5% frame time, trading idle GPU queueing for lower latency.
+     */
+    class FramePacer {
+    public:
+        /** Reads ENGINE_FRAME_PACING: "uncapped", "fifo", "mailbox" or "cap:<fps>". */
+        static FramePacer fromEnvironment();
+
+        explicit FramePacer(PacingMode mode = PacingMode::Mailbox, double targetFramesPerSecond = 0.0);
+
+        /** Switching between modes with different present modes requests a swapchain rebuild. */
+        void setMode(PacingMode mode, double targetFramesPerSecond = 0.0);
+        PacingMode mode() const { return m_mode; }
+
+        void setAdaptiveFramesInFlight(bool adaptive);
+
+        vk::PresentModeKHR choosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes) const;
+        uint32_t chooseImageCount(const vk::SurfaceCapabilitiesKHR &capabilities) const;
+
+        /** Returns true once after a mode change that needs a new swapchain. */
+        bool consumeSwapChainChange();
+
+        /** Capped mode: sleeps most of the remaining frame budget and spins the rest. No-op otherwise. */
+        void waitForFrameSlot();
+
+        /** Call right after polling input for the frame. */
+        void markInputSampled();
+
+        /** Time the CPU spent blocked on the frame fence, a sign of being GPU bound. */
+        void recordFenceWait(double milliseconds);
+
+        /** Call right after the frame's present returns. */
+        void markPresented();
+
+        /** Frames the CPU may record ahead of the GPU, between 1 and MAX_FRAMES_IN_FLIGHT. */
+        uint32_t framesInFlight() const { return m_framesInFlight; }
+
+        /** Statistics over the last HISTORY_SIZE frames. */
+        FramePacingStatistics statistics() const;
+
+        static const char *modeName(PacingMode mode);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t HISTORY_SIZE = 256;
+        static constexpr uint32_t ADAPT_WINDOW = 120;
+        static constexpr uint32_t REPROBE_WINDOWS = 30;
+        static constexpr std::chrono::microseconds SPIN_THRESHOLD{2000};
+
+        PacingMode m_mode;
+        double m_targetFramesPerSecond;
+        bool m_swapChainChanged = false;
+
+        Clock::time_point m_nextFrameStart{};
+        Clock::time_point m_inputSampled{};
+        Clock::time_point m_lastPresent{};
+
+        std::array<float, HISTORY_SIZE> m_frameTimes{};
+        std::array<float, HISTORY_SIZE> m_latencies{};
+        size_t m_historyCount = 0;
+        size_t m_historyHead = 0;
+
+        bool m_adaptive = true;
+        uint32_t m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+        double m_windowFrameTime = 0.0;
+        double m_windowFenceWait = 0.0;
+        uint32_t m_windowFrames = 0;
+        uint32_t m_windowsSinceProbe = 0;
+        std::array<double, MAX_FRAMES_IN_FLIGHT + 1> m_measuredFrameTime{};
+
+        void adaptFramesInFlight();
+
+        static bool parseMode(std::string_view text, PacingMode &mode, double &targetFramesPerSecond);
+    };
+}
+
+#endif
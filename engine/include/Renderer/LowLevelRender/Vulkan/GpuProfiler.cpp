@@ -0,0 +1,309 @@
+#include "GpuProfiler.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <tuple>
+
+namespace Engine {
+    namespace {
+        constexpr uint32_t STATISTIC_COUNT = 6;
+
+        std::string escapeJson(std::string_view text) {
+            std::string result;
+            for (const char character : text) {
+                if (character == '"' || character == '\\') {
+                    result += '\\';
+                }
+                result += character;
+            }
+            return result;
+        }
+    }
+
+    GpuProfilerMode GpuProfiler::modeFromEnvironment() {
+        GpuProfilerMode mode = GpuProfilerMode::Timestamps;
+
+        if (const char *value = std::getenv("ENGINE_GPU_PROFILER")) {
+            if (!parseMode(value, mode)) {
+                ENGINE_CLOG_WARNING(Render, "Ignoring ENGINE_GPU_PROFILER=\"{}\", expected off, timestamps or statistics", value)
+                mode = GpuProfilerMode::Timestamps;
+            }
+        }
+
+        return mode;
+    }
+
+    GpuProfiler::GpuProfiler(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                             uint32_t queueFamily, GpuProfilerMode mode, bool statisticsSupported)
+        : m_mode(mode) {
+        const vk::PhysicalDeviceProperties properties = physicalDevice.getProperties();
+        const uint32_t validBits = physicalDevice.getQueueFamilyProperties()[queueFamily].timestampValidBits;
+
+        if (m_mode != GpuProfilerMode::Off && validBits == 0) {
+            ENGINE_CLOG_WARNING(Render, "The graphics queue has no timestamp support, GPU profiling disabled")
+            m_mode = GpuProfilerMode::Off;
+        }
+
+        if (m_mode == GpuProfilerMode::Statistics && !statisticsSupported) {
+            ENGINE_CLOG_WARNING(Render, "Pipeline-statistics queries are not supported, GPU profiling falls back to timestamps")
+            m_mode = GpuProfilerMode::Timestamps;
+        }
+
+        if (m_mode == GpuProfilerMode::Off) {
+            return;
+        }
+
+        m_timestampPeriod = properties.limits.timestampPeriod;
+        m_timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+        for (FrameQueries &frame : m_frames) {
+            vk::QueryPoolCreateInfo timestampInfo{};
+            timestampInfo.queryType = vk::QueryType::eTimestamp;
+            timestampInfo.queryCount = MAX_PASSES * 2;
+            frame.timestamps = vk::raii::QueryPool(device, timestampInfo);
+
+            if (m_mode == GpuProfilerMode::Statistics) {
+                vk::QueryPoolCreateInfo statisticsInfo{};
+                statisticsInfo.queryType = vk::QueryType::ePipelineStatistics;
+                statisticsInfo.queryCount = MAX_PASSES;
+                statisticsInfo.pipelineStatistics = STATISTIC_FLAGS;
+                frame.statistics = vk::raii::QueryPool(device, statisticsInfo);
+            }
+        }
+
+        ENGINE_CLOG_INFO(Render, "GPU profiler: {} ({:.3f} ns per tick, {} valid timestamp bits)", modeName(m_mode), m_timestampPeriod, validBits)
+    }
+
+    bool GpuProfiler::parseMode(std::string_view text, GpuProfilerMode &mode) {
+        if (text == "off") {
+            mode = GpuProfilerMode::Off;
+        } else if (text == "timestamps") {
+            mode = GpuProfilerMode::Timestamps;
+        } else if (text == "statistics") {
+            mode = GpuProfilerMode::Statistics;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    const char *GpuProfiler::modeName(GpuProfilerMode mode) {
+        switch (mode) {
+            case GpuProfilerMode::Off: {
+                return "off";
+            }
+
+            case GpuProfilerMode::Timestamps: {
+                return "timestamps";
+            }
+
+            case GpuProfilerMode::Statistics: {
+                return "statistics";
+            }
+        }
+
+        return "unknown";
+    }
+
+    vk::QueryPipelineStatisticFlags GpuProfiler::inheritedStatistics() const {
+        return m_mode == GpuProfilerMode::Statistics ? STATISTIC_FLAGS : vk::QueryPipelineStatisticFlags{};
+    }
+
+    void GpuProfiler::beginFrame(const vk::raii::CommandBuffer &commandBuffer, uint32_t frameIndex) {
+        if (m_mode == GpuProfilerMode::Off) {
+            return;
+        }
+
+        FrameQueries &frame = m_frames[frameIndex];
+        resolve(frame);
+
+        commandBuffer.resetQueryPool(*frame.timestamps, 0, MAX_PASSES * 2);
+        if (m_mode == GpuProfilerMode::Statistics) {
+            commandBuffer.resetQueryPool(*frame.statistics, 0, MAX_PASSES);
+        }
+
+        frame.frameNumber = m_frameNumber++;
+        m_recording = &frame;
+    }
+
+    void GpuProfiler::beginPass(const vk::raii::CommandBuffer &commandBuffer, const char *passName) {
+        if (!m_recording || m_recording->passNames.size() >= MAX_PASSES) {
+            return;
+        }
+
+        const uint32_t passIndex = static_cast<uint32_t>(m_recording->passNames.size());
+        m_recording->passNames.emplace_back(passName);
+
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, *m_recording->timestamps, passIndex * 2);
+        if (m_mode == GpuProfilerMode::Statistics) {
+            commandBuffer.beginQuery(*m_recording->statistics, passIndex, {});
+        }
+    }
+
+    void GpuProfiler::endPass(const vk::raii::CommandBuffer &commandBuffer, const char *passName) {
+        if (!m_recording || m_recording->passNames.empty() || m_recording->passNames.back() != passName) {
+            return;
+        }
+
+        const uint32_t passIndex = static_cast<uint32_t>(m_recording->passNames.size() - 1);
+
+        if (m_mode == GpuProfilerMode::Statistics) {
+            commandBuffer.endQuery(*m_recording->statistics, passIndex);
+        }
+        commandBuffer.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, *m_recording->timestamps, passIndex * 2 + 1);
+    }
+
+    void GpuProfiler::resolveAll() {
+        if (m_mode == GpuProfilerMode::Off) {
+            return;
+        }
+
+        /** Oldest frame first, so the trace stays in submission order. */
+        std::array<FrameQueries *, MAX_FRAMES_IN_FLIGHT> pending{};
+        for (size_t i = 0; i < m_frames.size(); ++i) {
+            pending[i] = &m_frames[i];
+        }
+        std::ranges::sort(pending, {}, [](const FrameQueries *frame) { return frame->frameNumber; });
+
+        for (FrameQueries *frame : pending) {
+            resolve(*frame);
+        }
+        m_recording = nullptr;
+    }
+
+    void GpuProfiler::resolve(FrameQueries &frame) {
+        const uint32_t passCount = static_cast<uint32_t>(frame.passNames.size());
+        if (passCount == 0) {
+            return;
+        }
+
+        /** The frame fence was waited on, only a frame that never got submitted reports eNotReady and is dropped. */
+        auto [timestampResult, timestamps] = frame.timestamps.getResults<uint64_t>(
+            0, passCount * 2, passCount * 2 * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+
+        std::vector<uint64_t> statistics;
+        vk::Result statisticsResult = vk::Result::eSuccess;
+        if (m_mode == GpuProfilerMode::Statistics) {
+            std::tie(statisticsResult, statistics) = frame.statistics.getResults<uint64_t>(
+                0, passCount, passCount * STATISTIC_COUNT * sizeof(uint64_t), STATISTIC_COUNT * sizeof(uint64_t),
+                vk::QueryResultFlagBits::e64);
+        }
+
+        std::vector<std::string> passNames = std::move(frame.passNames);
+        frame.passNames.clear();
+
+        if (timestampResult != vk::Result::eSuccess || statisticsResult != vk::Result::eSuccess) {
+            return;
+        }
+
+        if (!m_hasTimeOrigin) {
+            m_timeOrigin = timestamps[0] & m_timestampMask;
+            m_hasTimeOrigin = true;
+        }
+
+        m_lastFrame.clear();
+        for (uint32_t passIndex = 0; passIndex < passCount; ++passIndex) {
+            GpuPassTiming timing;
+            timing.name = std::move(passNames[passIndex]);
+
+            const uint64_t begin = (timestamps[passIndex * 2] - m_timeOrigin) & m_timestampMask;
+            const uint64_t duration = (timestamps[passIndex * 2 + 1] - timestamps[passIndex * 2]) & m_timestampMask;
+            timing.beginNanoseconds = static_cast<double>(begin) * m_timestampPeriod;
+            timing.endNanoseconds = timing.beginNanoseconds + static_cast<double>(duration) * m_timestampPeriod;
+
+            if (!statistics.empty()) {
+                const uint64_t *values = &statistics[passIndex * STATISTIC_COUNT];
+                timing.statistics = {values[0], values[1], values[2], values[3], values[4], values[5]};
+            }
+
+            const double milliseconds = timing.milliseconds();
+            PassAggregate &aggregate = m_table[timing.name];
+            aggregate.minMilliseconds = aggregate.samples == 0 ? milliseconds : std::min(aggregate.minMilliseconds, milliseconds);
+            aggregate.maxMilliseconds = std::max(aggregate.maxMilliseconds, milliseconds);
+            aggregate.totalMilliseconds += milliseconds;
+            aggregate.lastStatistics = timing.statistics;
+            aggregate.samples++;
+
+            m_lastFrame.push_back(std::move(timing));
+        }
+
+        m_trace.emplace_back(frame.frameNumber, m_lastFrame);
+        if (m_trace.size() > TRACE_FRAMES) {
+            m_trace.pop_front();
+        }
+    }
+
+    std::string GpuProfiler::formatTable() const {
+        const bool statistics = m_mode == GpuProfilerMode::Statistics;
+        std::string table = statistics
+            ? "pass                  avg(ms)   min(ms)   max(ms)    vertices   fragments     compute\n"
+            : "pass                  avg(ms)   min(ms)   max(ms)\n";
+
+        char line[160];
+        for (const auto &[name, aggregate] : m_table) {
+            const double average = aggregate.totalMilliseconds / static_cast<double>(aggregate.samples);
+            if (statistics) {
+                const GpuPipelineStatistics &counters = aggregate.lastStatistics;
+                std::snprintf(line, sizeof(line), "%-20.20s  %7.3f  %8.3f  %8.3f  %10llu  %10llu  %10llu\n", name.c_str(),
+                              average, aggregate.minMilliseconds, aggregate.maxMilliseconds,
+                              static_cast<unsigned long long>(counters.vertexInvocations),
+                              static_cast<unsigned long long>(counters.fragmentInvocations),
+                              static_cast<unsigned long long>(counters.computeInvocations));
+            } else {
+                std::snprintf(line, sizeof(line), "%-20.20s  %7.3f  %8.3f  %8.3f\n", name.c_str(),
+                              average, aggregate.minMilliseconds, aggregate.maxMilliseconds);
+            }
+            table += line;
+        }
+
+        return table;
+    }
+
+    void GpuProfiler::resetTable() {
+        m_table.clear();
+    }
+
+    bool GpuProfiler::exportTrace(const std::filesystem::path &path) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        /** Trace-event timestamps are microseconds, one complete ("X") event per pass; keep them to the nanosecond. */
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto &[frameNumber, passes] : m_trace) {
+            for (const GpuPassTiming &pass : passes) {
+                file << (first ? "\n" : ",\n");
+                first = false;
+
+                file << "{\"name\":\"" << escapeJson(pass.name) << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+                     << ",\"ts\":" << pass.beginNanoseconds * 1e-3
+                     << ",\"dur\":" << (pass.endNanoseconds - pass.beginNanoseconds) * 1e-3
+                     << ",\"args\":{\"frame\":" << frameNumber;
+
+                if (m_mode == GpuProfilerMode::Statistics) {
+                    const GpuPipelineStatistics &counters = pass.statistics;
+                    file << ",\"inputVertices\":" << counters.inputVertices
+                         << ",\"inputPrimitives\":" << counters.inputPrimitives
+                         << ",\"vertexInvocations\":" << counters.vertexInvocations
+                         << ",\"clippingPrimitives\":" << counters.clippingPrimitives
+                         << ",\"fragmentInvocations\":" << counters.fragmentInvocations
+                         << ",\"computeInvocations\":" << counters.computeInvocations;
+                }
+
+                file << "}}";
+            }
+        }
+        file << "\n]}\n";
+
+        return static_cast<bool>(file);
+    }
+}
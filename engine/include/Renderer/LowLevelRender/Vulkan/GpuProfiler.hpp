@@ -0,0 +1,144 @@
+#ifndef __ENGINE_GPU_PROFILER_HPP__
+#define __ENGINE_GPU_PROFILER_HPP__
+
+#include "Vulkan.hpp"
+
+#include <array>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace Engine {
+    enum class GpuProfilerMode : uint8_t {
+        Off,
+        Timestamps,
+        /** Timestamps plus pipeline-statistics queries, when the device supports them. */
+        Statistics
+    };
+
+    /** Counters of one pipeline-statistics query, in the order of GpuProfiler::STATISTIC_FLAGS. */
+    struct GpuPipelineStatistics {
+        uint64_t inputVertices = 0;
+        uint64_t inputPrimitives = 0;
+        uint64_t vertexInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentInvocations = 0;
+        uint64_t computeInvocations = 0;
+    };
+
+    struct GpuPassTiming {
+        std::string name;
+        /** GPU timestamps of the pass in nanoseconds, relative to the start of the first resolved frame. */
+        double beginNanoseconds = 0.0;
+        double endNanoseconds = 0.0;
+        GpuPipelineStatistics statistics;
+
+        double milliseconds() const { return (endNanoseconds - beginNanoseconds) * 1e-6; }
+    };
+
+    /**
+     * Measures the GPU time of every render graph pass with timestamp queries and, in
+     * Statistics mode, the pipeline statistics of each pass.
+     *
+     * Every frame in flight owns its query pools. The results of a frame are read when its
+     * slot comes around again, after the frame fence was waited on, so reading never stalls
+     * and lags MAX_FRAMES_IN_FLIGHT frames behind. Passes are aggregated into a per-pass table
+     * and the last TRACE_FRAMES frames can be written as a Chrome trace (chrome://tracing,
+     * Perfetto).
+     */
+    class GpuProfiler {
+    public:
+        static constexpr uint32_t MAX_PASSES = 64;
+        static constexpr size_t TRACE_FRAMES = 600;
+        static constexpr vk::QueryPipelineStatisticFlags STATISTIC_FLAGS =
+            vk::QueryPipelineStatisticFlagBits::eInputAssemblyVertices |
+            vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+            vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+            vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+            vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+            vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+
+        /** Reads ENGINE_GPU_PROFILER: "off", "timestamps" (default) or "statistics". */
+        static GpuProfilerMode modeFromEnvironment();
+
+        /**
+         * `mode` is lowered when the device cannot honour it: Off without timestamp support on
+         * `queueFamily`, Timestamps when `statisticsSupported` is false.
+         */
+        GpuProfiler(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                    uint32_t queueFamily, GpuProfilerMode mode, bool statisticsSupported);
+
+        GpuProfiler(const GpuProfiler &) = delete;
+        GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+        /**
+         * Resolves the queries the slot carried last time and resets them. Record at the start
+         * of the frame's command buffer, after the frame fence was waited on.
+         */
+        void beginFrame(const vk::raii::CommandBuffer &commandBuffer, uint32_t frameIndex);
+
+        /** Render graph pass hooks. Passes beyond MAX_PASSES in a frame are not measured. */
+        void beginPass(const vk::raii::CommandBuffer &commandBuffer, const char *passName);
+        void endPass(const vk::raii::CommandBuffer &commandBuffer, const char *passName);
+
+        /** Resolves every slot still holding results. Only call when the device is idle. */
+        void resolveAll();
+
+        /** Statistics flags secondary command buffers executed inside a measured pass must inherit. */
+        vk::QueryPipelineStatisticFlags inheritedStatistics() const;
+
+        GpuProfilerMode mode() const { return m_mode; }
+
+        /** Passes of the most recently resolved frame. */
+        const std::vector<GpuPassTiming> &lastFrame() const { return m_lastFrame; }
+
+        /** Per-pass average, minimum and maximum since the last resetTable(). */
+        std::string formatTable() const;
+        void resetTable();
+
+        /** Writes the retained frames as Chrome trace-event JSON. Returns false when the file cannot be written. */
+        bool exportTrace(const std::filesystem::path &path) const;
+
+        static const char *modeName(GpuProfilerMode mode);
+
+    private:
+        struct FrameQueries {
+            vk::raii::QueryPool timestamps = nullptr;
+            vk::raii::QueryPool statistics = nullptr;
+            std::vector<std::string> passNames;
+            uint64_t frameNumber = 0;
+        };
+
+        struct PassAggregate {
+            uint64_t samples = 0;
+            double totalMilliseconds = 0.0;
+            double minMilliseconds = 0.0;
+            double maxMilliseconds = 0.0;
+            GpuPipelineStatistics lastStatistics;
+        };
+
+        GpuProfilerMode m_mode;
+        double m_timestampPeriod = 1.0;
+        uint64_t m_timestampMask = ~0ull;
+
+        std::array<FrameQueries, MAX_FRAMES_IN_FLIGHT> m_frames;
+        FrameQueries *m_recording = nullptr;
+        uint64_t m_frameNumber = 0;
+
+        /** Raw timestamp the trace is relative to, taken from the first resolved frame. */
+        uint64_t m_timeOrigin = 0;
+        bool m_hasTimeOrigin = false;
+
+        std::vector<GpuPassTiming> m_lastFrame;
+        std::map<std::string, PassAggregate, std::less<>> m_table;
+        std::deque<std::pair<uint64_t, std::vector<GpuPassTiming>>> m_trace;
+
+        void resolve(FrameQueries &frame);
+
+        static bool parseMode(std::string_view text, GpuProfilerMode &mode);
+    };
+}
+
+#endif
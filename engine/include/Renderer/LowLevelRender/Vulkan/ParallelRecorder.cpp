@@ -0,0 +1,109 @@
+#include "ParallelRecorder.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace Engine {
+    ParallelRecorder::ParallelRecorder(const vk::raii::Device &device, uint32_t queueFamilyIndex,
+                                       WorkerThreadPool &workerPool)
+        : m_device(device), m_workerPool(workerPool) {
+        const uint32_t threadCount = workerPool.threadCount();
+
+        for (auto &frameStates : m_threadStates) {
+            frameStates.resize(threadCount);
+
+            for (ThreadFrameState &state : frameStates) {
+                vk::CommandPoolCreateInfo poolInfo{};
+                poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+                poolInfo.queueFamilyIndex = queueFamilyIndex;
+                state.pool = vk::raii::CommandPool(device, poolInfo);
+            }
+        }
+
+        m_counters.resize(threadCount);
+    }
+
+    void ParallelRecorder::beginFrame(uint32_t frameIndex) {
+        m_frameIndex = frameIndex;
+
+        for (ThreadFrameState &state : m_threadStates[m_frameIndex]) {
+            state.pool.reset();
+            state.used = 0;
+        }
+    }
+
+    const vk::raii::CommandBuffer &ParallelRecorder::acquireBuffer(ThreadFrameState &state) {
+        if (state.used == state.buffers.size()) {
+            vk::CommandBufferAllocateInfo allocInfo{};
+            allocInfo.commandPool = *state.pool;
+            allocInfo.level = vk::CommandBufferLevel::eSecondary;
+            allocInfo.commandBufferCount = 1;
+            state.buffers.push_back(std::move(vk::raii::CommandBuffers(m_device, allocInfo).front()));
+        }
+
+        return state.buffers[state.used++];
+    }
+
+    std::vector<vk::CommandBuffer> ParallelRecorder::record(const vk::CommandBufferInheritanceRenderingInfo &renderingInfo,
+                                                            const std::vector<RenderWorkItem> &items,
+                                                            vk::QueryPipelineStatisticFlags inheritedStatistics) {
+        std::vector<vk::CommandBuffer> result(items.size());
+
+        for (ThreadCounters &counters : m_counters) {
+            counters = ThreadCounters{};
+        }
+
+        std::vector<ThreadFrameState> &frameStates = m_threadStates[m_frameIndex];
+
+        m_workerPool.parallelFor(static_cast<uint32_t>(items.size()), [&](uint32_t index, uint32_t threadIndex) {
+            const auto start = std::chrono::steady_clock::now();
+
+            const vk::raii::CommandBuffer &commandBuffer = acquireBuffer(frameStates[threadIndex]);
+
+            vk::CommandBufferInheritanceInfo inheritanceInfo{};
+            inheritanceInfo.pNext = &renderingInfo;
+            inheritanceInfo.pipelineStatistics = inheritedStatistics;
+
+            vk::CommandBufferBeginInfo beginInfo{};
+            beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+            beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+            commandBuffer.begin(beginInfo);
+            items[index].record(commandBuffer);
+            commandBuffer.end();
+
+            result[index] = *commandBuffer;
+
+            ThreadCounters &counters = m_counters[threadIndex];
+            counters.itemCount++;
+            counters.recordMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+
+        m_lastTimings.clear();
+        for (uint32_t threadIndex = 0; threadIndex < m_counters.size(); ++threadIndex) {
+            if (m_counters[threadIndex].itemCount == 0) {
+                continue;
+            }
+
+            ThreadRecordTiming timing{};
+            timing.threadIndex = threadIndex;
+            timing.itemCount = m_counters[threadIndex].itemCount;
+            timing.recordMilliseconds = m_counters[threadIndex].recordMilliseconds;
+            m_lastTimings.push_back(timing);
+        }
+
+        return result;
+    }
+
+    std::string ParallelRecorder::formatTimings() const {
+        std::string table = "thread  items  record(ms)\n";
+
+        char line[64];
+        for (const ThreadRecordTiming &timing : m_lastTimings) {
+            std::snprintf(line, sizeof(line), "%6u  %5u  %10.3f\n", timing.threadIndex, timing.itemCount, timing.recordMilliseconds);
+            table += line;
+        }
+
+        return table;
+    }
+}
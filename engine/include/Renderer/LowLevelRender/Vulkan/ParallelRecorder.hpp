@@ -0,0 +1,85 @@
+#ifndef __ENGINE_PARALLEL_RECORDER_HPP__
+#define __ENGINE_PARALLEL_RECORDER_HPP__
+
+#include "Vulkan.hpp"
+
+#include "../../../core/Threading/WorkerThreadPool.hpp"
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Engine {
+    /** One unit of draw recording, executed on whichever worker picks it up. */
+    struct RenderWorkItem {
+        const char *name = "";
+        std::function<void(const vk::raii::CommandBuffer &commandBuffer)> record;
+    };
+
+    /** CPU time spent by one thread on the last recorded frame. */
+    struct ThreadRecordTiming {
+        uint32_t threadIndex = 0;
+        uint32_t itemCount = 0;
+        double recordMilliseconds = 0.0;
+    };
+
+    /**
+     * Records dynamic-rendering secondary command buffers on the worker pool.
+     *
+     * Each thread owns one command pool per frame in flight, so recording never takes a
+     * lock. The returned buffers are in work-item order and the main thread only has to
+     * execute them inside its own beginRendering() scope.
+     */
+    class ParallelRecorder {
+    public:
+        ParallelRecorder(const vk::raii::Device &device, uint32_t queueFamilyIndex, WorkerThreadPool &workerPool);
+
+        ParallelRecorder(const ParallelRecorder &) = delete;
+        ParallelRecorder &operator=(const ParallelRecorder &) = delete;
+
+        /** Resets the pools of `frameIndex`. Call once the frame's fence signalled. */
+        void beginFrame(uint32_t frameIndex);
+
+        /**
+         * Records every item into its own secondary command buffer, continuing a rendering
+         * scope described by `renderingInfo`. `inheritedStatistics` must match the pipeline-statistics
+         * query active in the primary, if any. Blocks until all items are recorded.
+         */
+        std::vector<vk::CommandBuffer> record(const vk::CommandBufferInheritanceRenderingInfo &renderingInfo,
+                                              const std::vector<RenderWorkItem> &items,
+                                              vk::QueryPipelineStatisticFlags inheritedStatistics = {});
+
+        /** Per-thread recording cost of the last record() call, threads without work are omitted. */
+        const std::vector<ThreadRecordTiming> &lastTimings() const { return m_lastTimings; }
+
+        /** Human-readable table of lastTimings(). */
+        std::string formatTimings() const;
+
+    private:
+        struct ThreadFrameState {
+            vk::raii::CommandPool pool = nullptr;
+            std::vector<vk::raii::CommandBuffer> buffers;
+            uint32_t used = 0;
+        };
+
+        /** Padded so threads updating their own timings do not share a cache line. */
+        struct alignas(64) ThreadCounters {
+            uint32_t itemCount = 0;
+            double recordMilliseconds = 0.0;
+        };
+
+        const vk::raii::Device &m_device;
+        WorkerThreadPool &m_workerPool;
+
+        /** Indexed [frame][thread]. */
+        std::array<std::vector<ThreadFrameState>, MAX_FRAMES_IN_FLIGHT> m_threadStates;
+        std::vector<ThreadCounters> m_counters;
+        std::vector<ThreadRecordTiming> m_lastTimings;
+        uint32_t m_frameIndex = 0;
+
+        const vk::raii::CommandBuffer &acquireBuffer(ThreadFrameState &state);
+    };
+}
+
+#endif
@@ -0,0 +1,758 @@
+#include "RenderGraph.hpp"
+
+#include <algorithm>
+
+namespace Engine {
+    namespace {
+        struct UsageInfo {
+            vk::PipelineStageFlags2 stages;
+            vk::AccessFlags2 access;
+            vk::ImageLayout layout;
+            vk::ImageUsageFlags imageUsage;
+        };
+
+        UsageInfo getUsageInfo(RenderGraphUsage usage, bool write) {
+            switch (usage) {
+                case RenderGraphUsage::ColorAttachment: {
+                    return {vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                            write ? vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eColorAttachmentRead
+                                  : vk::AccessFlags2(vk::AccessFlagBits2::eColorAttachmentRead),
+                            vk::ImageLayout::eColorAttachmentOptimal, vk::ImageUsageFlagBits::eColorAttachment};
+                }
+
+                case RenderGraphUsage::DepthAttachment: {
+                    return {vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                            vk::AccessFlagBits2::eDepthStencilAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentRead,
+                            vk::ImageLayout::eDepthStencilAttachmentOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment};
+                }
+
+                case RenderGraphUsage::DepthRead: {
+                    return {vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests |
+                                vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eShaderSampledRead,
+                            vk::ImageLayout::eDepthStencilReadOnlyOptimal,
+                            vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled};
+                }
+
+                case RenderGraphUsage::SampledFragment: {
+                    return {vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eShaderSampledRead,
+                            vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageUsageFlagBits::eSampled};
+                }
+
+                case RenderGraphUsage::SampledCompute: {
+                    return {vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderSampledRead,
+                            vk::ImageLayout::eShaderReadOnlyOptimal, vk::ImageUsageFlagBits::eSampled};
+                }
+
+                case RenderGraphUsage::StorageRead: {
+                    return {vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageRead,
+                            vk::ImageLayout::eGeneral, vk::ImageUsageFlagBits::eStorage};
+                }
+
+                case RenderGraphUsage::StorageWrite: {
+                    return {vk::PipelineStageFlagBits2::eComputeShader,
+                            vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eShaderStorageRead,
+                            vk::ImageLayout::eGeneral, vk::ImageUsageFlagBits::eStorage};
+                }
+
+                case RenderGraphUsage::TransferSource: {
+                    return {vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferRead,
+                            vk::ImageLayout::eTransferSrcOptimal, vk::ImageUsageFlagBits::eTransferSrc};
+                }
+
+                case RenderGraphUsage::TransferDestination: {
+                    return {vk::PipelineStageFlagBits2::eAllTransfer, vk::AccessFlagBits2::eTransferWrite,
+                            vk::ImageLayout::eTransferDstOptimal, vk::ImageUsageFlagBits::eTransferDst};
+                }
+
+                case RenderGraphUsage::IndirectRead: {
+                    return {vk::PipelineStageFlagBits2::eDrawIndirect, vk::AccessFlagBits2::eIndirectCommandRead,
+                            vk::ImageLayout::eUndefined, {}};
+                }
+
+                case RenderGraphUsage::VertexRead: {
+                    return {vk::PipelineStageFlagBits2::eVertexAttributeInput, vk::AccessFlagBits2::eVertexAttributeRead,
+                            vk::ImageLayout::eUndefined, {}};
+                }
+
+                case RenderGraphUsage::IndexRead: {
+                    return {vk::PipelineStageFlagBits2::eIndexInput, vk::AccessFlagBits2::eIndexRead,
+                            vk::ImageLayout::eUndefined, {}};
+                }
+            }
+
+            return {};
+        }
+
+        constexpr vk::AccessFlags2 WRITE_ACCESS_MASK =
+            vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+            vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite;
+
+        /** Synchronization state of one resource while walking the passes in order. */
+        struct ResourceState {
+            vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags2 writeStages;
+            vk::AccessFlags2 writeAccess;
+            vk::PipelineStageFlags2 readStages;
+            vk::AccessFlags2 readAccess;
+        };
+    }
+
+    void RenderGraphPassBuilder::read(RenderGraphHandle handle, RenderGraphUsage usage) {
+        m_graph.m_passes[m_passIndex].accesses.push_back({handle, usage, false});
+    }
+
+    void RenderGraphPassBuilder::write(RenderGraphHandle handle, RenderGraphUsage usage) {
+        m_graph.m_passes[m_passIndex].accesses.push_back({handle, usage, true});
+    }
+
+    void RenderGraphPassBuilder::colorAttachment(RenderGraphHandle handle, vk::AttachmentLoadOp loadOp, vk::ClearColorValue clearValue) {
+        /** Loading keeps the previous contents, which makes the previous writer a dependency. */
+        if (loadOp == vk::AttachmentLoadOp::eLoad) {
+            read(handle, RenderGraphUsage::ColorAttachment);
+        }
+        write(handle, RenderGraphUsage::ColorAttachment);
+
+        m_graph.m_passes[m_passIndex].colorAttachments.push_back({handle, loadOp, vk::ClearValue(clearValue)});
+    }
+
+    void RenderGraphPassBuilder::depthAttachment(RenderGraphHandle handle, vk::AttachmentLoadOp loadOp, float clearDepth) {
+        if (loadOp == vk::AttachmentLoadOp::eLoad) {
+            read(handle, RenderGraphUsage::DepthAttachment);
+        }
+        write(handle, RenderGraphUsage::DepthAttachment);
+
+        m_graph.m_passes[m_passIndex].depthAttachment = {handle, loadOp, vk::ClearValue(vk::ClearDepthStencilValue(clearDepth, 0))};
+    }
+
+    void RenderGraphPassBuilder::sideEffects() {
+        m_graph.m_passes[m_passIndex].sideEffects = true;
+    }
+
+    void RenderGraphPassBuilder::secondaryCommandBuffers() {
+        m_graph.m_passes[m_passIndex].secondaryCommandBuffers = true;
+    }
+
+    RenderGraph::RenderGraph(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device)
+        : m_physicalDevice(physicalDevice), m_device(device) {
+    }
+
+    void RenderGraph::reset(uint32_t frameIndex) {
+        m_frameIndex = frameIndex % MAX_FRAMES_IN_FLIGHT;
+        m_resources.clear();
+        m_passes.clear();
+        m_executionOrder.clear();
+        m_finalBarriers.clear();
+        m_compiled = false;
+    }
+
+    RenderGraphHandle RenderGraph::importImage(const char *name, vk::Image image, vk::ImageView view, const RenderGraphImageInfo &info,
+                                               vk::ImageLayout initialLayout, vk::PipelineStageFlags2 initialStages,
+                                               vk::ImageLayout finalLayout) {
+        Resource resource;
+        resource.name = name;
+        resource.imported = true;
+        resource.output = finalLayout != vk::ImageLayout::eUndefined;
+        resource.imageInfo = info;
+        resource.image = image;
+        resource.view = view;
+        resource.initialLayout = initialLayout;
+        resource.initialStages = initialStages;
+        resource.finalLayout = finalLayout;
+        m_resources.push_back(std::move(resource));
+
+        return static_cast<RenderGraphHandle>(m_resources.size() - 1);
+    }
+
+    RenderGraphHandle RenderGraph::importBuffer(const char *name, vk::Buffer buffer, vk::DeviceSize size) {
+        Resource resource;
+        resource.name = name;
+        resource.isImage = false;
+        resource.imported = true;
+        resource.buffer = buffer;
+        resource.size = size;
+        m_resources.push_back(std::move(resource));
+
+        return static_cast<RenderGraphHandle>(m_resources.size() - 1);
+    }
+
+    RenderGraphHandle RenderGraph::createImage(const char *name, const RenderGraphImageInfo &info) {
+        Resource resource;
+        resource.name = name;
+        resource.imageInfo = info;
+        m_resources.push_back(std::move(resource));
+
+        return static_cast<RenderGraphHandle>(m_resources.size() - 1);
+    }
+
+    void RenderGraph::addPass(const char *name, const std::function<void(RenderGraphPassBuilder &builder)> &setup,
+                              std::function<void(const RenderGraphContext &context)> execute) {
+        Pass pass;
+        pass.name = name;
+        pass.execute = std::move(execute);
+        m_passes.push_back(std::move(pass));
+
+        RenderGraphPassBuilder builder(*this, static_cast<uint32_t>(m_passes.size() - 1));
+        setup(builder);
+    }
+
+    void RenderGraph::markOutput(RenderGraphHandle handle) {
+        m_resources[handle].output = true;
+    }
+
+    void RenderGraph::setPassHooks(PassHook beginPass, PassHook endPass) {
+        m_beginPassHook = std::move(beginPass);
+        m_endPassHook = std::move(endPass);
+    }
+
+    void RenderGraph::cullPasses() {
+        for (Pass &pass : m_passes) {
+            pass.refCount = 0;
+            pass.culled = false;
+
+            std::vector<RenderGraphHandle> written;
+            for (const Access &access : pass.accesses) {
+                if (access.write && std::find(written.begin(), written.end(), access.handle) == written.end()) {
+                    written.push_back(access.handle);
+                }
+
+                if (!access.write) {
+                    m_resources[access.handle].readerCount++;
+                }
+            }
+            pass.refCount = static_cast<uint32_t>(written.size());
+        }
+
+        std::vector<RenderGraphHandle> unreferenced;
+        auto releasePass = [&](Pass &pass) {
+            pass.culled = true;
+            for (const Access &access : pass.accesses) {
+                Resource &resource = m_resources[access.handle];
+                if (!access.write && --resource.readerCount == 0 && !resource.output) {
+                    unreferenced.push_back(access.handle);
+                }
+            }
+        };
+
+        for (RenderGraphHandle handle = 0; handle < m_resources.size(); ++handle) {
+            if (m_resources[handle].readerCount == 0 && !m_resources[handle].output) {
+                unreferenced.push_back(handle);
+            }
+        }
+
+        for (Pass &pass : m_passes) {
+            if (pass.refCount == 0 && !pass.sideEffects) {
+                releasePass(pass);
+            }
+        }
+
+        /** Walk back from resources nobody reads and drop the passes that only produce those. */
+        while (!unreferenced.empty()) {
+            const RenderGraphHandle handle = unreferenced.back();
+            unreferenced.pop_back();
+
+            for (Pass &pass : m_passes) {
+                if (pass.culled || pass.sideEffects) {
+                    continue;
+                }
+
+                const bool writes = std::any_of(pass.accesses.begin(), pass.accesses.end(), [&](const Access &access) {
+                    return access.write && access.handle == handle;
+                });
+
+                if (writes && --pass.refCount == 0) {
+                    releasePass(pass);
+                }
+            }
+        }
+
+        m_executionOrder.clear();
+        for (uint32_t passIndex = 0; passIndex < m_passes.size(); ++passIndex) {
+            if (!m_passes[passIndex].culled) {
+                m_executionOrder.push_back(passIndex);
+            }
+        }
+    }
+
+    void RenderGraph::computeLifetimes() {
+        for (uint32_t order = 0; order < m_executionOrder.size(); ++order) {
+            for (const Access &access : m_passes[m_executionOrder[order]].accesses) {
+                Resource &resource = m_resources[access.handle];
+                const UsageInfo info = getUsageInfo(access.usage, access.write);
+
+                if (resource.firstPass == ~0u) {
+                    resource.firstPass = order;
+                }
+
+                if (resource.lastPass != order || resource.lastStages == vk::PipelineStageFlags2()) {
+                    resource.lastStages = {};
+                    resource.lastAccess = {};
+                }
+
+                resource.lastPass = order;
+                resource.lastStages |= info.stages;
+                resource.lastAccess |= info.access;
+                resource.imageUsage |= info.imageUsage;
+            }
+        }
+    }
+
+    uint64_t RenderGraph::computeSignature() const {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        };
+
+        for (const Resource &resource : m_resources) {
+            if (resource.imported || !resource.isImage || resource.firstPass == ~0u) {
+                continue;
+            }
+
+            mix(static_cast<uint64_t>(resource.imageInfo.format));
+            mix(resource.imageInfo.extent.width);
+            mix(resource.imageInfo.extent.height);
+            mix(resource.imageInfo.mipLevels);
+            mix(static_cast<uint64_t>(static_cast<VkImageAspectFlags>(resource.imageInfo.aspect)));
+            mix(static_cast<uint64_t>(static_cast<VkImageUsageFlags>(resource.imageUsage)));
+            mix(resource.firstPass);
+            mix(resource.lastPass);
+        }
+
+        return hash;
+    }
+
+    void RenderGraph::allocateTransients() {
+        std::vector<RenderGraphHandle> transients;
+        for (RenderGraphHandle handle = 0; handle < m_resources.size(); ++handle) {
+            const Resource &resource = m_resources[handle];
+            if (!resource.imported && resource.isImage && resource.firstPass != ~0u) {
+                transients.push_back(handle);
+            }
+        }
+
+        TransientHeap &heap = m_heaps[m_frameIndex];
+        const uint64_t signature = computeSignature();
+        const bool reuse = signature == heap.signature && heap.images.size() == transients.size();
+
+        if (!reuse) {
+            if (!heap.images.empty()) {
+                heap.retiredAtFrame = m_frameNumber;
+                m_retiredHeaps.push_back(std::move(heap));
+            }
+
+            heap = TransientHeap{};
+            heap.signature = signature;
+            m_statistics.transientBytes = 0;
+            m_statistics.aliasedBytes = 0;
+        }
+
+        struct Placement {
+            uint32_t transientIndex;
+            vk::DeviceSize offset;
+            vk::DeviceSize size;
+        };
+
+        struct Block {
+            vk::DeviceSize size = 0;
+            uint32_t memoryTypeBits = 0;
+            std::vector<Placement> placements;
+        };
+
+        std::vector<vk::MemoryRequirements> requirements(transients.size());
+        std::vector<uint32_t> placementBlock(transients.size());
+        std::vector<vk::DeviceSize> placementOffset(transients.size());
+        std::vector<Block> blocks;
+
+        if (!reuse) {
+            for (uint32_t i = 0; i < transients.size(); ++i) {
+                const Resource &resource = m_resources[transients[i]];
+
+                vk::ImageCreateInfo imageInfo{};
+                imageInfo.flags = vk::ImageCreateFlagBits::eAlias;
+                imageInfo.imageType = vk::ImageType::e2D;
+                imageInfo.format = resource.imageInfo.format;
+                imageInfo.extent = vk::Extent3D(resource.imageInfo.extent.width, resource.imageInfo.extent.height, 1);
+                imageInfo.mipLevels = resource.imageInfo.mipLevels;
+                imageInfo.arrayLayers = 1;
+                imageInfo.samples = vk::SampleCountFlagBits::e1;
+                imageInfo.tiling = vk::ImageTiling::eOptimal;
+                imageInfo.usage = resource.imageUsage;
+                imageInfo.sharingMode = vk::SharingMode::eExclusive;
+                imageInfo.initialLayout = vk::ImageLayout::eUndefined;
+
+                PhysicalImage physical;
+                physical.image = vk::raii::Image(m_device, imageInfo);
+                requirements[i] = physical.image.getMemoryRequirements();
+                heap.images.push_back(std::move(physical));
+            }
+
+            /** Largest first, each image goes to the lowest offset not overlapping a live neighbour. */
+            std::vector<uint32_t> order(transients.size());
+            for (uint32_t i = 0; i < order.size(); ++i) {
+                order[i] = i;
+            }
+            std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return requirements[a].size > requirements[b].size;
+            });
+
+            for (uint32_t index : order) {
+                const Resource &resource = m_resources[transients[index]];
+                const vk::MemoryRequirements &requirement = requirements[index];
+                bool placed = false;
+
+                for (uint32_t blockIndex = 0; blockIndex < blocks.size() && !placed; ++blockIndex) {
+                    Block &block = blocks[blockIndex];
+                    if (!(block.memoryTypeBits & requirement.memoryTypeBits) || requirement.size > block.size) {
+                        continue;
+                    }
+
+                    std::vector<vk::DeviceSize> candidates = {0};
+                    for (const Placement &placement : block.placements) {
+                        candidates.push_back(alignUp(placement.offset + placement.size, requirement.alignment));
+                    }
+                    std::sort(candidates.begin(), candidates.end());
+
+                    for (vk::DeviceSize offset : candidates) {
+                        if (offset + requirement.size > block.size) {
+                            break;
+                        }
+
+                        const bool conflict = std::any_of(block.placements.begin(), block.placements.end(), [&](const Placement &placement) {
+                            const Resource &other = m_resources[transients[placement.transientIndex]];
+                            const bool livesTogether = !(other.lastPass < resource.firstPass || resource.lastPass < other.firstPass);
+                            const bool overlaps = offset < placement.offset + placement.size && placement.offset < offset + requirement.size;
+                            return livesTogether && overlaps;
+                        });
+
+                        if (!conflict) {
+                            block.placements.push_back({index, offset, requirement.size});
+                            block.memoryTypeBits &= requirement.memoryTypeBits;
+                            placementBlock[index] = blockIndex;
+                            placementOffset[index] = offset;
+                            placed = true;
+                            break;
+                        }
+                    }
+                }
+
+                if (!placed) {
+                    Block block;
+                    block.size = requirement.size;
+                    block.memoryTypeBits = requirement.memoryTypeBits;
+                    block.placements.push_back({index, 0, requirement.size});
+                    placementBlock[index] = static_cast<uint32_t>(blocks.size());
+                    placementOffset[index] = 0;
+                    blocks.push_back(std::move(block));
+                }
+
+                m_statistics.aliasedBytes += requirement.size;
+            }
+
+            for (const Block &block : blocks) {
+                vk::MemoryAllocateInfo allocInfo{};
+                allocInfo.allocationSize = block.size;
+                allocInfo.memoryTypeIndex = findMemoryType(m_physicalDevice, block.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
+                heap.blocks.emplace_back(m_device, allocInfo);
+                m_statistics.transientBytes += block.size;
+            }
+            m_statistics.aliasedBytes -= m_statistics.transientBytes;
+
+            for (uint32_t i = 0; i < transients.size(); ++i) {
+                const Resource &resource = m_resources[transients[i]];
+                PhysicalImage &physical = heap.images[i];
+                physical.image.bindMemory(*heap.blocks[placementBlock[i]], placementOffset[i]);
+
+                vk::ImageViewCreateInfo viewInfo{};
+                viewInfo.image = *physical.image;
+                viewInfo.viewType = vk::ImageViewType::e2D;
+                viewInfo.format = resource.imageInfo.format;
+                viewInfo.subresourceRange = vk::ImageSubresourceRange(resource.imageInfo.aspect, 0, resource.imageInfo.mipLevels, 0, 1);
+                physical.view = vk::raii::ImageView(m_device, viewInfo);
+            }
+        }
+
+        /** The resource table is rebuilt every frame, so handles are rebound to the cached images. */
+        for (uint32_t i = 0; i < transients.size(); ++i) {
+            Resource &resource = m_resources[transients[i]];
+            resource.image = *heap.images[i].image;
+            resource.view = *heap.images[i].view;
+        }
+
+        if (!reuse) {
+            for (const Block &block : blocks) {
+                for (const Placement &placement : block.placements) {
+                    Resource &resource = m_resources[transients[placement.transientIndex]];
+
+                    for (const Placement &other : block.placements) {
+                        const Resource &otherResource = m_resources[transients[other.transientIndex]];
+                        const bool overlaps = placement.offset < other.offset + other.size && other.offset < placement.offset + placement.size;
+                        if (&other != &placement && overlaps && otherResource.lastPass < resource.firstPass) {
+                            resource.aliasPredecessors.push_back(transients[other.transientIndex]);
+                        }
+                    }
+                }
+            }
+
+            heap.predecessors.clear();
+            for (RenderGraphHandle handle : transients) {
+                heap.predecessors.push_back(m_resources[handle].aliasPredecessors);
+            }
+        } else {
+            for (uint32_t i = 0; i < transients.size(); ++i) {
+                m_resources[transients[i]].aliasPredecessors = heap.predecessors[i];
+            }
+        }
+
+        m_statistics.transientImages = static_cast<uint32_t>(transients.size());
+    }
+
+    void RenderGraph::buildBarriers() {
+        std::vector<ResourceState> states(m_resources.size());
+
+        for (RenderGraphHandle handle = 0; handle < m_resources.size(); ++handle) {
+            const Resource &resource = m_resources[handle];
+            ResourceState &state = states[handle];
+
+            if (resource.imported) {
+                state.layout = resource.initialLayout;
+                state.writeStages = resource.initialStages;
+            } else {
+                for (RenderGraphHandle predecessor : resource.aliasPredecessors) {
+                    state.writeStages |= m_resources[predecessor].lastStages;
+                    state.writeAccess |= m_resources[predecessor].lastAccess & WRITE_ACCESS_MASK;
+                }
+            }
+        }
+
+        auto makeImageBarrier = [&](RenderGraphHandle handle, vk::PipelineStageFlags2 srcStages, vk::AccessFlags2 srcAccess,
+                                    vk::PipelineStageFlags2 dstStages, vk::AccessFlags2 dstAccess,
+                                    vk::ImageLayout oldLayout, vk::ImageLayout newLayout) {
+            const Resource &resource = m_resources[handle];
+
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.srcStageMask = srcStages ? srcStages : vk::PipelineStageFlags2(vk::PipelineStageFlagBits2::eNone);
+            barrier.srcAccessMask = srcAccess;
+            barrier.dstStageMask = dstStages;
+            barrier.dstAccessMask = dstAccess;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+            barrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+            barrier.image = resource.image;
+            barrier.subresourceRange = vk::ImageSubresourceRange(resource.imageInfo.aspect, 0, resource.imageInfo.mipLevels, 0, 1);
+            return barrier;
+        };
+
+        m_statistics.barriers = 0;
+
+        for (uint32_t passIndex : m_executionOrder) {
+            Pass &pass = m_passes[passIndex];
+            pass.imageBarriers.clear();
+            pass.bufferBarriers.clear();
+
+            /** Merge the usages of a resource within one pass so it gets at most one barrier. */
+            std::vector<std::pair<RenderGraphHandle, UsageInfo>> merged;
+            std::vector<bool> mergedWrite;
+            for (const Access &access : pass.accesses) {
+                const UsageInfo info = getUsageInfo(access.usage, access.write);
+                auto it = std::find_if(merged.begin(), merged.end(), [&](const auto &entry) { return entry.first == access.handle; });
+
+                if (it == merged.end()) {
+                    merged.emplace_back(access.handle, info);
+                    mergedWrite.push_back(access.write);
+                } else {
+                    it->second.stages |= info.stages;
+                    it->second.access |= info.access;
+                    mergedWrite[it - merged.begin()] = mergedWrite[it - merged.begin()] || access.write;
+                    if (access.write) {
+                        it->second.layout = info.layout;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < merged.size(); ++i) {
+                const RenderGraphHandle handle = merged[i].first;
+                const UsageInfo &info = merged[i].second;
+                const bool write = mergedWrite[i];
+                const Resource &resource = m_resources[handle];
+                ResourceState &state = states[handle];
+
+                const bool layoutChange = resource.isImage && state.layout != info.layout;
+                vk::PipelineStageFlags2 srcStages;
+                vk::AccessFlags2 srcAccess;
+                bool needsBarrier = layoutChange;
+
+                if (write || layoutChange) {
+                    /** Writes and transitions wait for every earlier access, only earlier writes need flushing. */
+                    srcStages = state.writeStages | state.readStages;
+                    srcAccess = state.writeAccess;
+                    needsBarrier = needsBarrier || srcStages;
+                } else if (state.writeStages && ((info.stages & ~state.readStages) || (info.access & ~state.readAccess))) {
+                    /** Read after write that was not yet made visible to these stages. */
+                    srcStages = state.writeStages;
+                    srcAccess = state.writeAccess;
+                    needsBarrier = true;
+                }
+
+                if (needsBarrier) {
+                    if (resource.isImage) {
+                        pass.imageBarriers.push_back(makeImageBarrier(handle, srcStages, srcAccess, info.stages, info.access,
+                                                                      state.layout, info.layout));
+                    } else {
+                        vk::BufferMemoryBarrier2 barrier{};
+                        barrier.srcStageMask = srcStages;
+                        barrier.srcAccessMask = srcAccess;
+                        barrier.dstStageMask = info.stages;
+                        barrier.dstAccessMask = info.access;
+                        barrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+                        barrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+                        barrier.buffer = resource.buffer;
+                        barrier.size = vk::WholeSize;
+                        pass.bufferBarriers.push_back(barrier);
+                    }
+                }
+
+                if (write) {
+                    state.writeStages = info.stages;
+                    state.writeAccess = info.access & WRITE_ACCESS_MASK;
+                    state.readStages = {};
+                    state.readAccess = {};
+                } else if (layoutChange) {
+                    state.readStages = info.stages;
+                    state.readAccess = info.access;
+                } else {
+                    state.readStages |= info.stages;
+                    state.readAccess |= info.access;
+                }
+
+                if (resource.isImage) {
+                    state.layout = info.layout;
+                }
+            }
+
+            m_statistics.barriers += static_cast<uint32_t>(pass.imageBarriers.size() + pass.bufferBarriers.size());
+        }
+
+        m_finalBarriers.clear();
+        for (RenderGraphHandle handle = 0; handle < m_resources.size(); ++handle) {
+            const Resource &resource = m_resources[handle];
+            const ResourceState &state = states[handle];
+
+            if (!resource.imported || !resource.isImage || resource.finalLayout == vk::ImageLayout::eUndefined ||
+                resource.finalLayout == state.layout) {
+                continue;
+            }
+
+            m_finalBarriers.push_back(makeImageBarrier(handle, state.writeStages | state.readStages, state.writeAccess,
+                                                       vk::PipelineStageFlagBits2::eBottomOfPipe, {},
+                                                       state.layout, resource.finalLayout));
+        }
+        m_statistics.barriers += static_cast<uint32_t>(m_finalBarriers.size());
+    }
+
+    void RenderGraph::compile() {
+        while (!m_retiredHeaps.empty() && m_retiredHeaps.front().retiredAtFrame + MAX_FRAMES_IN_FLIGHT <= m_frameNumber) {
+            m_retiredHeaps.pop_front();
+        }
+
+        cullPasses();
+        computeLifetimes();
+        allocateTransients();
+        buildBarriers();
+
+        m_statistics.passes = static_cast<uint32_t>(m_executionOrder.size());
+        m_statistics.culledPasses = static_cast<uint32_t>(m_passes.size() - m_executionOrder.size());
+        m_compiled = true;
+    }
+
+    void RenderGraph::beginRendering(const vk::raii::CommandBuffer &commandBuffer, const Pass &pass) const {
+        std::vector<vk::RenderingAttachmentInfo> colorInfos;
+        colorInfos.reserve(pass.colorAttachments.size());
+        vk::Extent2D extent{};
+
+        for (const Attachment &attachment : pass.colorAttachments) {
+            vk::RenderingAttachmentInfo info{};
+            info.imageView = m_resources[attachment.handle].view;
+            info.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+            info.loadOp = attachment.loadOp;
+            info.storeOp = vk::AttachmentStoreOp::eStore;
+            info.clearValue = attachment.clearValue;
+            colorInfos.push_back(info);
+            extent = m_resources[attachment.handle].imageInfo.extent;
+        }
+
+        vk::RenderingAttachmentInfo depthInfo{};
+        if (pass.depthAttachment) {
+            depthInfo.imageView = m_resources[pass.depthAttachment->handle].view;
+            depthInfo.imageLayout = vk::ImageLayout::eDepthStencilAttachmentOptimal;
+            depthInfo.loadOp = pass.depthAttachment->loadOp;
+            depthInfo.storeOp = vk::AttachmentStoreOp::eStore;
+            depthInfo.clearValue = pass.depthAttachment->clearValue;
+            extent = m_resources[pass.depthAttachment->handle].imageInfo.extent;
+        }
+
+        vk::RenderingInfo renderingInfo{};
+        renderingInfo.renderArea = vk::Rect2D({0, 0}, extent);
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorInfos.size());
+        renderingInfo.pColorAttachments = colorInfos.data();
+        renderingInfo.pDepthAttachment = pass.depthAttachment ? &depthInfo : nullptr;
+        if (pass.secondaryCommandBuffers) {
+            renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        }
+
+        commandBuffer.beginRendering(renderingInfo);
+    }
+
+    void RenderGraph::execute(const vk::raii::CommandBuffer &commandBuffer) {
+        if (!m_compiled) {
+            compile();
+        }
+
+        const RenderGraphContext context{commandBuffer, *this};
+
+        for (uint32_t passIndex : m_executionOrder) {
+            const Pass &pass = m_passes[passIndex];
+
+            if (!pass.imageBarriers.empty() || !pass.bufferBarriers.empty()) {
+                vk::DependencyInfo dependencyInfo{};
+                dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(pass.imageBarriers.size());
+                dependencyInfo.pImageMemoryBarriers = pass.imageBarriers.data();
+                dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(pass.bufferBarriers.size());
+                dependencyInfo.pBufferMemoryBarriers = pass.bufferBarriers.data();
+                commandBuffer.pipelineBarrier2(dependencyInfo);
+            }
+
+            if (m_beginPassHook) {
+                m_beginPassHook(commandBuffer, pass.name.c_str());
+            }
+
+            const bool rendering = !pass.colorAttachments.empty() || pass.depthAttachment;
+            if (rendering) {
+                beginRendering(commandBuffer, pass);
+            }
+
+            if (pass.execute) {
+                pass.execute(context);
+            }
+
+            if (rendering) {
+                commandBuffer.endRendering();
+            }
+
+            if (m_endPassHook) {
+                m_endPassHook(commandBuffer, pass.name.c_str());
+            }
+        }
+
+        if (!m_finalBarriers.empty()) {
+            vk::DependencyInfo dependencyInfo{};
+            dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(m_finalBarriers.size());
+            dependencyInfo.pImageMemoryBarriers = m_finalBarriers.data();
+            commandBuffer.pipelineBarrier2(dependencyInfo);
+        }
+
+        m_frameNumber++;
+    }
+}
@@ -0,0 +1,237 @@
+#ifndef __ENGINE_RENDER_GRAPH_HPP__
+#define __ENGINE_RENDER_GRAPH_HPP__
+
+#include "Vulkan.hpp"
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Engine {
+    using RenderGraphHandle = uint32_t;
+
+    constexpr RenderGraphHandle INVALID_RENDER_GRAPH_HANDLE = ~0u;
+
+    /** How a pass touches a resource. Each usage maps to fixed stages, access bits and image layout. */
+    enum class RenderGraphUsage : uint8_t {
+        ColorAttachment,
+        DepthAttachment,
+        DepthRead,
+        SampledFragment,
+        SampledCompute,
+        StorageRead,
+        StorageWrite,
+        TransferSource,
+        TransferDestination,
+        IndirectRead,
+        VertexRead,
+        IndexRead
+    };
+
+    struct RenderGraphImageInfo {
+        vk::Format format = vk::Format::eUndefined;
+        vk::Extent2D extent{};
+        uint32_t mipLevels = 1;
+        vk::ImageAspectFlags aspect = vk::ImageAspectFlagBits::eColor;
+    };
+
+    class RenderGraph;
+
+    /** Handed to a pass while it records. */
+    struct RenderGraphContext {
+        const vk::raii::CommandBuffer &commandBuffer;
+        const RenderGraph &graph;
+    };
+
+    /** Collects the reads and writes a pass declares during setup. */
+    class RenderGraphPassBuilder {
+    public:
+        void read(RenderGraphHandle handle, RenderGraphUsage usage);
+        void write(RenderGraphHandle handle, RenderGraphUsage usage);
+
+        /** The graph begins and ends dynamic rendering around the pass for its attachments. */
+        void colorAttachment(RenderGraphHandle handle, vk::AttachmentLoadOp loadOp,
+                             vk::ClearColorValue clearValue = vk::ClearColorValue(0.0f, 0.0f, 0.0f, 1.0f));
+        void depthAttachment(RenderGraphHandle handle, vk::AttachmentLoadOp loadOp, float clearDepth = 1.0f);
+
+        /** The pass is never culled, even when nothing reads what it writes. */
+        void sideEffects();
+
+        /** The pass executes secondary command buffers inside its rendering scope. */
+        void secondaryCommandBuffers();
+
+    private:
+        friend class RenderGraph;
+
+        RenderGraph &m_graph;
+        uint32_t m_passIndex;
+
+        RenderGraphPassBuilder(RenderGraph &graph, uint32_t passIndex) : m_graph(graph), m_passIndex(passIndex) {}
+    };
+
+    /**
+     * Frame render graph.
+     *
+     * Passes are added every frame with the resources they read and write. compile() culls
+     * passes whose results are never consumed, derives the synchronization2 barriers between
+     * the remaining ones and places transient images with disjoint lifetimes in shared memory.
+     * Every frame slot has its own transient memory, so a first use only has to wait for
+     * aliases of the same frame, never for the frame still executing in the other slot.
+     * Transient allocations are kept while the frame layout stays the same and released
+     * MAX_FRAMES_IN_FLIGHT frames after it changes, so rebuilding the graph never stalls.
+     */
+    class RenderGraph {
+    public:
+        struct Statistics {
+            uint32_t passes = 0;
+            uint32_t culledPasses = 0;
+            uint32_t barriers = 0;
+            uint32_t transientImages = 0;
+            vk::DeviceSize transientBytes = 0;
+            vk::DeviceSize aliasedBytes = 0;
+        };
+
+        using PassHook = std::function<void(const vk::raii::CommandBuffer &commandBuffer, const char *passName)>;
+
+        RenderGraph(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device);
+
+        RenderGraph(const RenderGraph &) = delete;
+        RenderGraph &operator=(const RenderGraph &) = delete;
+
+        /** Drops the passes and resources declared for the previous frame and records into frame slot `frameIndex`. */
+        void reset(uint32_t frameIndex);
+
+        /**
+         * Registers an image owned outside the graph. `initialStages` are the stages that must
+         * finish before its first use (the acquire wait stage for swapchain images). When
+         * `finalLayout` is set the image is a graph output and ends the frame in that layout.
+         */
+        RenderGraphHandle importImage(const char *name, vk::Image image, vk::ImageView view, const RenderGraphImageInfo &info,
+                                      vk::ImageLayout initialLayout, vk::PipelineStageFlags2 initialStages,
+                                      vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined);
+
+        RenderGraphHandle importBuffer(const char *name, vk::Buffer buffer, vk::DeviceSize size);
+
+        /** Declares an image that only lives during the frame and may share memory with others. */
+        RenderGraphHandle createImage(const char *name, const RenderGraphImageInfo &info);
+
+        void addPass(const char *name, const std::function<void(RenderGraphPassBuilder &builder)> &setup,
+                     std::function<void(const RenderGraphContext &context)> execute);
+
+        /** Keeps every pass contributing to `handle` alive. */
+        void markOutput(RenderGraphHandle handle);
+
+        void compile();
+
+        void execute(const vk::raii::CommandBuffer &commandBuffer);
+
+        /** Called around every executed pass, used by the GPU profiler. */
+        void setPassHooks(PassHook beginPass, PassHook endPass);
+
+        vk::Image image(RenderGraphHandle handle) const { return m_resources[handle].image; }
+        vk::ImageView imageView(RenderGraphHandle handle) const { return m_resources[handle].view; }
+        vk::Buffer buffer(RenderGraphHandle handle) const { return m_resources[handle].buffer; }
+
+        const Statistics &statistics() const { return m_statistics; }
+
+    private:
+        friend class RenderGraphPassBuilder;
+
+        struct Resource {
+            std::string name;
+            bool isImage = true;
+            bool imported = false;
+            bool output = false;
+            RenderGraphImageInfo imageInfo;
+            vk::Image image;
+            vk::ImageView view;
+            vk::Buffer buffer;
+            vk::DeviceSize size = 0;
+            vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags2 initialStages = vk::PipelineStageFlagBits2::eNone;
+            vk::ImageLayout finalLayout = vk::ImageLayout::eUndefined;
+
+            vk::ImageUsageFlags imageUsage;
+            uint32_t readerCount = 0;
+            uint32_t firstPass = ~0u;
+            uint32_t lastPass = 0;
+
+            /** Transient images previously occupying the same memory, first use waits for their last use. */
+            std::vector<RenderGraphHandle> aliasPredecessors;
+            vk::PipelineStageFlags2 lastStages;
+            vk::AccessFlags2 lastAccess;
+        };
+
+        struct Access {
+            RenderGraphHandle handle;
+            RenderGraphUsage usage;
+            bool write;
+        };
+
+        struct Attachment {
+            RenderGraphHandle handle;
+            vk::AttachmentLoadOp loadOp;
+            vk::ClearValue clearValue;
+        };
+
+        struct Pass {
+            std::string name;
+            std::vector<Access> accesses;
+            std::vector<Attachment> colorAttachments;
+            std::optional<Attachment> depthAttachment;
+            bool sideEffects = false;
+            bool secondaryCommandBuffers = false;
+            std::function<void(const RenderGraphContext &)> execute;
+
+            uint32_t refCount = 0;
+            bool culled = false;
+            std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+            std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        };
+
+        struct PhysicalImage {
+            vk::raii::Image image = nullptr;
+            vk::raii::ImageView view = nullptr;
+        };
+
+        /** Transient memory of one graph layout, released once no frame in flight uses it. */
+        struct TransientHeap {
+            uint64_t signature = 0;
+            std::vector<vk::raii::DeviceMemory> blocks;
+            std::vector<PhysicalImage> images;
+            std::vector<std::vector<RenderGraphHandle>> predecessors;
+            uint64_t retiredAtFrame = 0;
+        };
+
+        const vk::raii::PhysicalDevice &m_physicalDevice;
+        const vk::raii::Device &m_device;
+
+        std::vector<Resource> m_resources;
+        std::vector<Pass> m_passes;
+        std::vector<uint32_t> m_executionOrder;
+        std::vector<vk::ImageMemoryBarrier2> m_finalBarriers;
+
+        /** Indexed by frame slot; a slot's previous frame has retired before it records again. */
+        TransientHeap m_heaps[MAX_FRAMES_IN_FLIGHT];
+        uint32_t m_frameIndex = 0;
+        std::deque<TransientHeap> m_retiredHeaps;
+        uint64_t m_frameNumber = 0;
+
+        PassHook m_beginPassHook;
+        PassHook m_endPassHook;
+
+        Statistics m_statistics;
+        bool m_compiled = false;
+
+        void cullPasses();
+        void computeLifetimes();
+        uint64_t computeSignature() const;
+        void allocateTransients();
+        void buildBarriers();
+        void beginRendering(const vk::raii::CommandBuffer &commandBuffer, const Pass &pass) const;
+    };
+}
+
+#endif
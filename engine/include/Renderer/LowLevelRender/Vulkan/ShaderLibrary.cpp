@@ -0,0 +1,267 @@
+#include "ShaderLibrary.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define ENGINE_POPEN _popen
+#define ENGINE_PCLOSE _pclose
+#else
+#define ENGINE_POPEN popen
+#define ENGINE_PCLOSE pclose
+#endif
+
+namespace Engine {
+    namespace {
+        constexpr std::chrono::milliseconds SCAN_INTERVAL{250};
+    }
+
+    ShaderLibrary::ShaderLibrary(const vk::raii::Device &device)
+        : m_device(device) {
+        for (const EmbeddedShader &shader : embeddedShaders()) {
+            m_embedded.emplace(shader.name, shader.code);
+        }
+
+#if defined(ENGINE_SHADER_HOT_RELOAD)
+        const std::filesystem::path sourceDirectory = ENGINE_SHADER_SOURCE_DIR;
+        std::error_code error;
+        if (!std::filesystem::is_directory(sourceDirectory, error)) {
+            ENGINE_CLOG_INFO(Render, "Shader sources not found at {}, hot reload disabled", sourceDirectory.string())
+            return;
+        }
+
+        /** Until glslc reports the real includes, every header in the directory counts as a dependency. */
+        std::vector<std::filesystem::path> headers;
+        for (const auto &entry : std::filesystem::directory_iterator(sourceDirectory, error)) {
+            if (entry.path().extension() == ".glsl") {
+                headers.push_back(entry.path());
+            }
+        }
+
+        for (const auto &[name, code] : m_embedded) {
+            WatchedShader shader;
+            shader.source = sourceDirectory / name;
+            shader.dependencies = headers;
+            shader.dependencies.push_back(shader.source);
+            shader.lastWrite = newestWrite(shader);
+            m_watched.emplace(name, std::move(shader));
+        }
+
+        m_hotReload = true;
+        m_lastScan = std::chrono::steady_clock::now();
+        ENGINE_CLOG_INFO(Render, "Watching {} shaders in {} for changes", m_watched.size(), sourceDirectory.string())
+#endif
+    }
+
+    std::span<const uint32_t> ShaderLibrary::code(const std::string &name) const {
+        if (auto reloaded = m_reloaded.find(name); reloaded != m_reloaded.end()) {
+            return reloaded->second;
+        }
+
+        if (auto embedded = m_embedded.find(name); embedded != m_embedded.end()) {
+            return embedded->second;
+        }
+
+        throw std::runtime_error("Unknown shader: " + name);
+    }
+
+    vk::raii::ShaderModule ShaderLibrary::createModule(const std::string &name) const {
+        const std::span<const uint32_t> spirv = code(name);
+
+        vk::ShaderModuleCreateInfo createInfo{};
+        createInfo.codeSize = spirv.size_bytes();
+        createInfo.pCode = spirv.data();
+
+        return vk::raii::ShaderModule(m_device, createInfo);
+    }
+
+    void ShaderLibrary::onReload(std::vector<std::string> names, ReloadCallback callback) {
+        m_listeners.push_back({std::move(names), std::move(callback)});
+    }
+
+    void ShaderLibrary::retire(vk::raii::Pipeline &&pipeline) {
+        m_retired.push_back({std::move(pipeline), m_frameNumber});
+    }
+
+    void ShaderLibrary::poll(uint64_t submittedFrames) {
+        m_frameNumber = submittedFrames;
+        while (!m_retired.empty() && m_retired.front().retiredAtFrame + MAX_FRAMES_IN_FLIGHT <= m_frameNumber) {
+            m_retired.pop_front();
+        }
+
+        if (!m_hotReload) {
+            return;
+        }
+
+        collectCompiles();
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - m_lastScan >= SCAN_INTERVAL) {
+            m_lastScan = now;
+            scanSources();
+        }
+    }
+
+    std::filesystem::file_time_type ShaderLibrary::newestWrite(const WatchedShader &shader) const {
+        std::filesystem::file_time_type newest = std::filesystem::file_time_type::min();
+
+        for (const std::filesystem::path &dependency : shader.dependencies) {
+            std::error_code error;
+            const auto writeTime = std::filesystem::last_write_time(dependency, error);
+            if (!error) {
+                newest = std::max(newest, writeTime);
+            }
+        }
+
+        return newest;
+    }
+
+    void ShaderLibrary::scanSources() {
+        const std::filesystem::path outputDirectory = std::filesystem::temp_directory_path() / "LegacyOfVoidShaders";
+
+        for (auto &[name, shader] : m_watched) {
+            if (shader.compile.valid()) {
+                continue;
+            }
+
+            const auto writeTime = newestWrite(shader);
+            if (writeTime <= shader.lastWrite) {
+                continue;
+            }
+
+            shader.lastWrite = writeTime;
+            ENGINE_CLOG_INFO(Render, "Shader {} changed, recompiling", name)
+            shader.compile = std::async(std::launch::async, compileShader, shader.source, outputDirectory);
+        }
+    }
+
+    void ShaderLibrary::collectCompiles() {
+        std::vector<std::string> rebuilt;
+
+        for (auto &[name, shader] : m_watched) {
+            if (!shader.compile.valid() || shader.compile.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                continue;
+            }
+
+            CompileResult result = shader.compile.get();
+            if (!result.success) {
+                ENGINE_CLOG_ERROR(Render, "Shader {} failed to compile, keeping the previous version:\n{}", name, result.output)
+                continue;
+            }
+
+            if (!result.dependencies.empty()) {
+                shader.dependencies = std::move(result.dependencies);
+            }
+
+            m_reloaded[name] = std::move(result.code);
+            rebuilt.push_back(name);
+            ENGINE_CLOG_INFO(Render, "Shader {} reloaded", name)
+        }
+
+        if (rebuilt.empty()) {
+            return;
+        }
+
+        for (const Listener &listener : m_listeners) {
+            const bool affected = std::ranges::any_of(listener.names, [&](const std::string &name) {
+                return std::ranges::find(rebuilt, name) != rebuilt.end();
+            });
+
+            if (!affected) {
+                continue;
+            }
+
+            try {
+                listener.callback();
+            } catch (const std::exception &exception) {
+                ENGINE_CLOG_ERROR(Render, "Failed to rebuild pipelines after a shader reload: {}", exception.what())
+            }
+        }
+    }
+
+    ShaderLibrary::CompileResult ShaderLibrary::compileShader(std::filesystem::path source, std::filesystem::path outputDirectory) {
+        CompileResult result;
+
+#if defined(ENGINE_SHADER_HOT_RELOAD)
+        std::error_code error;
+        std::filesystem::create_directories(outputDirectory, error);
+
+        const std::filesystem::path output = outputDirectory / (source.filename().string() + ".spv");
+        const std::filesystem::path depfile = outputDirectory / (source.filename().string() + ".d");
+
+        std::ostringstream command;
+        command << '"' << ENGINE_GLSLC_EXECUTABLE << '"' << " --target-env=vulkan1.3 -g"
+                << " -I \"" << source.parent_path().string() << '"'
+                << " -MD -MF \"" << depfile.string() << '"'
+                << " -o \"" << output.string() << "\" \"" << source.string() << "\" 2>&1";
+
+        FILE *pipe = ENGINE_POPEN(command.str().c_str(), "r");
+        if (!pipe) {
+            result.output = "failed to launch glslc";
+            return result;
+        }
+
+        char buffer[512];
+        while (fgets(buffer, sizeof(buffer), pipe)) {
+            result.output += buffer;
+        }
+
+        if (ENGINE_PCLOSE(pipe) != 0) {
+            return result;
+        }
+
+        try {
+            result.code = readSpirvFile(output);
+            result.dependencies = readDepfile(depfile);
+            result.success = true;
+        } catch (const std::exception &exception) {
+            result.output += exception.what();
+        }
+#endif
+
+        return result;
+    }
+
+    std::vector<std::filesystem::path> ShaderLibrary::readDepfile(const std::filesystem::path &path) {
+        std::ifstream file(path);
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        /** Make-style rule: "target: source include...", with escaped spaces and line continuations. */
+        const size_t colon = content.find(": ");
+        if (colon == std::string::npos) {
+            return {};
+        }
+
+        std::vector<std::filesystem::path> dependencies;
+        std::string current;
+        for (size_t i = colon + 2; i < content.size(); ++i) {
+            const char character = content[i];
+
+            if (character == '\\' && i + 1 < content.size() && content[i + 1] == ' ') {
+                current += ' ';
+                i++;
+            } else if (character == '\\' && i + 1 < content.size() && (content[i + 1] == '\n' || content[i + 1] == '\r')) {
+                continue;
+            } else if (character == ' ' || character == '\n' || character == '\r' || character == '\t') {
+                if (!current.empty()) {
+                    dependencies.emplace_back(current);
+                    current.clear();
+                }
+            } else {
+                current += character;
+            }
+        }
+
+        if (!current.empty()) {
+            dependencies.emplace_back(current);
+        }
+
+        return dependencies;
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef __ENGINE_SHADER_LIBRARY_HPP__
+#define __ENGINE_SHADER_LIBRARY_HPP__
+
+#include "Vulkan.hpp"
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace Engine {
+    /** SPIR-V compiled by the build and embedded into the binary. */
+    struct EmbeddedShader {
+        const char *name;
+        std::span<const uint32_t> code;
+    };
+
+    /** Every shader of the engine's SHADER_FILES list, defined by the generated EmbeddedShaders.cpp. */
+    std::span<const EmbeddedShader> embeddedShaders();
+
+    /**
+     * Hands out shader code by source name, e.g. "ChunkCull.comp".
+     *
+     * Startup only uses the SPIR-V embedded by the build. Development builds
+     * (ENGINE_SHADER_HOT_RELOAD) also poll the shader sources and their includes: a changed
+     * shader is recompiled with glslc on a background thread and, once it compiles, replaces
+     * the embedded code and the reload callbacks registered for it run from poll(). A failing
+     * compile is logged and the previous code stays in use.
+     */
+    class ShaderLibrary {
+    public:
+        using ReloadCallback = std::function<void()>;
+
+        explicit ShaderLibrary(const vk::raii::Device &device);
+
+        ShaderLibrary(const ShaderLibrary &) = delete;
+        ShaderLibrary &operator=(const ShaderLibrary &) = delete;
+
+        /** Current code of `name`, valid until the next poll(). Throws std::runtime_error for unknown shaders. */
+        std::span<const uint32_t> code(const std::string &name) const;
+
+        vk::raii::ShaderModule createModule(const std::string &name) const;
+
+        /** Runs `callback` from poll() whenever one of `names` was rebuilt. */
+        void onReload(std::vector<std::string> names, ReloadCallback callback);
+
+        /** Keeps a pipeline replaced after a reload alive until no frame in flight can use it. */
+        void retire(vk::raii::Pipeline &&pipeline);
+
+        /**
+         * Collects finished compiles and fires callbacks. Call once per frame after the frame's
+         * fence wait; retired pipelines age on `submittedFrames`, the frames actually submitted
+         * so far, so frames skipped before submission do not free a pipeline still bound on the GPU.
+         */
+        void poll(uint64_t submittedFrames);
+
+        bool hotReloadEnabled() const { return m_hotReload; }
+
+    private:
+        struct CompileResult {
+            bool success = false;
+            std::string output;
+            std::vector<uint32_t> code;
+            std::vector<std::filesystem::path> dependencies;
+        };
+
+        struct WatchedShader {
+            std::filesystem::path source;
+            std::vector<std::filesystem::path> dependencies;
+            std::filesystem::file_time_type lastWrite;
+            std::future<CompileResult> compile;
+        };
+
+        struct Listener {
+            std::vector<std::string> names;
+            ReloadCallback callback;
+        };
+
+        struct RetiredPipeline {
+            vk::raii::Pipeline pipeline;
+            uint64_t retiredAtFrame;
+        };
+
+        const vk::raii::Device &m_device;
+        bool m_hotReload = false;
+
+        std::unordered_map<std::string, std::span<const uint32_t>> m_embedded;
+        std::unordered_map<std::string, std::vector<uint32_t>> m_reloaded;
+        std::unordered_map<std::string, WatchedShader> m_watched;
+        std::vector<Listener> m_listeners;
+
+        std::deque<RetiredPipeline> m_retired;
+        /** Submitted frames before the one being prepared, as given to the last poll(). */
+        uint64_t m_frameNumber = 0;
+        std::chrono::steady_clock::time_point m_lastScan;
+
+        std::filesystem::file_time_type newestWrite(const WatchedShader &shader) const;
+        void scanSources();
+        void collectCompiles();
+
+        static CompileResult compileShader(std::filesystem::path source, std::filesystem::path outputDirectory);
+        static std::vector<std::filesystem::path> readDepfile(const std::filesystem::path &path);
+    };
+}
+
+#endif
@@ -0,0 +1,340 @@
+#include "UploadRing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Engine {
+    UploadRing::UploadRing(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                           DeviceQueues &queues, vk::DeviceSize capacity)
+        : m_device(device), m_queues(queues), m_transferFamily(queues.family(QueueType::Transfer)),
+          m_graphicsFamily(queues.family(QueueType::Graphics)), m_capacity(capacity) {
+        m_staging = createBuffer(physicalDevice, device, capacity,
+                                 vk::BufferUsageFlagBits::eTransferSrc,
+                                 vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+        m_mapped = static_cast<uint8_t *>(m_staging.memory.mapMemory(0, capacity));
+
+        vk::PhysicalDeviceLimits limits = physicalDevice.getProperties().limits;
+        m_alignment = std::max<vk::DeviceSize>(m_alignment, limits.optimalBufferCopyOffsetAlignment);
+
+        vk::SemaphoreTypeCreateInfo timelineInfo{};
+        timelineInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        timelineInfo.initialValue = 0;
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.pNext = &timelineInfo;
+        m_timeline = vk::raii::Semaphore(device, semaphoreInfo);
+
+        for (CommandSlot &slot : m_commandSlots) {
+            vk::CommandPoolCreateInfo poolInfo{};
+            poolInfo.flags = vk::CommandPoolCreateFlagBits::eTransient;
+            poolInfo.queueFamilyIndex = m_transferFamily;
+            slot.pool = vk::raii::CommandPool(device, poolInfo);
+
+            vk::CommandBufferAllocateInfo allocInfo{};
+            allocInfo.commandPool = *slot.pool;
+            allocInfo.level = vk::CommandBufferLevel::ePrimary;
+            allocInfo.commandBufferCount = 1;
+            slot.commandBuffer = std::move(vk::raii::CommandBuffers(device, allocInfo).front());
+        }
+    }
+
+    std::optional<vk::DeviceSize> UploadRing::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+        if (size > m_capacity) {
+            return std::nullopt;
+        }
+
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            vk::DeviceSize offset = alignUp(m_head, alignment);
+            vk::DeviceSize consumed = offset - m_head + size;
+
+            /** The tail of the buffer is too short, skip it and account it to this batch. */
+            if (offset + size > m_capacity) {
+                offset = 0;
+                consumed = (m_capacity - m_head) + size;
+            }
+
+            if (m_used + consumed <= m_capacity) {
+                m_head = offset + size;
+                m_used += consumed;
+                m_pending.bytes += consumed;
+                return offset;
+            }
+
+            retire();
+        }
+
+        return std::nullopt;
+    }
+
+    void UploadRing::retire() {
+        const uint64_t completed = m_timeline.getCounterValue();
+
+        while (!m_inFlight.empty() && m_inFlight.front().ticket <= completed) {
+            m_used -= m_inFlight.front().bytes;
+            m_inFlight.pop_front();
+        }
+
+        if (m_used == 0) {
+            m_head = 0;
+        }
+    }
+
+    uint64_t UploadRing::uploadBuffer(vk::Buffer dst, vk::DeviceSize dstOffset, const void *data, vk::DeviceSize size,
+                                      vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::optional<vk::DeviceSize> offset = allocate(size, 4);
+        if (!offset) {
+            return 0;
+        }
+
+        std::memcpy(m_mapped + *offset, data, size);
+
+        BufferCopy copy{};
+        copy.dst = dst;
+        copy.region.srcOffset = *offset;
+        copy.region.dstOffset = dstOffset;
+        copy.region.size = size;
+        copy.dstStage = dstStage;
+        copy.dstAccess = dstAccess;
+        m_pending.bufferCopies.push_back(copy);
+
+        return m_submittedTicket + 1;
+    }
+
+    uint64_t UploadRing::uploadImage(vk::Image dst, vk::ImageAspectFlags aspect, vk::Extent3D extent,
+                                     uint32_t mipLevel, uint32_t arrayLayer, const void *data, vk::DeviceSize size,
+                                     vk::ImageLayout finalLayout, vk::PipelineStageFlags2 dstStage,
+                                     vk::AccessFlags2 dstAccess) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::optional<vk::DeviceSize> offset = allocate(size, m_alignment);
+        if (!offset) {
+            return 0;
+        }
+
+        std::memcpy(m_mapped + *offset, data, size);
+
+        ImageCopy copy{};
+        copy.dst = dst;
+        copy.region.bufferOffset = *offset;
+        copy.region.imageSubresource.aspectMask = aspect;
+        copy.region.imageSubresource.mipLevel = mipLevel;
+        copy.region.imageSubresource.baseArrayLayer = arrayLayer;
+        copy.region.imageSubresource.layerCount = 1;
+        copy.region.imageExtent = extent;
+        copy.finalLayout = finalLayout;
+        copy.dstStage = dstStage;
+        copy.dstAccess = dstAccess;
+        m_pending.imageCopies.push_back(copy);
+
+        return m_submittedTicket + 1;
+    }
+
+    void UploadRing::recordBatch(const vk::raii::CommandBuffer &commandBuffer, const Batch &batch) {
+        const bool ownershipTransfer = hasDedicatedTransferQueue();
+
+        std::vector<vk::ImageMemoryBarrier2> toTransferDst;
+        toTransferDst.reserve(batch.imageCopies.size());
+        for (const ImageCopy &copy : batch.imageCopies) {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+            barrier.dstStageMask = vk::PipelineStageFlagBits2::eCopy;
+            barrier.dstAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            barrier.oldLayout = vk::ImageLayout::eUndefined;
+            barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+            barrier.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
+            barrier.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
+            barrier.image = copy.dst;
+            barrier.subresourceRange = vk::ImageSubresourceRange(copy.region.imageSubresource.aspectMask,
+                                                                 copy.region.imageSubresource.mipLevel, 1,
+                                                                 copy.region.imageSubresource.baseArrayLayer, 1);
+            toTransferDst.push_back(barrier);
+        }
+
+        if (!toTransferDst.empty()) {
+            vk::DependencyInfo dependencyInfo{};
+            dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(toTransferDst.size());
+            dependencyInfo.pImageMemoryBarriers = toTransferDst.data();
+            commandBuffer.pipelineBarrier2(dependencyInfo);
+        }
+
+        for (const BufferCopy &copy : batch.bufferCopies) {
+            commandBuffer.copyBuffer(*m_staging.buffer, copy.dst, copy.region);
+        }
+
+        for (const ImageCopy &copy : batch.imageCopies) {
+            commandBuffer.copyBufferToImage(*m_staging.buffer, copy.dst, vk::ImageLayout::eTransferDstOptimal, copy.region);
+        }
+
+        /**
+         * With a dedicated transfer family the barriers below are the release half of a
+         * queue-family ownership transfer, the graphics queue records the matching acquire.
+         * Otherwise they are plain barriers covering the consumers directly.
+         */
+        std::vector<vk::BufferMemoryBarrier2> bufferBarriers;
+        std::vector<vk::ImageMemoryBarrier2> imageBarriers;
+        bufferBarriers.reserve(batch.bufferCopies.size());
+        imageBarriers.reserve(batch.imageCopies.size());
+
+        for (const BufferCopy &copy : batch.bufferCopies) {
+            vk::BufferMemoryBarrier2 barrier{};
+            barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+            barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            barrier.dstStageMask = ownershipTransfer ? vk::PipelineStageFlagBits2::eNone : copy.dstStage;
+            barrier.dstAccessMask = ownershipTransfer ? vk::AccessFlagBits2::eNone : copy.dstAccess;
+            barrier.srcQueueFamilyIndex = ownershipTransfer ? m_transferFamily : vk::QueueFamilyIgnored;
+            barrier.dstQueueFamilyIndex = ownershipTransfer ? m_graphicsFamily : vk::QueueFamilyIgnored;
+            barrier.buffer = copy.dst;
+            barrier.offset = copy.region.dstOffset;
+            barrier.size = copy.region.size;
+            bufferBarriers.push_back(barrier);
+
+            if (ownershipTransfer) {
+                barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+                barrier.srcAccessMask = vk::AccessFlagBits2::eNone;
+                barrier.dstStageMask = copy.dstStage;
+                barrier.dstAccessMask = copy.dstAccess;
+                m_acquireBufferBarriers.push_back(barrier);
+            }
+        }
+
+        for (const ImageCopy &copy : batch.imageCopies) {
+            vk::ImageMemoryBarrier2 barrier{};
+            barrier.srcStageMask = vk::PipelineStageFlagBits2::eCopy;
+            barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            barrier.dstStageMask = ownershipTransfer ? vk::PipelineStageFlagBits2::eNone : copy.dstStage;
+            barrier.dstAccessMask = ownershipTransfer ? vk::AccessFlagBits2::eNone : copy.dstAccess;
+            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+            barrier.newLayout = copy.finalLayout;
+            barrier.srcQueueFamilyIndex = ownershipTransfer ? m_transferFamily : vk::QueueFamilyIgnored;
+            barrier.dstQueueFamilyIndex = ownershipTransfer ? m_graphicsFamily : vk::QueueFamilyIgnored;
+            barrier.image = copy.dst;
+            barrier.subresourceRange = vk::ImageSubresourceRange(copy.region.imageSubresource.aspectMask,
+                                                                 copy.region.imageSubresource.mipLevel, 1,
+                                                                 copy.region.imageSubresource.baseArrayLayer, 1);
+            imageBarriers.push_back(barrier);
+
+            if (ownershipTransfer) {
+                barrier.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+                barrier.srcAccessMask = vk::AccessFlagBits2::eNone;
+                barrier.dstStageMask = copy.dstStage;
+                barrier.dstAccessMask = copy.dstAccess;
+                m_acquireImageBarriers.push_back(barrier);
+            }
+        }
+
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+        commandBuffer.pipelineBarrier2(dependencyInfo);
+    }
+
+    void UploadRing::flush() {
+        m_acquireBufferBarriers.clear();
+        m_acquireImageBarriers.clear();
+        m_acquireTicket = 0;
+
+        Batch batch;
+        uint64_t ticket = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            retire();
+
+            if (m_pending.bufferCopies.empty() && m_pending.imageCopies.empty()) {
+                return;
+            }
+
+            batch = std::move(m_pending);
+            m_pending = Batch{};
+            ticket = ++m_submittedTicket;
+            m_inFlight.push_back({ticket, batch.bytes});
+        }
+
+        CommandSlot &slot = m_commandSlots[m_nextCommandSlot];
+        m_nextCommandSlot = (m_nextCommandSlot + 1) % COMMAND_SLOT_COUNT;
+
+        /** Only waits when the transfer queue is more than a full slot cycle behind. */
+        waitForTicket(slot.ticket);
+        slot.pool.reset();
+        slot.ticket = ticket;
+
+        vk::CommandBufferBeginInfo beginInfo{};
+        beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+        slot.commandBuffer.begin(beginInfo);
+        recordBatch(slot.commandBuffer, batch);
+        slot.commandBuffer.end();
+
+        vk::CommandBufferSubmitInfo commandBufferInfo{};
+        commandBufferInfo.commandBuffer = *slot.commandBuffer;
+
+        vk::SemaphoreSubmitInfo signalInfo{};
+        signalInfo.semaphore = *m_timeline;
+        signalInfo.value = ticket;
+        signalInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+        vk::SubmitInfo2 submitInfo{};
+        submitInfo.commandBufferInfoCount = 1;
+        submitInfo.pCommandBufferInfos = &commandBufferInfo;
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &signalInfo;
+        m_queues.submit(QueueType::Transfer, submitInfo);
+
+        m_acquireTicket = ticket;
+    }
+
+    void UploadRing::recordAcquireBarriers(const vk::raii::CommandBuffer &commandBuffer) {
+        if (m_acquireBufferBarriers.empty() && m_acquireImageBarriers.empty()) {
+            return;
+        }
+
+        vk::DependencyInfo dependencyInfo{};
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_acquireBufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = m_acquireBufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(m_acquireImageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = m_acquireImageBarriers.data();
+        commandBuffer.pipelineBarrier2(dependencyInfo);
+
+        m_acquireBufferBarriers.clear();
+        m_acquireImageBarriers.clear();
+    }
+
+    std::optional<vk::SemaphoreSubmitInfo> UploadRing::graphicsWait() const {
+        if (m_acquireTicket == 0) {
+            return std::nullopt;
+        }
+
+        vk::SemaphoreSubmitInfo waitInfo{};
+        waitInfo.semaphore = *m_timeline;
+        waitInfo.value = m_acquireTicket;
+        waitInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        return waitInfo;
+    }
+
+    bool UploadRing::isRetired(uint64_t ticket) const {
+        return completedTicket() >= ticket;
+    }
+
+    uint64_t UploadRing::completedTicket() const {
+        return m_timeline.getCounterValue();
+    }
+
+    void UploadRing::waitForTicket(uint64_t ticket) const {
+        if (ticket == 0 || isRetired(ticket)) {
+            return;
+        }
+
+        vk::Semaphore semaphore = *m_timeline;
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &semaphore;
+        waitInfo.pValues = &ticket;
+        static_cast<void>(m_device.waitSemaphores(waitInfo, UINT64_MAX));
+    }
+
+    vk::DeviceSize UploadRing::bytesInUse() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_used;
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef __ENGINE_UPLOAD_RING_HPP__
+#define __ENGINE_UPLOAD_RING_HPP__
+
+#include "Vulkan.hpp"
+#include "DeviceQueues.hpp"
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace Engine {
+    /**
+     * Persistently mapped staging ring used to stream mesh and texture data to the GPU.
+     *
+     * Producers copy their data into the ring and receive a ticket. Once per frame flush()
+     * records every pending copy into a single command buffer and submits it to the transfer
+     * queue, signalling a timeline semaphore with the ticket value. When the transfer queue
+     * belongs to a different family than the graphics queue, the copies end with release
+     * barriers and the graphics frame must call recordAcquireBarriers() and wait on
+     * graphicsWait() before using the uploaded resources.
+     *
+     * Producers may call the upload functions from any thread.
+     */
+    class UploadRing {
+    public:
+        static constexpr vk::DeviceSize DEFAULT_CAPACITY = 64ull * 1024ull * 1024ull;
+
+        UploadRing(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                   DeviceQueues &queues, vk::DeviceSize capacity = DEFAULT_CAPACITY);
+
+        UploadRing(const UploadRing &) = delete;
+        UploadRing &operator=(const UploadRing &) = delete;
+
+        /**
+         * Stages `size` bytes for a copy into `dst` at `dstOffset`.
+         * Returns the ticket of the batch carrying the copy, or 0 when the ring is full
+         * and the caller should retry on a later frame.
+         */
+        uint64_t uploadBuffer(vk::Buffer dst, vk::DeviceSize dstOffset, const void *data, vk::DeviceSize size,
+                              vk::PipelineStageFlags2 dstStage, vk::AccessFlags2 dstAccess);
+
+        /**
+         * Stages a whole mip level of one array layer of `dst`. The previous contents of
+         * the subresource are discarded and it ends in `finalLayout`.
+         * Returns the ticket of the batch carrying the copy, or 0 when the ring is full.
+         */
+        uint64_t uploadImage(vk::Image dst, vk::ImageAspectFlags aspect, vk::Extent3D extent,
+                             uint32_t mipLevel, uint32_t arrayLayer, const void *data, vk::DeviceSize size,
+                             vk::ImageLayout finalLayout, vk::PipelineStageFlags2 dstStage,
+                             vk::AccessFlags2 dstAccess);
+
+        /** Records and submits every pending copy. Call once per frame before the graphics submit. */
+        void flush();
+
+        /** Records the queue-family acquire half of the last flushed batch into a graphics command buffer. */
+        void recordAcquireBarriers(const vk::raii::CommandBuffer &commandBuffer);
+
+        /** Timeline wait the graphics submit needs for the batch flushed this frame, if any. */
+        std::optional<vk::SemaphoreSubmitInfo> graphicsWait() const;
+
+        /** Returns true once the batch carrying `ticket` finished on the GPU and its staging memory is reusable. */
+        bool isRetired(uint64_t ticket) const;
+
+        /** Highest ticket known to be finished on the GPU. */
+        uint64_t completedTicket() const;
+
+        /** Blocks until the batch carrying `ticket` finished on the GPU. */
+        void waitForTicket(uint64_t ticket) const;
+
+        bool hasDedicatedTransferQueue() const { return m_transferFamily != m_graphicsFamily; }
+        vk::DeviceSize capacity() const { return m_capacity; }
+        vk::DeviceSize bytesInUse() const;
+
+    private:
+        struct BufferCopy {
+            vk::Buffer dst;
+            vk::BufferCopy region;
+            vk::PipelineStageFlags2 dstStage;
+            vk::AccessFlags2 dstAccess;
+        };
+
+        struct ImageCopy {
+            vk::Image dst;
+            vk::BufferImageCopy region;
+            vk::ImageLayout finalLayout;
+            vk::PipelineStageFlags2 dstStage;
+            vk::AccessFlags2 dstAccess;
+        };
+
+        struct Batch {
+            std::vector<BufferCopy> bufferCopies;
+            std::vector<ImageCopy> imageCopies;
+            vk::DeviceSize bytes = 0;
+        };
+
+        struct InFlightBatch {
+            uint64_t ticket = 0;
+            vk::DeviceSize bytes = 0;
+        };
+
+        /** Transfer command buffers are recycled once the batch they carried retired. */
+        struct CommandSlot {
+            vk::raii::CommandPool pool = nullptr;
+            vk::raii::CommandBuffer commandBuffer = nullptr;
+            uint64_t ticket = 0;
+        };
+
+        static constexpr uint32_t COMMAND_SLOT_COUNT = MAX_FRAMES_IN_FLIGHT + 1;
+
+        const vk::raii::Device &m_device;
+        DeviceQueues &m_queues;
+        uint32_t m_transferFamily;
+        uint32_t m_graphicsFamily;
+
+        VulkanBuffer m_staging;
+        uint8_t *m_mapped = nullptr;
+        vk::DeviceSize m_capacity;
+        vk::DeviceSize m_head = 0;
+        vk::DeviceSize m_used = 0;
+        vk::DeviceSize m_alignment = 16;
+
+        vk::raii::Semaphore m_timeline = nullptr;
+        uint64_t m_submittedTicket = 0;
+
+        std::array<CommandSlot, COMMAND_SLOT_COUNT> m_commandSlots;
+        uint32_t m_nextCommandSlot = 0;
+
+        Batch m_pending;
+        std::deque<InFlightBatch> m_inFlight;
+        mutable std::mutex m_mutex;
+
+        /** Acquire barriers of the batch flushed this frame, consumed by recordAcquireBarriers(). */
+        std::vector<vk::BufferMemoryBarrier2> m_acquireBufferBarriers;
+        std::vector<vk::ImageMemoryBarrier2> m_acquireImageBarriers;
+        uint64_t m_acquireTicket = 0;
+
+        std::optional<vk::DeviceSize> allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+        void retire();
+        void recordBatch(const vk::raii::CommandBuffer &commandBuffer, const Batch &batch);
+    };
+}
+
+#endif
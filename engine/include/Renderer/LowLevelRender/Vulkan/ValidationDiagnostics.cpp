@@ -0,0 +1,196 @@
+#include "ValidationDiagnostics.hpp"
+
+#include "../../../logger.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace Engine {
+    namespace {
+        constexpr size_t MAX_SUMMARY_ENTRIES = 8;
+    }
+
+    VKAPI_ATTR vk::Bool32 VKAPI_CALL ValidationDiagnostics::callback(vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
+                                                                     vk::DebugUtilsMessageTypeFlagsEXT type,
+                                                                     const vk::DebugUtilsMessengerCallbackDataEXT *pCallbackData,
+                                                                     void *pUserData) {
+        if (pUserData && pCallbackData) {
+            static_cast<ValidationDiagnostics *>(pUserData)->report(severity, type, *pCallbackData);
+        }
+
+        return vk::False;
+    }
+
+    uint64_t ValidationDiagnostics::keyOf(const vk::DebugUtilsMessengerCallbackDataEXT &callbackData) {
+        if (callbackData.messageIdNumber != 0) {
+            return static_cast<uint32_t>(callbackData.messageIdNumber);
+        }
+
+        /** Messages without an ID number are told apart by their name, or their text as a last resort. */
+        const char *text = callbackData.pMessageIdName ? callbackData.pMessageIdName : callbackData.pMessage;
+        return std::hash<std::string_view>{}(text ? text : "") | (1ull << 63);
+    }
+
+    void ValidationDiagnostics::report(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type,
+                                       const vk::DebugUtilsMessengerCallbackDataEXT &callbackData) {
+        const auto now = std::chrono::steady_clock::now();
+        const uint64_t key = keyOf(callbackData);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eError) {
+            m_errors++;
+        }
+
+        if (auto found = m_entries.find(key); found != m_entries.end()) {
+            found->second.message.count++;
+            found->second.message.lastSeen = now;
+            return;
+        }
+
+        if (m_entries.size() >= MAX_TRACKED_MESSAGES) {
+            m_untracked++;
+            return;
+        }
+
+        Entry entry;
+        entry.message.severity = severity;
+        entry.message.type = type;
+        entry.message.messageId = callbackData.messageIdNumber;
+        entry.message.idName = callbackData.pMessageIdName ? callbackData.pMessageIdName : "";
+        entry.message.message = callbackData.pMessage ? callbackData.pMessage : "";
+        entry.message.count = 1;
+        entry.message.firstSeen = now;
+        entry.message.lastSeen = now;
+        m_entries.emplace(key, std::move(entry));
+
+        m_recent.push_back(key);
+        if (m_recent.size() > RING_CAPACITY) {
+            m_recent.pop_front();
+        }
+
+        m_pending.push_back(key);
+    }
+
+    void ValidationDiagnostics::drain() {
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - m_budgetStart >= std::chrono::seconds(1)) {
+            m_budgetStart = now;
+            m_budgetUsed = 0;
+        }
+
+        std::vector<ValidationMessage> fresh;
+        uint64_t untracked = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            /** Messages over the budget stay pending and are logged in a later second. */
+            const size_t take = std::min<size_t>(m_pending.size(), MAX_LOGS_PER_SECOND - m_budgetUsed);
+            for (size_t i = 0; i < take; ++i) {
+                Entry &entry = m_entries[m_pending[i]];
+                entry.loggedCount = entry.message.count;
+                fresh.push_back(entry.message);
+            }
+            m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(take));
+            m_rateLimited = m_pending.size();
+
+            untracked = std::exchange(m_untracked, 0);
+        }
+
+        m_budgetUsed += static_cast<uint32_t>(fresh.size());
+        for (const ValidationMessage &message : fresh) {
+            log(message);
+        }
+
+        if (untracked > 0) {
+            ENGINE_CLOG_WARNING(Render, "{} validation messages dropped, more than {} distinct messages seen", untracked, MAX_TRACKED_MESSAGES)
+        }
+
+        if (now - m_lastSummary >= REPEAT_SUMMARY_INTERVAL) {
+            m_lastSummary = now;
+            logRepeats();
+
+            if (m_rateLimited > 0) {
+                ENGINE_CLOG_WARNING(Render, "{} validation messages waiting behind the log rate limit", m_rateLimited)
+            }
+        }
+    }
+
+    void ValidationDiagnostics::log(const ValidationMessage &message) {
+        if (message.isPerformanceHint()) {
+            ENGINE_CLOG_WARNING(Render, "Performance hint [{}]: {}", message.idName, message.message)
+        } else if (message.severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eError) {
+            ENGINE_CLOG_ERROR(Render, "Validation error [{}]: {}", message.idName, message.message)
+        } else if (message.severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning) {
+            ENGINE_CLOG_WARNING(Render, "Validation warning [{}]: {}", message.idName, message.message)
+        } else {
+            ENGINE_CLOG_DEBUG(Render, "Validation [{}]: {}", message.idName, message.message)
+        }
+    }
+
+    void ValidationDiagnostics::logRepeats() {
+        std::vector<std::pair<uint64_t, std::string>> repeats;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            for (auto &[key, entry] : m_entries) {
+                if (entry.loggedCount == 0 || entry.message.count == entry.loggedCount) {
+                    continue;
+                }
+
+                repeats.emplace_back(entry.message.count - entry.loggedCount, entry.message.idName);
+                entry.loggedCount = entry.message.count;
+            }
+        }
+
+        if (repeats.empty()) {
+            return;
+        }
+
+        std::ranges::sort(repeats, std::greater<>{});
+
+        std::string summary;
+        for (size_t i = 0; i < std::min(repeats.size(), MAX_SUMMARY_ENTRIES); ++i) {
+            summary += (summary.empty() ? "" : ", ") + repeats[i].second + " x" + std::to_string(repeats[i].first);
+        }
+        if (repeats.size() > MAX_SUMMARY_ENTRIES) {
+            summary += " and " + std::to_string(repeats.size() - MAX_SUMMARY_ENTRIES) + " more";
+        }
+
+        ENGINE_CLOG_WARNING(Render, "Repeated validation messages: {}", summary)
+    }
+
+    std::vector<ValidationMessage> ValidationDiagnostics::recent() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<ValidationMessage> messages;
+        messages.reserve(m_recent.size());
+        for (auto key = m_recent.rbegin(); key != m_recent.rend(); ++key) {
+            messages.push_back(m_entries.at(*key).message);
+        }
+
+        return messages;
+    }
+
+    std::vector<ValidationMessage> ValidationDiagnostics::performanceHints() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::vector<ValidationMessage> hints;
+        for (const auto &[key, entry] : m_entries) {
+            if (entry.message.isPerformanceHint()) {
+                hints.push_back(entry.message);
+            }
+        }
+
+        std::ranges::sort(hints, std::greater<>{}, &ValidationMessage::count);
+        return hints;
+    }
+
+    uint64_t ValidationDiagnostics::errorCount() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_errors;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef __ENGINE_VALIDATION_DIAGNOSTICS_HPP__
+#define __ENGINE_VALIDATION_DIAGNOSTICS_HPP__
+
+#include "Vulkan.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    /** One distinct validation message together with how often it fired. */
+    struct ValidationMessage {
+        vk::DebugUtilsMessageSeverityFlagBitsEXT severity = vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning;
+        vk::DebugUtilsMessageTypeFlagsEXT type;
+        int32_t messageId = 0;
+        std::string idName;
+        std::string message;
+        uint64_t count = 0;
+        std::chrono::steady_clock::time_point firstSeen;
+        std::chrono::steady_clock::time_point lastSeen;
+
+        bool isPerformanceHint() const { return !!(type & vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance); }
+    };
+
+    /**
+     * Sink for the debug utils messenger.
+     *
+     * report() runs on whichever thread the driver or layer calls back from and only records:
+     * messages are deduplicated by message ID, a repeat just bumps a counter, and only the
+     * first occurrence copies the text. drain() runs on the main thread and writes new
+     * messages to the engine logger, at most MAX_LOGS_PER_SECOND lines per second, plus a
+     * periodic summary of repeats and of lines dropped by the limit.
+     *
+     * ePerformance messages are also kept as structured performance hints.
+     */
+    class ValidationDiagnostics {
+    public:
+        static constexpr size_t RING_CAPACITY = 128;
+        static constexpr size_t MAX_TRACKED_MESSAGES = 1024;
+        static constexpr uint32_t MAX_LOGS_PER_SECOND = 20;
+        static constexpr std::chrono::seconds REPEAT_SUMMARY_INTERVAL{5};
+
+        ValidationDiagnostics() = default;
+
+        ValidationDiagnostics(const ValidationDiagnostics &) = delete;
+        ValidationDiagnostics &operator=(const ValidationDiagnostics &) = delete;
+
+        /** Thread safe, called from the messenger callback. */
+        void report(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type,
+                    const vk::DebugUtilsMessengerCallbackDataEXT &callbackData);
+
+        /** Logs what arrived since the last call. Call once per frame from the main thread. */
+        void drain();
+
+        /** Most recently first-seen messages, newest first, with their current counts. */
+        std::vector<ValidationMessage> recent() const;
+
+        /** Every distinct ePerformance message seen so far. */
+        std::vector<ValidationMessage> performanceHints() const;
+
+        uint64_t errorCount() const;
+
+        static VKAPI_ATTR vk::Bool32 VKAPI_CALL callback(vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
+                                                         vk::DebugUtilsMessageTypeFlagsEXT type,
+                                                         const vk::DebugUtilsMessengerCallbackDataEXT *pCallbackData,
+                                                         void *pUserData);
+
+    private:
+        struct Entry {
+            ValidationMessage message;
+            /** Count already written to the log. */
+            uint64_t loggedCount = 0;
+        };
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::deque<uint64_t> m_recent;
+        std::vector<uint64_t> m_pending;
+        uint64_t m_untracked = 0;
+        uint64_t m_errors = 0;
+
+        /** Main thread only. */
+        std::chrono::steady_clock::time_point m_budgetStart;
+        uint32_t m_budgetUsed = 0;
+        uint64_t m_rateLimited = 0;
+        std::chrono::steady_clock::time_point m_lastSummary;
+
+        static uint64_t keyOf(const vk::DebugUtilsMessengerCallbackDataEXT &callbackData);
+        void log(const ValidationMessage &message);
+        void logRepeats();
+    };
+}
+
+#endif
@@ -1 +1,86 @@
+#include "Vulkan.hpp"
 
+#include <fstream>
+#include <stdexcept>
+
+namespace Engine {
+    uint32_t findMemoryType(const vk::raii::PhysicalDevice &physicalDevice, uint32_t typeFilter,
+                            vk::MemoryPropertyFlags properties) {
+        vk::PhysicalDeviceMemoryProperties memoryProperties = physicalDevice.getMemoryProperties();
+
+        for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+            if ((typeFilter & (1u << i)) &&
+                (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return i;
+            }
+        }
+
+        throw std::runtime_error("Failed to find a suitable memory type!");
+    }
+
+    VulkanBuffer createBuffer(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                              vk::DeviceSize size, vk::BufferUsageFlags usage,
+                              vk::MemoryPropertyFlags properties) {
+        VulkanBuffer result;
+        result.size = size;
+
+        vk::BufferCreateInfo bufferInfo{};
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = vk::SharingMode::eExclusive;
+        result.buffer = vk::raii::Buffer(device, bufferInfo);
+
+        vk::MemoryRequirements memoryRequirements = result.buffer.getMemoryRequirements();
+        vk::MemoryAllocateInfo allocInfo{};
+        allocInfo.allocationSize = memoryRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memoryRequirements.memoryTypeBits, properties);
+        result.memory = vk::raii::DeviceMemory(device, allocInfo);
+        result.buffer.bindMemory(*result.memory, 0);
+
+        return result;
+    }
+
+    VulkanImage createImage(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                            const vk::ImageCreateInfo &imageInfo, vk::MemoryPropertyFlags properties) {
+        VulkanImage result;
+        result.format = imageInfo.format;
+        result.extent = imageInfo.extent;
+        result.mipLevels = imageInfo.mipLevels;
+        result.image = vk::raii::Image(device, imageInfo);
+
+        vk::MemoryRequirements memoryRequirements = result.image.getMemoryRequirements();
+        vk::MemoryAllocateInfo allocInfo{};
+        allocInfo.allocationSize = memoryRequirements.size;
+        allocInfo.memoryTypeIndex = findMemoryType(physicalDevice, memoryRequirements.memoryTypeBits, properties);
+        result.memory = vk::raii::DeviceMemory(device, allocInfo);
+        result.image.bindMemory(*result.memory, 0);
+
+        return result;
+    }
+
+    std::vector<uint32_t> readSpirvFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open shader file: " + path.string());
+        }
+
+        const std::streamsize size = file.tellg();
+        if (size <= 0 || size % sizeof(uint32_t) != 0) {
+            throw std::runtime_error("Malformed SPIR-V file: " + path.string());
+        }
+
+        std::vector<uint32_t> code(static_cast<size_t>(size) / sizeof(uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(code.data()), size);
+
+        return code;
+    }
+
+    vk::raii::ShaderModule createShaderModule(const vk::raii::Device &device, const std::vector<uint32_t> &code) {
+        vk::ShaderModuleCreateInfo createInfo{};
+        createInfo.codeSize = code.size() * sizeof(uint32_t);
+        createInfo.pCode = code.data();
+
+        return vk::raii::ShaderModule(device, createInfo);
+    }
+}
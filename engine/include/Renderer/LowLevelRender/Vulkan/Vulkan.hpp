@@ -1 +1,50 @@
+#ifndef __ENGINE_VULKAN_HPP__
+#define __ENGINE_VULKAN_HPP__
 
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+namespace Engine {
+    /** Number of frames the CPU is allowed to record ahead of the GPU. */
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+
+    /** Buffer together with the memory bound to it. */
+    struct VulkanBuffer {
+        vk::raii::Buffer buffer = nullptr;
+        vk::raii::DeviceMemory memory = nullptr;
+        vk::DeviceSize size = 0;
+    };
+
+    /** Image together with the memory bound to it. */
+    struct VulkanImage {
+        vk::raii::Image image = nullptr;
+        vk::raii::DeviceMemory memory = nullptr;
+        vk::Format format = vk::Format::eUndefined;
+        vk::Extent3D extent{};
+        uint32_t mipLevels = 1;
+    };
+
+    constexpr vk::DeviceSize alignUp(vk::DeviceSize value, vk::DeviceSize alignment) {
+        return alignment == 0 ? value : (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    uint32_t findMemoryType(const vk::raii::PhysicalDevice &physicalDevice, uint32_t typeFilter,
+                            vk::MemoryPropertyFlags properties);
+
+    VulkanBuffer createBuffer(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                              vk::DeviceSize size, vk::BufferUsageFlags usage,
+                              vk::MemoryPropertyFlags properties);
+
+    VulkanImage createImage(const vk::raii::PhysicalDevice &physicalDevice, const vk::raii::Device &device,
+                            const vk::ImageCreateInfo &imageInfo, vk::MemoryPropertyFlags properties);
+
+    /** Reads a SPIR-V binary, throws std::runtime_error when it is missing or malformed. */
+    std::vector<uint32_t> readSpirvFile(const std::filesystem::path &path);
+
+    vk::raii::ShaderModule createShaderModule(const vk::raii::Device &device, const std::vector<uint32_t> &code);
+}
+
+#endif
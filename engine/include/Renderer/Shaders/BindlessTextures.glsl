@@ -0,0 +1,42 @@
+#ifndef BINDLESS_TEXTURES_GLSL
+#define BINDLESS_TEXTURES_GLSL
+
+/**
+ * Bindless block texture heap and the packed chunk vertex, see BindlessTextureHeap.hpp.
+ * Define BINDLESS_SET before including to place the heap in another descriptor set.
+ */
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+#ifndef BINDLESS_SET
+#define BINDLESS_SET 0
+#endif
+
+layout(set = BINDLESS_SET, binding = 0) uniform sampler2D blockTextures[];
+
+struct BlockVertex {
+    uvec3 position;
+    uint face;
+    uint ambientOcclusion;
+    uint corner;
+    uint texture;
+    uint tint;
+};
+
+BlockVertex unpackBlockVertex(uvec2 packedVertex) {
+    BlockVertex vertex;
+    vertex.position = uvec3(packedVertex.x & 0x3Fu, (packedVertex.x >> 6u) & 0x3Fu, (packedVertex.x >> 12u) & 0x3Fu);
+    vertex.face = (packedVertex.x >> 18u) & 0x7u;
+    vertex.ambientOcclusion = (packedVertex.x >> 21u) & 0x3u;
+    vertex.corner = (packedVertex.x >> 23u) & 0x3u;
+    vertex.texture = packedVertex.y & 0xFFFFu;
+    vertex.tint = packedVertex.y >> 16u;
+    return vertex;
+}
+
+/** The index may differ inside a subgroup, so it must be marked non-uniform. */
+vec4 sampleBlockTexture(uint textureIndex, vec2 uv) {
+    return texture(blockTextures[nonuniformEXT(textureIndex)], uv);
+}
+
+#endif
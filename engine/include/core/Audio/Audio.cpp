@@ -1 +1,602 @@
+#include "Audio.hpp"
 
+#include "../../logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ENGINE_AUDIO_SSE 1
+#else
+#define ENGINE_AUDIO_SSE 0
+#endif
+
+namespace Engine {
+    namespace {
+        constexpr uint64_t FIXED_ONE = 1ull << 32;
+        constexpr float FIXED_FRACTION = 1.0f / 4294967296.0f;
+        constexpr float MIN_PITCH = 1.0f / 64.0f;
+        constexpr float MAX_PITCH = 64.0f;
+
+        /** `p_destination += p_source * gain`, the gain moving linearly from `p_from` to reach `p_to` after `p_rampFrames`. */
+        void mixRamp(float *p_destination, const float *p_source, uint32_t p_count, float p_from, float p_to, uint32_t p_rampFrames) {
+            const float delta = (p_to - p_from) / static_cast<float>(p_rampFrames);
+            uint32_t i = 0;
+
+#if ENGINE_AUDIO_SSE
+            __m128 gain = _mm_setr_ps(p_from + delta, p_from + 2.0f * delta, p_from + 3.0f * delta, p_from + 4.0f * delta);
+            const __m128 step = _mm_set1_ps(4.0f * delta);
+            for (; i + 4 <= p_count; i += 4) {
+                const __m128 mixed = _mm_add_ps(_mm_load_ps(p_destination + i), _mm_mul_ps(_mm_load_ps(p_source + i), gain));
+                _mm_store_ps(p_destination + i, mixed);
+                gain = _mm_add_ps(gain, step);
+            }
+#endif
+
+            for (; i < p_count; i++) {
+                p_destination[i] += p_source[i] * (p_from + delta * static_cast<float>(i + 1));
+            }
+        }
+
+        /** Clamps to [-1, 1] and interleaves the two planes into stereo frames. */
+        void interleave(float *p_output, const float *p_left, const float *p_right, uint32_t p_count) {
+            uint32_t i = 0;
+
+#if ENGINE_AUDIO_SSE
+            const __m128 low = _mm_set1_ps(-1.0f);
+            const __m128 high = _mm_set1_ps(1.0f);
+            for (; i + 4 <= p_count; i += 4) {
+                const __m128 left = _mm_min_ps(_mm_max_ps(_mm_load_ps(p_left + i), low), high);
+                const __m128 right = _mm_min_ps(_mm_max_ps(_mm_load_ps(p_right + i), low), high);
+                _mm_storeu_ps(p_output + i * 2, _mm_unpacklo_ps(left, right));
+                _mm_storeu_ps(p_output + i * 2 + 4, _mm_unpackhi_ps(left, right));
+            }
+#endif
+
+            for (; i < p_count; i++) {
+                p_output[i * 2] = std::clamp(p_left[i], -1.0f, 1.0f);
+                p_output[i * 2 + 1] = std::clamp(p_right[i], -1.0f, 1.0f);
+            }
+        }
+
+        void writeU16(std::ofstream &p_file, uint16_t p_value) {
+            const char bytes[2] = { static_cast<char>(p_value), static_cast<char>(p_value >> 8) };
+            p_file.write(bytes, sizeof(bytes));
+        }
+
+        void writeU32(std::ofstream &p_file, uint32_t p_value) {
+            writeU16(p_file, static_cast<uint16_t>(p_value));
+            writeU16(p_file, static_cast<uint16_t>(p_value >> 16));
+        }
+    }
+
+    AudioMixer::AudioMixer(uint32_t p_sampleRate) :
+            m_sampleRate(p_sampleRate) {
+        for (std::atomic<uint16_t> &generation : m_finishedGeneration) {
+            generation.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    AudioMixer::~AudioMixer() = default;
+
+    AudioSoundId AudioMixer::createSound(std::span<const float> p_samples, uint32_t p_channels, uint32_t p_sampleRate) {
+        if ((p_channels != 1 && p_channels != 2) || p_sampleRate == 0 || p_samples.empty() || p_samples.size() % p_channels != 0) {
+            ENGINE_CLOG_ERROR(Audio, "Audio: rejecting a sound of {} samples, {} channels at {} Hz", p_samples.size(), p_channels, p_sampleRate)
+            return 0;
+        }
+
+        AudioSoundId id;
+        if (!m_freeSounds.empty()) {
+            id = m_freeSounds.back();
+            m_freeSounds.pop_back();
+        } else if (m_sounds.size() < AUDIO_MAX_SOUNDS) {
+            m_sounds.emplace_back();
+            id = static_cast<AudioSoundId>(m_sounds.size());
+        } else {
+            ENGINE_CLOG_ERROR(Audio, "Audio: all {} sound slots are in use", AUDIO_MAX_SOUNDS)
+            return 0;
+        }
+
+        auto sound = std::make_unique<Sound>();
+        sound->samples.assign(p_samples.begin(), p_samples.end());
+        sound->channels = p_channels;
+        sound->frames = static_cast<uint32_t>(p_samples.size() / p_channels);
+        sound->sampleRate = p_sampleRate;
+        m_sounds[id - 1] = std::move(sound);
+        return id;
+    }
+
+    void AudioMixer::releaseSound(AudioSoundId p_sound) {
+        if (p_sound == 0 || p_sound > m_sounds.size() || !m_sounds[p_sound - 1]) {
+            return;
+        }
+
+        Command command;
+        command.type = CommandType::ReleaseSound;
+        command.sound = m_sounds[p_sound - 1].get();
+        queue(command);
+
+        m_pendingReleases.push_back({ m_commandsQueued, std::move(m_sounds[p_sound - 1]) });
+        m_freeSounds.push_back(p_sound);
+    }
+
+    AudioVoiceId AudioMixer::play(AudioSoundId p_sound, const AudioPlayParams &p_params) {
+        if (p_sound == 0 || p_sound > m_sounds.size() || !m_sounds[p_sound - 1]) {
+            return 0;
+        }
+
+        /** A free slot, else the lowest priority and then oldest voice that the new one outranks. */
+        uint32_t chosen = AUDIO_MAX_VOICES;
+        uint32_t victim = AUDIO_MAX_VOICES;
+        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; i++) {
+            Slot &current = m_slots[i];
+            if (current.busy && m_finishedGeneration[i].load(std::memory_order_acquire) == current.generation) {
+                current.busy = false;
+            }
+            if (!current.busy) {
+                chosen = i;
+                break;
+            }
+            if (current.priority <= p_params.priority &&
+                    (victim == AUDIO_MAX_VOICES || current.priority < m_slots[victim].priority ||
+                            (current.priority == m_slots[victim].priority && current.serial < m_slots[victim].serial))) {
+                victim = i;
+            }
+        }
+
+        if (chosen == AUDIO_MAX_VOICES) {
+            if (victim == AUDIO_MAX_VOICES) {
+                m_playsRejected++;
+                return 0;
+            }
+            chosen = victim;
+            m_voicesStolen++;
+        }
+
+        /** Play on a busy slot replaces its voice on the callback side, which fades the old one out; its generation never finishes. */
+        Slot &target = m_slots[chosen];
+        target.generation = target.generation == UINT16_MAX ? 1 : target.generation + 1;
+        target.busy = true;
+        target.priority = p_params.priority;
+        target.serial = m_playSerial++;
+
+        Command command;
+        command.type = CommandType::Play;
+        command.voice = static_cast<uint16_t>(chosen);
+        command.generation = target.generation;
+        command.sound = m_sounds[p_sound - 1].get();
+        command.params = p_params;
+        queue(command);
+
+        return chosen | static_cast<AudioVoiceId>(target.generation) << 16;
+    }
+
+    void AudioMixer::stop(AudioVoiceId p_voice) {
+        queueVoiceCommand(p_voice, CommandType::Stop, 0.0f);
+    }
+
+    void AudioMixer::setGain(AudioVoiceId p_voice, float p_gain) {
+        queueVoiceCommand(p_voice, CommandType::SetGain, p_gain);
+    }
+
+    void AudioMixer::setPitch(AudioVoiceId p_voice, float p_pitch) {
+        queueVoiceCommand(p_voice, CommandType::SetPitch, p_pitch);
+    }
+
+    void AudioMixer::setPosition(AudioVoiceId p_voice, float p_x, float p_y, float p_z) {
+        queueVoiceCommand(p_voice, CommandType::SetPosition, p_x, p_y, p_z);
+    }
+
+    void AudioMixer::setListener(float p_x, float p_y, float p_z, float p_rightX, float p_rightY, float p_rightZ) {
+        Command command;
+        command.type = CommandType::SetListener;
+        const float values[6] = { p_x, p_y, p_z, p_rightX, p_rightY, p_rightZ };
+        std::memcpy(command.values, values, sizeof(values));
+        queue(command);
+    }
+
+    void AudioMixer::setMasterGain(float p_gain) {
+        Command command;
+        command.type = CommandType::SetMasterGain;
+        command.values[0] = p_gain;
+        queue(command);
+    }
+
+    bool AudioMixer::isPlaying(AudioVoiceId p_voice) const {
+        const uint32_t index = p_voice & 0xffff;
+        const uint16_t generation = static_cast<uint16_t>(p_voice >> 16);
+        return index < AUDIO_MAX_VOICES && generation != 0 && m_slots[index].busy && m_slots[index].generation == generation &&
+                m_finishedGeneration[index].load(std::memory_order_acquire) != generation;
+    }
+
+    void AudioMixer::update() {
+        while (!m_overflow.empty() && m_commands.push(m_overflow.front())) {
+            m_overflow.pop_front();
+        }
+
+        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; i++) {
+            if (m_slots[i].busy && m_finishedGeneration[i].load(std::memory_order_acquire) == m_slots[i].generation) {
+                m_slots[i].busy = false;
+            }
+        }
+
+        const uint64_t consumed = m_commandsConsumed.load(std::memory_order_acquire);
+        std::erase_if(m_pendingReleases, [&](const PendingRelease &p_release) { return p_release.command <= consumed; });
+    }
+
+    void AudioMixer::render(float *p_output, uint32_t p_frames) {
+        const auto start = std::chrono::steady_clock::now();
+        consumeCommands();
+
+        const uint32_t total = p_frames;
+        while (p_frames > 0) {
+            const uint32_t count = std::min(p_frames, AUDIO_BLOCK_FRAMES);
+            mixBlock(count);
+            interleave(p_output, m_mixLeft, m_mixRight, count);
+            p_output += count * AUDIO_OUTPUT_CHANNELS;
+            p_frames -= count;
+        }
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        m_renderNanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        m_framesRendered.fetch_add(total, std::memory_order_relaxed);
+    }
+
+    void AudioMixer::renderOffline(uint32_t p_frames, std::vector<float> &p_output) {
+        size_t offset = p_output.size();
+        p_output.resize(offset + static_cast<size_t>(p_frames) * AUDIO_OUTPUT_CHANNELS);
+        while (p_frames > 0) {
+            const uint32_t count = std::min(p_frames, AUDIO_BLOCK_FRAMES);
+            render(p_output.data() + offset, count);
+            update();
+            offset += count * AUDIO_OUTPUT_CHANNELS;
+            p_frames -= count;
+        }
+    }
+
+    bool AudioMixer::writeWav(const std::string &p_path, std::span<const float> p_samples, uint32_t p_channels, uint32_t p_sampleRate) {
+        std::ofstream file(p_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            ENGINE_CLOG_ERROR(Audio, "Audio: cannot write {}", p_path)
+            return false;
+        }
+
+        /** WAVE_FORMAT_IEEE_FLOAT wants the extended fmt chunk and a fact chunk. */
+        const uint32_t dataBytes = static_cast<uint32_t>(p_samples.size() * sizeof(float));
+        file.write("RIFF", 4);
+        writeU32(file, 4 + (8 + 18) + (8 + 4) + (8 + dataBytes));
+        file.write("WAVE", 4);
+
+        file.write("fmt ", 4);
+        writeU32(file, 18);
+        writeU16(file, 3);
+        writeU16(file, static_cast<uint16_t>(p_channels));
+        writeU32(file, p_sampleRate);
+        writeU32(file, p_sampleRate * p_channels * sizeof(float));
+        writeU16(file, static_cast<uint16_t>(p_channels * sizeof(float)));
+        writeU16(file, 32);
+        writeU16(file, 0);
+
+        file.write("fact", 4);
+        writeU32(file, 4);
+        writeU32(file, static_cast<uint32_t>(p_samples.size() / p_channels));
+
+        file.write("data", 4);
+        writeU32(file, dataBytes);
+        for (float sample : p_samples) {
+            uint32_t bits;
+            std::memcpy(&bits, &sample, sizeof(bits));
+            writeU32(file, bits);
+        }
+
+        if (!file) {
+            ENGINE_CLOG_ERROR(Audio, "Audio: failed writing {}", p_path)
+            return false;
+        }
+        return true;
+    }
+
+    AudioMixerStatistics AudioMixer::statistics() const {
+        AudioMixerStatistics statistics;
+        statistics.activeVoices = m_activeVoices.load(std::memory_order_relaxed);
+        statistics.virtualVoices = m_virtualVoices.load(std::memory_order_relaxed);
+        statistics.framesRendered = m_framesRendered.load(std::memory_order_relaxed);
+        statistics.renderSeconds = static_cast<double>(m_renderNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+        statistics.voicesStolen = m_voicesStolen;
+        statistics.playsRejected = m_playsRejected;
+        return statistics;
+    }
+
+    void AudioMixer::queue(const Command &p_command) {
+        /** Behind queued overflow the ring is not tried, commands must stay in order. */
+        if (!m_overflow.empty() || !m_commands.push(p_command)) {
+            m_overflow.push_back(p_command);
+        }
+        m_commandsQueued++;
+    }
+
+    AudioMixer::Slot *AudioMixer::slot(AudioVoiceId p_voice) {
+        const uint32_t index = p_voice & 0xffff;
+        const uint16_t generation = static_cast<uint16_t>(p_voice >> 16);
+        if (index >= AUDIO_MAX_VOICES || generation == 0 || !m_slots[index].busy || m_slots[index].generation != generation) {
+            return nullptr;
+        }
+        return &m_slots[index];
+    }
+
+    void AudioMixer::queueVoiceCommand(AudioVoiceId p_voice, CommandType p_type, float p_a, float p_b, float p_c) {
+        if (!slot(p_voice)) {
+            return;
+        }
+
+        Command command;
+        command.type = p_type;
+        command.voice = static_cast<uint16_t>(p_voice & 0xffff);
+        command.generation = static_cast<uint16_t>(p_voice >> 16);
+        command.values[0] = p_a;
+        command.values[1] = p_b;
+        command.values[2] = p_c;
+        queue(command);
+    }
+
+    void AudioMixer::consumeCommands() {
+        uint64_t consumed = 0;
+        Command command;
+        while (m_commands.pop(command)) {
+            consumed++;
+            Voice &voice = m_voices[command.voice];
+            const bool current = voice.active && voice.generation == command.generation;
+
+            switch (command.type) {
+                case CommandType::Play: {
+                    const AudioPlayParams &params = command.params;
+                    /** A stolen voice that was heard fades out over the next block instead of cutting off. */
+                    if (voice.active && !voice.fresh && (voice.leftGain != 0.0f || voice.rightGain != 0.0f)) {
+                        m_stolen[command.voice] = voice;
+                    }
+                    voice = Voice();
+                    voice.sound = command.sound;
+                    voice.generation = command.generation;
+                    voice.active = true;
+                    voice.loop = params.loop;
+                    voice.positional = params.positional;
+                    voice.gain = params.gain;
+                    voice.pitch = params.pitch;
+                    voice.x = params.x;
+                    voice.y = params.y;
+                    voice.z = params.z;
+                    voice.minDistance = std::max(params.minDistance, 1e-3f);
+                    voice.maxDistance = params.maxDistance;
+                    voice.step = stepFor(*voice.sound, voice.pitch);
+                    break;
+                }
+                case CommandType::Stop:
+                    if (current) {
+                        finish(command.voice);
+                    }
+                    break;
+                case CommandType::SetGain:
+                    if (current) {
+                        voice.gain = command.values[0];
+                    }
+                    break;
+                case CommandType::SetPitch:
+                    if (current) {
+                        voice.pitch = command.values[0];
+                        voice.step = stepFor(*voice.sound, voice.pitch);
+                    }
+                    break;
+                case CommandType::SetPosition:
+                    if (current) {
+                        voice.x = command.values[0];
+                        voice.y = command.values[1];
+                        voice.z = command.values[2];
+                    }
+                    break;
+                case CommandType::SetListener:
+                    std::memcpy(m_listener, command.values, sizeof(m_listener));
+                    std::memcpy(m_listenerRight, command.values + 3, sizeof(m_listenerRight));
+                    break;
+                case CommandType::SetMasterGain:
+                    m_masterGain = command.values[0];
+                    break;
+                case CommandType::ReleaseSound:
+                    for (uint32_t i = 0; i < AUDIO_MAX_VOICES; i++) {
+                        if (m_voices[i].active && m_voices[i].sound == command.sound) {
+                            finish(i);
+                        }
+                        if (m_stolen[i].sound == command.sound) {
+                            m_stolen[i].active = false;
+                        }
+                    }
+                    break;
+            }
+        }
+
+        if (consumed) {
+            m_commandsConsumed.fetch_add(consumed, std::memory_order_release);
+        }
+    }
+
+    void AudioMixer::mixBlock(uint32_t p_frames) {
+        std::memset(m_mixLeft, 0, sizeof(float) * p_frames);
+        std::memset(m_mixRight, 0, sizeof(float) * p_frames);
+
+        uint32_t active = 0;
+        uint32_t virtualVoices = 0;
+        for (uint32_t i = 0; i < AUDIO_MAX_VOICES; i++) {
+            Voice &stolen = m_stolen[i];
+            if (stolen.active) {
+                const uint32_t produced = resample(stolen, p_frames);
+                const bool split = stolen.sound->channels == 2 && !stolen.positional;
+                mixRamp(m_mixLeft, m_source[0], produced, stolen.leftGain, 0.0f, p_frames);
+                mixRamp(m_mixRight, m_source[split ? 1 : 0], produced, stolen.rightGain, 0.0f, p_frames);
+                stolen.active = false;
+            }
+
+            Voice &voice = m_voices[i];
+            if (!voice.active) {
+                continue;
+            }
+            active++;
+
+            float left;
+            float right;
+            targetGains(voice, left, right);
+            if (voice.fresh) {
+                voice.leftGain = left;
+                voice.rightGain = right;
+                voice.fresh = false;
+            }
+
+            /** Inaudible for the whole block: keep time moving, skip the work. */
+            if (left == 0.0f && right == 0.0f && voice.leftGain == 0.0f && voice.rightGain == 0.0f) {
+                virtualVoices++;
+                const uint64_t end = static_cast<uint64_t>(voice.sound->frames) << 32;
+                voice.position += voice.step * p_frames;
+                if (voice.position >= end) {
+                    if (voice.loop) {
+                        voice.position %= end;
+                    } else {
+                        finish(i);
+                    }
+                }
+                continue;
+            }
+
+            const uint32_t produced = resample(voice, p_frames);
+            const bool split = voice.sound->channels == 2 && !voice.positional;
+            mixRamp(m_mixLeft, m_source[0], produced, voice.leftGain, left, p_frames);
+            mixRamp(m_mixRight, m_source[split ? 1 : 0], produced, voice.rightGain, right, p_frames);
+            voice.leftGain = left;
+            voice.rightGain = right;
+
+            if (produced < p_frames) {
+                finish(i);
+            }
+        }
+
+        m_activeVoices.store(active, std::memory_order_relaxed);
+        m_virtualVoices.store(virtualVoices, std::memory_order_relaxed);
+    }
+
+    uint64_t AudioMixer::stepFor(const Sound &p_sound, float p_pitch) const {
+        const double ratio = static_cast<double>(p_sound.sampleRate) / m_sampleRate * std::clamp(p_pitch, MIN_PITCH, MAX_PITCH);
+        return std::max<uint64_t>(1, static_cast<uint64_t>(ratio * static_cast<double>(FIXED_ONE) + 0.5));
+    }
+
+    void AudioMixer::targetGains(const Voice &p_voice, float &p_left, float &p_right) const {
+        const float gain = p_voice.gain * m_masterGain;
+        if (!p_voice.positional) {
+            p_left = gain;
+            p_right = gain;
+            return;
+        }
+
+        const float dx = p_voice.x - m_listener[0];
+        const float dy = p_voice.y - m_listener[1];
+        const float dz = p_voice.z - m_listener[2];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (distance >= p_voice.maxDistance) {
+            p_left = 0.0f;
+            p_right = 0.0f;
+            return;
+        }
+
+        /** Equal-power pan from the side the sound is on, centred when it is on the listener. */
+        const float attenuation = distance <= p_voice.minDistance ? 1.0f : p_voice.minDistance / distance;
+        float pan = 0.0f;
+        if (distance > 1e-4f) {
+            pan = std::clamp((dx * m_listenerRight[0] + dy * m_listenerRight[1] + dz * m_listenerRight[2]) / distance, -1.0f, 1.0f);
+        }
+        const float angle = (pan + 1.0f) * 0.785398163f;
+        p_left = std::cos(angle) * attenuation * gain;
+        p_right = std::sin(angle) * attenuation * gain;
+    }
+
+    uint32_t AudioMixer::resample(Voice &p_voice, uint32_t p_frames) {
+        const Sound &sound = *p_voice.sound;
+        const float *data = sound.samples.data();
+        const uint64_t step = p_voice.step;
+        const uint64_t end = static_cast<uint64_t>(sound.frames) << 32;
+        /** Last position whose next frame is still inside the sound. */
+        const uint64_t lastInterior = sound.frames > 1 ? (static_cast<uint64_t>(sound.frames - 1) << 32) - 1 : 0;
+        const bool stereo = sound.channels == 2;
+        const bool split = stereo && !p_voice.positional;
+        float *first = m_source[0];
+        float *second = m_source[1];
+
+        uint64_t position = p_voice.position;
+        uint32_t produced = 0;
+        while (produced < p_frames) {
+            if (position >= end) {
+                if (!p_voice.loop) {
+                    break;
+                }
+                position %= end;
+            }
+
+            if (sound.frames > 1 && position <= lastInterior) {
+                const uint32_t count = static_cast<uint32_t>(std::min<uint64_t>(p_frames - produced, (lastInterior - position) / step + 1));
+
+                if (!stereo && step == FIXED_ONE && static_cast<uint32_t>(position) == 0) {
+                    std::memcpy(first + produced, data + (position >> 32), sizeof(float) * count);
+                    position += step * count;
+                } else if (!stereo) {
+                    for (uint32_t i = produced; i < produced + count; i++) {
+                        const float *frame = data + (position >> 32);
+                        const float fraction = static_cast<float>(static_cast<uint32_t>(position)) * FIXED_FRACTION;
+                        first[i] = frame[0] + (frame[1] - frame[0]) * fraction;
+                        position += step;
+                    }
+                } else {
+                    for (uint32_t i = produced; i < produced + count; i++) {
+                        const float *frame = data + (position >> 32) * 2;
+                        const float fraction = static_cast<float>(static_cast<uint32_t>(position)) * FIXED_FRACTION;
+                        const float left = frame[0] + (frame[2] - frame[0]) * fraction;
+                        const float right = frame[1] + (frame[3] - frame[1]) * fraction;
+                        if (split) {
+                            first[i] = left;
+                            second[i] = right;
+                        } else {
+                            first[i] = (left + right) * 0.5f;
+                        }
+                        position += step;
+                    }
+                }
+                produced += count;
+                continue;
+            }
+
+            /** The last frame interpolates towards the start when looping, towards silence otherwise. */
+            const uint64_t index = position >> 32;
+            const float fraction = static_cast<float>(static_cast<uint32_t>(position)) * FIXED_FRACTION;
+            float values[2];
+            for (uint32_t channel = 0; channel < sound.channels; channel++) {
+                const float current = data[index * sound.channels + channel];
+                const float next = p_voice.loop ? data[channel] : 0.0f;
+                values[channel] = current + (next - current) * fraction;
+            }
+            if (split) {
+                first[produced] = values[0];
+                second[produced] = values[1];
+            } else {
+                first[produced] = stereo ? (values[0] + values[1]) * 0.5f : values[0];
+            }
+            position += step;
+            produced++;
+        }
+
+        p_voice.position = position;
+        return produced;
+    }
+
+    void AudioMixer::finish(uint32_t p_index) {
+        m_voices[p_index].active = false;
+        m_finishedGeneration[p_index].store(m_voices[p_index].generation, std::memory_order_release);
+    }
+}
@@ -1 +1,227 @@
+#ifndef __ENGINE_AUDIO_HPP__
+#define __ENGINE_AUDIO_HPP__
 
+#include "../Templates/SpscRing.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Engine {
+    inline constexpr uint32_t AUDIO_MAX_VOICES = 512;
+    inline constexpr uint32_t AUDIO_MAX_SOUNDS = 4096;
+    /** Frames mixed per pass; gains ramp across a block, so this bounds the reaction time too. */
+    inline constexpr uint32_t AUDIO_BLOCK_FRAMES = 256;
+    inline constexpr uint32_t AUDIO_OUTPUT_CHANNELS = 2;
+
+    /** Handle of a loaded sound, 0 is none. */
+    using AudioSoundId = uint32_t;
+    /** Voice slot in the low 16 bits and its generation above, so handles to a reused slot are stale. 0 is none. */
+    using AudioVoiceId = uint32_t;
+
+    struct AudioPlayParams {
+        float gain = 1.0f;
+        /** Playback rate multiplier, resampled per voice. */
+        float pitch = 1.0f;
+        bool loop = false;
+        /** Positional voices are attenuated and panned from the listener, others play as authored. */
+        bool positional = false;
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        /** Full volume up to minDistance, inverse distance beyond it, silent past maxDistance. */
+        float minDistance = 1.0f;
+        float maxDistance = 48.0f;
+        /** With every voice busy the lowest priority, then oldest, voice not above this one is replaced. */
+        int32_t priority = 0;
+    };
+
+    struct AudioMixerStatistics {
+        uint32_t activeVoices = 0;
+        /** Active voices out of range or at zero gain, advanced without being mixed. */
+        uint32_t virtualVoices = 0;
+        uint64_t framesRendered = 0;
+        /** Wall time spent in render(). */
+        double renderSeconds = 0.0;
+        uint64_t voicesStolen = 0;
+        uint64_t playsRejected = 0;
+    };
+
+    /**
+     * Software mixer producing interleaved stereo float frames.
+     *
+     * render() is the audio callback: it takes no lock and allocates nothing. Everything it
+     * needs arrives as commands through a single-producer/single-consumer ring, and the only
+     * state flowing back are atomics (which voice generation finished, how many commands were
+     * consumed), so all the other methods belong to one thread, typically the game thread.
+     * Commands that find the ring full wait in an overflow queue, drained by update().
+     *
+     * Voices come from a fixed pool. Each one resamples its sound with linear interpolation
+     * from a 32.32 fixed-point position, then is mixed into the block with SSE, its left and
+     * right gains ramping from the previous block's so gain, pitch and position changes do not
+     * click. A stolen voice ramps down to silence over one block next to its replacement.
+     * Positional voices out of range keep their position advancing without being mixed.
+     * Sounds are released through the queue and freed by update() once the callback has let
+     * go of them.
+     *
+     * Without a device, renderOffline() drives the callback directly and writeWav() stores
+     * the result, which is how the mixing cost per voice is measured.
+     */
+    class AudioMixer {
+    public:
+        explicit AudioMixer(uint32_t p_sampleRate = 48000);
+        ~AudioMixer();
+
+        AudioMixer(const AudioMixer &) = delete;
+        AudioMixer &operator=(const AudioMixer &) = delete;
+
+        uint32_t sampleRate() const { return m_sampleRate; }
+
+        /** Copies interleaved float PCM of 1 or 2 channels at any rate. */
+        AudioSoundId createSound(std::span<const float> p_samples, uint32_t p_channels, uint32_t p_sampleRate);
+
+        /** Stops the voices playing it; the memory goes once the callback acknowledged. */
+        void releaseSound(AudioSoundId p_sound);
+
+        /** 0 when the sound is unknown or every voice is busy with a higher priority. */
+        AudioVoiceId play(AudioSoundId p_sound, const AudioPlayParams &p_params = {});
+
+        void stop(AudioVoiceId p_voice);
+        void setGain(AudioVoiceId p_voice, float p_gain);
+        void setPitch(AudioVoiceId p_voice, float p_pitch);
+        void setPosition(AudioVoiceId p_voice, float p_x, float p_y, float p_z);
+
+        /** `p_right*` is the listener's unit right vector, it decides the panning. */
+        void setListener(float p_x, float p_y, float p_z, float p_rightX, float p_rightY, float p_rightZ);
+        void setMasterGain(float p_gain);
+
+        bool isPlaying(AudioVoiceId p_voice) const;
+
+        /** Frees finished voices and released sounds and retries queued commands. Once per frame. */
+        void update();
+
+        /** Audio callback: writes `p_frames` interleaved stereo frames. */
+        void render(float *p_output, uint32_t p_frames);
+
+        /** Renders `p_frames` frames on the calling thread and appends them to `p_output`. */
+        void renderOffline(uint32_t p_frames, std::vector<float> &p_output);
+
+        /** 32-bit float WAV. */
+        static bool writeWav(const std::string &p_path, std::span<const float> p_samples, uint32_t p_channels, uint32_t p_sampleRate);
+
+        AudioMixerStatistics statistics() const;
+
+    private:
+        struct Sound {
+            std::vector<float> samples;
+            uint32_t channels = 1;
+            uint32_t frames = 0;
+            uint32_t sampleRate = 0;
+        };
+
+        enum class CommandType : uint8_t {
+            Play,
+            Stop,
+            SetGain,
+            SetPitch,
+            SetPosition,
+            SetListener,
+            SetMasterGain,
+            ReleaseSound,
+        };
+
+        struct Command {
+            CommandType type = CommandType::Stop;
+            uint16_t voice = 0;
+            uint16_t generation = 0;
+            const Sound *sound = nullptr;
+            float values[6] = {};
+            AudioPlayParams params;
+        };
+
+        /** Callback side of a voice. */
+        struct Voice {
+            const Sound *sound = nullptr;
+            uint16_t generation = 0;
+            bool active = false;
+            bool loop = false;
+            bool positional = false;
+            /** The first block starts at its gains instead of ramping up from silence. */
+            bool fresh = true;
+            uint64_t position = 0;
+            uint64_t step = 0;
+            float gain = 1.0f;
+            float pitch = 1.0f;
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+            float minDistance = 1.0f;
+            float maxDistance = 48.0f;
+            float leftGain = 0.0f;
+            float rightGain = 0.0f;
+        };
+
+        /** Game thread view of a voice slot. */
+        struct Slot {
+            uint16_t generation = 0;
+            bool busy = false;
+            int32_t priority = 0;
+            uint64_t serial = 0;
+        };
+
+        struct PendingRelease {
+            uint64_t command;
+            std::unique_ptr<Sound> sound;
+        };
+
+        uint32_t m_sampleRate;
+
+        /** Game thread. */
+        std::vector<std::unique_ptr<Sound>> m_sounds;
+        std::vector<AudioSoundId> m_freeSounds;
+        std::vector<PendingRelease> m_pendingReleases;
+        Slot m_slots[AUDIO_MAX_VOICES];
+        uint64_t m_playSerial = 0;
+        uint64_t m_commandsQueued = 0;
+        std::deque<Command> m_overflow;
+        uint64_t m_voicesStolen = 0;
+        uint64_t m_playsRejected = 0;
+
+        /** Shared. */
+        SpscRing<Command, 4096> m_commands;
+        std::atomic<uint64_t> m_commandsConsumed{0};
+        std::atomic<uint16_t> m_finishedGeneration[AUDIO_MAX_VOICES];
+        std::atomic<uint32_t> m_activeVoices{0};
+        std::atomic<uint32_t> m_virtualVoices{0};
+        std::atomic<uint64_t> m_framesRendered{0};
+        std::atomic<uint64_t> m_renderNanoseconds{0};
+
+        /** Callback thread. */
+        Voice m_voices[AUDIO_MAX_VOICES];
+        /** Voice a play replaced in the slot, mixed for one more block ramping down to silence. */
+        Voice m_stolen[AUDIO_MAX_VOICES];
+        float m_listener[3] = {};
+        float m_listenerRight[3] = { 1.0f, 0.0f, 0.0f };
+        float m_masterGain = 1.0f;
+        alignas(16) float m_mixLeft[AUDIO_BLOCK_FRAMES];
+        alignas(16) float m_mixRight[AUDIO_BLOCK_FRAMES];
+        alignas(16) float m_source[2][AUDIO_BLOCK_FRAMES];
+
+        void queue(const Command &p_command);
+        Slot *slot(AudioVoiceId p_voice);
+        void queueVoiceCommand(AudioVoiceId p_voice, CommandType p_type, float p_a, float p_b = 0.0f, float p_c = 0.0f);
+
+        void consumeCommands();
+        void mixBlock(uint32_t p_frames);
+        uint64_t stepFor(const Sound &p_sound, float p_pitch) const;
+        void targetGains(const Voice &p_voice, float &p_left, float &p_right) const;
+        uint32_t resample(Voice &p_voice, uint32_t p_frames);
+        void finish(uint32_t p_index);
+    };
+}
+
+#endif
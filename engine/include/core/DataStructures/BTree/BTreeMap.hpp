@@ -0,0 +1,506 @@
+#ifndef __ENGINE_BTREE_MAP_HPP__
+#define __ENGINE_BTREE_MAP_HPP__
+
+#include "../../SystemOS/Memory.hpp"
+
+#include <algorithm>
+#include <utility>
+
+/**
+ * Ordered map stored as a B+ tree.
+ *
+ * Nodes hold around 256 bytes of keys (and values or child pointers) in sorted arrays, so a
+ * lookup reads a handful of cache lines per level instead of one node per comparison as in a
+ * red-black tree, and the tree is a few levels deep even for millions of keys. All elements
+ * live in the leaves, which are linked in key order, so iteration and range scans walk arrays
+ * from leaf to leaf. Leaves and inner nodes stay at least half full: erasing borrows from a
+ * sibling or merges with it.
+ *
+ * Keys and values must be default-constructible and movable. Iterators and pointers to
+ * elements are invalidated by any insertion or removal.
+ */
+template <typename K, typename V, typename C = Comparator<K>>
+class BTreeMap {
+    static constexpr uint32_t NODE_BYTES = 256;
+
+public:
+    static constexpr uint32_t LEAF_CAPACITY = CLAMP(static_cast<uint32_t>(NODE_BYTES / (sizeof(K) + sizeof(V))), 4u, 64u);
+    static constexpr uint32_t INNER_CAPACITY = CLAMP(static_cast<uint32_t>(NODE_BYTES / (sizeof(K) + sizeof(void *))), 4u, 64u);
+
+private:
+    static constexpr uint32_t MIN_LEAF = LEAF_CAPACITY / 2;
+    static constexpr uint32_t MIN_INNER = INNER_CAPACITY / 2;
+    static constexpr uint32_t MAX_DEPTH = 32;
+
+    struct Node {
+        bool leaf = true;
+        uint32_t count = 0;
+    };
+
+    struct Leaf : Node {
+        K keys[LEAF_CAPACITY];
+        V values[LEAF_CAPACITY];
+        Leaf *prev = nullptr;
+        Leaf *next = nullptr;
+    };
+
+    /** `children[i]` holds the keys below `keys[i]`, `children[count]` the rest. */
+    struct Inner : Node {
+        K keys[INNER_CAPACITY];
+        Node *children[INNER_CAPACITY + 1] = {};
+
+        Inner() { this->leaf = false; }
+    };
+
+    /** Inner nodes from the root down to a leaf, with the child taken at each of them. */
+    struct Path {
+        Inner *nodes[MAX_DEPTH];
+        uint32_t indices[MAX_DEPTH];
+        uint32_t depth = 0;
+    };
+
+    template <bool p_const>
+    class IteratorBase {
+    public:
+        using Key = const K;
+        using Value = std::conditional_t<p_const, const V, V>;
+
+        _FORCE_INLINE_ Key &key() const { return m_leaf->keys[m_index]; }
+        _FORCE_INLINE_ Value &value() const { return m_leaf->values[m_index]; }
+
+        _FORCE_INLINE_ IteratorBase &operator++() {
+            if (++m_index == m_leaf->count) {
+                m_leaf = m_leaf->next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        _FORCE_INLINE_ bool operator==(const IteratorBase &p_other) const {
+            return m_leaf == p_other.m_leaf && m_index == p_other.m_index;
+        }
+        _FORCE_INLINE_ bool operator!=(const IteratorBase &p_other) const { return !(*this == p_other); }
+
+        /** Range-for support, `for (auto &element : map)` yields iterators. */
+        _FORCE_INLINE_ const IteratorBase &operator*() const { return *this; }
+
+    private:
+        friend class BTreeMap;
+
+        Leaf *m_leaf = nullptr;
+        uint32_t m_index = 0;
+
+        IteratorBase(Leaf *p_leaf, uint32_t p_index) :
+                m_leaf(p_leaf), m_index(p_index) {}
+
+    public:
+        IteratorBase() = default;
+    };
+
+public:
+    using Iterator = IteratorBase<false>;
+    using ConstIterator = IteratorBase<true>;
+
+    BTreeMap() = default;
+
+    BTreeMap(const BTreeMap &p_from) {
+        for (ConstIterator it = p_from.begin(); it != p_from.end(); ++it) {
+            insert(it.key(), it.value());
+        }
+    }
+
+    BTreeMap(BTreeMap &&p_from) noexcept :
+            m_root(p_from.m_root), m_first(p_from.m_first), m_size(p_from.m_size) {
+        p_from.m_root = nullptr;
+        p_from.m_first = nullptr;
+        p_from.m_size = 0;
+    }
+
+    BTreeMap &operator=(const BTreeMap &p_from) {
+        if (this != &p_from) {
+            BTreeMap copy(p_from);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    BTreeMap &operator=(BTreeMap &&p_from) noexcept {
+        if (this != &p_from) {
+            clear();
+            SWAP(m_root, p_from.m_root);
+            SWAP(m_first, p_from.m_first);
+            SWAP(m_size, p_from.m_size);
+        }
+        return *this;
+    }
+
+    ~BTreeMap() { clear(); }
+
+    _FORCE_INLINE_ uint32_t size() const { return m_size; }
+    _FORCE_INLINE_ bool isEmpty() const { return m_size == 0; }
+
+    _FORCE_INLINE_ Iterator begin() { return Iterator(m_first, 0); }
+    _FORCE_INLINE_ Iterator end() { return Iterator(); }
+    _FORCE_INLINE_ ConstIterator begin() const { return ConstIterator(m_first, 0); }
+    _FORCE_INLINE_ ConstIterator end() const { return ConstIterator(); }
+
+    Iterator find(const K &p_key) {
+        Path path;
+        Leaf *leaf = descend(p_key, path);
+        const uint32_t index = leaf ? lowerBound(leaf, p_key) : 0;
+        return leaf && index < leaf->count && equal(leaf->keys[index], p_key) ? Iterator(leaf, index) : end();
+    }
+
+    ConstIterator find(const K &p_key) const {
+        Iterator it = const_cast<BTreeMap *>(this)->find(p_key);
+        return ConstIterator(it.m_leaf, it.m_index);
+    }
+
+    /** First element whose key is not less than `p_key`. */
+    Iterator lowerBound(const K &p_key) {
+        Path path;
+        Leaf *leaf = descend(p_key, path);
+        if (!leaf) {
+            return end();
+        }
+
+        const uint32_t index = lowerBound(leaf, p_key);
+        return index < leaf->count ? Iterator(leaf, index) : Iterator(leaf->next, 0);
+    }
+
+    V *getPtr(const K &p_key) {
+        Iterator it = find(p_key);
+        return it == end() ? nullptr : &it.value();
+    }
+
+    const V *getPtr(const K &p_key) const { return const_cast<BTreeMap *>(this)->getPtr(p_key); }
+
+    _FORCE_INLINE_ bool has(const K &p_key) const { return getPtr(p_key) != nullptr; }
+
+    /** Inserts or overwrites. */
+    Iterator insert(const K &p_key, const V &p_value) {
+        Iterator it = findOrInsert(p_key);
+        it.value() = p_value;
+        return it;
+    }
+
+    /** Default-constructs the value of a missing key. */
+    V &operator[](const K &p_key) { return findOrInsert(p_key).value(); }
+
+    bool erase(const K &p_key) {
+        Path path;
+        Leaf *leaf = descend(p_key, path);
+        if (!leaf) {
+            return false;
+        }
+
+        const uint32_t index = lowerBound(leaf, p_key);
+        if (index == leaf->count || !equal(leaf->keys[index], p_key)) {
+            return false;
+        }
+
+        std::move(leaf->keys + index + 1, leaf->keys + leaf->count, leaf->keys + index);
+        std::move(leaf->values + index + 1, leaf->values + leaf->count, leaf->values + index);
+        leaf->count--;
+        leaf->keys[leaf->count] = K();
+        leaf->values[leaf->count] = V();
+        m_size--;
+
+        if (path.depth == 0) {
+            if (leaf->count == 0) {
+                memoryDelete(leaf);
+                m_root = nullptr;
+                m_first = nullptr;
+            }
+            return true;
+        }
+
+        if (leaf->count < MIN_LEAF) {
+            rebalanceLeaf(leaf, path);
+        }
+        return true;
+    }
+
+    void clear() {
+        if (m_root) {
+            destroy(m_root);
+        }
+        m_root = nullptr;
+        m_first = nullptr;
+        m_size = 0;
+    }
+
+private:
+    Node *m_root = nullptr;
+    /** Leftmost leaf, where iteration starts. */
+    Leaf *m_first = nullptr;
+    uint32_t m_size = 0;
+
+    static _FORCE_INLINE_ bool equal(const K &p_a, const K &p_b) { return !C()(p_a, p_b) && !C()(p_b, p_a); }
+
+    static _FORCE_INLINE_ uint32_t lowerBound(const Leaf *p_leaf, const K &p_key) {
+        return static_cast<uint32_t>(std::lower_bound(p_leaf->keys, p_leaf->keys + p_leaf->count, p_key, C()) - p_leaf->keys);
+    }
+
+    /** Child to follow for `p_key`: keys equal to a separator live on its right. */
+    static _FORCE_INLINE_ uint32_t childIndex(const Inner *p_inner, const K &p_key) {
+        return static_cast<uint32_t>(std::upper_bound(p_inner->keys, p_inner->keys + p_inner->count, p_key, C()) - p_inner->keys);
+    }
+
+    Leaf *descend(const K &p_key, Path &r_path) const {
+        Node *node = m_root;
+        r_path.depth = 0;
+        while (node && !node->leaf) {
+            Inner *inner = static_cast<Inner *>(node);
+            const uint32_t index = childIndex(inner, p_key);
+            CRASH_COND(r_path.depth == MAX_DEPTH);
+            r_path.nodes[r_path.depth] = inner;
+            r_path.indices[r_path.depth] = index;
+            r_path.depth++;
+            node = inner->children[index];
+        }
+        return static_cast<Leaf *>(node);
+    }
+
+    Iterator findOrInsert(const K &p_key) {
+        if (!m_root) {
+            Leaf *leaf = memoryNew(Leaf);
+            m_root = leaf;
+            m_first = leaf;
+        }
+
+        Path path;
+        Leaf *leaf = descend(p_key, path);
+        uint32_t index = lowerBound(leaf, p_key);
+        if (index < leaf->count && equal(leaf->keys[index], p_key)) {
+            return Iterator(leaf, index);
+        }
+
+        m_size++;
+        if (leaf->count < LEAF_CAPACITY) {
+            insertIntoLeaf(leaf, index, p_key);
+            return Iterator(leaf, index);
+        }
+
+        /** Split the full leaf in two halves and insert into the one the key belongs to. */
+        Leaf *right = memoryNew(Leaf);
+        const uint32_t half = LEAF_CAPACITY / 2;
+        std::move(leaf->keys + half, leaf->keys + LEAF_CAPACITY, right->keys);
+        std::move(leaf->values + half, leaf->values + LEAF_CAPACITY, right->values);
+        right->count = LEAF_CAPACITY - half;
+        leaf->count = half;
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        }
+        leaf->next = right;
+
+        Leaf *target = leaf;
+        if (index > half) {
+            target = right;
+            index -= half;
+        }
+        insertIntoLeaf(target, index, p_key);
+
+        insertIntoParent(path, leaf, right->keys[0], right);
+        return Iterator(target, index);
+    }
+
+    static void insertIntoLeaf(Leaf *p_leaf, uint32_t p_index, const K &p_key) {
+        std::move_backward(p_leaf->keys + p_index, p_leaf->keys + p_leaf->count, p_leaf->keys + p_leaf->count + 1);
+        std::move_backward(p_leaf->values + p_index, p_leaf->values + p_leaf->count, p_leaf->values + p_leaf->count + 1);
+        p_leaf->keys[p_index] = p_key;
+        p_leaf->values[p_index] = V();
+        p_leaf->count++;
+    }
+
+    /** Links `p_right`, split off `p_left`, into the parent on `p_path`, splitting upward as needed. */
+    void insertIntoParent(Path &p_path, Node *p_left, K p_separator, Node *p_right) {
+        while (true) {
+            if (p_path.depth == 0) {
+                Inner *root = memoryNew(Inner);
+                root->keys[0] = std::move(p_separator);
+                root->children[0] = p_left;
+                root->children[1] = p_right;
+                root->count = 1;
+                m_root = root;
+                return;
+            }
+
+            p_path.depth--;
+            Inner *parent = p_path.nodes[p_path.depth];
+            const uint32_t index = p_path.indices[p_path.depth];
+
+            if (parent->count < INNER_CAPACITY) {
+                std::move_backward(parent->keys + index, parent->keys + parent->count, parent->keys + parent->count + 1);
+                std::move_backward(parent->children + index + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+                parent->keys[index] = std::move(p_separator);
+                parent->children[index + 1] = p_right;
+                parent->count++;
+                return;
+            }
+
+            /** Full: lay out the INNER_CAPACITY + 1 keys in order and push the middle one up. */
+            K keys[INNER_CAPACITY + 1];
+            Node *children[INNER_CAPACITY + 2];
+            std::move(parent->keys, parent->keys + index, keys);
+            keys[index] = std::move(p_separator);
+            std::move(parent->keys + index, parent->keys + INNER_CAPACITY, keys + index + 1);
+            std::copy(parent->children, parent->children + index + 1, children);
+            children[index + 1] = p_right;
+            std::copy(parent->children + index + 1, parent->children + INNER_CAPACITY + 1, children + index + 2);
+
+            const uint32_t middle = (INNER_CAPACITY + 1) / 2;
+            Inner *sibling = memoryNew(Inner);
+
+            std::move(keys, keys + middle, parent->keys);
+            std::copy(children, children + middle + 1, parent->children);
+            parent->count = middle;
+            std::fill(parent->keys + middle, parent->keys + INNER_CAPACITY, K());
+            std::fill(parent->children + middle + 1, parent->children + INNER_CAPACITY + 1, nullptr);
+
+            std::move(keys + middle + 1, keys + INNER_CAPACITY + 1, sibling->keys);
+            std::copy(children + middle + 1, children + INNER_CAPACITY + 2, sibling->children);
+            sibling->count = INNER_CAPACITY - middle;
+
+            p_left = parent;
+            p_separator = std::move(keys[middle]);
+            p_right = sibling;
+        }
+    }
+
+    void rebalanceLeaf(Leaf *p_leaf, Path &p_path) {
+        Inner *parent = p_path.nodes[p_path.depth - 1];
+        const uint32_t index = p_path.indices[p_path.depth - 1];
+        Leaf *left = index > 0 ? static_cast<Leaf *>(parent->children[index - 1]) : nullptr;
+        Leaf *right = index < parent->count ? static_cast<Leaf *>(parent->children[index + 1]) : nullptr;
+
+        if (left && left->count > MIN_LEAF) {
+            std::move_backward(p_leaf->keys, p_leaf->keys + p_leaf->count, p_leaf->keys + p_leaf->count + 1);
+            std::move_backward(p_leaf->values, p_leaf->values + p_leaf->count, p_leaf->values + p_leaf->count + 1);
+            left->count--;
+            p_leaf->keys[0] = std::move(left->keys[left->count]);
+            p_leaf->values[0] = std::move(left->values[left->count]);
+            p_leaf->count++;
+            parent->keys[index - 1] = p_leaf->keys[0];
+            return;
+        }
+
+        if (right && right->count > MIN_LEAF) {
+            p_leaf->keys[p_leaf->count] = std::move(right->keys[0]);
+            p_leaf->values[p_leaf->count] = std::move(right->values[0]);
+            p_leaf->count++;
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->values + 1, right->values + right->count, right->values);
+            right->count--;
+            parent->keys[index] = right->keys[0];
+            return;
+        }
+
+        /** Neither sibling can spare an element: merge into the left one of the pair. */
+        Leaf *into = left ? left : p_leaf;
+        Leaf *from = left ? p_leaf : right;
+        const uint32_t separator = left ? index - 1 : index;
+
+        std::move(from->keys, from->keys + from->count, into->keys + into->count);
+        std::move(from->values, from->values + from->count, into->values + into->count);
+        into->count += from->count;
+        into->next = from->next;
+        if (from->next) {
+            from->next->prev = into;
+        }
+        memoryDelete(from);
+
+        removeFromInner(parent, separator);
+        p_path.depth--;
+        rebalanceInner(parent, p_path);
+    }
+
+    /** Drops `keys[p_index]` and the child on its right. */
+    static void removeFromInner(Inner *p_inner, uint32_t p_index) {
+        std::move(p_inner->keys + p_index + 1, p_inner->keys + p_inner->count, p_inner->keys + p_index);
+        std::copy(p_inner->children + p_index + 2, p_inner->children + p_inner->count + 1, p_inner->children + p_index + 1);
+        p_inner->count--;
+        p_inner->keys[p_inner->count] = K();
+        p_inner->children[p_inner->count + 1] = nullptr;
+    }
+
+    void rebalanceInner(Inner *p_inner, Path &p_path) {
+        while (true) {
+            if (p_path.depth == 0) {
+                /** The root may be nearly empty, but an inner root needs a key to have two children. */
+                if (p_inner->count == 0) {
+                    m_root = p_inner->children[0];
+                    memoryDelete(p_inner);
+                }
+                return;
+            }
+
+            if (p_inner->count >= MIN_INNER) {
+                return;
+            }
+
+            Inner *parent = p_path.nodes[p_path.depth - 1];
+            const uint32_t index = p_path.indices[p_path.depth - 1];
+            Inner *left = index > 0 ? static_cast<Inner *>(parent->children[index - 1]) : nullptr;
+            Inner *right = index < parent->count ? static_cast<Inner *>(parent->children[index + 1]) : nullptr;
+
+            if (left && left->count > MIN_INNER) {
+                std::move_backward(p_inner->keys, p_inner->keys + p_inner->count, p_inner->keys + p_inner->count + 1);
+                std::copy_backward(p_inner->children, p_inner->children + p_inner->count + 1, p_inner->children + p_inner->count + 2);
+                p_inner->keys[0] = std::move(parent->keys[index - 1]);
+                p_inner->children[0] = left->children[left->count];
+                p_inner->count++;
+
+                parent->keys[index - 1] = std::move(left->keys[left->count - 1]);
+                left->children[left->count] = nullptr;
+                left->count--;
+                return;
+            }
+
+            if (right && right->count > MIN_INNER) {
+                p_inner->keys[p_inner->count] = std::move(parent->keys[index]);
+                p_inner->children[p_inner->count + 1] = right->children[0];
+                p_inner->count++;
+
+                parent->keys[index] = std::move(right->keys[0]);
+                std::move(right->keys + 1, right->keys + right->count, right->keys);
+                std::copy(right->children + 1, right->children + right->count + 1, right->children);
+                right->count--;
+                right->children[right->count + 1] = nullptr;
+                return;
+            }
+
+            Inner *into = left ? left : p_inner;
+            Inner *from = left ? p_inner : right;
+            const uint32_t separator = left ? index - 1 : index;
+
+            into->keys[into->count] = std::move(parent->keys[separator]);
+            std::move(from->keys, from->keys + from->count, into->keys + into->count + 1);
+            std::copy(from->children, from->children + from->count + 1, into->children + into->count + 1);
+            into->count += from->count + 1;
+            memoryDelete(from);
+
+            removeFromInner(parent, separator);
+            p_path.depth--;
+            p_inner = parent;
+        }
+    }
+
+    void destroy(Node *p_node) {
+        if (p_node->leaf) {
+            memoryDelete(static_cast<Leaf *>(p_node));
+            return;
+        }
+
+        Inner *inner = static_cast<Inner *>(p_node);
+        for (uint32_t i = 0; i <= inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        memoryDelete(inner);
+    }
+};
+
+#endif
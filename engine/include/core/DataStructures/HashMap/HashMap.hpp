@@ -0,0 +1,410 @@
+#ifndef __ENGINE_HASH_MAP_HPP__
+#define __ENGINE_HASH_MAP_HPP__
+
+#include "../../SystemOS/Memory.hpp"
+
+#include <bit>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_MAP_SSE2
+#include <emmintrin.h>
+#endif
+
+/** std::hash followed by a 64-bit finalizer, std::hash of integers is the identity on most standard libraries. */
+struct HashMapHasherDefault {
+    template <typename T>
+    static _FORCE_INLINE_ uint64_t hash(const T &p_key) {
+        uint64_t hash = static_cast<uint64_t>(std::hash<T>{}(p_key));
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+};
+
+template <typename T>
+struct HashMapComparatorDefault {
+    static _FORCE_INLINE_ bool compare(const T &p_lhs, const T &p_rhs) { return p_lhs == p_rhs; }
+};
+
+/**
+ * Sixteen control bytes of a HashMap, compared all at once with SSE2 or one by one without it.
+ * A control byte is EMPTY, DELETED or, for a used slot, the low seven bits of its key's hash.
+ */
+struct HashMapGroup {
+    static constexpr uint32_t WIDTH = 16;
+    static constexpr int8_t EMPTY = -128;
+    static constexpr int8_t DELETED = -2;
+
+#ifdef HASH_MAP_SSE2
+    __m128i control;
+
+    explicit HashMapGroup(const int8_t *p_control) :
+            control(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p_control))) {}
+
+    /** Bit i is set when byte i equals `p_h2`. */
+    _FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(p_h2), control)));
+    }
+
+    _FORCE_INLINE_ uint32_t matchEmpty() const { return match(EMPTY); }
+
+    /** Both markers are negative, used slots never are. */
+    _FORCE_INLINE_ uint32_t matchFree() const { return static_cast<uint32_t>(_mm_movemask_epi8(control)); }
+#else
+    int8_t control[WIDTH];
+
+    explicit HashMapGroup(const int8_t *p_control) { memcpy(control, p_control, WIDTH); }
+
+    _FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < WIDTH; i++) {
+            bits |= static_cast<uint32_t>(control[i] == p_h2) << i;
+        }
+        return bits;
+    }
+
+    _FORCE_INLINE_ uint32_t matchEmpty() const { return match(EMPTY); }
+
+    _FORCE_INLINE_ uint32_t matchFree() const {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < WIDTH; i++) {
+            bits |= static_cast<uint32_t>(control[i] < 0) << i;
+        }
+        return bits;
+    }
+#endif
+};
+
+template <typename K, typename V>
+struct KeyValue {
+    /** Changing the key of an element in a map breaks the map. */
+    K key;
+    V value;
+};
+
+/**
+ * Open addressing hash map in the Swiss table layout.
+ *
+ * Elements live inline in one slot array next to an array of control bytes, one per slot,
+ * holding seven bits of the slot's hash. A lookup hashes once, then compares a whole group
+ * of sixteen control bytes against those seven bits in a couple of instructions and only
+ * touches the slots whose byte matched, stopping at the first group with an empty byte.
+ * Erasing leaves a DELETED marker that insertion reuses, and a rehash at the same capacity
+ * drops the markers when they pile up. The table stays at most 7/8 full.
+ *
+ * Pointers to elements are stable until the next insertion that rehashes.
+ */
+template <typename K, typename V, typename Hasher = HashMapHasherDefault, typename Comparator = HashMapComparatorDefault<K>>
+class HashMap {
+    using Slot = KeyValue<K, V>;
+    static_assert(alignof(Slot) <= alignof(max_align_t), "Over-aligned elements need Memory::allocAlignedStatic");
+
+    template <bool p_const>
+    class IteratorBase {
+    public:
+        using Map = std::conditional_t<p_const, const HashMap, HashMap>;
+        using Element = std::conditional_t<p_const, const Slot, Slot>;
+
+        _FORCE_INLINE_ Element &operator*() const { return m_map->m_slots[m_index]; }
+        _FORCE_INLINE_ Element *operator->() const { return &m_map->m_slots[m_index]; }
+
+        _FORCE_INLINE_ IteratorBase &operator++() {
+            m_index = m_map->nextUsed(m_index + 1);
+            return *this;
+        }
+
+        _FORCE_INLINE_ bool operator==(const IteratorBase &p_other) const { return m_index == p_other.m_index; }
+        _FORCE_INLINE_ bool operator!=(const IteratorBase &p_other) const { return m_index != p_other.m_index; }
+
+    private:
+        friend class HashMap;
+
+        Map *m_map = nullptr;
+        uint32_t m_index = 0;
+
+        IteratorBase(Map *p_map, uint32_t p_index) :
+                m_map(p_map), m_index(p_index) {}
+    };
+
+public:
+    using Iterator = IteratorBase<false>;
+    using ConstIterator = IteratorBase<true>;
+
+    static constexpr uint32_t MIN_CAPACITY = HashMapGroup::WIDTH;
+
+    HashMap() = default;
+
+    explicit HashMap(uint32_t p_reserve) { reserve(p_reserve); }
+
+    HashMap(const HashMap &p_from) {
+        reserve(p_from.m_size);
+        for (const Slot &element : p_from) {
+            insert(element.key, element.value);
+        }
+    }
+
+    HashMap(HashMap &&p_from) noexcept :
+            m_slots(p_from.m_slots), m_control(p_from.m_control), m_capacity(p_from.m_capacity), m_size(p_from.m_size),
+            m_deleted(p_from.m_deleted) {
+        p_from.m_slots = nullptr;
+        p_from.m_control = nullptr;
+        p_from.m_capacity = 0;
+        p_from.m_size = 0;
+        p_from.m_deleted = 0;
+    }
+
+    HashMap &operator=(const HashMap &p_from) {
+        if (this != &p_from) {
+            HashMap copy(p_from);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    HashMap &operator=(HashMap &&p_from) noexcept {
+        if (this != &p_from) {
+            reset();
+            SWAP(m_slots, p_from.m_slots);
+            SWAP(m_control, p_from.m_control);
+            SWAP(m_capacity, p_from.m_capacity);
+            SWAP(m_size, p_from.m_size);
+            SWAP(m_deleted, p_from.m_deleted);
+        }
+        return *this;
+    }
+
+    ~HashMap() { reset(); }
+
+    _FORCE_INLINE_ uint32_t size() const { return m_size; }
+    _FORCE_INLINE_ bool isEmpty() const { return m_size == 0; }
+    _FORCE_INLINE_ uint32_t capacity() const { return m_capacity; }
+
+    _FORCE_INLINE_ Iterator begin() { return Iterator(this, nextUsed(0)); }
+    _FORCE_INLINE_ Iterator end() { return Iterator(this, m_capacity); }
+    _FORCE_INLINE_ ConstIterator begin() const { return ConstIterator(this, nextUsed(0)); }
+    _FORCE_INLINE_ ConstIterator end() const { return ConstIterator(this, m_capacity); }
+
+    Iterator find(const K &p_key) {
+        const uint32_t index = lookup(p_key, Hasher::hash(p_key));
+        return Iterator(this, index == NOT_FOUND ? m_capacity : index);
+    }
+
+    ConstIterator find(const K &p_key) const {
+        const uint32_t index = lookup(p_key, Hasher::hash(p_key));
+        return ConstIterator(this, index == NOT_FOUND ? m_capacity : index);
+    }
+
+    V *getPtr(const K &p_key) {
+        const uint32_t index = lookup(p_key, Hasher::hash(p_key));
+        return index == NOT_FOUND ? nullptr : &m_slots[index].value;
+    }
+
+    const V *getPtr(const K &p_key) const { return const_cast<HashMap *>(this)->getPtr(p_key); }
+
+    _FORCE_INLINE_ bool has(const K &p_key) const { return lookup(p_key, Hasher::hash(p_key)) != NOT_FOUND; }
+
+    /** Inserts or overwrites. */
+    Iterator insert(const K &p_key, const V &p_value) {
+        const uint64_t hash = Hasher::hash(p_key);
+        uint32_t index = lookup(p_key, hash);
+        if (index != NOT_FOUND) {
+            m_slots[index].value = p_value;
+            return Iterator(this, index);
+        }
+
+        index = claimSlot(hash);
+        ::new (&m_slots[index]) Slot{ p_key, p_value };
+        return Iterator(this, index);
+    }
+
+    /** Default-constructs the value of a missing key. */
+    V &operator[](const K &p_key) {
+        const uint64_t hash = Hasher::hash(p_key);
+        uint32_t index = lookup(p_key, hash);
+        if (index == NOT_FOUND) {
+            index = claimSlot(hash);
+            ::new (&m_slots[index]) Slot{ p_key, V() };
+        }
+        return m_slots[index].value;
+    }
+
+    bool erase(const K &p_key) {
+        const uint32_t index = lookup(p_key, Hasher::hash(p_key));
+        if (index == NOT_FOUND) {
+            return false;
+        }
+
+        m_slots[index].~Slot();
+        setControl(index, HashMapGroup::DELETED);
+        m_size--;
+        m_deleted++;
+        return true;
+    }
+
+    /** Destroys the elements and keeps the storage. */
+    void clear() {
+        destroyElements();
+        if (m_control) {
+            memset(m_control, static_cast<uint8_t>(HashMapGroup::EMPTY), m_capacity + HashMapGroup::WIDTH);
+        }
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    /** Destroys the elements and frees the storage. */
+    void reset() {
+        destroyElements();
+        if (m_slots) {
+            Memory::freeStatic(m_slots);
+        }
+        m_slots = nullptr;
+        m_control = nullptr;
+        m_capacity = 0;
+        m_size = 0;
+        m_deleted = 0;
+    }
+
+    /** Makes room for `p_size` elements without rehashing. */
+    void reserve(uint32_t p_size) {
+        uint32_t capacity = MAX(m_capacity, MIN_CAPACITY);
+        while (maxLoad(capacity) < p_size) {
+            capacity *= 2;
+        }
+        if (capacity != m_capacity) {
+            rehash(capacity);
+        }
+    }
+
+private:
+    static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    /** `m_capacity` slots followed by `m_capacity + WIDTH` control bytes, the last WIDTH mirroring the first ones. */
+    Slot *m_slots = nullptr;
+    int8_t *m_control = nullptr;
+    uint32_t m_capacity = 0;
+    uint32_t m_size = 0;
+    uint32_t m_deleted = 0;
+
+    static constexpr uint32_t maxLoad(uint32_t p_capacity) { return p_capacity - p_capacity / 8; }
+
+    static _FORCE_INLINE_ int8_t h2(uint64_t p_hash) { return static_cast<int8_t>(p_hash & 0x7F); }
+
+    uint32_t lookup(const K &p_key, uint64_t p_hash) const {
+        if (m_size == 0) {
+            return NOT_FOUND;
+        }
+
+        const uint32_t mask = m_capacity - 1;
+        const int8_t tag = h2(p_hash);
+        uint32_t position = static_cast<uint32_t>(p_hash >> 7) & mask;
+
+        for (uint32_t step = HashMapGroup::WIDTH;; step += HashMapGroup::WIDTH) {
+            const HashMapGroup group(m_control + position);
+            for (uint32_t bits = group.match(tag); bits; bits &= bits - 1) {
+                const uint32_t index = (position + std::countr_zero(bits)) & mask;
+                if (likely(Comparator::compare(m_slots[index].key, p_key))) {
+                    return index;
+                }
+            }
+            if (group.matchEmpty()) {
+                return NOT_FOUND;
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    /** First EMPTY or DELETED slot on the probe sequence of `p_hash`. */
+    uint32_t findFree(uint64_t p_hash) const {
+        const uint32_t mask = m_capacity - 1;
+        uint32_t position = static_cast<uint32_t>(p_hash >> 7) & mask;
+
+        for (uint32_t step = HashMapGroup::WIDTH;; step += HashMapGroup::WIDTH) {
+            const uint32_t bits = HashMapGroup(m_control + position).matchFree();
+            if (bits) {
+                return (position + std::countr_zero(bits)) & mask;
+            }
+            position = (position + step) & mask;
+        }
+    }
+
+    uint32_t claimSlot(uint64_t p_hash) {
+        if (m_capacity == 0 || m_size + m_deleted + 1 > maxLoad(m_capacity)) {
+            /** Mostly markers: rehash in place to drop them, otherwise grow. */
+            const bool grow = m_capacity == 0 || m_size + 1 > maxLoad(m_capacity) / 2;
+            rehash(grow ? MAX(m_capacity * 2, MIN_CAPACITY) : m_capacity);
+        }
+
+        const uint32_t index = findFree(p_hash);
+        if (m_control[index] == HashMapGroup::DELETED) {
+            m_deleted--;
+        }
+        setControl(index, h2(p_hash));
+        m_size++;
+        return index;
+    }
+
+    _FORCE_INLINE_ void setControl(uint32_t p_index, int8_t p_value) {
+        m_control[p_index] = p_value;
+        if (p_index < HashMapGroup::WIDTH) {
+            m_control[m_capacity + p_index] = p_value;
+        }
+    }
+
+    void rehash(uint32_t p_capacity) {
+        Slot *oldSlots = m_slots;
+        int8_t *oldControl = m_control;
+        const uint32_t oldCapacity = m_capacity;
+
+        const size_t slotBytes = static_cast<size_t>(p_capacity) * sizeof(Slot);
+        uint8_t *memory = static_cast<uint8_t *>(Memory::allocStatic(slotBytes + p_capacity + HashMapGroup::WIDTH));
+        CRASH_COND_MSG(!memory, "Out of memory");
+
+        m_slots = reinterpret_cast<Slot *>(memory);
+        m_control = reinterpret_cast<int8_t *>(memory + slotBytes);
+        m_capacity = p_capacity;
+        m_deleted = 0;
+        memset(m_control, static_cast<uint8_t>(HashMapGroup::EMPTY), p_capacity + HashMapGroup::WIDTH);
+
+        for (uint32_t i = 0; i < oldCapacity; i++) {
+            if (oldControl[i] < 0) {
+                continue;
+            }
+
+            const uint64_t hash = Hasher::hash(oldSlots[i].key);
+            const uint32_t index = findFree(hash);
+            setControl(index, h2(hash));
+            ::new (&m_slots[index]) Slot(std::move(oldSlots[i]));
+            oldSlots[i].~Slot();
+        }
+
+        if (oldSlots) {
+            Memory::freeStatic(oldSlots);
+        }
+    }
+
+    void destroyElements() {
+        if constexpr (!std::is_trivially_destructible_v<Slot>) {
+            for (uint32_t i = 0; i < m_capacity; i++) {
+                if (m_control[i] >= 0) {
+                    m_slots[i].~Slot();
+                }
+            }
+        }
+    }
+
+    uint32_t nextUsed(uint32_t p_index) const {
+        while (p_index < m_capacity && m_control[p_index] < 0) {
+            p_index++;
+        }
+        return p_index;
+    }
+};
+
+#endif
@@ -1 +1,357 @@
+#ifndef __ENGINE_LIST_HPP__
+#define __ENGINE_LIST_HPP__
 
+#include "../../SystemOS/Memory.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/** Elements per List chunk, about half a kilobyte of them but never fewer than four. */
+template <typename T>
+inline constexpr uint32_t LIST_DEFAULT_CHUNK_CAPACITY = MAX(static_cast<uint32_t>(512 / sizeof(T)), 4u);
+
+/**
+ * Sequence with cheap insertion and removal anywhere, stored as a doubly linked list of
+ * fixed-size chunks (an unrolled linked list) instead of one node per element.
+ *
+ * Walking the list touches one chunk header per ChunkCapacity elements and the elements of a
+ * chunk are contiguous, so iteration runs at close to array speed. Inserting into a full
+ * chunk splits it in two and a chunk left less than a quarter full absorbs its successor
+ * when they fit together. Elements move inside their chunk on insertion and removal, so
+ * unlike std::list pointers and iterators to other elements of the same chunk are
+ * invalidated; the iterator returned by insert() and erase() stays valid.
+ */
+template <typename T, uint32_t ChunkCapacity = LIST_DEFAULT_CHUNK_CAPACITY<T>>
+class List {
+    static_assert(ChunkCapacity >= 2, "Chunks must hold at least two elements to split");
+    static_assert(alignof(T) <= alignof(max_align_t), "Over-aligned elements need Memory::allocAlignedStatic");
+
+    struct Chunk {
+        Chunk *prev = nullptr;
+        Chunk *next = nullptr;
+        uint32_t count = 0;
+        alignas(T) unsigned char storage[sizeof(T) * ChunkCapacity];
+
+        _FORCE_INLINE_ T *items() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    template <bool p_const>
+    class IteratorBase {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<p_const, const T *, T *>;
+        using reference = std::conditional_t<p_const, const T &, T &>;
+
+        IteratorBase() = default;
+
+        /** A mutable iterator converts to a const one. */
+        template <bool p_otherConst, typename = std::enable_if_t<p_const && !p_otherConst>>
+        IteratorBase(const IteratorBase<p_otherConst> &p_other) :
+                m_chunk(p_other.m_chunk), m_index(p_other.m_index) {}
+
+        _FORCE_INLINE_ reference operator*() const { return m_chunk->items()[m_index]; }
+        _FORCE_INLINE_ pointer operator->() const { return &m_chunk->items()[m_index]; }
+
+        _FORCE_INLINE_ IteratorBase &operator++() {
+            if (++m_index == m_chunk->count) {
+                m_chunk = m_chunk->next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        _FORCE_INLINE_ IteratorBase operator++(int) {
+            IteratorBase previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        _FORCE_INLINE_ bool operator==(const IteratorBase &p_other) const {
+            return m_chunk == p_other.m_chunk && m_index == p_other.m_index;
+        }
+        _FORCE_INLINE_ bool operator!=(const IteratorBase &p_other) const { return !(*this == p_other); }
+
+    private:
+        friend class List;
+        template <bool>
+        friend class IteratorBase;
+
+        Chunk *m_chunk = nullptr;
+        uint32_t m_index = 0;
+
+        IteratorBase(Chunk *p_chunk, uint32_t p_index) :
+                m_chunk(p_chunk), m_index(p_index) {}
+    };
+
+public:
+    using Iterator = IteratorBase<false>;
+    using ConstIterator = IteratorBase<true>;
+
+    List() = default;
+
+    List(std::initializer_list<T> p_init) {
+        for (const T &element : p_init) {
+            pushBack(element);
+        }
+    }
+
+    List(const List &p_from) {
+        for (const T &element : p_from) {
+            pushBack(element);
+        }
+    }
+
+    List(List &&p_from) noexcept :
+            m_first(p_from.m_first), m_last(p_from.m_last), m_spare(p_from.m_spare), m_size(p_from.m_size) {
+        p_from.m_first = nullptr;
+        p_from.m_last = nullptr;
+        p_from.m_spare = nullptr;
+        p_from.m_size = 0;
+    }
+
+    List &operator=(const List &p_from) {
+        if (this != &p_from) {
+            clear();
+            for (const T &element : p_from) {
+                pushBack(element);
+            }
+        }
+        return *this;
+    }
+
+    List &operator=(List &&p_from) noexcept {
+        if (this != &p_from) {
+            reset();
+            SWAP(m_first, p_from.m_first);
+            SWAP(m_last, p_from.m_last);
+            SWAP(m_spare, p_from.m_spare);
+            SWAP(m_size, p_from.m_size);
+        }
+        return *this;
+    }
+
+    ~List() { reset(); }
+
+    _FORCE_INLINE_ uint32_t size() const { return m_size; }
+    _FORCE_INLINE_ bool isEmpty() const { return m_size == 0; }
+
+    _FORCE_INLINE_ Iterator begin() { return Iterator(m_first, 0); }
+    _FORCE_INLINE_ Iterator end() { return Iterator(); }
+    _FORCE_INLINE_ ConstIterator begin() const { return ConstIterator(m_first, 0); }
+    _FORCE_INLINE_ ConstIterator end() const { return ConstIterator(); }
+
+    T &front() {
+        CRASH_COND(m_size == 0);
+        return m_first->items()[0];
+    }
+
+    T &back() {
+        CRASH_COND(m_size == 0);
+        return m_last->items()[m_last->count - 1];
+    }
+
+    const T &front() const { return const_cast<List *>(this)->front(); }
+    const T &back() const { return const_cast<List *>(this)->back(); }
+
+    Iterator pushBack(T p_value) {
+        if (!m_last || m_last->count == ChunkCapacity) {
+            linkAfter(m_last, acquireChunk());
+        }
+        ::new (&m_last->items()[m_last->count]) T(std::move(p_value));
+        m_size++;
+        return Iterator(m_last, m_last->count++);
+    }
+
+    Iterator pushFront(T p_value) {
+        if (!m_first || m_first->count == ChunkCapacity) {
+            linkAfter(nullptr, acquireChunk());
+        }
+        insertAt(m_first, 0, std::move(p_value));
+        return Iterator(m_first, 0);
+    }
+
+    void popBack() {
+        ERR_FAIL_COND(m_size == 0);
+        erase(Iterator(m_last, m_last->count - 1));
+    }
+
+    void popFront() {
+        ERR_FAIL_COND(m_size == 0);
+        erase(Iterator(m_first, 0));
+    }
+
+    /** Inserts before `p_position` and returns an iterator to the new element. */
+    Iterator insert(ConstIterator p_position, T p_value) {
+        Chunk *chunk = p_position.m_chunk;
+        uint32_t index = p_position.m_index;
+        if (!chunk) {
+            return pushBack(std::move(p_value));
+        }
+
+        if (chunk->count == ChunkCapacity) {
+            Chunk *upper = acquireChunk();
+            const uint32_t half = ChunkCapacity / 2;
+            T *items = chunk->items();
+            for (uint32_t i = half; i < ChunkCapacity; i++) {
+                ::new (&upper->items()[i - half]) T(std::move(items[i]));
+                items[i].~T();
+            }
+            upper->count = ChunkCapacity - half;
+            chunk->count = half;
+            linkAfter(chunk, upper);
+
+            if (index > half) {
+                chunk = upper;
+                index -= half;
+            }
+        }
+
+        insertAt(chunk, index, std::move(p_value));
+        return Iterator(chunk, index);
+    }
+
+    /** Removes the element at `p_position` and returns an iterator to the one after it. */
+    Iterator erase(ConstIterator p_position) {
+        Chunk *chunk = p_position.m_chunk;
+        const uint32_t index = p_position.m_index;
+        ERR_FAIL_NULL_V(chunk, end());
+
+        T *items = chunk->items();
+        for (uint32_t i = index; i + 1 < chunk->count; i++) {
+            items[i] = std::move(items[i + 1]);
+        }
+        items[--chunk->count].~T();
+        m_size--;
+
+        if (chunk->count == 0) {
+            Chunk *next = chunk->next;
+            unlink(chunk);
+            releaseChunk(chunk);
+            return Iterator(next, 0);
+        }
+
+        Chunk *next = chunk->next;
+        if (next && chunk->count < ChunkCapacity / 4 && chunk->count + next->count <= ChunkCapacity) {
+            T *nextItems = next->items();
+            for (uint32_t i = 0; i < next->count; i++) {
+                ::new (&items[chunk->count + i]) T(std::move(nextItems[i]));
+                nextItems[i].~T();
+            }
+            chunk->count += next->count;
+            next->count = 0;
+            unlink(next);
+            releaseChunk(next);
+        }
+
+        return index < chunk->count ? Iterator(chunk, index) : Iterator(chunk->next, 0);
+    }
+
+    Iterator find(const T &p_value) {
+        for (Iterator it = begin(); it != end(); ++it) {
+            if (*it == p_value) {
+                return it;
+            }
+        }
+        return end();
+    }
+
+    /** Destroys the elements and keeps one chunk around for reuse. */
+    void clear() {
+        while (m_first) {
+            Chunk *chunk = m_first;
+            unlink(chunk);
+            destroyItems(chunk);
+            releaseChunk(chunk);
+        }
+        m_size = 0;
+    }
+
+    /** Destroys the elements and frees every chunk. */
+    void reset() {
+        clear();
+        if (m_spare) {
+            Memory::freeStatic(m_spare);
+            m_spare = nullptr;
+        }
+    }
+
+private:
+    Chunk *m_first = nullptr;
+    Chunk *m_last = nullptr;
+    /** Last released chunk, so a list oscillating around a chunk boundary does not allocate. */
+    Chunk *m_spare = nullptr;
+    uint32_t m_size = 0;
+
+    Chunk *acquireChunk() {
+        if (Chunk *chunk = m_spare) {
+            m_spare = nullptr;
+            return chunk;
+        }
+
+        void *memory = Memory::allocStatic(sizeof(Chunk));
+        CRASH_COND_MSG(!memory, "Out of memory");
+        return ::new (memory) Chunk();
+    }
+
+    void releaseChunk(Chunk *p_chunk) {
+        if (!m_spare) {
+            p_chunk->count = 0;
+            m_spare = p_chunk;
+            return;
+        }
+        Memory::freeStatic(p_chunk);
+    }
+
+    /** `p_after == nullptr` links at the front. */
+    void linkAfter(Chunk *p_after, Chunk *p_chunk) {
+        p_chunk->prev = p_after;
+        p_chunk->next = p_after ? p_after->next : m_first;
+        if (p_chunk->next) {
+            p_chunk->next->prev = p_chunk;
+        } else {
+            m_last = p_chunk;
+        }
+        if (p_after) {
+            p_after->next = p_chunk;
+        } else {
+            m_first = p_chunk;
+        }
+    }
+
+    void unlink(Chunk *p_chunk) {
+        (p_chunk->prev ? p_chunk->prev->next : m_first) = p_chunk->next;
+        (p_chunk->next ? p_chunk->next->prev : m_last) = p_chunk->prev;
+        p_chunk->prev = nullptr;
+        p_chunk->next = nullptr;
+    }
+
+    void insertAt(Chunk *p_chunk, uint32_t p_index, T &&p_value) {
+        T *items = p_chunk->items();
+        if (p_index == p_chunk->count) {
+            ::new (&items[p_index]) T(std::move(p_value));
+        } else {
+            ::new (&items[p_chunk->count]) T(std::move(items[p_chunk->count - 1]));
+            std::move_backward(items + p_index, items + p_chunk->count - 1, items + p_chunk->count);
+            items[p_index] = std::move(p_value);
+        }
+        p_chunk->count++;
+        m_size++;
+    }
+
+    void destroyItems(Chunk *p_chunk) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (uint32_t i = 0; i < p_chunk->count; i++) {
+                p_chunk->items()[i].~T();
+            }
+        }
+        p_chunk->count = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef __ENGINE_LOCAL_VECTOR_HPP__
+#define __ENGINE_LOCAL_VECTOR_HPP__
+
+#include "../../SystemOS/Memory.hpp"
+
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Growable array owned by a single place, without the copy-on-write of Vector.
+ *
+ * Storage comes from Memory::allocStatic, trivially copyable elements grow through
+ * Memory::reallocStatic without being touched one by one. clear() keeps the capacity, so a
+ * vector reused every frame stops allocating once it reached its working size.
+ */
+template <typename T, typename U = uint32_t>
+class LocalVector {
+    static_assert(alignof(T) <= alignof(max_align_t), "Over-aligned elements need Memory::allocAlignedStatic");
+
+public:
+    LocalVector() = default;
+
+    LocalVector(std::initializer_list<T> p_init) {
+        reserve(static_cast<U>(p_init.size()));
+        for (const T &element : p_init) {
+            pushBack(element);
+        }
+    }
+
+    LocalVector(const LocalVector &p_from) {
+        reserve(p_from.m_count);
+        for (U i = 0; i < p_from.m_count; i++) {
+            ::new (&m_data[i]) T(p_from.m_data[i]);
+        }
+        m_count = p_from.m_count;
+    }
+
+    LocalVector(LocalVector &&p_from) noexcept :
+            m_count(p_from.m_count), m_capacity(p_from.m_capacity), m_data(p_from.m_data) {
+        p_from.m_count = 0;
+        p_from.m_capacity = 0;
+        p_from.m_data = nullptr;
+    }
+
+    LocalVector &operator=(const LocalVector &p_from) {
+        if (this != &p_from) {
+            LocalVector copy(p_from);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    LocalVector &operator=(LocalVector &&p_from) noexcept {
+        if (this != &p_from) {
+            reset();
+            SWAP(m_count, p_from.m_count);
+            SWAP(m_capacity, p_from.m_capacity);
+            SWAP(m_data, p_from.m_data);
+        }
+        return *this;
+    }
+
+    ~LocalVector() { reset(); }
+
+    _FORCE_INLINE_ T *ptr() { return m_data; }
+    _FORCE_INLINE_ const T *ptr() const { return m_data; }
+
+    _FORCE_INLINE_ U size() const { return m_count; }
+    _FORCE_INLINE_ U capacity() const { return m_capacity; }
+    _FORCE_INLINE_ bool isEmpty() const { return m_count == 0; }
+
+    _FORCE_INLINE_ T &operator[](U p_index) {
+        CRASH_BAD_UNSIGNED_INDEX(p_index, m_count);
+        return m_data[p_index];
+    }
+
+    _FORCE_INLINE_ const T &operator[](U p_index) const {
+        CRASH_BAD_UNSIGNED_INDEX(p_index, m_count);
+        return m_data[p_index];
+    }
+
+    _FORCE_INLINE_ T *begin() { return m_data; }
+    _FORCE_INLINE_ T *end() { return m_data + m_count; }
+    _FORCE_INLINE_ const T *begin() const { return m_data; }
+    _FORCE_INLINE_ const T *end() const { return m_data + m_count; }
+
+    template <typename... Args>
+    T &emplaceBack(Args &&...p_args) {
+        if (m_count == m_capacity) {
+            /** The arguments may refer to an element, build the value before the storage moves. */
+            T value(std::forward<Args>(p_args)...);
+            grow(m_count + 1);
+            ::new (&m_data[m_count]) T(std::move(value));
+        } else {
+            ::new (&m_data[m_count]) T(std::forward<Args>(p_args)...);
+        }
+        return m_data[m_count++];
+    }
+
+    _FORCE_INLINE_ void pushBack(const T &p_element) { emplaceBack(p_element); }
+    _FORCE_INLINE_ void pushBack(T &&p_element) { emplaceBack(std::move(p_element)); }
+
+    void popBack() {
+        ERR_FAIL_COND(m_count == 0);
+        m_count--;
+        destroy(m_count, m_count + 1);
+    }
+
+    /** Keeps the order of the remaining elements. */
+    void removeAt(U p_index) {
+        ERR_FAIL_UNSIGNED_INDEX(p_index, m_count);
+        for (U i = p_index; i + 1 < m_count; i++) {
+            m_data[i] = std::move(m_data[i + 1]);
+        }
+        popBack();
+    }
+
+    /** Moves the last element into the gap, O(1). */
+    void removeAtUnordered(U p_index) {
+        ERR_FAIL_UNSIGNED_INDEX(p_index, m_count);
+        if (p_index + 1 != m_count) {
+            m_data[p_index] = std::move(m_data[m_count - 1]);
+        }
+        popBack();
+    }
+
+    /** Removes the first element equal to `p_value`, returns whether there was one. */
+    bool erase(const T &p_value) {
+        const int64_t index = find(p_value);
+        if (index < 0) {
+            return false;
+        }
+        removeAt(static_cast<U>(index));
+        return true;
+    }
+
+    void insert(U p_position, T p_value) {
+        ERR_FAIL_UNSIGNED_INDEX(p_position, m_count + 1);
+        if (p_position == m_count) {
+            pushBack(std::move(p_value));
+            return;
+        }
+
+        emplaceBack(std::move(m_data[m_count - 1]));
+        for (U i = m_count - 2; i > p_position; i--) {
+            m_data[i] = std::move(m_data[i - 1]);
+        }
+        m_data[p_position] = std::move(p_value);
+    }
+
+    int64_t find(const T &p_value, U p_from = 0) const {
+        for (U i = p_from; i < m_count; i++) {
+            if (m_data[i] == p_value) {
+                return static_cast<int64_t>(i);
+            }
+        }
+        return -1;
+    }
+
+    _FORCE_INLINE_ bool has(const T &p_value) const { return find(p_value) != -1; }
+
+    /** Destroys the elements and keeps the storage. */
+    void clear() {
+        destroy(0, m_count);
+        m_count = 0;
+    }
+
+    /** Destroys the elements and frees the storage. */
+    void reset() {
+        clear();
+        if (m_data) {
+            Memory::freeStatic(m_data);
+            m_data = nullptr;
+        }
+        m_capacity = 0;
+    }
+
+    void reserve(U p_capacity) {
+        if (p_capacity > m_capacity) {
+            relocate(p_capacity);
+        }
+    }
+
+    /** New elements are value-initialized. */
+    void resize(U p_size) {
+        if (p_size < m_count) {
+            destroy(p_size, m_count);
+            m_count = p_size;
+            return;
+        }
+
+        reserve(p_size);
+        if constexpr (is_zero_constructible_v<T>) {
+            memset(static_cast<void *>(m_data + m_count), 0, (p_size - m_count) * sizeof(T));
+        } else {
+            for (U i = m_count; i < p_size; i++) {
+                ::new (&m_data[i]) T();
+            }
+        }
+        m_count = p_size;
+    }
+
+private:
+    U m_count = 0;
+    U m_capacity = 0;
+    T *m_data = nullptr;
+
+    void grow(U p_minimum) {
+        U capacity = m_capacity ? m_capacity * 2 : 4;
+        relocate(MAX(capacity, p_minimum));
+    }
+
+    void relocate(U p_capacity) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            m_data = static_cast<T *>(Memory::reallocStatic(m_data, static_cast<size_t>(p_capacity) * sizeof(T)));
+            CRASH_COND_MSG(!m_data, "Out of memory");
+        } else {
+            T *data = static_cast<T *>(Memory::allocStatic(static_cast<size_t>(p_capacity) * sizeof(T)));
+            CRASH_COND_MSG(!data, "Out of memory");
+            for (U i = 0; i < m_count; i++) {
+                ::new (&data[i]) T(std::move(m_data[i]));
+                m_data[i].~T();
+            }
+            if (m_data) {
+                Memory::freeStatic(m_data);
+            }
+            m_data = data;
+        }
+        m_capacity = p_capacity;
+    }
+
+    void destroy(U p_from, U p_to) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (U i = p_from; i < p_to; i++) {
+                m_data[i].~T();
+            }
+        }
+    }
+};
+
+#endif
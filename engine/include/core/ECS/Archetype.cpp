@@ -0,0 +1,106 @@
+#include "Archetype.hpp"
+
+namespace Engine {
+    namespace {
+        uint32_t alignUp(uint32_t p_value, uint32_t p_alignment) {
+            return (p_value + p_alignment - 1) & ~(p_alignment - 1);
+        }
+    }
+
+    Archetype::Archetype(ComponentMask p_mask) :
+            m_mask(p_mask) {
+        uint32_t rowBytes = sizeof(Entity);
+        for (ComponentId id = 0; id < MAX_COMPONENT_TYPES; id++) {
+            if (has(id)) {
+                m_components.pushBack(id);
+                m_infos.pushBack(&ComponentRegistry::info(id));
+                rowBytes += m_infos[m_infos.size() - 1]->size;
+            }
+        }
+
+        /** Start from the unpadded estimate and shrink until the aligned columns fit. */
+        for (uint32_t capacity = CHUNK_BYTES / rowBytes; capacity > 0; capacity--) {
+            uint32_t offset = capacity * sizeof(Entity);
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                offset = alignUp(offset, m_infos[i]->alignment);
+                m_columnOffsets[m_components[i]] = offset;
+                offset += capacity * m_infos[i]->size;
+            }
+            if (offset <= CHUNK_BYTES) {
+                m_chunkCapacity = capacity;
+                break;
+            }
+        }
+        CRASH_COND_MSG(m_chunkCapacity == 0, "Components of an archetype do not fit in one chunk row");
+    }
+
+    Archetype::~Archetype() {
+        for (uint32_t chunk = 0; chunk < m_chunks.size(); chunk++) {
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                if (!m_infos[i]->destroy) {
+                    continue;
+                }
+                uint8_t *data = static_cast<uint8_t *>(column(chunk, m_components[i]));
+                for (uint32_t row = 0; row < m_chunks[chunk].count; row++) {
+                    m_infos[i]->destroy(data + static_cast<size_t>(row) * m_infos[i]->size);
+                }
+            }
+            Memory::freeAlignedStatic(m_chunks[chunk].data);
+        }
+        if (m_spare) {
+            Memory::freeAlignedStatic(m_spare);
+        }
+    }
+
+    Archetype::Location Archetype::allocateRow(Entity p_entity) {
+        if (m_chunks.isEmpty() || m_chunks[m_chunks.size() - 1].count == m_chunkCapacity) {
+            Chunk chunk;
+            if (m_spare) {
+                chunk.data = m_spare;
+                m_spare = nullptr;
+            } else {
+                chunk.data = static_cast<uint8_t *>(Memory::allocAlignedStatic(CHUNK_BYTES, CHUNK_ALIGNMENT));
+                CRASH_COND_MSG(!chunk.data, "Out of memory");
+            }
+            m_chunks.pushBack(chunk);
+        }
+
+        const uint32_t chunk = m_chunks.size() - 1;
+        const uint32_t row = m_chunks[chunk].count++;
+        entities(chunk)[row] = p_entity;
+        m_size++;
+        return { chunk, row };
+    }
+
+    Entity Archetype::removeRow(Location p_location, bool p_destroy) {
+        if (p_destroy) {
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                if (m_infos[i]->destroy) {
+                    m_infos[i]->destroy(component(p_location, m_components[i]));
+                }
+            }
+        }
+
+        const uint32_t lastChunk = m_chunks.size() - 1;
+        const Location last = { lastChunk, m_chunks[lastChunk].count - 1 };
+
+        Entity moved;
+        if (last.chunk != p_location.chunk || last.row != p_location.row) {
+            for (uint32_t i = 0; i < m_components.size(); i++) {
+                m_infos[i]->relocate(component(p_location, m_components[i]), component(last, m_components[i]));
+            }
+            moved = entities(last.chunk)[last.row];
+            entities(p_location.chunk)[p_location.row] = moved;
+        }
+
+        m_size--;
+        if (--m_chunks[lastChunk].count == 0) {
+            if (m_spare) {
+                Memory::freeAlignedStatic(m_spare);
+            }
+            m_spare = m_chunks[lastChunk].data;
+            m_chunks.popBack();
+        }
+        return moved;
+    }
+}
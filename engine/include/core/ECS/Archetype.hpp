@@ -0,0 +1,97 @@
+#ifndef __ENGINE_ECS_ARCHETYPE_HPP__
+#define __ENGINE_ECS_ARCHETYPE_HPP__
+
+#include "Component.hpp"
+
+#include "../DataStructures/LocalVector/LocalVector.hpp"
+
+namespace Engine {
+    /**
+     * Storage for every entity that has exactly the same set of components.
+     *
+     * Entities live in 16 KB chunks laid out as structure of arrays: the entity handles first,
+     * then one contiguous column per component in id order. Rows are kept packed, removing one
+     * moves the very last row of the archetype into the hole, so every chunk but the last is
+     * full and iterating a column is a linear walk over memory.
+     */
+    class Archetype {
+    public:
+        static constexpr uint32_t CHUNK_BYTES = 16 * 1024;
+        static constexpr uint32_t CHUNK_ALIGNMENT = 64;
+
+        struct Location {
+            uint32_t chunk = 0;
+            uint32_t row = 0;
+        };
+
+        explicit Archetype(ComponentMask p_mask);
+        ~Archetype();
+
+        Archetype(const Archetype &) = delete;
+        Archetype &operator=(const Archetype &) = delete;
+
+        ComponentMask mask() const { return m_mask; }
+        bool has(ComponentId p_id) const { return (m_mask >> p_id) & 1; }
+        const LocalVector<ComponentId> &components() const { return m_components; }
+
+        /** Entities in the whole archetype and in one chunk. */
+        uint32_t size() const { return m_size; }
+        uint32_t chunkCapacity() const { return m_chunkCapacity; }
+        uint32_t chunkCount() const { return m_chunks.size(); }
+        uint32_t chunkSize(uint32_t p_chunk) const { return m_chunks[p_chunk].count; }
+
+        Entity *entities(uint32_t p_chunk) { return reinterpret_cast<Entity *>(m_chunks[p_chunk].data); }
+
+        /** First element of the column of `p_id` in `p_chunk`, which must be part of the archetype. */
+        void *column(uint32_t p_chunk, ComponentId p_id) {
+            return m_chunks[p_chunk].data + m_columnOffsets[p_id];
+        }
+
+        template <typename T>
+        T *column(uint32_t p_chunk) {
+            return std::launder(static_cast<T *>(column(p_chunk, ComponentRegistry::id<T>())));
+        }
+
+        void *component(Location p_location, ComponentId p_id) {
+            return static_cast<uint8_t *>(column(p_location.chunk, p_id)) +
+                    static_cast<size_t>(p_location.row) * ComponentRegistry::info(p_id).size;
+        }
+
+        /** Appends a row for `p_entity`, its components are left for the caller to construct. */
+        Location allocateRow(Entity p_entity);
+
+        /**
+         * Removes the row at `p_location`, destroying its components when `p_destroy` is set
+         * (otherwise the caller already relocated or destroyed them). Returns the entity that
+         * was moved into the hole, or an invalid one when the row was the last.
+         */
+        Entity removeRow(Location p_location, bool p_destroy);
+
+        /** Cached neighbours in the archetype graph, null until World looked them up once. */
+        Archetype *&addEdge(ComponentId p_id) { return m_addEdges[p_id]; }
+        Archetype *&removeEdge(ComponentId p_id) { return m_removeEdges[p_id]; }
+
+    private:
+        struct Chunk {
+            uint8_t *data = nullptr;
+            uint32_t count = 0;
+        };
+
+        ComponentMask m_mask = 0;
+        LocalVector<ComponentId> m_components;
+        /** Parallel to m_components. */
+        LocalVector<const ComponentInfo *> m_infos;
+        uint32_t m_columnOffsets[MAX_COMPONENT_TYPES] = {};
+
+        LocalVector<Chunk> m_chunks;
+        /** Last emptied chunk, so an archetype oscillating around a chunk boundary does not allocate. */
+        uint8_t *m_spare = nullptr;
+        uint32_t m_chunkCapacity = 0;
+        uint32_t m_size = 0;
+
+        Archetype *m_addEdges[MAX_COMPONENT_TYPES] = {};
+        Archetype *m_removeEdges[MAX_COMPONENT_TYPES] = {};
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "CommandBuffer.hpp"
+
+namespace Engine {
+    CommandBuffer::~CommandBuffer() {
+        clear();
+        for (uint8_t *page : m_pages) {
+            Memory::freeAlignedStatic(page);
+        }
+    }
+
+    Entity CommandBuffer::create() {
+        const Entity entity = { m_created++, PENDING_GENERATION };
+        m_commands.pushBack({ Op::Create, 0, entity, nullptr });
+        return entity;
+    }
+
+    void CommandBuffer::destroy(Entity p_entity) {
+        m_commands.pushBack({ Op::Destroy, 0, p_entity, nullptr });
+    }
+
+    void CommandBuffer::apply(World &p_world) {
+        if (m_commands.isEmpty()) {
+            return;
+        }
+
+        m_resolved.resize(m_created);
+        for (Command &command : m_commands) {
+            if (command.op == Op::Create) {
+                m_resolved[command.entity.index] = p_world.create();
+                continue;
+            }
+
+            const Entity entity = resolve(command.entity);
+            if (!p_world.isAlive(entity)) {
+                continue;
+            }
+
+            switch (command.op) {
+                case Op::Destroy:
+                    p_world.destroy(entity);
+                    break;
+                case Op::Add:
+                    p_world.addRaw(entity, command.component, command.payload);
+                    command.payload = nullptr;
+                    break;
+                case Op::Remove:
+                    p_world.removeRaw(entity, command.component);
+                    break;
+                case Op::Create:
+                    break;
+            }
+        }
+
+        clear();
+    }
+
+    void CommandBuffer::clear() {
+        for (const Command &command : m_commands) {
+            if (command.op == Op::Add && command.payload) {
+                const ComponentInfo &info = ComponentRegistry::info(command.component);
+                if (info.destroy) {
+                    info.destroy(command.payload);
+                }
+            }
+        }
+        for (void *payload : m_largePayloads) {
+            Memory::freeAlignedStatic(payload);
+        }
+
+        m_commands.clear();
+        m_largePayloads.clear();
+        m_resolved.clear();
+        m_page = 0;
+        m_pageOffset = 0;
+        m_created = 0;
+    }
+
+    void *CommandBuffer::allocate(uint32_t p_size, uint32_t p_alignment) {
+        if (p_size > PAGE_BYTES) {
+            void *payload = Memory::allocAlignedStatic(p_size, PAGE_ALIGNMENT);
+            CRASH_COND_MSG(!payload, "Out of memory");
+            m_largePayloads.pushBack(payload);
+            return payload;
+        }
+
+        for (;;) {
+            if (m_page == m_pages.size()) {
+                uint8_t *page = static_cast<uint8_t *>(Memory::allocAlignedStatic(PAGE_BYTES, PAGE_ALIGNMENT));
+                CRASH_COND_MSG(!page, "Out of memory");
+                m_pages.pushBack(page);
+            }
+
+            const uint32_t offset = (m_pageOffset + p_alignment - 1) & ~(p_alignment - 1);
+            if (offset + p_size <= PAGE_BYTES) {
+                m_pageOffset = offset + p_size;
+                return m_pages[m_page] + offset;
+            }
+
+            m_page++;
+            m_pageOffset = 0;
+        }
+    }
+
+    Entity CommandBuffer::resolve(Entity p_entity) const {
+        if (p_entity.generation != PENDING_GENERATION) {
+            return p_entity;
+        }
+        ERR_FAIL_UNSIGNED_INDEX_V_MSG(p_entity.index, m_resolved.size(), Entity(), "Entity created by another command buffer.");
+        return m_resolved[p_entity.index];
+    }
+}
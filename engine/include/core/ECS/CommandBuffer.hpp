@@ -0,0 +1,84 @@
+#ifndef __ENGINE_ECS_COMMAND_BUFFER_HPP__
+#define __ENGINE_ECS_COMMAND_BUFFER_HPP__
+
+#include "World.hpp"
+
+namespace Engine {
+    /**
+     * Structural changes recorded while a world is being iterated and applied at a sync point.
+     *
+     * A buffer belongs to one thread at a time. Component values are moved into 16 KB pages
+     * that are kept across apply() calls, so a buffer reused every frame stops allocating once
+     * it reached its working size. Entities returned by create() are placeholders that only
+     * this buffer can resolve; they may be passed to its own add(), remove() and destroy().
+     * Commands on entities that died before apply() are dropped silently, two systems
+     * destroying the same mob is not an error.
+     */
+    class CommandBuffer {
+    public:
+        CommandBuffer() = default;
+        ~CommandBuffer();
+
+        CommandBuffer(const CommandBuffer &) = delete;
+        CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+        Entity create();
+        void destroy(Entity p_entity);
+
+        template <typename T>
+        void add(Entity p_entity, T p_component) {
+            void *payload = allocate(sizeof(T), alignof(T));
+            ::new (payload) T(std::move(p_component));
+            m_commands.pushBack({ Op::Add, ComponentRegistry::id<T>(), p_entity, payload });
+        }
+
+        template <typename T>
+        void remove(Entity p_entity) {
+            m_commands.pushBack({ Op::Remove, ComponentRegistry::id<T>(), p_entity, nullptr });
+        }
+
+        bool isEmpty() const { return m_commands.isEmpty(); }
+        uint32_t size() const { return m_commands.size(); }
+
+        /** Executes the commands in recording order and clears the buffer. */
+        void apply(World &p_world);
+
+        /** Drops the commands, destroying the component values they carry. */
+        void clear();
+
+    private:
+        enum class Op : uint8_t {
+            Create,
+            Destroy,
+            Add,
+            Remove,
+        };
+
+        struct Command {
+            Op op;
+            ComponentId component;
+            Entity entity;
+            /** Component value of an Add, null once it was moved into the world. */
+            void *payload;
+        };
+
+        static constexpr uint32_t PAGE_BYTES = 16 * 1024;
+        static constexpr uint32_t PAGE_ALIGNMENT = 64;
+        /** Generation marking an entity created by this buffer, its index counts creations. */
+        static constexpr uint32_t PENDING_GENERATION = UINT32_MAX;
+
+        LocalVector<Command> m_commands;
+        LocalVector<uint8_t *> m_pages;
+        uint32_t m_page = 0;
+        uint32_t m_pageOffset = 0;
+        /** Components larger than a page, freed by clear(). */
+        LocalVector<void *> m_largePayloads;
+        uint32_t m_created = 0;
+        LocalVector<Entity> m_resolved;
+
+        void *allocate(uint32_t p_size, uint32_t p_alignment);
+        Entity resolve(Entity p_entity) const;
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "Component.hpp"
+
+#include "../Errors/ErrorMacros.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace Engine {
+    namespace {
+        ComponentInfo s_components[MAX_COMPONENT_TYPES];
+        std::atomic<uint32_t> s_componentCount{0};
+        std::mutex s_registerMutex;
+    }
+
+    const ComponentInfo &ComponentRegistry::info(ComponentId p_id) {
+        CRASH_BAD_UNSIGNED_INDEX(p_id, s_componentCount.load(std::memory_order_acquire));
+        return s_components[p_id];
+    }
+
+    uint32_t ComponentRegistry::count() {
+        return s_componentCount.load(std::memory_order_acquire);
+    }
+
+    ComponentId ComponentRegistry::registerComponent(const ComponentInfo &p_info) {
+        std::lock_guard<std::mutex> lock(s_registerMutex);
+        const uint32_t id = s_componentCount.load(std::memory_order_relaxed);
+        CRASH_COND_MSG(id >= MAX_COMPONENT_TYPES, "Too many component types, ComponentMask has one bit per type");
+        s_components[id] = p_info;
+        s_componentCount.store(id + 1, std::memory_order_release);
+        return id;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef __ENGINE_ECS_COMPONENT_HPP__
+#define __ENGINE_ECS_COMPONENT_HPP__
+
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace Engine {
+    /** Handle to an entity, the generation tells a recycled index apart from the entity that used it before. */
+    struct Entity {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool isValid() const { return index != UINT32_MAX; }
+
+        bool operator==(const Entity &p_other) const { return index == p_other.index && generation == p_other.generation; }
+        bool operator!=(const Entity &p_other) const { return !(*this == p_other); }
+    };
+
+    using ComponentId = uint32_t;
+
+    /** One bit per component id, which caps the number of component types. */
+    using ComponentMask = uint64_t;
+    inline constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+
+    /** How archetype chunks and command buffers handle a component type without knowing it. */
+    struct ComponentInfo {
+        const char *name = nullptr;
+        uint32_t size = 0;
+        uint32_t alignment = 0;
+        /** Move-constructs `p_to` from `p_from` and destroys `p_from`. */
+        void (*relocate)(void *p_to, void *p_from) = nullptr;
+        /** Null for trivially destructible components. */
+        void (*destroy)(void *p_component) = nullptr;
+    };
+
+    /**
+     * Process-wide table of component types. Ids are handed out on first use of a type, in
+     * whatever order the code first touches them, and stay valid until exit.
+     */
+    class ComponentRegistry {
+    public:
+        template <typename T>
+        static ComponentId id() {
+            if constexpr (!std::is_same_v<T, std::remove_cv_t<T>>) {
+                /** `const Position` must not register a second type. */
+                return id<std::remove_cv_t<T>>();
+            } else {
+                static const ComponentId s_id = registerComponent(makeInfo<T>());
+                return s_id;
+            }
+        }
+
+        template <typename T>
+        static ComponentMask mask() { return ComponentMask(1) << id<T>(); }
+
+        static const ComponentInfo &info(ComponentId p_id);
+        static uint32_t count();
+
+    private:
+        static ComponentId registerComponent(const ComponentInfo &p_info);
+
+        template <typename T>
+        static ComponentInfo makeInfo() {
+            static_assert(std::is_move_constructible_v<T>, "Components are moved between chunks");
+            static_assert(alignof(T) <= 64, "Chunk columns are aligned to at most a cache line");
+
+            ComponentInfo info;
+            info.name = typeid(T).name();
+            info.size = sizeof(T);
+            info.alignment = alignof(T);
+            info.relocate = [](void *p_to, void *p_from) {
+                T *from = static_cast<T *>(p_from);
+                ::new (p_to) T(std::move(*from));
+                from->~T();
+            };
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                info.destroy = [](void *p_component) { static_cast<T *>(p_component)->~T(); };
+            }
+            return info;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef __ENGINE_ECS_QUERY_HPP__
+#define __ENGINE_ECS_QUERY_HPP__
+
+#include "World.hpp"
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace Engine {
+    /** Columns of one chunk for the components of a query, `const` ones are read-only. */
+    template <typename... Ts>
+    struct ChunkView {
+        uint32_t count = 0;
+        const Entity *entities = nullptr;
+        std::tuple<Ts *...> columns;
+
+        template <typename T>
+        T *get() const { return std::get<T *>(columns); }
+    };
+
+    /**
+     * Iterates the entities having at least the components `Ts`, e.g.
+     * `Query<const Velocity, Position>` reads Velocity and writes Position.
+     *
+     * The matching archetypes are cached and refresh() only tests the archetypes created since
+     * the previous call, so a query is meant to be kept and reused rather than rebuilt every
+     * frame. Iteration walks each chunk's columns linearly and locks the world's structure.
+     */
+    template <typename... Ts>
+    class Query {
+        static_assert(sizeof...(Ts) > 0, "A query needs at least one component");
+
+    public:
+        explicit Query(World &p_world) :
+                m_world(&p_world), m_ids{ ComponentRegistry::id<Ts>()... } {
+            CRASH_COND_MSG(std::popcount(accessMask()) != static_cast<int>(sizeof...(Ts)), "A query lists each component once");
+        }
+
+        /** Every component the query touches, and the subset it may modify. */
+        static ComponentMask accessMask() { return (ComponentRegistry::mask<Ts>() | ...); }
+        static ComponentMask writeMask() { return ((std::is_const_v<Ts> ? ComponentMask(0) : ComponentMask(ComponentRegistry::mask<Ts>())) | ...); }
+
+        /** Picks up archetypes created since the last call. */
+        void refresh() {
+            const ComponentMask required = accessMask();
+            for (; m_seenArchetypes < m_world->archetypeCount(); m_seenArchetypes++) {
+                Archetype &archetype = m_world->archetype(m_seenArchetypes);
+                if ((archetype.mask() & required) == required) {
+                    m_archetypes.pushBack(&archetype);
+                }
+            }
+        }
+
+        const LocalVector<Archetype *> &archetypes() {
+            refresh();
+            return m_archetypes;
+        }
+
+        /** Number of matching entities. */
+        uint32_t size() {
+            uint32_t count = 0;
+            for (Archetype *archetype : archetypes()) {
+                count += archetype->size();
+            }
+            return count;
+        }
+
+        ChunkView<Ts...> view(Archetype &p_archetype, uint32_t p_chunk) const {
+            return makeView(p_archetype, p_chunk, std::index_sequence_for<Ts...>());
+        }
+
+        /** `p_function(const ChunkView<Ts...> &)` once per chunk. */
+        template <typename F>
+        void eachChunk(F &&p_function) {
+            refresh();
+            World::StructureLock lock(*m_world);
+            for (Archetype *archetype : m_archetypes) {
+                for (uint32_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+                    p_function(view(*archetype, chunk));
+                }
+            }
+        }
+
+        /** `p_function(Ts &...)` or `p_function(Entity, Ts &...)` once per entity. */
+        template <typename F>
+        void each(F &&p_function) {
+            eachChunk([&p_function](const ChunkView<Ts...> &p_view) { eachRow(p_view, p_function); });
+        }
+
+        template <typename F>
+        static void eachRow(const ChunkView<Ts...> &p_view, F &p_function) {
+            eachRow(p_view, p_function, std::index_sequence_for<Ts...>());
+        }
+
+    private:
+        World *m_world;
+        std::array<ComponentId, sizeof...(Ts)> m_ids;
+        LocalVector<Archetype *> m_archetypes;
+        uint32_t m_seenArchetypes = 0;
+
+        template <size_t... I>
+        ChunkView<Ts...> makeView(Archetype &p_archetype, uint32_t p_chunk, std::index_sequence<I...>) const {
+            ChunkView<Ts...> view;
+            view.count = p_archetype.chunkSize(p_chunk);
+            view.entities = p_archetype.entities(p_chunk);
+            view.columns = std::tuple<Ts *...>(std::launder(static_cast<Ts *>(p_archetype.column(p_chunk, m_ids[I])))...);
+            return view;
+        }
+
+        template <typename F, size_t... I>
+        static void eachRow(const ChunkView<Ts...> &p_view, F &p_function, std::index_sequence<I...>) {
+            /** Hoisted so the loop body only indexes plain pointers. */
+            const std::tuple<Ts *...> columns = p_view.columns;
+            for (uint32_t row = 0; row < p_view.count; row++) {
+                if constexpr (std::is_invocable_v<F &, Entity, Ts &...>) {
+                    p_function(p_view.entities[row], std::get<I>(columns)[row]...);
+                } else {
+                    p_function(std::get<I>(columns)[row]...);
+                }
+            }
+        }
+    };
+}
+
+#endif
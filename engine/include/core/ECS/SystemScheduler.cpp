@@ -0,0 +1,80 @@
+#include "SystemScheduler.hpp"
+
+#include "../../logger.hpp"
+
+namespace Engine {
+    SystemScheduler::SystemScheduler(World &p_world, WorkerThreadPool &p_pool) :
+            m_world(p_world), m_pool(p_pool), m_commandBuffers(std::make_unique<CommandBuffer[]>(p_pool.threadCount())) {
+        m_runItem = [this](uint32_t p_index, uint32_t p_threadIndex) {
+            const WorkItem &item = m_items[p_index];
+            item.system->runChunk(*item.archetype, item.chunk, m_commandBuffers[p_threadIndex]);
+        };
+    }
+
+    SystemScheduler::~SystemScheduler() {
+        for (SystemBase *system : m_systems) {
+            memoryDelete(system);
+        }
+    }
+
+    void SystemScheduler::run() {
+        buildStages();
+
+        for (const LocalVector<uint32_t> &stage : m_stages) {
+            m_items.clear();
+            for (uint32_t index : stage) {
+                SystemBase *system = m_systems[index];
+                for (Archetype *archetype : system->archetypes()) {
+                    for (uint32_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+                        m_items.pushBack({ system, archetype, chunk });
+                    }
+                }
+            }
+
+            if (m_items.isEmpty()) {
+                continue;
+            }
+
+            {
+                World::StructureLock lock(m_world);
+                if (m_items.size() == 1) {
+                    m_runItem(0, m_pool.threadCount() - 1);
+                } else {
+                    m_pool.parallelFor(m_items.size(), m_runItem);
+                }
+            }
+
+            for (uint32_t thread = 0; thread < m_pool.threadCount(); thread++) {
+                m_commandBuffers[thread].apply(m_world);
+            }
+        }
+    }
+
+    void SystemScheduler::buildStages() {
+        if (!m_stagesDirty) {
+            return;
+        }
+        m_stagesDirty = false;
+
+        LocalVector<uint32_t> stageOf;
+        stageOf.resize(m_systems.size());
+        m_stages.clear();
+
+        for (uint32_t i = 0; i < m_systems.size(); i++) {
+            uint32_t stage = 0;
+            for (uint32_t j = 0; j < i; j++) {
+                if (m_systems[i]->conflictsWith(*m_systems[j])) {
+                    stage = MAX(stage, stageOf[j] + 1);
+                }
+            }
+
+            stageOf[i] = stage;
+            if (stage == m_stages.size()) {
+                m_stages.pushBack(LocalVector<uint32_t>());
+            }
+            m_stages[stage].pushBack(i);
+        }
+
+        ENGINE_CLOG_DEBUG(Core, "ECS: {} systems in {} stages", m_systems.size(), m_stages.size())
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef __ENGINE_ECS_SYSTEM_SCHEDULER_HPP__
+#define __ENGINE_ECS_SYSTEM_SCHEDULER_HPP__
+
+#include "CommandBuffer.hpp"
+#include "Query.hpp"
+
+#include "../Threading/WorkerThreadPool.hpp"
+
+#include <memory>
+
+namespace Engine {
+    /**
+     * Runs systems over a world on the worker pool.
+     *
+     * Each system declares its components through its query, `const` ones being read-only.
+     * Systems are packed into stages: a system goes one stage after the last earlier system it
+     * conflicts with (one of them writes a component the other reads or writes), so running
+     * a stage in parallel gives the same result as registration order. A stage is split into
+     * one work item per chunk of every system, which balances a single heavy system across
+     * the threads as well as many light ones.
+     *
+     * Systems record structural changes into the command buffer of the thread they run on.
+     * The buffers are applied in thread order after each stage, so later stages see the
+     * entities created and destroyed by earlier ones within the same run().
+     */
+    class SystemScheduler {
+    public:
+        SystemScheduler(World &p_world, WorkerThreadPool &p_pool);
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler &) = delete;
+        SystemScheduler &operator=(const SystemScheduler &) = delete;
+
+        /** `p_function(const ChunkView<Ts...> &, CommandBuffer &)` once per chunk, from any thread. */
+        template <typename... Ts, typename F>
+        void addChunkSystem(const char *p_name, F p_function) {
+            using SystemType = System<F, Ts...>;
+            m_systems.pushBack(memoryNew(SystemType(p_name, m_world, std::move(p_function))));
+            m_stagesDirty = true;
+        }
+
+        /** `p_function(CommandBuffer &, Entity, Ts &...)` once per entity, from any thread. */
+        template <typename... Ts, typename F>
+        void addSystem(const char *p_name, F p_function) {
+            addChunkSystem<Ts...>(p_name, [function = std::move(p_function)](const ChunkView<Ts...> &p_view, CommandBuffer &p_commands) {
+                auto row = [&](Entity p_entity, Ts &...p_components) { function(p_commands, p_entity, p_components...); };
+                Query<Ts...>::eachRow(p_view, row);
+            });
+        }
+
+        /** Runs every system once. */
+        void run();
+
+        uint32_t systemCount() const { return m_systems.size(); }
+        uint32_t stageCount() {
+            buildStages();
+            return m_stages.size();
+        }
+
+    private:
+        struct SystemBase {
+            const char *name;
+            ComponentMask access;
+            ComponentMask writes;
+
+            SystemBase(const char *p_name, ComponentMask p_access, ComponentMask p_writes) :
+                    name(p_name), access(p_access), writes(p_writes) {}
+            virtual ~SystemBase() = default;
+
+            virtual const LocalVector<Archetype *> &archetypes() = 0;
+            virtual void runChunk(Archetype &p_archetype, uint32_t p_chunk, CommandBuffer &p_commands) = 0;
+
+            bool conflictsWith(const SystemBase &p_other) const {
+                return (writes & p_other.access) != 0 || (p_other.writes & access) != 0;
+            }
+        };
+
+        template <typename F, typename... Ts>
+        struct System final : SystemBase {
+            Query<Ts...> query;
+            F function;
+
+            System(const char *p_name, World &p_world, F p_function) :
+                    SystemBase(p_name, Query<Ts...>::accessMask(), Query<Ts...>::writeMask()),
+                    query(p_world), function(std::move(p_function)) {}
+
+            const LocalVector<Archetype *> &archetypes() override { return query.archetypes(); }
+
+            void runChunk(Archetype &p_archetype, uint32_t p_chunk, CommandBuffer &p_commands) override {
+                function(query.view(p_archetype, p_chunk), p_commands);
+            }
+        };
+
+        struct WorkItem {
+            SystemBase *system;
+            Archetype *archetype;
+            uint32_t chunk;
+        };
+
+        World &m_world;
+        WorkerThreadPool &m_pool;
+
+        LocalVector<SystemBase *> m_systems;
+        /** Indices into m_systems, one list per stage. */
+        LocalVector<LocalVector<uint32_t>> m_stages;
+        bool m_stagesDirty = false;
+
+        LocalVector<WorkItem> m_items;
+        std::unique_ptr<CommandBuffer[]> m_commandBuffers;
+        /** Built once, it only captures `this` and so never allocates. */
+        WorkerThreadPool::Task m_runItem;
+
+        void buildStages();
+    };
+}
+
+#endif
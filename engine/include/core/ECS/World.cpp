@@ -0,0 +1,137 @@
+#include "World.hpp"
+
+namespace Engine {
+    World::World() {
+        m_emptyArchetype = archetypeFor(0);
+    }
+
+    World::~World() {
+        for (Archetype *archetype : m_archetypes) {
+            memoryDelete(archetype);
+        }
+    }
+
+    Entity World::create() {
+        CRASH_COND_MSG(isStructureLocked(), "Entity created during iteration, record it in a CommandBuffer");
+        return allocateEntity(m_emptyArchetype);
+    }
+
+    void World::destroy(Entity p_entity) {
+        ERR_FAIL_COND_MSG(!isAlive(p_entity), "Destroying an entity that is not alive.");
+        CRASH_COND_MSG(isStructureLocked(), "Entity destroyed during iteration, record it in a CommandBuffer");
+
+        Record &record = m_records[p_entity.index];
+        const Entity moved = record.archetype->removeRow(record.location, true);
+        if (moved.isValid()) {
+            m_records[moved.index].location = record.location;
+        }
+
+        record.archetype = nullptr;
+        record.generation++;
+        m_freeIndices.pushBack(p_entity.index);
+        m_alive--;
+    }
+
+    void *World::addRaw(Entity p_entity, ComponentId p_id, void *p_component) {
+        const ComponentInfo &info = ComponentRegistry::info(p_id);
+        if (!isAlive(p_entity)) {
+            if (info.destroy) {
+                info.destroy(p_component);
+            }
+            ERR_FAIL_V_MSG(nullptr, "Adding a component to an entity that is not alive.");
+        }
+
+        Record &record = m_records[p_entity.index];
+        if (record.archetype->has(p_id)) {
+            void *slot = record.archetype->component(record.location, p_id);
+            if (info.destroy) {
+                info.destroy(slot);
+            }
+            info.relocate(slot, p_component);
+            return slot;
+        }
+
+        CRASH_COND_MSG(isStructureLocked(), "Component added during iteration, record it in a CommandBuffer");
+
+        Archetype *&edge = record.archetype->addEdge(p_id);
+        if (!edge) {
+            edge = archetypeFor(record.archetype->mask() | (ComponentMask(1) << p_id));
+        }
+        moveEntity(p_entity, edge);
+
+        void *slot = record.archetype->component(record.location, p_id);
+        info.relocate(slot, p_component);
+        return slot;
+    }
+
+    void World::removeRaw(Entity p_entity, ComponentId p_id) {
+        ERR_FAIL_COND_MSG(!isAlive(p_entity), "Removing a component from an entity that is not alive.");
+
+        Record &record = m_records[p_entity.index];
+        if (!record.archetype->has(p_id)) {
+            return;
+        }
+
+        CRASH_COND_MSG(isStructureLocked(), "Component removed during iteration, record it in a CommandBuffer");
+
+        Archetype *&edge = record.archetype->removeEdge(p_id);
+        if (!edge) {
+            edge = archetypeFor(record.archetype->mask() & ~(ComponentMask(1) << p_id));
+        }
+        moveEntity(p_entity, edge);
+    }
+
+    Archetype *World::archetypeFor(ComponentMask p_mask) {
+        if (Archetype **found = m_archetypesByMask.getPtr(p_mask)) {
+            return *found;
+        }
+
+        Archetype *archetype = memoryNew(Archetype(p_mask));
+        m_archetypes.pushBack(archetype);
+        m_archetypesByMask.insert(p_mask, archetype);
+        return archetype;
+    }
+
+    Entity World::allocateEntity(Archetype *p_archetype) {
+        uint32_t index;
+        if (!m_freeIndices.isEmpty()) {
+            index = m_freeIndices[m_freeIndices.size() - 1];
+            m_freeIndices.popBack();
+        } else {
+            index = m_records.size();
+            m_records.pushBack(Record());
+        }
+
+        Record &record = m_records[index];
+        const Entity entity = { index, record.generation };
+        record.archetype = p_archetype;
+        record.location = p_archetype->allocateRow(entity);
+        m_alive++;
+        return entity;
+    }
+
+    void World::moveEntity(Entity p_entity, Archetype *p_target) {
+        Record &record = m_records[p_entity.index];
+        Archetype *source = record.archetype;
+        const Archetype::Location from = record.location;
+        const Archetype::Location to = p_target->allocateRow(p_entity);
+
+        for (ComponentId id : source->components()) {
+            const ComponentInfo &info = ComponentRegistry::info(id);
+            void *component = source->component(from, id);
+            if (p_target->has(id)) {
+                info.relocate(p_target->component(to, id), component);
+            } else if (info.destroy) {
+                info.destroy(component);
+            }
+        }
+
+        const Entity moved = source->removeRow(from, false);
+        if (moved.isValid()) {
+            m_records[moved.index].location = from;
+        }
+
+        record.archetype = p_target;
+        record.location = to;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef __ENGINE_ECS_WORLD_HPP__
+#define __ENGINE_ECS_WORLD_HPP__
+
+#include "Archetype.hpp"
+
+#include "../DataStructures/HashMap/HashMap.hpp"
+
+#include <atomic>
+#include <bit>
+
+namespace Engine {
+    /**
+     * Owner of entities and of the archetypes storing their components.
+     *
+     * Adding or removing a component moves the entity to the archetype of its new component
+     * set, found through edges cached on the archetypes so that a repeated transition is a
+     * pointer load. Structural changes (create, destroy, add, remove) are refused while the
+     * structure is locked by a query or the system scheduler; record them in a CommandBuffer
+     * and apply it afterwards. Reading and writing components in place is always allowed.
+     */
+    class World {
+    public:
+        World();
+        ~World();
+
+        World(const World &) = delete;
+        World &operator=(const World &) = delete;
+
+        /** Entity without components. */
+        Entity create();
+
+        template <typename... Ts>
+        Entity create(Ts &&...p_components) {
+            static_assert(sizeof...(Ts) > 0, "Use create() for an entity without components");
+            CRASH_COND_MSG(isStructureLocked(), "Entity created during iteration, record it in a CommandBuffer");
+            const ComponentMask mask = (ComponentRegistry::mask<std::decay_t<Ts>>() | ...);
+            CRASH_COND_MSG(std::popcount(mask) != static_cast<int>(sizeof...(Ts)), "An entity has at most one component of each type");
+
+            Archetype *archetype = archetypeFor(mask);
+            const Entity entity = allocateEntity(archetype);
+            const Archetype::Location location = m_records[entity.index].location;
+            (::new (archetype->component(location, ComponentRegistry::id<std::decay_t<Ts>>()))
+                            std::decay_t<Ts>(std::forward<Ts>(p_components)),
+                    ...);
+            return entity;
+        }
+
+        void destroy(Entity p_entity);
+
+        bool isAlive(Entity p_entity) const {
+            return p_entity.index < m_records.size() && m_records[p_entity.index].generation == p_entity.generation &&
+                    m_records[p_entity.index].archetype != nullptr;
+        }
+
+        /** Number of living entities. */
+        uint32_t size() const { return m_alive; }
+
+        /** Null when the entity is dead or does not have the component. */
+        template <typename T>
+        T *get(Entity p_entity) {
+            const ComponentId id = ComponentRegistry::id<T>();
+            if (!isAlive(p_entity) || !m_records[p_entity.index].archetype->has(id)) {
+                return nullptr;
+            }
+            const Record &record = m_records[p_entity.index];
+            return std::launder(static_cast<T *>(record.archetype->component(record.location, id)));
+        }
+
+        template <typename T>
+        bool has(Entity p_entity) const {
+            return isAlive(p_entity) && m_records[p_entity.index].archetype->has(ComponentRegistry::id<T>());
+        }
+
+        /** Adds the component, or overwrites it when the entity already has one. */
+        template <typename T>
+        T *add(Entity p_entity, T p_component) {
+            alignas(T) unsigned char storage[sizeof(T)];
+            ::new (storage) T(std::move(p_component));
+            return std::launder(static_cast<T *>(addRaw(p_entity, ComponentRegistry::id<T>(), storage)));
+        }
+
+        template <typename T>
+        void remove(Entity p_entity) { removeRaw(p_entity, ComponentRegistry::id<T>()); }
+
+        /**
+         * Type-erased add for command buffers. The component at `p_component` is relocated into
+         * the entity, so the caller must not destroy it, and is destroyed if the entity is dead.
+         */
+        void *addRaw(Entity p_entity, ComponentId p_id, void *p_component);
+        void removeRaw(Entity p_entity, ComponentId p_id);
+
+        /** Archetypes only ever get appended, queries remember how many they already matched. */
+        uint32_t archetypeCount() const { return m_archetypes.size(); }
+        Archetype &archetype(uint32_t p_index) { return *m_archetypes[p_index]; }
+
+        /** Nesting lock taken while something iterates the archetypes. */
+        void lockStructure() { m_structureLocks.fetch_add(1, std::memory_order_relaxed); }
+        void unlockStructure() { m_structureLocks.fetch_sub(1, std::memory_order_relaxed); }
+        bool isStructureLocked() const { return m_structureLocks.load(std::memory_order_relaxed) != 0; }
+
+        class StructureLock {
+        public:
+            explicit StructureLock(World &p_world) :
+                    m_world(p_world) { m_world.lockStructure(); }
+            ~StructureLock() { m_world.unlockStructure(); }
+
+            StructureLock(const StructureLock &) = delete;
+            StructureLock &operator=(const StructureLock &) = delete;
+
+        private:
+            World &m_world;
+        };
+
+    private:
+        struct Record {
+            Archetype *archetype = nullptr;
+            Archetype::Location location;
+            uint32_t generation = 0;
+        };
+
+        LocalVector<Record> m_records;
+        LocalVector<uint32_t> m_freeIndices;
+        uint32_t m_alive = 0;
+
+        LocalVector<Archetype *> m_archetypes;
+        HashMap<ComponentMask, Archetype *> m_archetypesByMask;
+        Archetype *m_emptyArchetype = nullptr;
+
+        std::atomic<uint32_t> m_structureLocks{0};
+
+        Archetype *archetypeFor(ComponentMask p_mask);
+        Entity allocateEntity(Archetype *p_archetype);
+        /** Moves the entity's row to `p_target`, destroying the components `p_target` lacks. */
+        void moveEntity(Entity p_entity, Archetype *p_target);
+    };
+}
+
+#endif
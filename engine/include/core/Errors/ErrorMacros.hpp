@@ -3,6 +3,8 @@
 
 #include "../Typedefs.hpp"
 
+#include <atomic>
+
 #ifdef _MSC_VER
 #include <intrin.h>
 #endif
@@ -57,9 +59,76 @@ struct ErrorHandlerList {
     ErrorHandlerList() {}
 };
 
+/**
+ * Handlers are dispatched without a lock from an immutable snapshot of the list, replaced on
+ * every add or remove. removeErrorHandler() returns once no thread still runs the handler,
+ * so it must not be called from inside a handler.
+ */
 void addErrorHandler(ErrorHandlerList *pHandler);
 void removeErrorHandler(const ErrorHandlerList *pHandler);
 
+/** What kind of macro an ErrorSite belongs to. */
+enum ErrorSiteKind {
+    ERROR_SITE_ERROR,
+    ERROR_SITE_WARNING,
+    ERROR_SITE_CRASH
+};
+
+/**
+ * Static record the error macros create for each call site.
+ * The first `burst` hits of a site are printed, later ones only counted, with a summary of
+ * the suppressed hits at most once per interval. See setErrorSiteThrottle(). Crash sites
+ * are counted but always printed.
+ * A site joins the telemetry list of ErrorTelemetry on its first hit.
+ */
+struct ErrorSite {
+    const char *function;
+    const char *file;
+    int_fast32_t line;
+    ErrorSiteKind kind;
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> suppressed{0};
+    /** Steady clock milliseconds of the last summary, zero before the first suppressed hit. */
+    std::atomic<int64_t> lastSummary{0};
+
+    /** Next registered site, written once before the site is published. */
+    ErrorSite *next = nullptr;
+
+    constexpr ErrorSite(const char *pFunction, const char *pFile, int_fast32_t pLine, ErrorSiteKind pKind)
+        : function(pFunction), file(pFile), line(pLine), kind(pKind) {}
+
+    ErrorSite(const ErrorSite &) = delete;
+    ErrorSite &operator=(const ErrorSite &) = delete;
+};
+
+extern std::atomic<uint32_t> errorSiteBurst;
+
+/** Hits printed per site before throttling (0 throttles every site but crashes) and seconds between summaries. */
+void setErrorSiteThrottle(uint32_t pBurst, uint32_t pSummaryIntervalSeconds);
+
+/** Adds the site to the telemetry list, called once per site on its first hit. */
+_NO_INLINE_ void errorSiteRegister(ErrorSite &pSite);
+
+/** Counts a suppressed hit and prints the summary once the interval passed. */
+_NO_INLINE_ void errorSiteThrottled(ErrorSite &pSite);
+
+/** Counts a hit, returns whether it should be printed. */
+inline bool errorSiteHit(ErrorSite &pSite) {
+    const uint64_t hits = pSite.hits.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (unlikely(hits == 1)) {
+        errorSiteRegister(pSite);
+    }
+
+    /** A crash site traps right after printing, so its message is never the one to drop. */
+    if (likely(hits <= errorSiteBurst.load(std::memory_order_relaxed)) || pSite.kind == ERROR_SITE_CRASH) {
+        return true;
+    }
+
+    errorSiteThrottled(pSite);
+    return false;
+}
+
 /** Functions used by the error macros. */
 _NO_INLINE_ void errorPrintError(const char *p_function, const char *p_file,
                                  int_fast32_t p_line, const char *p_error,
@@ -135,6 +204,19 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
 #define GENERATE_TRAP() __builtin_trap()
 #endif
 
+/**
+ * Don't use _ERR_SITE_REPORT() directly, should only be used be the macros below.
+ * Every expansion owns a constant-initialized ErrorSite, `m_print` only runs while the site is not throttled.
+ */
+#define _ERR_SITE_REPORT(m_kind, m_print, ...)                                 \
+    {                                                                          \
+        static ErrorSite _errorSite(FUNCTION_STR, __FILE__, __LINE__, m_kind); \
+        if (errorSiteHit(_errorSite))                                          \
+        {                                                                      \
+            m_print(FUNCTION_STR, __FILE__, __LINE__, __VA_ARGS__);            \
+        }                                                                      \
+    }
+
 /**
  * Error macros.
  * WARNING: These macros work in the opposite way to assert().
@@ -165,38 +247,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, the current function returns.
  */
-#define ERR_FAIL_INDEX(m_index, m_size)                                                                       \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                     \
-    {                                                                                                         \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size)); \
-        return;                                                                                               \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_INDEX(m_index, m_size)                                                                         \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                       \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size)); \
+        return;                                                                                                 \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, prints `m_msg` and the current function returns.
  */
-#define ERR_FAIL_INDEX_MSG(m_index, m_size, m_msg)                                                                   \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                            \
-    {                                                                                                                \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
-        return;                                                                                                      \
-    }                                                                                                                \
-    else                                                                                                             \
+#define ERR_FAIL_INDEX_MSG(m_index, m_size, m_msg)                                                                     \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                              \
+    {                                                                                                                  \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
+        return;                                                                                                        \
+    }                                                                                                                  \
+    else                                                                                                               \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_INDEX_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_INDEX_EDMSG(m_index, m_size, m_msg)                                                                       \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                  \
-    {                                                                                                                      \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
-        return;                                                                                                            \
-    }                                                                                                                      \
-    else                                                                                                                   \
+#define ERR_FAIL_INDEX_EDMSG(m_index, m_size, m_msg)                                                                         \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                    \
+    {                                                                                                                        \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
+        return;                                                                                                              \
+    }                                                                                                                        \
+    else                                                                                                                     \
         ((void)0)
 
 /**
@@ -206,38 +288,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, the current function returns `m_retval`.
  */
-#define ERR_FAIL_INDEX_V(m_index, m_size, m_retval)                                                           \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                     \
-    {                                                                                                         \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size)); \
-        return m_retval;                                                                                      \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_INDEX_V(m_index, m_size, m_retval)                                                             \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                       \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size)); \
+        return m_retval;                                                                                        \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, prints `m_msg` and the current function returns `m_retval`.
  */
-#define ERR_FAIL_INDEX_V_MSG(m_index, m_size, m_retval, m_msg)                                                       \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                            \
-    {                                                                                                                \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
-        return m_retval;                                                                                             \
-    }                                                                                                                \
-    else                                                                                                             \
+#define ERR_FAIL_INDEX_V_MSG(m_index, m_size, m_retval, m_msg)                                                         \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                              \
+    {                                                                                                                  \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
+        return m_retval;                                                                                               \
+    }                                                                                                                  \
+    else                                                                                                               \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_INDEX_V_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_INDEX_V_EDMSG(m_index, m_size, m_retval, m_msg)                                                           \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                  \
-    {                                                                                                                      \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
-        return m_retval;                                                                                                   \
-    }                                                                                                                      \
-    else                                                                                                                   \
+#define ERR_FAIL_INDEX_V_EDMSG(m_index, m_size, m_retval, m_msg)                                                             \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                    \
+    {                                                                                                                        \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
+        return m_retval;                                                                                                     \
+    }                                                                                                                        \
+    else                                                                                                                     \
         ((void)0)
 
 /**
@@ -248,14 +330,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, the application crashes.
  */
-#define CRASH_BAD_INDEX(m_index, m_size)                                                                                       \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                      \
-    {                                                                                                                          \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), "", false, true); \
-        errorFlushStdout();                                                                                                    \
-        GENERATE_TRAP();                                                                                                       \
-    }                                                                                                                          \
-    else                                                                                                                       \
+#define CRASH_BAD_INDEX(m_index, m_size)                                                                                         \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                        \
+    {                                                                                                                            \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), "", false, true); \
+        errorFlushStdout();                                                                                                      \
+        GENERATE_TRAP();                                                                                                         \
+    }                                                                                                                            \
+    else                                                                                                                         \
         ((void)0)
 
 /**
@@ -265,14 +347,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an integer index `m_index` is less than `m_size` and greater than or equal to 0.
  * If not, prints `m_msg` and the application crashes.
  */
-#define CRASH_BAD_INDEX_MSG(m_index, m_size, m_msg)                                                                               \
-    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                         \
-    {                                                                                                                             \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, false, true); \
-        errorFlushStdout();                                                                                                       \
-        GENERATE_TRAP();                                                                                                          \
-    }                                                                                                                             \
-    else                                                                                                                          \
+#define CRASH_BAD_INDEX_MSG(m_index, m_size, m_msg)                                                                                 \
+    if (unlikely((m_index) < 0 || (m_index) >= (m_size)))                                                                           \
+    {                                                                                                                               \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, false, true); \
+        errorFlushStdout();                                                                                                         \
+        GENERATE_TRAP();                                                                                                            \
+    }                                                                                                                               \
+    else                                                                                                                            \
         ((void)0)
 
 // Unsigned integer index out of bounds error macros.
@@ -284,38 +366,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, the current function returns.
  */
-#define ERR_FAIL_UNSIGNED_INDEX(m_index, m_size)                                                              \
-    if (unlikely((m_index) >= (m_size)))                                                                      \
-    {                                                                                                         \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size)); \
-        return;                                                                                               \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_UNSIGNED_INDEX(m_index, m_size)                                                                \
+    if (unlikely((m_index) >= (m_size)))                                                                        \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size)); \
+        return;                                                                                                 \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, prints `m_msg` and the current function returns.
  */
-#define ERR_FAIL_UNSIGNED_INDEX_MSG(m_index, m_size, m_msg)                                                          \
-    if (unlikely((m_index) >= (m_size)))                                                                             \
-    {                                                                                                                \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
-        return;                                                                                                      \
-    }                                                                                                                \
-    else                                                                                                             \
+#define ERR_FAIL_UNSIGNED_INDEX_MSG(m_index, m_size, m_msg)                                                            \
+    if (unlikely((m_index) >= (m_size)))                                                                               \
+    {                                                                                                                  \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
+        return;                                                                                                        \
+    }                                                                                                                  \
+    else                                                                                                               \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_UNSIGNED_INDEX_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_UNSIGNED_INDEX_EDMSG(m_index, m_size, m_msg)                                                              \
-    if (unlikely((m_index) >= (m_size)))                                                                                   \
-    {                                                                                                                      \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
-        return;                                                                                                            \
-    }                                                                                                                      \
-    else                                                                                                                   \
+#define ERR_FAIL_UNSIGNED_INDEX_EDMSG(m_index, m_size, m_msg)                                                                \
+    if (unlikely((m_index) >= (m_size)))                                                                                     \
+    {                                                                                                                        \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
+        return;                                                                                                              \
+    }                                                                                                                        \
+    else                                                                                                                     \
         ((void)0)
 
 /**
@@ -325,38 +407,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, the current function returns `m_retval`.
  */
-#define ERR_FAIL_UNSIGNED_INDEX_V(m_index, m_size, m_retval)                                                  \
-    if (unlikely((m_index) >= (m_size)))                                                                      \
-    {                                                                                                         \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size)); \
-        return m_retval;                                                                                      \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_UNSIGNED_INDEX_V(m_index, m_size, m_retval)                                                    \
+    if (unlikely((m_index) >= (m_size)))                                                                        \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size)); \
+        return m_retval;                                                                                        \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, prints `m_msg` and the current function returns `m_retval`.
  */
-#define ERR_FAIL_UNSIGNED_INDEX_V_MSG(m_index, m_size, m_retval, m_msg)                                              \
-    if (unlikely((m_index) >= (m_size)))                                                                             \
-    {                                                                                                                \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
-        return m_retval;                                                                                             \
-    }                                                                                                                \
-    else                                                                                                             \
+#define ERR_FAIL_UNSIGNED_INDEX_V_MSG(m_index, m_size, m_retval, m_msg)                                                \
+    if (unlikely((m_index) >= (m_size)))                                                                               \
+    {                                                                                                                  \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg); \
+        return m_retval;                                                                                               \
+    }                                                                                                                  \
+    else                                                                                                               \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_UNSIGNED_INDEX_V_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_UNSIGNED_INDEX_V_EDMSG(m_index, m_size, m_retval, m_msg)                                                  \
-    if (unlikely((m_index) >= (m_size)))                                                                                   \
-    {                                                                                                                      \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
-        return m_retval;                                                                                                   \
-    }                                                                                                                      \
-    else                                                                                                                   \
+#define ERR_FAIL_UNSIGNED_INDEX_V_EDMSG(m_index, m_size, m_retval, m_msg)                                                    \
+    if (unlikely((m_index) >= (m_size)))                                                                                     \
+    {                                                                                                                        \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, true); \
+        return m_retval;                                                                                                     \
+    }                                                                                                                        \
+    else                                                                                                                     \
         ((void)0)
 
 /**
@@ -367,14 +449,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, the application crashes.
  */
-#define CRASH_BAD_UNSIGNED_INDEX(m_index, m_size)                                                                              \
-    if (unlikely((m_index) >= (m_size)))                                                                                       \
-    {                                                                                                                          \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), "", false, true); \
-        errorFlushStdout();                                                                                                    \
-        GENERATE_TRAP();                                                                                                       \
-    }                                                                                                                          \
-    else                                                                                                                       \
+#define CRASH_BAD_UNSIGNED_INDEX(m_index, m_size)                                                                                \
+    if (unlikely((m_index) >= (m_size)))                                                                                         \
+    {                                                                                                                            \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), "", false, true); \
+        errorFlushStdout();                                                                                                      \
+        GENERATE_TRAP();                                                                                                         \
+    }                                                                                                                            \
+    else                                                                                                                         \
         ((void)0)
 
 /**
@@ -384,14 +466,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures an unsigned integer index `m_index` is less than `m_size`.
  * If not, prints `m_msg` and the application crashes.
  */
-#define CRASH_BAD_UNSIGNED_INDEX_MSG(m_index, m_size, m_msg)                                                                      \
-    if (unlikely((m_index) >= (m_size)))                                                                                          \
-    {                                                                                                                             \
-        errorPrintIndexError(FUNCTION_STR, __FILE__, __LINE__, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, false, true); \
-        errorFlushStdout();                                                                                                       \
-        GENERATE_TRAP();                                                                                                          \
-    }                                                                                                                             \
-    else                                                                                                                          \
+#define CRASH_BAD_UNSIGNED_INDEX_MSG(m_index, m_size, m_msg)                                                                        \
+    if (unlikely((m_index) >= (m_size)))                                                                                            \
+    {                                                                                                                               \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintIndexError, m_index, m_size, _STR(m_index), _STR(m_size), m_msg, false, true); \
+        errorFlushStdout();                                                                                                         \
+        GENERATE_TRAP();                                                                                                            \
+    }                                                                                                                               \
+    else                                                                                                                            \
         ((void)0)
 
 // Null reference error macros.
@@ -403,38 +485,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures a pointer `m_param` is not null.
  * If it is null, the current function returns.
  */
-#define ERR_FAIL_NULL(m_param)                                                                         \
-    if (unlikely(m_param == nullptr))                                                                  \
-    {                                                                                                  \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null."); \
-        return;                                                                                        \
-    }                                                                                                  \
-    else                                                                                               \
+#define ERR_FAIL_NULL(m_param)                                                                           \
+    if (unlikely(m_param == nullptr))                                                                    \
+    {                                                                                                    \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null."); \
+        return;                                                                                          \
+    }                                                                                                    \
+    else                                                                                                 \
         ((void)0)
 
 /**
  * Ensures a pointer `m_param` is not null.
  * If it is null, prints `m_msg` and the current function returns.
  */
-#define ERR_FAIL_NULL_MSG(m_param, m_msg)                                                                     \
-    if (unlikely(m_param == nullptr))                                                                         \
-    {                                                                                                         \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null.", m_msg); \
-        return;                                                                                               \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_NULL_MSG(m_param, m_msg)                                                                       \
+    if (unlikely(m_param == nullptr))                                                                           \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null.", m_msg); \
+        return;                                                                                                 \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_NULL_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_NULL_EDMSG(m_param, m_msg)                                                                         \
-    if (unlikely(m_param == nullptr))                                                                               \
-    {                                                                                                               \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null.", m_msg, true); \
-        return;                                                                                                     \
-    }                                                                                                               \
-    else                                                                                                            \
+#define ERR_FAIL_NULL_EDMSG(m_param, m_msg)                                                                           \
+    if (unlikely(m_param == nullptr))                                                                                 \
+    {                                                                                                                 \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null.", m_msg, true); \
+        return;                                                                                                       \
+    }                                                                                                                 \
+    else                                                                                                              \
         ((void)0)
 
 /**
@@ -444,38 +526,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures a pointer `m_param` is not null.
  * If it is null, the current function returns `m_retval`.
  */
-#define ERR_FAIL_NULL_V(m_param, m_retval)                                                             \
-    if (unlikely(m_param == nullptr))                                                                  \
-    {                                                                                                  \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null."); \
-        return m_retval;                                                                               \
-    }                                                                                                  \
-    else                                                                                               \
+#define ERR_FAIL_NULL_V(m_param, m_retval)                                                               \
+    if (unlikely(m_param == nullptr))                                                                    \
+    {                                                                                                    \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null."); \
+        return m_retval;                                                                                 \
+    }                                                                                                    \
+    else                                                                                                 \
         ((void)0)
 
 /**
  * Ensures a pointer `m_param` is not null.
  * If it is null, prints `m_msg` and the current function returns `m_retval`.
  */
-#define ERR_FAIL_NULL_V_MSG(m_param, m_retval, m_msg)                                                         \
-    if (unlikely(m_param == nullptr))                                                                         \
-    {                                                                                                         \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null.", m_msg); \
-        return m_retval;                                                                                      \
-    }                                                                                                         \
-    else                                                                                                      \
+#define ERR_FAIL_NULL_V_MSG(m_param, m_retval, m_msg)                                                           \
+    if (unlikely(m_param == nullptr))                                                                           \
+    {                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null.", m_msg); \
+        return m_retval;                                                                                        \
+    }                                                                                                           \
+    else                                                                                                        \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_NULL_V_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_NULL_V_EDMSG(m_param, m_retval, m_msg)                                                             \
-    if (unlikely(m_param == nullptr))                                                                               \
-    {                                                                                                               \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Parameter \"" _STR(m_param) "\" is null.", m_msg, true); \
-        return m_retval;                                                                                            \
-    }                                                                                                               \
-    else                                                                                                            \
+#define ERR_FAIL_NULL_V_EDMSG(m_param, m_retval, m_msg)                                                               \
+    if (unlikely(m_param == nullptr))                                                                                 \
+    {                                                                                                                 \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Parameter \"" _STR(m_param) "\" is null.", m_msg, true); \
+        return m_retval;                                                                                              \
+    }                                                                                                                 \
+    else                                                                                                              \
         ((void)0)
 
 /**
@@ -487,13 +569,13 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, the current function returns.
  */
-#define ERR_FAIL_COND(m_cond)                                                                         \
-    if (unlikely(m_cond))                                                                             \
-    {                                                                                                 \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true."); \
-        return;                                                                                       \
-    }                                                                                                 \
-    else                                                                                              \
+#define ERR_FAIL_COND(m_cond)                                                                           \
+    if (unlikely(m_cond))                                                                               \
+    {                                                                                                   \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true."); \
+        return;                                                                                         \
+    }                                                                                                   \
+    else                                                                                                \
         ((void)0)
 
 /**
@@ -503,25 +585,25 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * If checking for null use ERR_FAIL_NULL_MSG instead.
  * If checking index bounds use ERR_FAIL_INDEX_MSG instead.
  */
-#define ERR_FAIL_COND_MSG(m_cond, m_msg)                                                                     \
-    if (unlikely(m_cond))                                                                                    \
-    {                                                                                                        \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true.", m_msg); \
-        return;                                                                                              \
-    }                                                                                                        \
-    else                                                                                                     \
+#define ERR_FAIL_COND_MSG(m_cond, m_msg)                                                                       \
+    if (unlikely(m_cond))                                                                                      \
+    {                                                                                                          \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true.", m_msg); \
+        return;                                                                                                \
+    }                                                                                                          \
+    else                                                                                                       \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_COND_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_COND_EDMSG(m_cond, m_msg)                                                                         \
-    if (unlikely(m_cond))                                                                                          \
-    {                                                                                                              \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true.", m_msg, true); \
-        return;                                                                                                    \
-    }                                                                                                              \
-    else                                                                                                           \
+#define ERR_FAIL_COND_EDMSG(m_cond, m_msg)                                                                           \
+    if (unlikely(m_cond))                                                                                            \
+    {                                                                                                                \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true.", m_msg, true); \
+        return;                                                                                                      \
+    }                                                                                                                \
+    else                                                                                                             \
         ((void)0)
 
 /**
@@ -533,13 +615,13 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, the current function returns `m_retval`.
  */
-#define ERR_FAIL_COND_V(m_cond, m_retval)                                                                                        \
-    if (unlikely(m_cond))                                                                                                        \
-    {                                                                                                                            \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval)); \
-        return m_retval;                                                                                                         \
-    }                                                                                                                            \
-    else                                                                                                                         \
+#define ERR_FAIL_COND_V(m_cond, m_retval)                                                                                          \
+    if (unlikely(m_cond))                                                                                                          \
+    {                                                                                                                              \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval)); \
+        return m_retval;                                                                                                           \
+    }                                                                                                                              \
+    else                                                                                                                           \
         ((void)0)
 
 /**
@@ -549,25 +631,25 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * If checking for null use ERR_FAIL_NULL_V_MSG instead.
  * If checking index bounds use ERR_FAIL_INDEX_V_MSG instead.
  */
-#define ERR_FAIL_COND_V_MSG(m_cond, m_retval, m_msg)                                                                                    \
-    if (unlikely(m_cond))                                                                                                               \
-    {                                                                                                                                   \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval), m_msg); \
-        return m_retval;                                                                                                                \
-    }                                                                                                                                   \
-    else                                                                                                                                \
+#define ERR_FAIL_COND_V_MSG(m_cond, m_retval, m_msg)                                                                                      \
+    if (unlikely(m_cond))                                                                                                                 \
+    {                                                                                                                                     \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval), m_msg); \
+        return m_retval;                                                                                                                  \
+    }                                                                                                                                     \
+    else                                                                                                                                  \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_COND_V_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_COND_V_EDMSG(m_cond, m_retval, m_msg)                                                                                        \
-    if (unlikely(m_cond))                                                                                                                     \
-    {                                                                                                                                         \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval), m_msg, true); \
-        return m_retval;                                                                                                                      \
-    }                                                                                                                                         \
-    else                                                                                                                                      \
+#define ERR_FAIL_COND_V_EDMSG(m_cond, m_retval, m_msg)                                                                                          \
+    if (unlikely(m_cond))                                                                                                                       \
+    {                                                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Returning: " _STR(m_retval), m_msg, true); \
+        return m_retval;                                                                                                                        \
+    }                                                                                                                                           \
+    else                                                                                                                                        \
         ((void)0)
 
 /**
@@ -577,38 +659,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, the current loop continues.
  */
-#define ERR_CONTINUE(m_cond)                                                                                      \
-    if (unlikely(m_cond))                                                                                         \
-    {                                                                                                             \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Continuing."); \
-        continue;                                                                                                 \
-    }                                                                                                             \
-    else                                                                                                          \
+#define ERR_CONTINUE(m_cond)                                                                                        \
+    if (unlikely(m_cond))                                                                                           \
+    {                                                                                                               \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Continuing."); \
+        continue;                                                                                                   \
+    }                                                                                                               \
+    else                                                                                                            \
         ((void)0)
 
 /**
  * Ensures `m_cond` is false.
  * If `m_cond` is true, prints `m_msg` and the current loop continues.
  */
-#define ERR_CONTINUE_MSG(m_cond, m_msg)                                                                                  \
-    if (unlikely(m_cond))                                                                                                \
-    {                                                                                                                    \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Continuing.", m_msg); \
-        continue;                                                                                                        \
-    }                                                                                                                    \
-    else                                                                                                                 \
+#define ERR_CONTINUE_MSG(m_cond, m_msg)                                                                                    \
+    if (unlikely(m_cond))                                                                                                  \
+    {                                                                                                                      \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Continuing.", m_msg); \
+        continue;                                                                                                          \
+    }                                                                                                                      \
+    else                                                                                                                   \
         ((void)0)
 
 /**
  * Same as `ERR_CONTINUE_MSG` but also notifies the editor.
  */
-#define ERR_CONTINUE_EDMSG(m_cond, m_msg)                                                                                      \
-    if (unlikely(m_cond))                                                                                                      \
-    {                                                                                                                          \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Continuing.", m_msg, true); \
-        continue;                                                                                                              \
-    }                                                                                                                          \
-    else                                                                                                                       \
+#define ERR_CONTINUE_EDMSG(m_cond, m_msg)                                                                                        \
+    if (unlikely(m_cond))                                                                                                        \
+    {                                                                                                                            \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Continuing.", m_msg, true); \
+        continue;                                                                                                                \
+    }                                                                                                                            \
+    else                                                                                                                         \
         ((void)0)
 
 /**
@@ -618,38 +700,38 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, the current loop breaks.
  */
-#define ERR_BREAK(m_cond)                                                                                       \
-    if (unlikely(m_cond))                                                                                       \
-    {                                                                                                           \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Breaking."); \
-        break;                                                                                                  \
-    }                                                                                                           \
-    else                                                                                                        \
+#define ERR_BREAK(m_cond)                                                                                         \
+    if (unlikely(m_cond))                                                                                         \
+    {                                                                                                             \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Breaking."); \
+        break;                                                                                                    \
+    }                                                                                                             \
+    else                                                                                                          \
         ((void)0)
 
 /**
  * Ensures `m_cond` is false.
  * If `m_cond` is true, prints `m_msg` and the current loop breaks.
  */
-#define ERR_BREAK_MSG(m_cond, m_msg)                                                                                   \
-    if (unlikely(m_cond))                                                                                              \
-    {                                                                                                                  \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Breaking.", m_msg); \
-        break;                                                                                                         \
-    }                                                                                                                  \
-    else                                                                                                               \
+#define ERR_BREAK_MSG(m_cond, m_msg)                                                                                     \
+    if (unlikely(m_cond))                                                                                                \
+    {                                                                                                                    \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Breaking.", m_msg); \
+        break;                                                                                                           \
+    }                                                                                                                    \
+    else                                                                                                                 \
         ((void)0)
 
 /**
  * Same as `ERR_BREAK_MSG` but also notifies the editor.
  */
-#define ERR_BREAK_EDMSG(m_cond, m_msg)                                                                                       \
-    if (unlikely(m_cond))                                                                                                    \
-    {                                                                                                                        \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Condition \"" _STR(m_cond) "\" is true. Breaking.", m_msg, true); \
-        break;                                                                                                               \
-    }                                                                                                                        \
-    else                                                                                                                     \
+#define ERR_BREAK_EDMSG(m_cond, m_msg)                                                                                         \
+    if (unlikely(m_cond))                                                                                                      \
+    {                                                                                                                          \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Condition \"" _STR(m_cond) "\" is true. Breaking.", m_msg, true); \
+        break;                                                                                                                 \
+    }                                                                                                                          \
+    else                                                                                                                       \
         ((void)0)
 
 /**
@@ -660,14 +742,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, the application crashes.
  */
-#define CRASH_COND(m_cond)                                                                                   \
-    if (unlikely(m_cond))                                                                                    \
-    {                                                                                                        \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "FATAL: Condition \"" _STR(m_cond) "\" is true."); \
-        errorFlushStdout();                                                                                  \
-        GENERATE_TRAP();                                                                                     \
-    }                                                                                                        \
-    else                                                                                                     \
+#define CRASH_COND(m_cond)                                                                                     \
+    if (unlikely(m_cond))                                                                                      \
+    {                                                                                                          \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintError, "FATAL: Condition \"" _STR(m_cond) "\" is true."); \
+        errorFlushStdout();                                                                                    \
+        GENERATE_TRAP();                                                                                       \
+    }                                                                                                          \
+    else                                                                                                       \
         ((void)0)
 
 /**
@@ -677,14 +759,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Ensures `m_cond` is false.
  * If `m_cond` is true, prints `m_msg` and the application crashes.
  */
-#define CRASH_COND_MSG(m_cond, m_msg)                                                                               \
-    if (unlikely(m_cond))                                                                                           \
-    {                                                                                                               \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "FATAL: Condition \"" _STR(m_cond) "\" is true.", m_msg); \
-        errorFlushStdout();                                                                                         \
-        GENERATE_TRAP();                                                                                            \
-    }                                                                                                               \
-    else                                                                                                            \
+#define CRASH_COND_MSG(m_cond, m_msg)                                                                                 \
+    if (unlikely(m_cond))                                                                                             \
+    {                                                                                                                 \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintError, "FATAL: Condition \"" _STR(m_cond) "\" is true.", m_msg); \
+        errorFlushStdout();                                                                                           \
+        GENERATE_TRAP();                                                                                              \
+    }                                                                                                                 \
+    else                                                                                                              \
         ((void)0)
 
 // Generic error macros.
@@ -696,13 +778,13 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * The current function returns.
  */
-#define ERR_FAIL()                                                                    \
-    if (true)                                                                         \
-    {                                                                                 \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed."); \
-        return;                                                                       \
-    }                                                                                 \
-    else                                                                              \
+#define ERR_FAIL()                                                                      \
+    if (true)                                                                           \
+    {                                                                                   \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed."); \
+        return;                                                                         \
+    }                                                                                   \
+    else                                                                                \
         ((void)0)
 
 /**
@@ -711,25 +793,25 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * Prints `m_msg`, and the current function returns.
  */
-#define ERR_FAIL_MSG(m_msg)                                                                  \
-    if (true)                                                                                \
-    {                                                                                        \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed.", m_msg); \
-        return;                                                                              \
-    }                                                                                        \
-    else                                                                                     \
+#define ERR_FAIL_MSG(m_msg)                                                                    \
+    if (true)                                                                                  \
+    {                                                                                          \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed.", m_msg); \
+        return;                                                                                \
+    }                                                                                          \
+    else                                                                                       \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_EDMSG(m_msg)                                                                      \
-    if (true)                                                                                      \
-    {                                                                                              \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed.", m_msg, true); \
-        return;                                                                                    \
-    }                                                                                              \
-    else                                                                                           \
+#define ERR_FAIL_EDMSG(m_msg)                                                                        \
+    if (true)                                                                                        \
+    {                                                                                                \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed.", m_msg, true); \
+        return;                                                                                      \
+    }                                                                                                \
+    else                                                                                             \
         ((void)0)
 
 /**
@@ -739,13 +821,13 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * The current function returns `m_retval`.
  */
-#define ERR_FAIL_V(m_retval)                                                                                     \
-    if (true)                                                                                                    \
-    {                                                                                                            \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed. Returning: " _STR(m_retval)); \
-        return m_retval;                                                                                         \
-    }                                                                                                            \
-    else                                                                                                         \
+#define ERR_FAIL_V(m_retval)                                                                                       \
+    if (true)                                                                                                      \
+    {                                                                                                              \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed. Returning: " _STR(m_retval)); \
+        return m_retval;                                                                                           \
+    }                                                                                                              \
+    else                                                                                                           \
         ((void)0)
 
 /**
@@ -754,25 +836,25 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * Prints `m_msg`, and the current function returns `m_retval`.
  */
-#define ERR_FAIL_V_MSG(m_retval, m_msg)                                                                                 \
-    if (true)                                                                                                           \
-    {                                                                                                                   \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed. Returning: " _STR(m_retval), m_msg); \
-        return m_retval;                                                                                                \
-    }                                                                                                                   \
-    else                                                                                                                \
+#define ERR_FAIL_V_MSG(m_retval, m_msg)                                                                                   \
+    if (true)                                                                                                             \
+    {                                                                                                                     \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed. Returning: " _STR(m_retval), m_msg); \
+        return m_retval;                                                                                                  \
+    }                                                                                                                     \
+    else                                                                                                                  \
         ((void)0)
 
 /**
  * Same as `ERR_FAIL_V_MSG` but also notifies the editor.
  */
-#define ERR_FAIL_V_EDMSG(m_retval, m_msg)                                                                                     \
-    if (true)                                                                                                                 \
-    {                                                                                                                         \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "Method/function failed. Returning: " _STR(m_retval), m_msg, true); \
-        return m_retval;                                                                                                      \
-    }                                                                                                                         \
-    else                                                                                                                      \
+#define ERR_FAIL_V_EDMSG(m_retval, m_msg)                                                                                       \
+    if (true)                                                                                                                   \
+    {                                                                                                                           \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "Method/function failed. Returning: " _STR(m_retval), m_msg, true); \
+        return m_retval;                                                                                                        \
+    }                                                                                                                           \
+    else                                                                                                                        \
         ((void)0)
 
 /**
@@ -782,45 +864,55 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * Prints `m_msg`.
  */
-#define ERR_PRINT(m_msg) \
-    errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg)
+#define ERR_PRINT(m_msg)                                            \
+    if (true)                                                       \
+    {                                                               \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, m_msg); \
+    }                                                               \
+    else                                                            \
+        ((void)0)
 
 /**
  * Same as `ERR_PRINT` but also notifies the editor.
  */
-#define ERR_PRINT_ED(m_msg) \
-    errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, true)
+#define ERR_PRINT_ED(m_msg)                                               \
+    if (true)                                                             \
+    {                                                                     \
+        _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, m_msg, true); \
+    }                                                                     \
+    else                                                                  \
+        ((void)0)
 
 /**
  * Prints `m_msg` once during the application lifetime.
  */
-#define ERR_PRINT_ONCE(m_msg)                                         \
-    if (true)                                                         \
-    {                                                                 \
-        static bool warning_shown = false;                            \
-        if (unlikely(!warning_shown))                                 \
-        {                                                             \
-            warning_shown = true;                                     \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg); \
-        }                                                             \
-    }                                                                 \
-    else                                                              \
+#define ERR_PRINT_ONCE(m_msg)                                           \
+    if (true)                                                           \
+    {                                                                   \
+        static bool warning_shown = false;                              \
+        if (unlikely(!warning_shown))                                   \
+        {                                                               \
+            warning_shown = true;                                       \
+            _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, m_msg); \
+        }                                                               \
+    }                                                                   \
+    else                                                                \
         ((void)0)
 
 /**
  * Same as `ERR_PRINT_ONCE` but also notifies the editor.
  */
-#define ERR_PRINT_ONCE_ED(m_msg)                                            \
-    if (true)                                                               \
-    {                                                                       \
-        static bool warning_shown = false;                                  \
-        if (unlikely(!warning_shown))                                       \
-        {                                                                   \
-            warning_shown = true;                                           \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, true); \
-        }                                                                   \
-    }                                                                       \
-    else                                                                    \
+#define ERR_PRINT_ONCE_ED(m_msg)                                              \
+    if (true)                                                                 \
+    {                                                                         \
+        static bool warning_shown = false;                                    \
+        if (unlikely(!warning_shown))                                         \
+        {                                                                     \
+            warning_shown = true;                                             \
+            _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, m_msg, true); \
+        }                                                                     \
+    }                                                                         \
+    else                                                                      \
         ((void)0)
 
 // Print warning message macros.
@@ -830,47 +922,57 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * If warning about deprecated usage, use `WARN_DEPRECATED` or `WARN_DEPRECATED_MSG` instead.
  */
-#define WARN_PRINT(m_msg) \
-    errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ERR_HANDLER_WARNING)
+#define WARN_PRINT(m_msg)                                                                           \
+    if (true)                                                                                       \
+    {                                                                                               \
+        _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, m_msg, false, ERROR_HANDLER_WARNING); \
+    }                                                                                               \
+    else                                                                                            \
+        ((void)0)
 
 /**
  * Same as `WARN_PRINT` but also notifies the editor.
  */
-#define WARN_PRINT_ED(m_msg) \
-    errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ERR_HANDLER_WARNING)
+#define WARN_PRINT_ED(m_msg)                                                                       \
+    if (true)                                                                                      \
+    {                                                                                              \
+        _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, m_msg, true, ERROR_HANDLER_WARNING); \
+    }                                                                                              \
+    else                                                                                           \
+        ((void)0)
 
 /**
  * Prints `m_msg` once during the application lifetime.
  *
  * If warning about deprecated usage, use `WARN_DEPRECATED` or `WARN_DEPRECATED_MSG` instead.
  */
-#define WARN_PRINT_ONCE(m_msg)                                                                    \
-    if (true)                                                                                     \
-    {                                                                                             \
-        static bool warning_shown = false;                                                        \
-        if (unlikely(!warning_shown))                                                             \
-        {                                                                                         \
-            warning_shown = true;                                                                 \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, false, ERR_HANDLER_WARNING); \
-        }                                                                                         \
-    }                                                                                             \
-    else                                                                                          \
+#define WARN_PRINT_ONCE(m_msg)                                                                          \
+    if (true)                                                                                           \
+    {                                                                                                   \
+        static bool warning_shown = false;                                                              \
+        if (unlikely(!warning_shown))                                                                   \
+        {                                                                                               \
+            warning_shown = true;                                                                       \
+            _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, m_msg, false, ERROR_HANDLER_WARNING); \
+        }                                                                                               \
+    }                                                                                                   \
+    else                                                                                                \
         ((void)0)
 
 /**
  * Same as `WARN_PRINT_ONCE` but also notifies the editor.
  */
-#define WARN_PRINT_ONCE_ED(m_msg)                                                                \
-    if (true)                                                                                    \
-    {                                                                                            \
-        static bool warning_shown = false;                                                       \
-        if (unlikely(!warning_shown))                                                            \
-        {                                                                                        \
-            warning_shown = true;                                                                \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, m_msg, true, ERR_HANDLER_WARNING); \
-        }                                                                                        \
-    }                                                                                            \
-    else                                                                                         \
+#define WARN_PRINT_ONCE_ED(m_msg)                                                                      \
+    if (true)                                                                                          \
+    {                                                                                                  \
+        static bool warning_shown = false;                                                             \
+        if (unlikely(!warning_shown))                                                                  \
+        {                                                                                              \
+            warning_shown = true;                                                                      \
+            _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, m_msg, true, ERROR_HANDLER_WARNING); \
+        }                                                                                              \
+    }                                                                                                  \
+    else                                                                                               \
         ((void)0)
 
 /**
@@ -889,33 +991,33 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
 /**
  * Warns that the current function is deprecated.
  */
-#define WARN_DEPRECATED                                                                                                                                          \
-    if (true)                                                                                                                                                    \
-    {                                                                                                                                                            \
-        static bool warning_shown = false;                                                                                                                       \
-        if (unlikely(!warning_shown))                                                                                                                            \
-        {                                                                                                                                                        \
-            warning_shown = true;                                                                                                                                \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", false, ERR_HANDLER_WARNING); \
-        }                                                                                                                                                        \
-    }                                                                                                                                                            \
-    else                                                                                                                                                         \
+#define WARN_DEPRECATED                                                                                                                                                \
+    if (true)                                                                                                                                                          \
+    {                                                                                                                                                                  \
+        static bool warning_shown = false;                                                                                                                             \
+        if (unlikely(!warning_shown))                                                                                                                                  \
+        {                                                                                                                                                              \
+            warning_shown = true;                                                                                                                                      \
+            _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, "This method has been deprecated and will be removed in the future.", false, ERROR_HANDLER_WARNING); \
+        }                                                                                                                                                              \
+    }                                                                                                                                                                  \
+    else                                                                                                                                                               \
         ((void)0)
 
 /**
  * Warns that the current function is deprecated and prints `m_msg`.
  */
-#define WARN_DEPRECATED_MSG(m_msg)                                                                                                                                      \
-    if (true)                                                                                                                                                           \
-    {                                                                                                                                                                   \
-        static bool warning_shown = false;                                                                                                                              \
-        if (unlikely(!warning_shown))                                                                                                                                   \
-        {                                                                                                                                                               \
-            warning_shown = true;                                                                                                                                       \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "This method has been deprecated and will be removed in the future.", m_msg, false, ERR_HANDLER_WARNING); \
-        }                                                                                                                                                               \
-    }                                                                                                                                                                   \
-    else                                                                                                                                                                \
+#define WARN_DEPRECATED_MSG(m_msg)                                                                                                                                            \
+    if (true)                                                                                                                                                                 \
+    {                                                                                                                                                                         \
+        static bool warning_shown = false;                                                                                                                                    \
+        if (unlikely(!warning_shown))                                                                                                                                         \
+        {                                                                                                                                                                     \
+            warning_shown = true;                                                                                                                                             \
+            _ERR_SITE_REPORT(ERROR_SITE_WARNING, errorPrintError, "This method has been deprecated and will be removed in the future.", m_msg, false, ERROR_HANDLER_WARNING); \
+        }                                                                                                                                                                     \
+    }                                                                                                                                                                         \
+    else                                                                                                                                                                      \
         ((void)0)
 
 /**
@@ -924,14 +1026,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * The application crashes.
  */
-#define CRASH_NOW()                                                                          \
-    if (true)                                                                                \
-    {                                                                                        \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "FATAL: Method/function failed."); \
-        errorFlushStdout();                                                                  \
-        GENERATE_TRAP();                                                                     \
-    }                                                                                        \
-    else                                                                                     \
+#define CRASH_NOW()                                                                            \
+    if (true)                                                                                  \
+    {                                                                                          \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintError, "FATAL: Method/function failed."); \
+        errorFlushStdout();                                                                    \
+        GENERATE_TRAP();                                                                       \
+    }                                                                                          \
+    else                                                                                       \
         ((void)0)
 
 /**
@@ -939,14 +1041,14 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *
  * Prints `m_msg`, and then the application crashes.
  */
-#define CRASH_NOW_MSG(m_msg)                                                                        \
-    if (true)                                                                                       \
-    {                                                                                               \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "FATAL: Method/function failed.", m_msg); \
-        errorFlushStdout();                                                                         \
-        GENERATE_TRAP();                                                                            \
-    }                                                                                               \
-    else                                                                                            \
+#define CRASH_NOW_MSG(m_msg)                                                                          \
+    if (true)                                                                                         \
+    {                                                                                                 \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintError, "FATAL: Method/function failed.", m_msg); \
+        errorFlushStdout();                                                                           \
+        GENERATE_TRAP();                                                                              \
+    }                                                                                                 \
+    else                                                                                              \
         ((void)0)
 
 /**
@@ -965,31 +1067,31 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  *    and that can't fail for other contributors once the code is finished and merged.
  */
 #ifdef DEV_ENABLED
-#define DEV_ASSERT(m_cond)                                                                                             \
-    if (unlikely(!(m_cond)))                                                                                           \
-    {                                                                                                                  \
-        errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "FATAL: DEV_ASSERT failed  \"" _STR(m_cond) "\" is false."); \
-        errorFlushStdout();                                                                                            \
-        GENERATE_TRAP();                                                                                               \
-    }                                                                                                                  \
-    else                                                                                                               \
+#define DEV_ASSERT(m_cond)                                                                                               \
+    if (unlikely(!(m_cond)))                                                                                             \
+    {                                                                                                                    \
+        _ERR_SITE_REPORT(ERROR_SITE_CRASH, errorPrintError, "FATAL: DEV_ASSERT failed  \"" _STR(m_cond) "\" is false."); \
+        errorFlushStdout();                                                                                              \
+        GENERATE_TRAP();                                                                                                 \
+    }                                                                                                                    \
+    else                                                                                                                 \
         ((void)0)
 #else
 #define DEV_ASSERT(m_cond)
 #endif
 
 #ifdef DEV_ENABLED
-#define DEV_CHECK_ONCE(m_cond)                                                                                          \
-    if (true)                                                                                                           \
-    {                                                                                                                   \
-        static bool first_print = true;                                                                                 \
-        if (first_print && unlikely(!(m_cond)))                                                                         \
-        {                                                                                                               \
-            errorPrintError(FUNCTION_STR, __FILE__, __LINE__, "DEV_CHECK_ONCE failed  \"" _STR(m_cond) "\" is false."); \
-            first_print = false;                                                                                        \
-        }                                                                                                               \
-    }                                                                                                                   \
-    else                                                                                                                \
+#define DEV_CHECK_ONCE(m_cond)                                                                                            \
+    if (true)                                                                                                             \
+    {                                                                                                                     \
+        static bool first_print = true;                                                                                   \
+        if (first_print && unlikely(!(m_cond)))                                                                           \
+        {                                                                                                                 \
+            _ERR_SITE_REPORT(ERROR_SITE_ERROR, errorPrintError, "DEV_CHECK_ONCE failed  \"" _STR(m_cond) "\" is false."); \
+            first_print = false;                                                                                          \
+        }                                                                                                                 \
+    }                                                                                                                     \
+    else                                                                                                                  \
         ((void)0)
 #else
 #define DEV_CHECK_ONCE(m_cond)
@@ -999,10 +1101,10 @@ void physicsInterpolationWarning(const char *p_function, const char *p_file, int
  * Physics Interpolation warnings.
  * These are spam protection warnings.
  */
-#define PHYSICS_INTERPOLATION_NODE_WARNING(m_object_id, m_string) \
+#define PHYSICS_INTERPOLATION_NODE_WARNING(m_object_id, m_string)                        \
     physicsInterpolationWarning(FUNCTION_STR, __FILE__, __LINE__, m_object_id, m_string)
 
-#define PHYSICS_INTERPOLATION_WARNING(m_string) \
+#define PHYSICS_INTERPOLATION_WARNING(m_string)                                                   \
     physicsInterpolationWarning(FUNCTION_STR, __FILE__, __LINE__, ObjectID(UINT64_MAX), m_string)
 
 #endif
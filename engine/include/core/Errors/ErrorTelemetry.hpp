@@ -0,0 +1,75 @@
+#ifndef __ENGINE_ERROR_TELEMETRY_HPP__
+#define __ENGINE_ERROR_TELEMETRY_HPP__
+
+#include "ErrorMacros.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Engine {
+    /** Counters of one ERR_*, WARN_* or CRASH_* call site at the time of a snapshot. */
+    struct ErrorSiteStats {
+        const char *function = "";
+        const char *file = "";
+        int_fast32_t line = 0;
+        ErrorSiteKind kind = ERROR_SITE_ERROR;
+        uint64_t hits = 0;
+        /** Hits per second since the baseline's previous snapshot, or since startup without one. */
+        double rate = 0.0;
+    };
+
+    /**
+     * Hits of every site at one consumer's previous snapshot. Each periodic reader keeps its
+     * own, so an ad-hoc snapshot (a debug overlay, a one-off export) does not skew its rates.
+     * Not synchronized, a baseline belongs to one thread at a time.
+     */
+    struct ErrorRateBaseline {
+        std::unordered_map<const ErrorSite *, uint64_t> previousHits;
+        std::chrono::steady_clock::time_point previousTime;
+        bool started = false;
+    };
+
+    /**
+     * Per call site error counters.
+     *
+     * Every site registers itself on its first hit (see ErrorSite), so hitting an error costs
+     * the same relaxed counter increment whether or not anybody reads the telemetry. Snapshots
+     * walk the registered sites without blocking them or changing any state and can be exported
+     * in the Prometheus text format to a file or a TCP socket, once or periodically from a
+     * background thread, which keeps its own ErrorRateBaseline.
+     */
+    class ErrorTelemetry {
+    public:
+        /**
+         * Hottest sites first, by rate and then by total hits. A `limit` of 0 returns every site.
+         * Rates are measured since `baseline`'s previous snapshot, which this one replaces, or
+         * averaged since startup without a baseline.
+         */
+        static std::vector<ErrorSiteStats> snapshot(size_t limit = 0, ErrorRateBaseline *baseline = nullptr);
+
+        static std::string formatMetrics(const std::vector<ErrorSiteStats> &stats);
+
+        /** Writes a temporary file and renames it over `path`, readers never see a partial file. */
+        static bool exportToFile(const std::string &path, ErrorRateBaseline *baseline = nullptr);
+
+        /** Connects to `host`:`port` over TCP and sends the metrics, for a local collector; gives up after a couple of seconds. */
+        static bool exportToSocket(const std::string &host, uint16_t port, ErrorRateBaseline *baseline = nullptr);
+
+        /** Reads ENGINE_ERROR_METRICS (a path or "tcp://host:port") and ENGINE_ERROR_METRICS_INTERVAL (seconds). */
+        static void startFromEnvironment();
+
+        /** Exports to `target`, in the ENGINE_ERROR_METRICS syntax, every `interval` until stop(). */
+        static void start(const std::string &target, std::chrono::seconds interval);
+
+        /** Joins the exporter after one last export. */
+        static void stop();
+
+        static const char *kindName(ErrorSiteKind kind);
+    };
+}
+
+#endif
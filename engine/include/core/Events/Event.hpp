@@ -0,0 +1,242 @@
+#ifndef __ENGINE_EVENT_HPP__
+#define __ENGINE_EVENT_HPP__
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Input/InputEvent.hpp"
+
+namespace Engine {
+    struct WindowResizedEvent {
+        int32_t width = 0;
+        int32_t height = 0;
+    };
+
+    struct ChunkLoadedEvent {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+    };
+
+    struct ChunkUnloadedEvent {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+    };
+
+    struct BlockChangedEvent {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+        uint16_t previousBlock = 0;
+        uint16_t block = 0;
+    };
+
+    /**
+     * Contiguous queue of one event type, drained in batches by dispatch().
+     *
+     * The dispatching thread posts with post(), any other thread with postConcurrent(), which
+     * reserves a slot in a preallocated buffer with one fetch_add. Two such buffers alternate:
+     * dispatch() makes the other one current, waits for the writers still inside the old one
+     * and hands its events to the handlers as a span. Posts past the capacity go to a locked
+     * overflow vector and the buffer grows to fit at the next dispatch, so a steady load stops
+     * allocating after the first ticks.
+     */
+    template <typename T>
+    class EventQueue {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>, "Events are plain data");
+
+    public:
+        /** Called with every batch of the type, possibly several times per dispatch(). */
+        using Handler = std::function<void(std::span<const T> p_events)>;
+
+        static constexpr size_t DEFAULT_CONCURRENT_CAPACITY = 4096;
+
+        explicit EventQueue(size_t p_concurrentCapacity = DEFAULT_CONCURRENT_CAPACITY) {
+            for (ConcurrentBuffer &buffer : m_buffers) {
+                buffer.events.resize(std::max<size_t>(p_concurrentCapacity, 1));
+            }
+        }
+
+        EventQueue(const EventQueue &) = delete;
+        EventQueue &operator=(const EventQueue &) = delete;
+
+        /** Only from the thread that calls dispatch(), events posted by a handler wait for the next dispatch. */
+        void post(const T &p_event) { m_pending.push_back(p_event); }
+
+        /** From any thread, lock-free unless the current buffer is full. */
+        void postConcurrent(const T &p_event) {
+            while (true) {
+                const uint32_t index = m_current.load(std::memory_order_seq_cst);
+                ConcurrentBuffer &buffer = m_buffers[index];
+
+                /** The recheck pairs with the flip in dispatch(), a writer either is counted or sees the new buffer. */
+                buffer.writers.fetch_add(1, std::memory_order_seq_cst);
+                if (m_current.load(std::memory_order_seq_cst) != index) {
+                    buffer.writers.fetch_sub(1, std::memory_order_release);
+                    continue;
+                }
+
+                const size_t slot = buffer.reserved.fetch_add(1, std::memory_order_relaxed);
+                if (slot < buffer.events.size()) {
+                    buffer.events[slot] = p_event;
+                }
+                buffer.writers.fetch_sub(1, std::memory_order_release);
+
+                if (slot < buffer.events.size()) {
+                    return;
+                }
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflow.push_back(p_event);
+        }
+
+        /** Handlers run in subscription order on the dispatching thread. */
+        void subscribe(Handler p_handler) { m_handlers.push_back(std::move(p_handler)); }
+
+        /** Reserves room for `p_count` events per dispatch on both paths, to skip the warm-up growth. */
+        void reserve(size_t p_count) {
+            m_pending.reserve(p_count);
+            m_dispatching.reserve(p_count);
+
+            /** Only the idle buffer is resized now, the current one grows after its next dispatch. */
+            ConcurrentBuffer &idle = m_buffers[m_current.load(std::memory_order_relaxed) ^ 1];
+            if (idle.events.size() < p_count) {
+                idle.events.resize(p_count);
+            }
+            m_growTo = std::max(m_growTo, p_count);
+        }
+
+        /** Hands every event posted so far to the handlers and returns how many there were. */
+        size_t dispatch() {
+            const uint32_t index = m_current.load(std::memory_order_relaxed);
+            m_current.store(index ^ 1, std::memory_order_seq_cst);
+
+            ConcurrentBuffer &buffer = m_buffers[index];
+            while (buffer.writers.load(std::memory_order_acquire) != 0) {
+                std::this_thread::yield();
+            }
+
+            const size_t reserved = buffer.reserved.load(std::memory_order_relaxed);
+            const size_t concurrentCount = std::min(reserved, buffer.events.size());
+            if (reserved > buffer.events.size()) {
+                m_growTo = std::max(m_growTo, reserved);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_overflowMutex);
+                m_overflow.swap(m_overflowDispatching);
+            }
+            m_pending.swap(m_dispatching);
+
+            const size_t count = m_dispatching.size() + concurrentCount + m_overflowDispatching.size();
+            if (count != 0) {
+                deliver(std::span<const T>(m_dispatching));
+                deliver(std::span<const T>(buffer.events.data(), concurrentCount));
+                deliver(std::span<const T>(m_overflowDispatching));
+            }
+
+            m_dispatching.clear();
+            m_overflowDispatching.clear();
+
+            /** Nobody writes to the buffer until the next flip, it can be reset and grown in place. */
+            buffer.reserved.store(0, std::memory_order_relaxed);
+            if (buffer.events.size() < m_growTo) {
+                buffer.events.resize(std::bit_ceil(m_growTo));
+            }
+
+            return count;
+        }
+
+    private:
+        struct ConcurrentBuffer {
+            std::vector<T> events;
+            std::atomic<size_t> reserved{0};
+            std::atomic<uint32_t> writers{0};
+        };
+
+        ConcurrentBuffer m_buffers[2];
+        std::atomic<uint32_t> m_current{0};
+        /** Largest concurrent batch seen, both buffers grow to it once they are idle. */
+        size_t m_growTo = 0;
+
+        std::mutex m_overflowMutex;
+        std::vector<T> m_overflow;
+        std::vector<T> m_overflowDispatching;
+
+        std::vector<T> m_pending;
+        std::vector<T> m_dispatching;
+
+        std::vector<Handler> m_handlers;
+
+        void deliver(std::span<const T> p_events) {
+            if (p_events.empty()) {
+                return;
+            }
+            for (const Handler &handler : m_handlers) {
+                handler(p_events);
+            }
+        }
+    };
+
+    /**
+     * One EventQueue per event type, the types being fixed by the template arguments.
+     *
+     * The position of a type in the list is its id, resolved at compile time, so posting and
+     * subscribing index straight into a tuple without any lookup or type erasure.
+     */
+    template <typename... Events>
+    class EventBus {
+    public:
+        template <typename T>
+        static constexpr size_t typeId() {
+            static_assert((std::is_same_v<T, Events> || ...), "Event type is not part of this bus");
+
+            size_t id = 0;
+            bool found = false;
+            ((found = found || std::is_same_v<T, Events>, id += found ? 0 : 1), ...);
+            return id;
+        }
+
+        static constexpr size_t TYPE_COUNT = sizeof...(Events);
+
+        template <typename T>
+        EventQueue<T> &queue() { return std::get<typeId<T>()>(m_queues); }
+
+        template <typename T>
+        void post(const T &p_event) { queue<T>().post(p_event); }
+
+        template <typename T>
+        void postConcurrent(const T &p_event) { queue<T>().postConcurrent(p_event); }
+
+        template <typename T, typename F>
+        void subscribe(F &&p_handler) { queue<T>().subscribe(std::forward<F>(p_handler)); }
+
+        /** Drains every queue in the order of the template arguments, returns the number of events. */
+        size_t dispatch() {
+            size_t count = 0;
+            std::apply([&count](EventQueue<Events> &...queues) { ((count += queues.dispatch()), ...); }, m_queues);
+            return count;
+        }
+
+    private:
+        std::tuple<EventQueue<Events>...> m_queues;
+    };
+
+    using EngineEventBus = EventBus<InputEvent, WindowResizedEvent, ChunkLoadedEvent, ChunkUnloadedEvent, BlockChangedEvent>;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef __ENGINE_INPUT_EVENT_HPP__
+#define __ENGINE_INPUT_EVENT_HPP__
+
+#include <cstdint>
+
+namespace Engine {
+    enum class InputEventType : uint8_t {
+        Key,
+        MouseButton,
+        /** `x`, `y`: cursor position in screen coordinates. */
+        MouseMove,
+        /** `x`, `y`: scroll offset. */
+        Scroll,
+        /** `x`, `y`: framebuffer size in pixels. */
+        FramebufferResized
+    };
+
+    /** One window input event, the codes and actions are the GLFW ones. */
+    struct InputEvent {
+        InputEventType type = InputEventType::Key;
+        int32_t code = 0;
+        int32_t scancode = 0;
+        int32_t action = 0;
+        int32_t mods = 0;
+        /** GLFW samples merged into this event, more than one for coalesced moves and scrolls. */
+        uint32_t samples = 1;
+        double x = 0.0;
+        double y = 0.0;
+        /** steady_clock time of the first sample, in nanoseconds. */
+        int64_t time = 0;
+    };
+}
+
+#endif
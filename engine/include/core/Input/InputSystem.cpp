@@ -0,0 +1,194 @@
+#include "InputSystem.hpp"
+
+#include "../../logger.hpp"
+
+#include <GLFW/glfw3.h>
+
+#include <cstdlib>
+#include <string_view>
+#include <thread>
+
+namespace Engine {
+    bool InputSystem::pollThreadFromEnvironment() {
+        const char *value = std::getenv("ENGINE_INPUT_THREAD");
+        if (!value) {
+            return false;
+        }
+
+        const std::string_view text(value);
+        if (text == "1") {
+            return true;
+        }
+        if (text != "0") {
+            spdlog::warn("Ignoring ENGINE_INPUT_THREAD=\"{}\", expected 0 or 1", text);
+        }
+        return false;
+    }
+
+    void InputSystem::attach(GLFWwindow *p_window, bool p_pollThread) {
+        m_pollThread = p_pollThread;
+
+        glfwSetWindowUserPointer(p_window, this);
+        glfwSetKeyCallback(p_window, keyCallback);
+        glfwSetMouseButtonCallback(p_window, mouseButtonCallback);
+        glfwSetCursorPosCallback(p_window, cursorPositionCallback);
+        glfwSetScrollCallback(p_window, scrollCallback);
+        glfwSetFramebufferSizeCallback(p_window, framebufferSizeCallback);
+        glfwSetWindowCloseCallback(p_window, windowCloseCallback);
+
+        int width = 0;
+        int height = 0;
+        glfwGetFramebufferSize(p_window, &width, &height);
+        m_framebufferSize.store(static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32 | static_cast<uint32_t>(height),
+                                std::memory_order_release);
+    }
+
+    void InputSystem::poll() {
+        glfwPollEvents();
+        flushPending();
+    }
+
+    void InputSystem::runPollLoop() {
+        while (!m_stopPollLoop.load(std::memory_order_acquire)) {
+            /** Callbacks publish as they fire, the wait only ends on the next batch of window events. */
+            glfwWaitEvents();
+            flushPending();
+        }
+    }
+
+    void InputSystem::stopPollLoop() {
+        m_stopPollLoop.store(true, std::memory_order_release);
+        glfwPostEmptyEvent();
+    }
+
+    void InputSystem::waitEvents(double p_seconds) {
+        if (m_pollThread) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(p_seconds));
+            return;
+        }
+
+        glfwWaitEventsTimeout(p_seconds);
+        flushPending();
+    }
+
+    void InputSystem::framebufferSize(int32_t &p_width, int32_t &p_height) const {
+        const uint64_t size = m_framebufferSize.load(std::memory_order_acquire);
+        p_width = static_cast<int32_t>(size >> 32);
+        p_height = static_cast<int32_t>(size & UINT32_MAX);
+    }
+
+    InputLatencyStatistics InputSystem::takeStatistics() {
+        InputLatencyStatistics statistics;
+        statistics.events = m_drainedEvents;
+        statistics.samples = m_drainedSamples;
+        statistics.averageMilliseconds = m_drainedEvents != 0 ? m_latencySum / static_cast<double>(m_drainedEvents) : 0.0;
+        statistics.worstMilliseconds = m_worstLatency;
+
+        const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+        statistics.dropped = dropped - m_reportedDrops;
+        m_reportedDrops = dropped;
+
+        m_latencySum = 0.0;
+        m_worstLatency = 0.0;
+        m_drainedEvents = 0;
+        m_drainedSamples = 0;
+
+        return statistics;
+    }
+
+    void InputSystem::publish(const InputEvent &p_event) {
+        flushPending();
+        if (!m_ring.push(p_event)) {
+            m_dropped.fetch_add(p_event.samples, std::memory_order_relaxed);
+        }
+    }
+
+    void InputSystem::coalesce(const InputEvent &p_event) {
+        if (m_hasPending && m_pending.type == p_event.type) {
+            m_pending.samples += 1;
+            if (p_event.type == InputEventType::Scroll) {
+                m_pending.x += p_event.x;
+                m_pending.y += p_event.y;
+            } else {
+                m_pending.x = p_event.x;
+                m_pending.y = p_event.y;
+            }
+            return;
+        }
+
+        flushPending();
+        m_pending = p_event;
+        m_hasPending = true;
+    }
+
+    void InputSystem::flushPending() {
+        if (!m_hasPending) {
+            return;
+        }
+
+        m_hasPending = false;
+        if (!m_ring.push(m_pending)) {
+            m_dropped.fetch_add(m_pending.samples, std::memory_order_relaxed);
+        }
+    }
+
+    InputSystem &InputSystem::from(GLFWwindow *p_window) {
+        return *static_cast<InputSystem *>(glfwGetWindowUserPointer(p_window));
+    }
+
+    void InputSystem::keyCallback(GLFWwindow *p_window, int p_key, int p_scancode, int p_action, int p_mods) {
+        InputEvent event;
+        event.type = InputEventType::Key;
+        event.code = p_key;
+        event.scancode = p_scancode;
+        event.action = p_action;
+        event.mods = p_mods;
+        event.time = nowNanoseconds();
+        from(p_window).publish(event);
+    }
+
+    void InputSystem::mouseButtonCallback(GLFWwindow *p_window, int p_button, int p_action, int p_mods) {
+        InputEvent event;
+        event.type = InputEventType::MouseButton;
+        event.code = p_button;
+        event.action = p_action;
+        event.mods = p_mods;
+        event.time = nowNanoseconds();
+        from(p_window).publish(event);
+    }
+
+    void InputSystem::cursorPositionCallback(GLFWwindow *p_window, double p_x, double p_y) {
+        InputEvent event;
+        event.type = InputEventType::MouseMove;
+        event.x = p_x;
+        event.y = p_y;
+        event.time = nowNanoseconds();
+        from(p_window).coalesce(event);
+    }
+
+    void InputSystem::scrollCallback(GLFWwindow *p_window, double p_x, double p_y) {
+        InputEvent event;
+        event.type = InputEventType::Scroll;
+        event.x = p_x;
+        event.y = p_y;
+        event.time = nowNanoseconds();
+        from(p_window).coalesce(event);
+    }
+
+    void InputSystem::framebufferSizeCallback(GLFWwindow *p_window, int p_width, int p_height) {
+        InputSystem &input = from(p_window);
+        input.m_framebufferSize.store(static_cast<uint64_t>(static_cast<uint32_t>(p_width)) << 32 | static_cast<uint32_t>(p_height),
+                                      std::memory_order_release);
+
+        InputEvent event;
+        event.type = InputEventType::FramebufferResized;
+        event.x = p_width;
+        event.y = p_height;
+        event.time = nowNanoseconds();
+        input.publish(event);
+    }
+
+    void InputSystem::windowCloseCallback(GLFWwindow *p_window) {
+        from(p_window).m_closeRequested.store(true, std::memory_order_release);
+    }
+}
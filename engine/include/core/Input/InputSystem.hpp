@@ -0,0 +1,135 @@
+#ifndef __ENGINE_INPUT_SYSTEM_HPP__
+#define __ENGINE_INPUT_SYSTEM_HPP__
+
+#include "InputEvent.hpp"
+#include "../Templates/SpscRing.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+struct GLFWwindow;
+
+namespace Engine {
+    struct InputLatencyStatistics {
+        double averageMilliseconds = 0.0;
+        double worstMilliseconds = 0.0;
+        uint64_t events = 0;
+        /** GLFW samples behind those events, the difference was coalesced away. */
+        uint64_t samples = 0;
+        uint64_t dropped = 0;
+    };
+
+    /**
+     * Captures GLFW input into a single-producer/single-consumer ring.
+     *
+     * The producer is the thread processing window events, which GLFW requires to be the main
+     * thread: either inline through poll() once per frame, or in runPollLoop() while the
+     * simulation runs on a thread of its own and only ever calls drain(). Cursor moves and
+     * scrolls arriving back to back are merged into one event carrying the latest position
+     * (or the summed offset) and the time of the first sample, so high-rate mice do not flood
+     * the ring. Latency is measured from that first sample to drain().
+     */
+    class InputSystem {
+    public:
+        static constexpr size_t RING_CAPACITY = 1024;
+
+        /** Reads ENGINE_INPUT_THREAD: "1" polls on the main thread and simulates on another one. */
+        static bool pollThreadFromEnvironment();
+
+        InputSystem() = default;
+
+        InputSystem(const InputSystem &) = delete;
+        InputSystem &operator=(const InputSystem &) = delete;
+
+        /**
+         * Main thread. Installs the callbacks, the window user pointer belongs to the input system
+         * from now on. With `p_pollThread` the main thread is expected to run runPollLoop().
+         */
+        void attach(GLFWwindow *p_window, bool p_pollThread);
+
+        bool pollThread() const { return m_pollThread; }
+
+        /** Main thread. Processes pending window events and publishes them. */
+        void poll();
+
+        /** Main thread. Waits for and publishes window events until stopPollLoop(). */
+        void runPollLoop();
+
+        /** Any thread. */
+        void stopPollLoop();
+
+        /** Waits up to `p_seconds` for window events, from the simulation thread as well when polling runs apart. */
+        void waitEvents(double p_seconds);
+
+        /** Any thread. Set once the user asked to close the window. */
+        bool closeRequested() const { return m_closeRequested.load(std::memory_order_acquire); }
+
+        /** Any thread. Latest framebuffer size in pixels. */
+        void framebufferSize(int32_t &p_width, int32_t &p_height) const;
+
+        /** Simulation thread. Hands every published event to `p_handler` in order and returns their number. */
+        template <typename F>
+        size_t drain(F &&p_handler) {
+            const int64_t now = nowNanoseconds();
+
+            size_t count = 0;
+            InputEvent event;
+            while (m_ring.pop(event)) {
+                const double latency = static_cast<double>(now - event.time) / 1.0e6;
+                m_latencySum += latency;
+                m_worstLatency = std::max(m_worstLatency, latency);
+                m_drainedEvents += 1;
+                m_drainedSamples += event.samples;
+
+                p_handler(event);
+                ++count;
+            }
+
+            return count;
+        }
+
+        /** Simulation thread. Statistics since the previous call. */
+        InputLatencyStatistics takeStatistics();
+
+        static int64_t nowNanoseconds() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+    private:
+        SpscRing<InputEvent, RING_CAPACITY> m_ring;
+        bool m_pollThread = false;
+
+        /** Producer side: the move or scroll still being merged into. */
+        InputEvent m_pending;
+        bool m_hasPending = false;
+
+        std::atomic<uint64_t> m_dropped{0};
+        std::atomic<bool> m_closeRequested{false};
+        std::atomic<bool> m_stopPollLoop{false};
+        /** Width in the high half, height in the low one. */
+        std::atomic<uint64_t> m_framebufferSize{0};
+
+        /** Consumer side. */
+        double m_latencySum = 0.0;
+        double m_worstLatency = 0.0;
+        uint64_t m_drainedEvents = 0;
+        uint64_t m_drainedSamples = 0;
+        uint64_t m_reportedDrops = 0;
+
+        void publish(const InputEvent &p_event);
+        void coalesce(const InputEvent &p_event);
+        void flushPending();
+
+        static InputSystem &from(GLFWwindow *p_window);
+        static void keyCallback(GLFWwindow *p_window, int p_key, int p_scancode, int p_action, int p_mods);
+        static void mouseButtonCallback(GLFWwindow *p_window, int p_button, int p_action, int p_mods);
+        static void cursorPositionCallback(GLFWwindow *p_window, double p_x, double p_y);
+        static void scrollCallback(GLFWwindow *p_window, double p_x, double p_y);
+        static void framebufferSizeCallback(GLFWwindow *p_window, int p_width, int p_height);
+        static void windowCloseCallback(GLFWwindow *p_window);
+    };
+}
+
+#endif
@@ -0,0 +1,270 @@
+#include "AsyncLog.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+    std::atomic<bool> AsyncLog::s_running{false};
+    std::atomic<LogOverflowPolicy> AsyncLog::s_overflow{LogOverflowPolicy::Drop};
+
+    namespace {
+        /** How long a Block producer waits for the flusher before giving up on the message. */
+        constexpr std::chrono::seconds BLOCK_TIMEOUT{1};
+
+        struct PendingMessage {
+            spdlog::log_clock::time_point time;
+            spdlog::level::level_enum level;
+            std::string text;
+        };
+    }
+
+    struct AsyncLogState {
+        std::mutex mutex;
+        std::condition_variable wakeFlusher;
+        std::condition_variable flushed;
+
+        std::vector<std::shared_ptr<AsyncLog::ThreadBuffer>> buffers;
+        AsyncLogConfig config;
+        std::thread flusher;
+        bool exit = false;
+
+        uint64_t flushRequested = 0;
+        uint64_t flushCompleted = 0;
+
+        std::atomic<uint64_t> dropped{0};
+        uint64_t droppedReported = 0;
+
+        ~AsyncLogState() {
+            /** Safety net for an exception escaping past AsyncLog::stop(). */
+            stopFlusher();
+        }
+
+        void stopFlusher() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!flusher.joinable()) {
+                    return;
+                }
+
+                AsyncLog::s_running.store(false, std::memory_order_release);
+                exit = true;
+            }
+
+            wakeFlusher.notify_one();
+            flusher.join();
+        }
+    };
+
+    namespace {
+        AsyncLogState &state() {
+            static AsyncLogState instance;
+            return instance;
+        }
+
+        /** Keeps the ring of a thread registered until the thread exits, the flusher frees it once drained. */
+        struct ThreadBufferOwner {
+            std::shared_ptr<AsyncLog::ThreadBuffer> buffer;
+
+            ~ThreadBufferOwner() {
+                if (buffer) {
+                    buffer->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local ThreadBufferOwner t_bufferOwner;
+
+        LogOverflowPolicy parseOverflow(const char *value) {
+            const std::string_view text(value);
+            if (text == "block") {
+                return LogOverflowPolicy::Block;
+            }
+
+            if (text == "sync") {
+                return LogOverflowPolicy::Synchronous;
+            }
+
+            if (text != "drop") {
+                spdlog::warn("Ignoring ENGINE_LOG_OVERFLOW=\"{}\", expected block, drop or sync", text);
+            }
+
+            return LogOverflowPolicy::Drop;
+        }
+    }
+
+    AsyncLog::ThreadBuffer::ThreadBuffer(size_t capacity)
+        : data(static_cast<std::byte *>(::operator new(capacity + alignRecord(sizeof(RecordHeader)), std::align_val_t(RECORD_ALIGNMENT)))),
+          capacity(capacity) {
+    }
+
+    AsyncLog::ThreadBuffer::~ThreadBuffer() {
+        ::operator delete(data, std::align_val_t(RECORD_ALIGNMENT));
+    }
+
+    void AsyncLog::startFromEnvironment() {
+        if (const char *value = std::getenv("ENGINE_LOG_ASYNC"); value && std::string_view(value) == "0") {
+            return;
+        }
+
+        AsyncLogConfig config;
+        if (const char *value = std::getenv("ENGINE_LOG_OVERFLOW")) {
+            config.overflow = parseOverflow(value);
+        }
+
+        start(config);
+    }
+
+    void AsyncLog::start(const AsyncLogConfig &config) {
+        /** Creates the spdlog registry first, so it outlives the state and the final flush. */
+        spdlog::default_logger_raw();
+
+        AsyncLogState &logState = state();
+        std::lock_guard<std::mutex> lock(logState.mutex);
+        if (logState.flusher.joinable()) {
+            return;
+        }
+
+        logState.config = config;
+        logState.config.threadBufferBytes = std::max<size_t>(alignRecord(config.threadBufferBytes), 4096);
+        logState.exit = false;
+        s_overflow.store(config.overflow, std::memory_order_relaxed);
+
+        logState.flusher = std::thread([&logState] {
+            std::vector<PendingMessage> batch;
+            spdlog::memory_buf_t text;
+
+            std::unique_lock<std::mutex> lock(logState.mutex);
+            while (true) {
+                logState.wakeFlusher.wait_for(lock, logState.config.flushInterval, [&logState] {
+                    return logState.exit || logState.flushRequested != logState.flushCompleted;
+                });
+
+                const bool exiting = logState.exit;
+                const uint64_t flushTarget = logState.flushRequested;
+                std::vector<std::shared_ptr<ThreadBuffer>> buffers = logState.buffers;
+                lock.unlock();
+
+                for (const std::shared_ptr<ThreadBuffer> &buffer : buffers) {
+                    uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+                    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+                    while (tail != head) {
+                        std::byte *record = buffer->data + static_cast<size_t>(tail % buffer->capacity);
+                        RecordHeader *header = reinterpret_cast<RecordHeader *>(record);
+
+                        if (header->formatPayload) {
+                            void *payload = record + alignRecord(sizeof(RecordHeader));
+                            text.clear();
+                            try {
+                                header->formatPayload(payload, header->format, text);
+                            } catch (const std::exception &exception) {
+                                text.clear();
+                                fmt::format_to(fmt::appender(text), "[log format error: {}] {}", exception.what(), header->format);
+                            }
+                            header->destroyPayload(payload);
+                            batch.push_back({header->time, header->level, std::string(text.data(), text.size())});
+                        }
+
+                        tail += header->size;
+                        header->~RecordHeader();
+                    }
+
+                    buffer->tail.store(tail, std::memory_order_release);
+                }
+
+                /** Every ring is ordered already, a stable sort merges them without reordering a thread. */
+                std::ranges::stable_sort(batch, {}, &PendingMessage::time);
+
+                spdlog::logger *logger = spdlog::default_logger_raw();
+                for (const PendingMessage &message : batch) {
+                    logger->log(message.time, spdlog::source_loc{}, message.level, spdlog::string_view_t(message.text.data(), message.text.size()));
+                }
+                batch.clear();
+
+                const uint64_t dropped = logState.dropped.load(std::memory_order_relaxed);
+                if (dropped != logState.droppedReported) {
+                    logger->warn("{} log messages dropped, the log rings were full", dropped - logState.droppedReported);
+                    logState.droppedReported = dropped;
+                }
+
+                if (flushTarget != logState.flushCompleted || exiting) {
+                    logger->flush();
+                }
+
+                lock.lock();
+
+                std::erase_if(logState.buffers, [](const std::shared_ptr<ThreadBuffer> &buffer) {
+                    return buffer->retired.load(std::memory_order_acquire) &&
+                           buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_acquire);
+                });
+
+                logState.flushCompleted = flushTarget;
+                logState.flushed.notify_all();
+
+                if (exiting) {
+                    break;
+                }
+            }
+        });
+
+        s_running.store(true, std::memory_order_release);
+    }
+
+    void AsyncLog::stop() {
+        state().stopFlusher();
+    }
+
+    void AsyncLog::flush() {
+        AsyncLogState &logState = state();
+
+        std::unique_lock<std::mutex> lock(logState.mutex);
+        if (!logState.flusher.joinable()) {
+            spdlog::default_logger_raw()->flush();
+            return;
+        }
+
+        const uint64_t target = ++logState.flushRequested;
+        logState.wakeFlusher.notify_one();
+        logState.flushed.wait(lock, [&logState, target] {
+            return logState.flushCompleted >= target || !logState.flusher.joinable() || logState.exit;
+        });
+    }
+
+    uint64_t AsyncLog::droppedMessages() {
+        return state().dropped.load(std::memory_order_relaxed);
+    }
+
+    AsyncLog::ThreadBuffer &AsyncLog::threadBuffer() {
+        if (!t_bufferOwner.buffer) {
+            AsyncLogState &logState = state();
+            std::lock_guard<std::mutex> lock(logState.mutex);
+            t_bufferOwner.buffer = std::make_shared<ThreadBuffer>(logState.config.threadBufferBytes);
+            logState.buffers.push_back(t_bufferOwner.buffer);
+        }
+
+        return *t_bufferOwner.buffer;
+    }
+
+    bool AsyncLog::waitForSpace(ThreadBuffer &buffer, uint64_t needed) {
+        const auto deadline = std::chrono::steady_clock::now() + BLOCK_TIMEOUT;
+        const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+        state().wakeFlusher.notify_one();
+        while (buffer.capacity - (head - buffer.tail.load(std::memory_order_acquire)) < needed) {
+            if (!running() || std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+
+        return true;
+    }
+
+    void AsyncLog::countDropped() {
+        state().dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,192 @@
+#ifndef __ENGINE_ASYNC_LOG_HPP__
+#define __ENGINE_ASYNC_LOG_HPP__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "spdlog/spdlog.h"
+
+namespace Engine {
+    /** What a thread does when its log ring is full. */
+    enum class LogOverflowPolicy : uint8_t {
+        /** Wait for the flusher to make room. */
+        Block,
+        /** Count the message as dropped, reported by the flusher. */
+        Drop,
+        /** Format and write the message on the calling thread. */
+        Synchronous
+    };
+
+    struct AsyncLogState;
+
+    struct AsyncLogConfig {
+        size_t threadBufferBytes = 256 * 1024;
+        LogOverflowPolicy overflow = LogOverflowPolicy::Drop;
+        std::chrono::milliseconds flushInterval{2};
+    };
+
+    /**
+     * Asynchronous backend of the ENGINE_LOG_* macros.
+     *
+     * Every logging thread owns a single-producer ring the flusher thread is the only consumer
+     * of, so logging takes no lock. The call site only copies its arguments into the ring:
+     * strings by value, everything else as its decayed type. Formatting and the spdlog sinks
+     * run on the flusher, which merges the rings by timestamp.
+     *
+     * Before start() and after stop() messages are written synchronously through spdlog.
+     */
+    class AsyncLog {
+    public:
+        /** Reads ENGINE_LOG_ASYNC ("0" keeps logging synchronous) and ENGINE_LOG_OVERFLOW ("block", "drop", "sync"). */
+        static void startFromEnvironment();
+
+        static void start(const AsyncLogConfig &config);
+
+        /** Writes everything queued and joins the flusher. Other threads should have stopped logging. */
+        static void stop();
+
+        /** Blocks until every message queued before the call is written and the sinks are flushed. */
+        static void flush();
+
+        static bool running() { return s_running.load(std::memory_order_relaxed); }
+
+        static uint64_t droppedMessages();
+
+        template <typename... Args>
+        static void write(spdlog::level::level_enum level, spdlog::format_string_t<Args...> format, Args &&...args);
+
+    private:
+        static constexpr size_t RECORD_ALIGNMENT = 16;
+
+        using FormatFunction = void (*)(void *payload, std::string_view format, spdlog::memory_buf_t &out);
+        using DestroyFunction = void (*)(void *payload);
+
+        /** Precedes every record in a ring. A null `formatPayload` marks padding up to the end of the ring. */
+        struct alignas(RECORD_ALIGNMENT) RecordHeader {
+            uint32_t size = 0;
+            spdlog::level::level_enum level = spdlog::level::info;
+            spdlog::log_clock::time_point time;
+            std::string_view format;
+            FormatFunction formatPayload = nullptr;
+            DestroyFunction destroyPayload = nullptr;
+        };
+
+    public:
+        /** Ring of one logging thread. */
+        struct ThreadBuffer {
+            explicit ThreadBuffer(size_t capacity);
+            ~ThreadBuffer();
+
+            std::byte *data = nullptr;
+            size_t capacity = 0;
+
+            /** Written by the owning thread only. */
+            alignas(64) std::atomic<uint64_t> head{0};
+            /** Written by the flusher only. */
+            alignas(64) std::atomic<uint64_t> tail{0};
+            std::atomic<bool> retired{false};
+        };
+
+    private:
+        friend struct AsyncLogState;
+
+        static std::atomic<bool> s_running;
+        static std::atomic<LogOverflowPolicy> s_overflow;
+
+        static ThreadBuffer &threadBuffer();
+        static bool waitForSpace(ThreadBuffer &buffer, uint64_t needed);
+        static void countDropped();
+
+        /** Strings are copied, the caller's buffer may be gone by the time the flusher formats. */
+        template <typename T>
+        struct Captured {
+            using Type = std::conditional_t<std::is_convertible_v<std::decay_t<T>, std::string_view> &&
+                                                !std::is_arithmetic_v<std::decay_t<T>>,
+                                            std::string, std::decay_t<T>>;
+        };
+
+        static constexpr size_t alignRecord(size_t size) {
+            return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+        }
+    };
+
+    template <typename... Args>
+    void AsyncLog::write(spdlog::level::level_enum level, spdlog::format_string_t<Args...> format, Args &&...args) {
+        spdlog::logger *logger = spdlog::default_logger_raw();
+        if (!logger->should_log(level)) {
+            return;
+        }
+
+        if (!running()) {
+            logger->log(level, format, std::forward<Args>(args)...);
+            return;
+        }
+
+        using Payload = std::tuple<typename Captured<Args>::Type...>;
+        static_assert(alignof(Payload) <= RECORD_ALIGNMENT, "Log argument alignment exceeds the record alignment");
+
+        ThreadBuffer &buffer = threadBuffer();
+        const size_t size = alignRecord(sizeof(RecordHeader)) + alignRecord(sizeof(Payload));
+
+        if (size > buffer.capacity / 4) {
+            logger->log(level, format, std::forward<Args>(args)...);
+            return;
+        }
+
+        uint64_t head = buffer.head.load(std::memory_order_relaxed);
+        const size_t offset = static_cast<size_t>(head % buffer.capacity);
+        const size_t contiguous = buffer.capacity - offset;
+        const uint64_t needed = size + (contiguous < size ? contiguous : 0);
+
+        if (buffer.capacity - (head - buffer.tail.load(std::memory_order_acquire)) < needed) {
+            const LogOverflowPolicy overflow = s_overflow.load(std::memory_order_relaxed);
+            if (overflow == LogOverflowPolicy::Synchronous) {
+                logger->log(level, format, std::forward<Args>(args)...);
+                return;
+            }
+
+            if (overflow == LogOverflowPolicy::Drop || !waitForSpace(buffer, needed)) {
+                countDropped();
+                return;
+            }
+        }
+
+        /** Too close to the end for the record, pad the rest of the ring (it has slack for the header) and start over. */
+        if (contiguous < size) {
+            RecordHeader *padding = new (buffer.data + offset) RecordHeader();
+            padding->size = static_cast<uint32_t>(contiguous);
+            head += contiguous;
+        }
+
+        std::byte *record = buffer.data + static_cast<size_t>(head % buffer.capacity);
+        RecordHeader *header = new (record) RecordHeader();
+        header->size = static_cast<uint32_t>(size);
+        header->level = level;
+        header->time = spdlog::log_clock::now();
+        const auto formatView = spdlog::string_view_t(format);
+        header->format = std::string_view(formatView.data(), formatView.size());
+        header->formatPayload = [](void *payload, std::string_view formatString, spdlog::memory_buf_t &out) {
+            std::apply([&](auto &...values) {
+                fmt::vformat_to(fmt::appender(out), fmt::string_view(formatString.data(), formatString.size()),
+                                fmt::make_format_args(values...));
+            }, *static_cast<Payload *>(payload));
+        };
+        header->destroyPayload = [](void *payload) {
+            static_cast<Payload *>(payload)->~Payload();
+        };
+        new (record + alignRecord(sizeof(RecordHeader))) Payload(std::forward<Args>(args)...);
+
+        buffer.head.store(head + size, std::memory_order_release);
+    }
+}
+
+#endif
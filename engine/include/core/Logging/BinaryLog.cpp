@@ -0,0 +1,503 @@
+#include "BinaryLog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace Engine {
+    std::atomic<bool> BinaryLog::s_running{false};
+    std::atomic<uint64_t> BinaryLog::s_dropped{0};
+
+    /** One memory-mapped segment file. The struct outlives its mapping, writers may still compare against it. */
+    struct BinaryLogSegment {
+        std::string path;
+        uint64_t index = 0;
+        std::byte *data = nullptr;
+        size_t capacity = 0;
+
+        std::atomic<uint64_t> cursor{0};
+
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#else
+        int file = -1;
+#endif
+
+        bool map(size_t bytes) {
+            capacity = bytes;
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                return false;
+            }
+
+            const ULARGE_INTEGER size{.QuadPart = bytes};
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+            if (!mapping) {
+                return false;
+            }
+
+            data = static_cast<std::byte *>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, bytes));
+            return data != nullptr;
+#else
+            file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (file < 0 || ::ftruncate(file, static_cast<off_t>(bytes)) != 0) {
+                return false;
+            }
+
+            void *view = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if (view == MAP_FAILED) {
+                return false;
+            }
+
+            data = static_cast<std::byte *>(view);
+            return true;
+#endif
+        }
+
+        void sync() {
+            if (!data) {
+                return;
+            }
+#ifdef _WIN32
+            FlushViewOfFile(data, 0);
+            FlushFileBuffers(file);
+#else
+            ::msync(data, capacity, MS_SYNC);
+#endif
+        }
+
+        /** Releases the mapping and trims the file to what was written. */
+        void unmap() {
+            const uint64_t used = std::min<uint64_t>(cursor.load(std::memory_order_relaxed), capacity);
+#ifdef _WIN32
+            if (data) {
+                UnmapViewOfFile(data);
+            }
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+            if (file != INVALID_HANDLE_VALUE) {
+                LARGE_INTEGER end{.QuadPart = static_cast<LONGLONG>(used)};
+                SetFilePointerEx(file, end, nullptr, FILE_BEGIN);
+                SetEndOfFile(file);
+                CloseHandle(file);
+            }
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (data) {
+                ::munmap(data, capacity);
+            }
+            if (file >= 0) {
+                if (::ftruncate(file, static_cast<off_t>(used)) != 0) {
+                    spdlog::warn("Failed to trim binary log segment {}", path);
+                }
+                ::close(file);
+            }
+            file = -1;
+#endif
+            data = nullptr;
+        }
+    };
+
+    /** Write state of one thread, on a cache line of its own. Slots are reused once their thread exits. */
+    struct alignas(64) BinaryLogWriter {
+        /** Segment of the record between reserve() and commit(), a retired segment is only unmapped when no writer points at it. */
+        std::atomic<BinaryLogSegment *> writing{nullptr};
+
+        /** Block of `segment` owned by the thread; the bytes from `next` to `end` are covered by a Padding record. */
+        BinaryLogSegment *segment = nullptr;
+        uint64_t next = 0;
+        uint64_t end = 0;
+
+        uint32_t threadIndex = 0;
+        /** Taken by a live thread, guarded by the state mutex. */
+        bool used = false;
+    };
+
+    namespace {
+        /** Bytes a writer takes from the segment cursor at once, a record never spans two blocks. */
+        constexpr uint64_t WRITER_BLOCK_BYTES = 64 * 1024;
+
+        struct SiteDefinition {
+            LogCategory category;
+            spdlog::level::level_enum level;
+            uint32_t line;
+            std::string file;
+            std::string format;
+            std::vector<BinaryLogFormat::ArgumentType> arguments;
+        };
+
+        struct BinaryLogState {
+            std::mutex mutex;
+            BinaryLogConfig config;
+            std::atomic<BinaryLogSegment *> current{nullptr};
+
+            /** Never shrinks while running, late writers may still hold a retired segment. */
+            std::deque<std::unique_ptr<BinaryLogSegment>> segments;
+            std::vector<SiteDefinition> sites;
+            /** Never shrinks, a slot outlives its thread. */
+            std::deque<std::unique_ptr<BinaryLogWriter>> writers;
+
+            ~BinaryLogState() {
+                for (std::unique_ptr<BinaryLogSegment> &segment : segments) {
+                    segment->unmap();
+                }
+            }
+        };
+
+        BinaryLogState &state() {
+            static BinaryLogState instance;
+            return instance;
+        }
+
+        std::atomic<uint32_t> s_nextThreadIndex{0};
+
+        /** Hands the writer slot of a thread back when the thread exits. */
+        struct WriterSlot {
+            BinaryLogWriter *writer = nullptr;
+
+            ~WriterSlot() {
+                if (writer) {
+                    std::lock_guard<std::mutex> lock(state().mutex);
+                    writer->segment = nullptr;
+                    writer->used = false;
+                }
+            }
+        };
+
+        BinaryLogWriter &threadWriter() {
+            thread_local WriterSlot slot;
+            if (slot.writer) {
+                return *slot.writer;
+            }
+
+            BinaryLogState &logState = state();
+            std::lock_guard<std::mutex> lock(logState.mutex);
+            const auto free = std::find_if(logState.writers.begin(), logState.writers.end(),
+                                           [](const std::unique_ptr<BinaryLogWriter> &writer) { return !writer->used; });
+            BinaryLogWriter *writer = free != logState.writers.end() ? free->get()
+                                                                     : logState.writers.emplace_back(std::make_unique<BinaryLogWriter>()).get();
+            writer->used = true;
+            writer->segment = nullptr;
+            writer->threadIndex = s_nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+            slot.writer = writer;
+            return *writer;
+        }
+
+        bool isWriting(const BinaryLogState &logState, const BinaryLogSegment *segment) {
+            return std::any_of(logState.writers.begin(), logState.writers.end(), [segment](const std::unique_ptr<BinaryLogWriter> &writer) {
+                return writer->writing.load(std::memory_order_seq_cst) == segment;
+            });
+        }
+
+        void writePadding(std::byte *data, uint64_t bytes) {
+            using namespace BinaryLogFormat;
+            const RecordHeader header{static_cast<uint32_t>(bytes), RecordKind::Padding, 0, 0, 0};
+            std::memcpy(data, &header, sizeof(header));
+        }
+
+        /** Takes a new block of `segment` for the writer, shorter at the end of the segment; false when `size` does not fit. */
+        bool takeBlock(BinaryLogWriter &writer, BinaryLogSegment &segment, uint32_t size) {
+            const uint64_t bytes = std::max<uint64_t>(WRITER_BLOCK_BYTES, size);
+            const uint64_t offset = segment.cursor.fetch_add(bytes, std::memory_order_relaxed);
+            if (offset >= segment.capacity || segment.capacity - offset < size) {
+                return false;
+            }
+
+            writer.segment = &segment;
+            writer.next = offset;
+            writer.end = std::min<uint64_t>(offset + bytes, segment.capacity);
+            writePadding(segment.data + writer.next, writer.end - writer.next);
+            return true;
+        }
+
+        std::string segmentPath(const BinaryLogConfig &config, uint64_t index) {
+            return config.path + "." + std::to_string(index);
+        }
+
+        /** Writes a record into a segment only the caller can see, or under the state mutex. */
+        bool writeDefinition(BinaryLogSegment &segment, uint32_t siteId, const SiteDefinition &site) {
+            using namespace BinaryLogFormat;
+
+            const size_t fileBytes = std::min<size_t>(site.file.size(), UINT16_MAX);
+            const size_t size = alignRecord(sizeof(RecordHeader) + sizeof(DefinitionBody) + site.arguments.size() + fileBytes +
+                                            site.format.size());
+
+            const uint64_t offset = segment.cursor.fetch_add(size, std::memory_order_relaxed);
+            if (offset + size > segment.capacity) {
+                return false;
+            }
+
+            std::byte *record = segment.data + offset;
+            const RecordHeader header{static_cast<uint32_t>(size), RecordKind::Uncommitted, static_cast<uint8_t>(site.level),
+                                      static_cast<uint8_t>(site.category), 0};
+            const DefinitionBody body{siteId, site.line, static_cast<uint16_t>(site.arguments.size()), static_cast<uint16_t>(fileBytes),
+                                      static_cast<uint32_t>(site.format.size())};
+
+            std::byte *out = record;
+            std::memcpy(out, &header, sizeof(header));
+            out += sizeof(header);
+            std::memcpy(out, &body, sizeof(body));
+            out += sizeof(body);
+            if (!site.arguments.empty()) {
+                std::memcpy(out, site.arguments.data(), site.arguments.size());
+                out += site.arguments.size();
+            }
+            std::memcpy(out, site.file.data(), fileBytes);
+            out += fileBytes;
+            std::memcpy(out, site.format.data(), site.format.size());
+
+            std::atomic_ref<RecordKind>(reinterpret_cast<RecordHeader *>(record)->kind).store(RecordKind::Definition, std::memory_order_release);
+            return true;
+        }
+
+        /** Creates the segment and writes the header and every known site definition, before anyone else sees it. */
+        std::unique_ptr<BinaryLogSegment> openSegment(BinaryLogState &logState, uint64_t index) {
+            using namespace BinaryLogFormat;
+
+            auto segment = std::make_unique<BinaryLogSegment>();
+            segment->path = segmentPath(logState.config, index);
+            segment->index = index;
+
+            if (!segment->map(logState.config.segmentBytes)) {
+                segment->unmap();
+                std::remove(segment->path.c_str());
+                return nullptr;
+            }
+
+            SegmentHeader header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.headerBytes = static_cast<uint32_t>(alignRecord(sizeof(SegmentHeader)));
+            header.segmentIndex = index;
+            header.startTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+            std::memcpy(segment->data, &header, sizeof(header));
+            segment->cursor.store(header.headerBytes, std::memory_order_relaxed);
+
+            for (size_t i = 0; i < logState.sites.size(); ++i) {
+                if (!writeDefinition(*segment, static_cast<uint32_t>(i + 1), logState.sites[i])) {
+                    spdlog::warn("Binary log segment of {} bytes is too small for the call site definitions", logState.config.segmentBytes);
+                    break;
+                }
+            }
+
+            return segment;
+        }
+
+        /** Unmaps retired segments nobody is writing to any more. */
+        void releaseRetired(BinaryLogState &logState) {
+            BinaryLogSegment *current = logState.current.load(std::memory_order_seq_cst);
+            for (std::unique_ptr<BinaryLogSegment> &segment : logState.segments) {
+                if (segment.get() != current && segment->data && !isWriting(logState, segment.get())) {
+                    segment->unmap();
+                }
+            }
+        }
+
+        /** Called with the state mutex held. Returns false once binary logging had to stop. */
+        bool rollLocked(BinaryLogState &logState, BinaryLogSegment *full) {
+            BinaryLogSegment *current = logState.current.load(std::memory_order_relaxed);
+            if (current != full) {
+                return current != nullptr;
+            }
+
+            const uint64_t index = full->index + 1;
+            std::unique_ptr<BinaryLogSegment> next = openSegment(logState, index);
+            if (!next) {
+                spdlog::warn("Failed to create binary log segment {}, falling back to text logging", segmentPath(logState.config, index));
+                logState.current.store(nullptr, std::memory_order_seq_cst);
+                return false;
+            }
+
+            logState.current.store(next.get(), std::memory_order_seq_cst);
+            logState.segments.push_back(std::move(next));
+
+            releaseRetired(logState);
+
+            if (logState.config.keepSegments != 0 && index >= logState.config.keepSegments) {
+                std::remove(segmentPath(logState.config, index - logState.config.keepSegments).c_str());
+            }
+
+            return true;
+        }
+
+        size_t parseSize(const char *name, const char *value, size_t fallback) {
+            char *end = nullptr;
+            const unsigned long long parsed = std::strtoull(value, &end, 10);
+            if (end == value || *end != '\0' || parsed == 0) {
+                spdlog::warn("Ignoring {}=\"{}\", expected a positive integer", name, value);
+                return fallback;
+            }
+            return static_cast<size_t>(parsed);
+        }
+    }
+
+    void BinaryLog::startFromEnvironment() {
+        const char *path = std::getenv("ENGINE_LOG_BINARY");
+        if (!path || !*path) {
+            return;
+        }
+
+        BinaryLogConfig config;
+        config.path = path;
+        if (const char *value = std::getenv("ENGINE_LOG_BINARY_SEGMENT_MB")) {
+            config.segmentBytes = parseSize("ENGINE_LOG_BINARY_SEGMENT_MB", value, config.segmentBytes >> 20) << 20;
+        }
+        if (const char *value = std::getenv("ENGINE_LOG_BINARY_SEGMENTS")) {
+            config.keepSegments = static_cast<uint32_t>(parseSize("ENGINE_LOG_BINARY_SEGMENTS", value, config.keepSegments));
+        }
+
+        start(config);
+    }
+
+    void BinaryLog::start(const BinaryLogConfig &config) {
+        BinaryLogState &logState = state();
+        std::lock_guard<std::mutex> lock(logState.mutex);
+        if (logState.current.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        logState.config = config;
+        logState.config.segmentBytes = std::max<size_t>(BinaryLogFormat::alignRecord(config.segmentBytes), 1024 * 1024);
+
+        std::unique_ptr<BinaryLogSegment> segment = openSegment(logState, 0);
+        if (!segment) {
+            throw std::runtime_error("failed to create binary log segment " + segmentPath(logState.config, 0));
+        }
+
+        logState.current.store(segment.get(), std::memory_order_seq_cst);
+        logState.segments.push_back(std::move(segment));
+        s_running.store(true, std::memory_order_release);
+    }
+
+    void BinaryLog::stop() {
+        BinaryLogState &logState = state();
+        std::lock_guard<std::mutex> lock(logState.mutex);
+
+        s_running.store(false, std::memory_order_release);
+        logState.current.store(nullptr, std::memory_order_seq_cst);
+
+        for (std::unique_ptr<BinaryLogSegment> &segment : logState.segments) {
+            while (isWriting(logState, segment.get())) {
+                std::this_thread::yield();
+            }
+            segment->unmap();
+        }
+        logState.segments.clear();
+
+        /** A segment of a later start() may reuse the address of a freed one. */
+        for (std::unique_ptr<BinaryLogWriter> &writer : logState.writers) {
+            writer->segment = nullptr;
+        }
+    }
+
+    void BinaryLog::flush() {
+        BinaryLogState &logState = state();
+        std::lock_guard<std::mutex> lock(logState.mutex);
+
+        if (BinaryLogSegment *segment = logState.current.load(std::memory_order_relaxed)) {
+            segment->sync();
+        }
+    }
+
+    uint32_t BinaryLog::registerSite(BinaryLogSite &site, LogCategory category, spdlog::level::level_enum level, const char *file,
+                                     int line, std::string_view format, std::initializer_list<ArgumentType> arguments) {
+        BinaryLogState &logState = state();
+        std::lock_guard<std::mutex> lock(logState.mutex);
+
+        if (const uint32_t id = site.id.load(std::memory_order_relaxed); id != 0) {
+            return id;
+        }
+
+        logState.sites.push_back({category, level, static_cast<uint32_t>(line), file, std::string(format), arguments});
+        const uint32_t id = static_cast<uint32_t>(logState.sites.size());
+
+        /** A segment opened by a roll repeats every definition, including this one. */
+        if (BinaryLogSegment *segment = logState.current.load(std::memory_order_relaxed)) {
+            if (!writeDefinition(*segment, id, logState.sites.back()) && !rollLocked(logState, segment)) {
+                s_running.store(false, std::memory_order_release);
+            }
+        }
+
+        site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    BinaryLog::Reservation BinaryLog::reserve(uint32_t size) {
+        BinaryLogState &logState = state();
+        BinaryLogWriter &writer = threadWriter();
+
+        while (true) {
+            BinaryLogSegment *segment = logState.current.load(std::memory_order_seq_cst);
+            if (!segment) {
+                writer.writing.store(nullptr, std::memory_order_release);
+                s_dropped.fetch_add(1, std::memory_order_relaxed);
+                return {};
+            }
+
+            /** Announce the writer before checking the segment is still current, so a roll cannot unmap under it. */
+            writer.writing.store(segment, std::memory_order_seq_cst);
+            if (logState.current.load(std::memory_order_seq_cst) != segment) {
+                continue;
+            }
+
+            if (size > segment->capacity / 4) {
+                writer.writing.store(nullptr, std::memory_order_release);
+                s_dropped.fetch_add(1, std::memory_order_relaxed);
+                return {};
+            }
+
+            if ((writer.segment == segment && writer.end - writer.next >= size) || takeBlock(writer, *segment, size)) {
+                std::byte *data = segment->data + writer.next;
+                writer.next += size;
+                /** The rest of the block is covered again before the record is written over the old padding. */
+                if (writer.next < writer.end) {
+                    writePadding(segment->data + writer.next, writer.end - writer.next);
+                }
+                return {&writer, data, writer.threadIndex};
+            }
+
+            writer.writing.store(nullptr, std::memory_order_release);
+
+            std::lock_guard<std::mutex> lock(logState.mutex);
+            if (!rollLocked(logState, segment)) {
+                s_running.store(false, std::memory_order_release);
+                s_dropped.fetch_add(1, std::memory_order_relaxed);
+                return {};
+            }
+        }
+    }
+
+    void BinaryLog::commit(const Reservation &reservation, BinaryLogFormat::RecordKind kind) {
+        std::atomic_ref<BinaryLogFormat::RecordKind>(reinterpret_cast<BinaryLogFormat::RecordHeader *>(reservation.data)->kind).store(kind, std::memory_order_release);
+        reservation.writer->writing.store(nullptr, std::memory_order_release);
+    }
+
+    uint64_t BinaryLog::now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef __ENGINE_BINARY_LOG_FORMAT_HPP__
+#define __ENGINE_BINARY_LOG_FORMAT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * On-disk layout of the binary log, shared by BinaryLog and the LogDecoder tool.
+ *
+ * A segment file starts with a SegmentHeader followed by records, each aligned to
+ * RECORD_ALIGNMENT and starting with a RecordHeader. The size of a record is written as soon
+ * as its space is reserved and its kind last, on commit: a record still of kind Uncommitted
+ * is skipped by its size, a zero size marks the end of the written part of a segment. Every
+ * segment repeats the definitions of the call sites registered so far and can be
+ * decoded on its own. All values are little-endian, in the byte order of the writer.
+ */
+namespace Engine::BinaryLogFormat {
+    constexpr char MAGIC[8] = {'L', 'O', 'V', 'B', 'L', 'O', 'G', '\0'};
+    constexpr uint32_t VERSION = 1;
+    constexpr size_t RECORD_ALIGNMENT = 8;
+
+    enum class RecordKind : uint8_t {
+        /** Reserved but not written completely, its writer is busy or never finished. */
+        Uncommitted = 0,
+        /** Describes one call site: format string, argument types, file and line. */
+        Definition = 1,
+        /** One logged message: the site ID, a timestamp and the raw arguments. */
+        Message = 2,
+        /** Unused rest of the block a writer thread reserved, later records are cut from its front. */
+        Padding = 3
+    };
+
+    /** How a message argument is stored, strings as a uint32_t length followed by the bytes. */
+    enum class ArgumentType : uint8_t {
+        Bool,
+        Char,
+        Int,
+        UInt,
+        Float,
+        Double,
+        Pointer,
+        String
+    };
+
+    struct SegmentHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerBytes;
+        uint64_t segmentIndex;
+        /** System clock, nanoseconds since the epoch. */
+        uint64_t startTime;
+    };
+
+    struct RecordHeader {
+        /** Whole record including padding, written when the record is reserved. */
+        uint32_t size;
+        /** Written last, publishes the record. */
+        RecordKind kind;
+        uint8_t level;
+        uint8_t category;
+        uint8_t reserved;
+    };
+
+    /** Followed by `argumentCount` ArgumentType bytes, the file name and the format string. */
+    struct DefinitionBody {
+        uint32_t siteId;
+        uint32_t line;
+        uint16_t argumentCount;
+        uint16_t fileBytes;
+        uint32_t formatBytes;
+    };
+
+    /** Followed by the arguments in the order of the site definition. */
+    struct MessageBody {
+        uint32_t siteId;
+        uint32_t threadIndex;
+        /** System clock, nanoseconds since the epoch. */
+        uint64_t time;
+    };
+
+    static_assert(sizeof(SegmentHeader) == 32);
+    static_assert(sizeof(RecordHeader) == 8);
+    static_assert(sizeof(DefinitionBody) == 16);
+    static_assert(sizeof(MessageBody) == 16);
+
+    constexpr size_t alignRecord(size_t size) {
+        return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    }
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "LogCategory.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Engine {
+    namespace {
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        std::optional<LogCategory> parseCategory(std::string_view text) {
+            for (size_t i = 0; i < LOG_CATEGORY_COUNT; ++i) {
+                if (text == LOG_CATEGORY_NAMES[i]) {
+                    return static_cast<LogCategory>(i);
+                }
+            }
+            return std::nullopt;
+        }
+
+        std::optional<spdlog::level::level_enum> parseLevel(std::string_view text) {
+            /** spdlog maps unknown names to off, which must not pass for a typo. */
+            const spdlog::level::level_enum level = spdlog::level::from_str(std::string(text));
+            if (level == spdlog::level::off && text != "off") {
+                return std::nullopt;
+            }
+            return level;
+        }
+    }
+
+    void LogFilter::setLevel(LogCategory category, spdlog::level::level_enum level) {
+        s_levels[static_cast<size_t>(category)].store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+        syncLoggerLevel();
+    }
+
+    void LogFilter::setAllLevels(spdlog::level::level_enum level) {
+        for (std::atomic<uint8_t> &categoryLevel : s_levels) {
+            categoryLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+        }
+        syncLoggerLevel();
+    }
+
+    void LogFilter::configureFromEnvironment() {
+        const char *value = std::getenv("ENGINE_LOG_LEVELS");
+        if (!value) {
+            return;
+        }
+
+        std::string_view remaining(value);
+        while (!remaining.empty()) {
+            const size_t comma = remaining.find(',');
+            const std::string_view entry = trim(remaining.substr(0, comma));
+            remaining = comma == std::string_view::npos ? std::string_view() : remaining.substr(comma + 1);
+
+            if (entry.empty()) {
+                continue;
+            }
+
+            const size_t equals = entry.find('=');
+            const std::string_view categoryName = trim(entry.substr(0, equals));
+            const std::optional<spdlog::level::level_enum> level =
+                equals == std::string_view::npos ? std::nullopt : parseLevel(trim(entry.substr(equals + 1)));
+
+            if (!level) {
+                spdlog::warn("Ignoring ENGINE_LOG_LEVELS entry \"{}\", expected category=trace|debug|info|warning|error|critical|off", entry);
+                continue;
+            }
+
+            if (categoryName == "*") {
+                setAllLevels(*level);
+            } else if (const std::optional<LogCategory> category = parseCategory(categoryName)) {
+                setLevel(*category, *level);
+            } else {
+                spdlog::warn("Ignoring ENGINE_LOG_LEVELS entry \"{}\", unknown category \"{}\"", entry, categoryName);
+            }
+        }
+    }
+
+    void LogFilter::syncLoggerLevel() {
+        /** The category levels do the filtering, the logger only has to let the lowest of them through. */
+        uint8_t lowest = static_cast<uint8_t>(spdlog::level::off);
+        for (const std::atomic<uint8_t> &categoryLevel : s_levels) {
+            lowest = std::min(lowest, categoryLevel.load(std::memory_order_relaxed));
+        }
+
+        spdlog::set_level(static_cast<spdlog::level::level_enum>(lowest));
+    }
+}
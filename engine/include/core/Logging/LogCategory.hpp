@@ -0,0 +1,128 @@
+#ifndef __ENGINE_LOG_CATEGORY_HPP__
+#define __ENGINE_LOG_CATEGORY_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "spdlog/spdlog.h"
+
+/**
+ * Compile-time floors use the numeric spdlog levels: 0 trace, 1 debug, 2 info, 3 warn,
+ * 4 error, 5 critical, 6 compiles every message of the category out.
+ * ENGINE_LOG_COMPILE_LEVEL is the default of every ENGINE_LOG_COMPILE_LEVEL_<CATEGORY>.
+ */
+#ifndef ENGINE_LOG_COMPILE_LEVEL
+    #if defined(RELEASE) && RELEASE == 1
+        #define ENGINE_LOG_COMPILE_LEVEL 2
+    #else
+        #define ENGINE_LOG_COMPILE_LEVEL 0
+    #endif
+#endif
+
+#ifndef ENGINE_LOG_COMPILE_LEVEL_CORE
+    #define ENGINE_LOG_COMPILE_LEVEL_CORE ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_RENDER
+    #define ENGINE_LOG_COMPILE_LEVEL_RENDER ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_WORLD
+    #define ENGINE_LOG_COMPILE_LEVEL_WORLD ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_NET
+    #define ENGINE_LOG_COMPILE_LEVEL_NET ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_MEMORY
+    #define ENGINE_LOG_COMPILE_LEVEL_MEMORY ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_AUDIO
+    #define ENGINE_LOG_COMPILE_LEVEL_AUDIO ENGINE_LOG_COMPILE_LEVEL
+#endif
+#ifndef ENGINE_LOG_COMPILE_LEVEL_INPUT
+    #define ENGINE_LOG_COMPILE_LEVEL_INPUT ENGINE_LOG_COMPILE_LEVEL
+#endif
+
+namespace Engine {
+    enum class LogCategory : uint8_t {
+        Core,
+        Render,
+        World,
+        Net,
+        Memory,
+        Audio,
+        Input
+    };
+
+    constexpr size_t LOG_CATEGORY_COUNT = 7;
+
+    /** Names used by ENGINE_LOG_LEVELS and the binary log decoder. */
+    constexpr const char *LOG_CATEGORY_NAMES[LOG_CATEGORY_COUNT] = {
+        "core",
+        "render",
+        "world",
+        "net",
+        "memory",
+        "audio",
+        "input"
+    };
+
+    /**
+     * Per-category log levels.
+     *
+     * A message passes two gates before its arguments are evaluated: the compile-time floor
+     * of its category, which discards the whole statement when the level is below it, and
+     * the runtime level, a single relaxed load of one byte. ENGINE_LOG_LEVELS sets runtime
+     * levels, e.g. "world=trace,render=warn" or "*=debug".
+     */
+    class LogFilter {
+    public:
+        static constexpr spdlog::level::level_enum compiledLevel(LogCategory category) {
+            constexpr int levels[LOG_CATEGORY_COUNT] = {
+                ENGINE_LOG_COMPILE_LEVEL_CORE,
+                ENGINE_LOG_COMPILE_LEVEL_RENDER,
+                ENGINE_LOG_COMPILE_LEVEL_WORLD,
+                ENGINE_LOG_COMPILE_LEVEL_NET,
+                ENGINE_LOG_COMPILE_LEVEL_MEMORY,
+                ENGINE_LOG_COMPILE_LEVEL_AUDIO,
+                ENGINE_LOG_COMPILE_LEVEL_INPUT
+            };
+
+            return static_cast<spdlog::level::level_enum>(levels[static_cast<size_t>(category)]);
+        }
+
+        static constexpr bool compiledIn(LogCategory category, spdlog::level::level_enum level) {
+            return level >= compiledLevel(category) && level != spdlog::level::off;
+        }
+
+        static bool enabled(LogCategory category, spdlog::level::level_enum level) {
+            return static_cast<uint8_t>(level) >= s_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+        }
+
+        static spdlog::level::level_enum level(LogCategory category) {
+            return static_cast<spdlog::level::level_enum>(s_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed));
+        }
+
+        /** Also lowers the spdlog logger level when needed, so the message reaches the sinks. */
+        static void setLevel(LogCategory category, spdlog::level::level_enum level);
+
+        static void setAllLevels(spdlog::level::level_enum level);
+
+        /** Reads ENGINE_LOG_LEVELS, a comma separated list of category=level, where "*" names every category. */
+        static void configureFromEnvironment();
+
+        static constexpr const char *name(LogCategory category) {
+            return LOG_CATEGORY_NAMES[static_cast<size_t>(category)];
+        }
+
+    private:
+        /** Runtime defaults match the spdlog default, info and above. */
+        static constexpr uint8_t DEFAULT_LEVEL = static_cast<uint8_t>(spdlog::level::info);
+        static inline std::atomic<uint8_t> s_levels[LOG_CATEGORY_COUNT] = {
+            DEFAULT_LEVEL, DEFAULT_LEVEL, DEFAULT_LEVEL, DEFAULT_LEVEL, DEFAULT_LEVEL, DEFAULT_LEVEL, DEFAULT_LEVEL
+        };
+
+        static void syncLoggerLevel();
+    };
+}
+
+#endif
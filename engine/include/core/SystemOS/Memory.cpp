@@ -0,0 +1,197 @@
+#include "Memory.hpp"
+
+#include <cstdlib>
+
+#ifdef DEBUG_ENABLED
+SafeNumeric<uint64_t> Memory::m_memoryUsage;
+SafeNumeric<uint64_t> Memory::m_maxUsage;
+#endif
+
+template <bool p_ensureZero>
+void *Memory::allocStatic(size_t p_bytes, bool p_padAlign) {
+#ifdef DEBUG_ENABLED
+    (void)p_padAlign;
+    const bool prepad = true;
+#else
+    const bool prepad = p_padAlign;
+#endif
+
+    void *memory = nullptr;
+    if constexpr (p_ensureZero) {
+        memory = std::calloc(1, p_bytes + (prepad ? DATA_OFFSET : 0));
+    } else {
+        memory = std::malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+    }
+
+    ERR_FAIL_NULL_V(memory, nullptr);
+
+    if (!prepad) {
+        return memory;
+    }
+
+    uint8_t *bytes = static_cast<uint8_t *>(memory);
+    *reinterpret_cast<uint64_t *>(bytes + SIZE_OFFSET) = p_bytes;
+
+#ifdef DEBUG_ENABLED
+    m_maxUsage.exchangeIfGreater(m_memoryUsage.add(p_bytes));
+#endif
+
+    return bytes + DATA_OFFSET;
+}
+
+template void *Memory::allocStatic<true>(size_t p_bytes, bool p_padAlign);
+template void *Memory::allocStatic<false>(size_t p_bytes, bool p_padAlign);
+
+void *Memory::reallocStatic(void *p_memory, size_t p_bytes, bool p_padAlign) {
+    if (p_memory == nullptr) {
+        return allocStatic(p_bytes, p_padAlign);
+    }
+
+#ifdef DEBUG_ENABLED
+    (void)p_padAlign;
+    const bool prepad = true;
+#else
+    const bool prepad = p_padAlign;
+#endif
+
+    uint8_t *memory = static_cast<uint8_t *>(p_memory);
+
+    if (!prepad) {
+        memory = static_cast<uint8_t *>(std::realloc(memory, p_bytes));
+        ERR_FAIL_COND_V(memory == nullptr && p_bytes > 0, nullptr);
+        return memory;
+    }
+
+    memory -= DATA_OFFSET;
+    uint64_t *size = reinterpret_cast<uint64_t *>(memory + SIZE_OFFSET);
+
+#ifdef DEBUG_ENABLED
+    if (p_bytes > *size) {
+        m_maxUsage.exchangeIfGreater(m_memoryUsage.add(p_bytes - *size));
+    } else {
+        m_memoryUsage.sub(*size - p_bytes);
+    }
+#endif
+
+    if (p_bytes == 0) {
+        std::free(memory);
+        return nullptr;
+    }
+
+    memory = static_cast<uint8_t *>(std::realloc(memory, p_bytes + DATA_OFFSET));
+    ERR_FAIL_NULL_V(memory, nullptr);
+
+    *reinterpret_cast<uint64_t *>(memory + SIZE_OFFSET) = p_bytes;
+    return memory + DATA_OFFSET;
+}
+
+void Memory::freeStatic(void *p_ptr, bool p_padAlign) {
+    ERR_FAIL_NULL(p_ptr);
+
+#ifdef DEBUG_ENABLED
+    (void)p_padAlign;
+    const bool prepad = true;
+#else
+    const bool prepad = p_padAlign;
+#endif
+
+    uint8_t *memory = static_cast<uint8_t *>(p_ptr);
+    if (prepad) {
+        memory -= DATA_OFFSET;
+#ifdef DEBUG_ENABLED
+        m_memoryUsage.sub(*reinterpret_cast<uint64_t *>(memory + SIZE_OFFSET));
+#endif
+    }
+
+    std::free(memory);
+}
+
+void *Memory::allocAlignedStatic(size_t p_bytes, size_t p_alignment) {
+    DEV_ASSERT(is_power_of_2(p_alignment));
+
+    void *base = std::malloc(p_bytes + p_alignment - 1 + sizeof(uint32_t));
+    if (base == nullptr) {
+        return nullptr;
+    }
+
+    void *aligned = reinterpret_cast<void *>((reinterpret_cast<uintptr_t>(base) + sizeof(uint32_t) + p_alignment - 1) & ~(p_alignment - 1));
+    *(static_cast<uint32_t *>(aligned) - 1) = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(aligned) - reinterpret_cast<uintptr_t>(base));
+    return aligned;
+}
+
+void *Memory::reallocAlignedStatic(void *p_memory, size_t p_bytes, size_t p_prevBytes, size_t p_alignment) {
+    if (p_memory == nullptr) {
+        return allocAlignedStatic(p_bytes, p_alignment);
+    }
+
+    void *memory = allocAlignedStatic(p_bytes, p_alignment);
+    if (memory) {
+        std::memcpy(memory, p_memory, MIN(p_bytes, p_prevBytes));
+    }
+    freeAlignedStatic(p_memory);
+    return memory;
+}
+
+void Memory::freeAlignedStatic(void *p_memory) {
+    const uint32_t offset = *(static_cast<uint32_t *>(p_memory) - 1);
+    std::free(static_cast<uint8_t *>(p_memory) - offset);
+}
+
+uint64_t Memory::getMemoryAvailable() {
+    /** Unknown, the allocator is the system one. */
+    return UINT64_MAX;
+}
+
+uint64_t Memory::getMemoryUsage() {
+#ifdef DEBUG_ENABLED
+    return m_memoryUsage.get();
+#else
+    return 0;
+#endif
+}
+
+uint64_t Memory::getMemoryMaxUsage() {
+#ifdef DEBUG_ENABLED
+    return m_maxUsage.get();
+#else
+    return 0;
+#endif
+}
+
+void *operator new(size_t p_size, const char *p_description) {
+    (void)p_description;
+    return Memory::allocStatic(p_size, false);
+}
+
+void *operator new(size_t p_size, void *(*p_allocFunction)(size_t p_size)) {
+    return p_allocFunction(p_size);
+}
+
+void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description) {
+    (void)p_size;
+    (void)check;
+    (void)p_description;
+    return p_pointer;
+}
+
+#ifdef _MSC_VER
+void operator delete(void *p_memory, const char *p_description) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+
+void operator delete(void *p_memory, void *(*p_allocfunc)(size_t p_size)) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+
+void operator delete(void *p_memory, void *p_pointer, size_t check, const char *p_description) {
+    CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
+#endif
+
+_GlobalNil::_GlobalNil() {
+    left = this;
+    right = this;
+    parent = this;
+}
+
+_GlobalNil _GlobalNilClass::_nil;
@@ -117,7 +117,7 @@ void operator delete(void *p_memory, void *p_pointer, size_t check, const char *
 #endif
 
 #define memoryAlloc(m_size) Memory::allocStatic(m_size)
-#define memoryAllocZeroed(m_size) Memory::allocStaticZeroed(m_size)
+#define memoryAllocZeroed(m_size) Memory::allocateStaticZeroed(m_size)
 #define memoryRealloc(m_memory, m_size) Memory::reallocStatic(m_memory, m_size)
 #define memoryFree(m_memory) Memory::freeStatic(m_memory)
 
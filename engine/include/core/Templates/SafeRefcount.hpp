@@ -42,7 +42,7 @@ class SafeNumeric {
 
 public:
     _ALWAYS_INLINE_ void set(T p_value) {
-        value.store(p_value, std::memory_order_release);
+        m_value.store(p_value, std::memory_order_release);
     }
 
     _ALWAYS_INLINE_ T get() const {
@@ -0,0 +1,68 @@
+#ifndef __ENGINE_SPSC_RING_HPP__
+#define __ENGINE_SPSC_RING_HPP__
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+
+namespace Engine {
+    /**
+     * Fixed capacity single-producer/single-consumer queue.
+     *
+     * Each side owns one cache line with its index and a cached copy of the other side's
+     * index, and only reloads the other index when the cached one says the ring is full or
+     * empty, so a steady stream costs one release store per push and per pop.
+     */
+    template <typename T, size_t Capacity>
+    class SpscRing {
+        static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
+    public:
+        /** Producer only. Returns false when the ring is full. */
+        bool push(const T &p_value) {
+            const size_t head = m_head.load(std::memory_order_relaxed);
+            if (head - m_cachedTail == Capacity) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if (head - m_cachedTail == Capacity) {
+                    return false;
+                }
+            }
+
+            m_items[head & (Capacity - 1)] = p_value;
+            m_head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Consumer only. Returns false when the ring is empty. */
+        bool pop(T &p_value) {
+            const size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail == m_cachedHead) {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail == m_cachedHead) {
+                    return false;
+                }
+            }
+
+            p_value = m_items[tail & (Capacity - 1)];
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Approximate from any thread other than the two sides. */
+        size_t size() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+
+        static constexpr size_t capacity() { return Capacity; }
+
+    private:
+        alignas(64) std::atomic<size_t> m_head{0};
+        size_t m_cachedTail = 0;
+
+        alignas(64) std::atomic<size_t> m_tail{0};
+        size_t m_cachedHead = 0;
+
+        alignas(64) std::array<T, Capacity> m_items{};
+    };
+}
+
+#endif
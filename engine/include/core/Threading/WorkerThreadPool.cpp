@@ -0,0 +1,96 @@
+#include "WorkerThreadPool.hpp"
+
+namespace Engine {
+    WorkerThreadPool::WorkerThreadPool(uint32_t p_workerCount) {
+        if (p_workerCount == 0) {
+            const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            p_workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_threads.reserve(p_workerCount);
+        for (uint32_t i = 0; i < p_workerCount; ++i) {
+            m_threads.emplace_back(&WorkerThreadPool::workerLoop, this, i);
+        }
+    }
+
+    WorkerThreadPool::~WorkerThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_exit = true;
+        }
+        m_wakeWorkers.notify_all();
+
+        for (std::thread &thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    void WorkerThreadPool::runJob(Job &p_job, uint32_t p_threadIndex) {
+        uint32_t index;
+        while ((index = p_job.next.fetch_add(1, std::memory_order_relaxed)) < p_job.count) {
+            (*p_job.task)(index, p_threadIndex);
+            p_job.finished.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+    void WorkerThreadPool::parallelFor(uint32_t p_count, const Task &p_task) {
+        if (p_count == 0) {
+            return;
+        }
+
+        const uint32_t callerIndex = static_cast<uint32_t>(m_threads.size());
+
+        if (p_count == 1) {
+            p_task(0, callerIndex);
+            return;
+        }
+
+        Job job;
+        job.task = &p_task;
+        job.count = p_count;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_job = &job;
+            ++m_generation;
+        }
+        m_wakeWorkers.notify_all();
+
+        runJob(job, callerIndex);
+
+        /** Workers that picked the job up may still be touching it, wait for them to let go. */
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobDone.wait(lock, [&] {
+            return m_activeWorkers == 0 && job.finished.load(std::memory_order_acquire) == p_count;
+        });
+        m_job = nullptr;
+    }
+
+    void WorkerThreadPool::workerLoop(uint32_t p_threadIndex) {
+        uint64_t seenGeneration = 0;
+
+        while (true) {
+            Job *job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeWorkers.wait(lock, [&] { return m_exit || (m_job && m_generation != seenGeneration); });
+
+                if (m_exit) {
+                    return;
+                }
+
+                seenGeneration = m_generation;
+                job = m_job;
+                ++m_activeWorkers;
+            }
+
+            runJob(*job, p_threadIndex);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_activeWorkers;
+            }
+            m_jobDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef __ENGINE_WORKER_THREAD_POOL_HPP__
+#define __ENGINE_WORKER_THREAD_POOL_HPP__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Engine {
+    /**
+     * Fixed set of worker threads used for data-parallel engine work.
+     *
+     * Every participating thread has a stable index in [0, threadCount()), the thread calling
+     * parallelFor() always being the last one. Systems that keep per-thread state (command
+     * pools, scratch buffers) index it with the value passed to the task.
+     */
+    class WorkerThreadPool {
+    public:
+        using Task = std::function<void(uint32_t p_index, uint32_t p_threadIndex)>;
+
+        /** `p_workerCount == 0` uses one worker per hardware thread minus the caller. */
+        explicit WorkerThreadPool(uint32_t p_workerCount = 0);
+        ~WorkerThreadPool();
+
+        WorkerThreadPool(const WorkerThreadPool &) = delete;
+        WorkerThreadPool &operator=(const WorkerThreadPool &) = delete;
+
+        /** Number of threads that may run tasks, including the calling thread. */
+        uint32_t threadCount() const { return static_cast<uint32_t>(m_threads.size()) + 1; }
+
+        /** Runs `p_task` for every index in [0, p_count) and returns once all of them finished. */
+        void parallelFor(uint32_t p_count, const Task &p_task);
+
+    private:
+        struct Job {
+            const Task *task = nullptr;
+            uint32_t count = 0;
+            std::atomic<uint32_t> next{0};
+            std::atomic<uint32_t> finished{0};
+        };
+
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeWorkers;
+        std::condition_variable m_jobDone;
+
+        Job *m_job = nullptr;
+        uint64_t m_generation = 0;
+        uint32_t m_activeWorkers = 0;
+        bool m_exit = false;
+
+        void workerLoop(uint32_t p_threadIndex);
+        static void runJob(Job &p_job, uint32_t p_threadIndex);
+    };
+}
+
+#endif
@@ -9,10 +9,33 @@
 #include <memory>
 #include <algorithm>
 #include <limits>
+#include <deque>
+#include <exception>
+#include <thread>
 
 #include <vulkan/vulkan_raii.hpp>
 #include <vulkan/vk_platform.h>
 
+#include "../../Renderer/LowLevelRender/Vulkan/Vulkan.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/DeviceQueues.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/DeviceSelector.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/UploadRing.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/ParallelRecorder.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/ChunkCuller.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/RenderGraph.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/BindlessTextureHeap.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/FramePacer.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/GpuProfiler.hpp"
+#include "../../Renderer/LowLevelRender/Vulkan/ValidationDiagnostics.hpp"
+#include "../Threading/WorkerThreadPool.hpp"
+#include "../Events/Event.hpp"
+#include "../ECS/SystemScheduler.hpp"
+#include "../Input/InputSystem.hpp"
+#include "../Logging/AsyncLog.hpp"
+#include "../Logging/LogCategory.hpp"
+#include "../Logging/BinaryLog.hpp"
+#include "../Errors/ErrorTelemetry.hpp"
+
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
@@ -20,6 +43,9 @@ namespace Engine {
     constexpr uint32_t WIDTH = 800;
     constexpr uint32_t HEIGHT = 600;
 
+    /** Upper bound of chunk draws the culler can compact per frame. */
+    constexpr uint32_t MAX_CHUNK_DRAWS = 65536;
+
     const std::vector validationLayers = {
         "VK_LAYER_KHRONOS_validation"
     };
@@ -35,6 +61,10 @@ namespace Engine {
         Application() {}
 
         void run() {
+            AsyncLog::startFromEnvironment();
+            LogFilter::configureFromEnvironment();
+            BinaryLog::startFromEnvironment();
+            ErrorTelemetry::startFromEnvironment();
             initWindow();
             initVulkan();
             mainLoop();
@@ -47,13 +77,16 @@ namespace Engine {
     private:
         GLFWwindow *m_window = nullptr;
 
+        /** Declared before the messenger so it outlives every callback. */
+        ValidationDiagnostics m_validationDiagnostics;
+
         vk::raii::Context m_context;
         vk::raii::Instance m_instance = nullptr;
         vk::raii::DebugUtilsMessengerEXT m_debugMessenger = nullptr;
         vk::raii::SurfaceKHR m_surface = nullptr;
         vk::raii::PhysicalDevice m_physicalDevice = nullptr;
         vk::raii::Device m_device = nullptr;
-        vk::raii::Queue m_graphicsQueue = nullptr;
+        std::unique_ptr<DeviceQueues> m_queues;
 
         vk::raii::SwapchainKHR m_swapChain = nullptr;
         std::vector<vk::Image> m_swapChainImages;
@@ -61,6 +94,64 @@ namespace Engine {
         vk::Extent2D m_swapChainExtent;
         std::vector<vk::raii::ImageView> m_swapChainImageViews;
 
+        /** Set by a resize input event or a suboptimal acquire/present, the swapchain is rebuilt before the next frame. */
+        bool m_framebufferResized = false;
+
+        /**
+         * Swapchain replaced by a recreation together with the objects frames in flight may still
+         * reference. Core Vulkan has no fence for presentation, the frame fences a few frames later
+         * stand in for it.
+         */
+        struct RetiredSwapChain {
+            vk::raii::SwapchainKHR swapChain = nullptr;
+            std::vector<vk::raii::ImageView> imageViews;
+            std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+            uint64_t retiredAtFrame = 0;
+        };
+
+        std::deque<RetiredSwapChain> m_retiredSwapChains;
+
+        FramePacer m_framePacer = FramePacer::fromEnvironment();
+
+        /** Posted to by the engine and worker threads, drained once per frame in mainLoop(). */
+        EngineEventBus m_events;
+
+        /** Window input, polled by the frame loop or by the main thread while the frame loop runs apart. */
+        InputSystem m_input;
+
+        vk::raii::CommandPool m_commandPool = nullptr;
+        std::vector<vk::raii::CommandBuffer> m_commandBuffers;
+
+        std::vector<vk::raii::Semaphore> m_imageAvailableSemaphores;
+        std::vector<vk::raii::Semaphore> m_renderFinishedSemaphores;
+        std::vector<vk::raii::Fence> m_inFlightFences;
+        uint32_t m_currentFrame = 0;
+
+        std::unique_ptr<UploadRing> m_uploadRing;
+        std::unique_ptr<BindlessTextureHeap> m_textureHeap;
+
+        std::unique_ptr<WorkerThreadPool> m_workerPool;
+        std::unique_ptr<ParallelRecorder> m_parallelRecorder;
+
+        /** Gameplay entities, simulated once per frame by the systems on the worker pool. */
+        World m_world;
+        std::unique_ptr<SystemScheduler> m_systems;
+
+        /** Draw work for the current frame, recorded into secondary command buffers by the workers. */
+        std::vector<RenderWorkItem> m_renderWorkItems;
+
+        std::unique_ptr<ShaderLibrary> m_shaderLibrary;
+        std::unique_ptr<ChunkCuller> m_chunkCuller;
+        glm::mat4 m_viewProjection{1.0f};
+
+        std::unique_ptr<RenderGraph> m_renderGraph;
+        std::unique_ptr<GpuProfiler> m_gpuProfiler;
+
+        /** Main-thread cost of stitching and submitting the last frame. */
+        double m_mainThreadSubmitMilliseconds = 0.0;
+        /** Frames submitted so far, skipped frames do not count; everything retired per frame ages on it. */
+        uint64_t m_frameCounter = 0;
+
         std::vector<const char*> m_requiredDeviceExtension = {
             vk::KHRSwapchainExtensionName,
             vk::KHRSpirv14ExtensionName,
@@ -72,9 +163,10 @@ namespace Engine {
             glfwInit();
 
             glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-            glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
             m_window = glfwCreateWindow(WIDTH, HEIGHT, "Vulkan", nullptr, nullptr);
+            m_input.attach(m_window, InputSystem::pollThreadFromEnvironment());
         }
 
         void initVulkan() {
@@ -84,18 +176,77 @@ namespace Engine {
             pickPhysicalDevice();
             createLogicalDevice();
             createSwapChain();
+            createImageViews();
+            createCommandPool();
+            createCommandBuffers();
+            createSyncObjects();
+            createUploadRing();
+            createTextureHeap();
+            createParallelRecorder();
+            createSystemScheduler();
+            createShaderLibrary();
+            createChunkCuller();
+            createRenderGraph();
+            createGpuProfiler();
         }
 
+        /**
+         * GLFW only processes window events on the main thread, so with a poll thread the frame
+         * loop moves to a thread of its own and the main thread keeps feeding the input ring.
+         */
         void mainLoop() {
-            while (!glfwWindowShouldClose(m_window)) {
-                glfwPollEvents();
+            if (!m_input.pollThread()) {
+                frameLoop();
+                return;
+            }
+
+            std::exception_ptr frameLoopError;
+            std::thread frameThread([this, &frameLoopError] {
+                try {
+                    frameLoop();
+                } catch (...) {
+                    frameLoopError = std::current_exception();
+                }
+                m_input.stopPollLoop();
+            });
+
+            m_input.runPollLoop();
+            frameThread.join();
+
+            if (frameLoopError) {
+                std::rethrow_exception(frameLoopError);
+            }
+        }
+
+        void frameLoop() {
+            while (!m_input.closeRequested()) {
+                /** Input is sampled after the frame-rate limiter so the wait does not add latency. */
+                m_framePacer.waitForFrameSlot();
+                if (!m_input.pollThread()) {
+                    m_input.poll();
+                }
+                drainInput();
+                m_framePacer.markInputSampled();
+
+                /** Events of the previous frame, the workers and the input, before anything is drawn. */
+                m_events.dispatch();
+                m_systems->run();
+                drawFrame();
             }
+
+            m_device.waitIdle();
+            finishGpuProfiling();
+            m_validationDiagnostics.drain();
         }
 
         void cleanup() {
             glfwDestroyWindow(m_window);
 
             glfwTerminate();
+
+            ErrorTelemetry::stop();
+            BinaryLog::stop();
+            AsyncLog::stop();
         }
 
         void createInstance();
@@ -108,20 +259,56 @@ namespace Engine {
 
         void createLogicalDevice();
 
-        void createSwapChain();
+        void createSwapChain(vk::SwapchainKHR oldSwapChain = nullptr);
+
+        void recreateSwapChain();
+
+        void drainInput();
+
+        void releaseRetiredSwapChains();
+
+        void waitForFramesInFlight();
+
+        void createImageViews();
+
+        void createCommandPool();
+
+        void createCommandBuffers();
+
+        void createSyncObjects();
+
+        void createPresentSemaphores();
+
+        void createUploadRing();
+
+        void createTextureHeap();
+
+        void createParallelRecorder();
+        void createSystemScheduler();
+
+        void createShaderLibrary();
+
+        void createChunkCuller();
+
+        void createRenderGraph();
+
+        void createGpuProfiler();
+
+        void finishGpuProfiling();
+
+        void reportFrameTimings();
+
+        void drawFrame();
+
+        void recordCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, uint32_t imageIndex);
 
         static vk::Format chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
 
-        static vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
+        vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
 
         vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities);
 
         std::vector<const char *> getRequiredExtensions();
-
-        static VKAPI_ATTR vk::Bool32 VKAPI_CALL debugCallback(
-            vk::DebugUtilsMessageSeverityFlagBitsEXT severity,
-            vk::DebugUtilsMessageTypeFlagsEXT type,
-            const vk::DebugUtilsMessengerCallbackDataEXT *pCallbackData, void *);
     };
 }
 
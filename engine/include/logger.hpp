@@ -6,17 +6,53 @@
 #include "spdlog/spdlog.h"
 
 namespace Engine {
-    #define LOG_WARNING_ENABLED 1
-    #define LOG_INFO_ENABLED 1
-    #define LOG_DEBUG_ENABLED 1
-    #define LOG_TRACE_ENABLED 1
+    /**
+     * The level switches are only defaults, a build may predefine any of them.
+     * Debug and trace logging is disabled for release builds.
+     */
+    #ifndef LOG_WARNING_ENABLED
+        #define LOG_WARNING_ENABLED 1
+    #endif
+    #ifndef LOG_INFO_ENABLED
+        #define LOG_INFO_ENABLED 1
+    #endif
+    #if defined(RELEASE) && RELEASE == 1
+        #ifndef LOG_DEBUG_ENABLED
+            #define LOG_DEBUG_ENABLED 0
+        #endif
+        #ifndef LOG_TRACE_ENABLED
+            #define LOG_TRACE_ENABLED 0
+        #endif
+    #else
+        #ifndef LOG_DEBUG_ENABLED
+            #define LOG_DEBUG_ENABLED 1
+        #endif
+        #ifndef LOG_TRACE_ENABLED
+            #define LOG_TRACE_ENABLED 1
+        #endif
+    #endif
 
-    /** Disable debug and trace logging for release builds. */
-    #if RELEASE == 1
-        #define LOG_DEBUG_ENABLED 0
-        #define LOG_TRACE_ENABLED 0
+    /** The lowest enabled level is the default compile-time floor of every category. */
+    #ifndef ENGINE_LOG_COMPILE_LEVEL
+        #if LOG_TRACE_ENABLED == 1
+            #define ENGINE_LOG_COMPILE_LEVEL 0
+        #elif LOG_DEBUG_ENABLED == 1
+            #define ENGINE_LOG_COMPILE_LEVEL 1
+        #elif LOG_INFO_ENABLED == 1
+            #define ENGINE_LOG_COMPILE_LEVEL 2
+        #elif LOG_WARNING_ENABLED == 1
+            #define ENGINE_LOG_COMPILE_LEVEL 3
+        #else
+            #define ENGINE_LOG_COMPILE_LEVEL 4
+        #endif
     #endif
+}
 
+#include "core/Logging/AsyncLog.hpp"
+#include "core/Logging/LogCategory.hpp"
+#include "core/Logging/BinaryLog.hpp"
+
+namespace Engine {
     enum class TypeErrors {
         FAILED_CREATE_GAME,
         FAILED_ASSIGNED_FUNCTION_GAME,
@@ -24,45 +60,58 @@ namespace Engine {
         FAILED_APPLICATION_SHUTDOWN_GRACEFULLY
     };
 
-    /** Logs a fatal-level message. */
-    #define ENGINE_LOG_FATAL(...) spdlog::error(__VA_ARGS__);
+    /**
+     * Logs a message of a category (Core, Render, World, ...) at a spdlog level.
+     * Below the compile-time floor of the category the statement is discarded, below the
+     * runtime level the arguments are never evaluated. While the binary log runs (ENGINE_LOG_BINARY)
+     * messages go to its segment files instead of spdlog.
+     */
+    #define ENGINE_LOG_AT(category, level, ...) \
+        do { \
+            if constexpr (::Engine::LogFilter::compiledIn(::Engine::LogCategory::category, level)) { \
+                if (::Engine::LogFilter::enabled(::Engine::LogCategory::category, level)) { \
+                    if (::Engine::BinaryLog::running()) { \
+                        static constinit ::Engine::BinaryLogSite engineLogSite; \
+                        ::Engine::BinaryLog::write(engineLogSite, ::Engine::LogCategory::category, level, __FILE__, __LINE__, __VA_ARGS__); \
+                    } else { \
+                        ::Engine::AsyncLog::write(level, __VA_ARGS__); \
+                    } \
+                } \
+            } \
+        } while (false);
+
+    /** Logs a fatal-level message of a category and waits until it reached the sinks. */
+    #define ENGINE_CLOG_FATAL(category, ...) \
+        do { \
+            ENGINE_LOG_AT(category, spdlog::level::critical, __VA_ARGS__) \
+            ::Engine::AsyncLog::flush(); \
+            ::Engine::BinaryLog::flush(); \
+        } while (false);
+    #define ENGINE_CLOG_ERROR(category, ...) ENGINE_LOG_AT(category, spdlog::level::err, __VA_ARGS__)
+    #define ENGINE_CLOG_WARNING(category, ...) ENGINE_LOG_AT(category, spdlog::level::warn, __VA_ARGS__)
+    #define ENGINE_CLOG_INFO(category, ...) ENGINE_LOG_AT(category, spdlog::level::info, __VA_ARGS__)
+    #define ENGINE_CLOG_DEBUG(category, ...) ENGINE_LOG_AT(category, spdlog::level::debug, __VA_ARGS__)
+    #define ENGINE_CLOG_TRACE(category, ...) ENGINE_LOG_AT(category, spdlog::level::trace, __VA_ARGS__)
+
+    /** Logs a fatal-level message and waits until it reached the sinks. */
+    #define ENGINE_LOG_FATAL(...) ENGINE_CLOG_FATAL(Core, __VA_ARGS__)
 
     #ifndef ENGINE_LOG_ERROR
         /** Logs a error-level message. */
-        #define ENGINE_LOG_ERROR(...) spdlog::error(__VA_ARGS__);
+        #define ENGINE_LOG_ERROR(...) ENGINE_CLOG_ERROR(Core, __VA_ARGS__)
     #endif
 
-    #if LOG_WARNING_ENABLED == 1
-        /** Logs a warning-level message. */
-        #define ENGINE_LOG_WARNING(...) spdlog::warn(__VA_ARGS__);
-    #else
-        /** Does nothing when LOG_WARN_ENABLED != 1 */
-        #define ENGINE_LOG_WARNING(...)
-    #endif
+    /** Logs a warning-level message. */
+    #define ENGINE_LOG_WARNING(...) ENGINE_CLOG_WARNING(Core, __VA_ARGS__)
 
-    #if LOG_INFO_ENABLED == 1
-        /** Logs a info-level message. */
-        #define ENGINE_LOG_INFO(...) spdlog::info(__VA_ARGS__);
-    #else
-        /** Does nothing when LOG_INFO_ENABLED != 1 */
-        #define ENGINE_LOG_INFO(...)
-    #endif
+    /** Logs a info-level message. */
+    #define ENGINE_LOG_INFO(...) ENGINE_CLOG_INFO(Core, __VA_ARGS__)
 
-    #if LOG_DEBUG_ENABLED == 1
-        /** Logs a debug-level message. */
-        #define ENGINE_LOG_DEBUG(...) spdlog::debug(__VA_ARGS__);
-    #else
-        /** Does nothing when LOG_DEBUG_ENABLED != 1 */
-        #define ENGINE_LOG_DEBUG(...)
-    #endif
+    /** Logs a debug-level message. */
+    #define ENGINE_LOG_DEBUG(...) ENGINE_CLOG_DEBUG(Core, __VA_ARGS__)
 
-    #if LOG_TRACE_ENABLED == 1
-        /** Logs a trace-level message. */
-        #define ENGINE_LOG_TRACE(...) spdlog::trace(__VA_ARGS__);
-    #else
-        /** Does nothing when LOG_TRACE_ENABLED != 1 */
-        #define ENGINE_LOG_TRACE(...)
-    #endif
+    /** Logs a trace-level message. */
+    #define ENGINE_LOG_TRACE(...) ENGINE_CLOG_TRACE(Core, __VA_ARGS__)
 }
 
 #endif
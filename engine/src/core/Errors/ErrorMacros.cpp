@@ -1 +1,169 @@
+#include "../../../include/core/Errors/ErrorMacros.hpp"
 
+#include "../../../include/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::atomic<uint32_t> errorSiteBurst{10};
+
+namespace {
+    std::atomic<int64_t> g_errorSiteInterval{5000};
+
+    struct HandlerEntry {
+        ErrorHandlerFunc errorFunc;
+        void *userData;
+    };
+
+    /** Immutable once published, replaced as a whole by addErrorHandler() and removeErrorHandler(). */
+    struct HandlerSnapshot {
+        std::vector<HandlerEntry> handlers;
+    };
+
+    /**
+     * Readers pin the snapshot by counting themselves in the current epoch's slot. A writer
+     * publishes the new snapshot and then flips the epoch twice, waiting each time for the
+     * slot it left to drain, after which no reader can still hold the old snapshot.
+     */
+    struct HandlerRegistry {
+        std::atomic<const HandlerSnapshot *> snapshot{nullptr};
+        std::atomic<uint32_t> epoch{0};
+        std::atomic<uint32_t> readers[2]{};
+
+        /** Serializes writers and owns the intrusive list of the callers. */
+        std::mutex writerMutex;
+        ErrorHandlerList *list = nullptr;
+
+        void publishLocked() {
+            auto *next = new HandlerSnapshot();
+            for (ErrorHandlerList *handler = list; handler; handler = handler->next) {
+                next->handlers.push_back({handler->errorFunc, handler->userData});
+            }
+
+            const HandlerSnapshot *previous = snapshot.exchange(next, std::memory_order_seq_cst);
+            synchronize();
+            delete previous;
+        }
+
+        void synchronize() {
+            for (int flip = 0; flip < 2; ++flip) {
+                const uint32_t left = epoch.fetch_xor(1, std::memory_order_seq_cst) & 1;
+                while (readers[left].load(std::memory_order_seq_cst) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
+
+    HandlerRegistry &registry() {
+        static HandlerRegistry instance;
+        return instance;
+    }
+
+    int64_t steadyMilliseconds() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void dispatch(const char *p_function, const char *p_file, int_fast32_t p_line, const char *p_error,
+                  const char *p_message, bool p_editorNotify, ErrorHandlerType p_type) {
+        const std::string_view message = p_message ? p_message : "";
+        const std::string_view text = message.empty() ? std::string_view(p_error) : message;
+
+        if (p_type == ERROR_HANDLER_WARNING) {
+            ENGINE_LOG_WARNING("{}\n   at: {} ({}:{})", text, p_function, p_file, p_line)
+        } else {
+            ENGINE_LOG_ERROR("{}: {}\n   at: {} ({}:{})", errorHandlerTypeString(p_type), text, p_function, p_file, p_line)
+        }
+
+        HandlerRegistry &handlers = registry();
+        const uint32_t slot = handlers.epoch.load(std::memory_order_seq_cst) & 1;
+        handlers.readers[slot].fetch_add(1, std::memory_order_seq_cst);
+
+        if (const HandlerSnapshot *snapshot = handlers.snapshot.load(std::memory_order_seq_cst)) {
+            for (const HandlerEntry &handler : snapshot->handlers) {
+                handler.errorFunc(handler.userData, p_function, p_file, p_line, p_error, message.data(), p_editorNotify, p_type);
+            }
+        }
+
+        handlers.readers[slot].fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void addErrorHandler(ErrorHandlerList *pHandler) {
+    HandlerRegistry &handlers = registry();
+    std::lock_guard<std::mutex> lock(handlers.writerMutex);
+
+    pHandler->next = handlers.list;
+    handlers.list = pHandler;
+    handlers.publishLocked();
+}
+
+void removeErrorHandler(const ErrorHandlerList *pHandler) {
+    HandlerRegistry &handlers = registry();
+    std::lock_guard<std::mutex> lock(handlers.writerMutex);
+
+    for (ErrorHandlerList **link = &handlers.list; *link; link = &(*link)->next) {
+        if (*link == pHandler) {
+            *link = pHandler->next;
+            break;
+        }
+    }
+    handlers.publishLocked();
+}
+
+void setErrorSiteThrottle(uint32_t pBurst, uint32_t pSummaryIntervalSeconds) {
+    errorSiteBurst.store(pBurst, std::memory_order_relaxed);
+    g_errorSiteInterval.store(static_cast<int64_t>(pSummaryIntervalSeconds) * 1000, std::memory_order_relaxed);
+}
+
+void errorSiteThrottled(ErrorSite &pSite) {
+    pSite.suppressed.fetch_add(1, std::memory_order_relaxed);
+
+    const int64_t now = steadyMilliseconds();
+    int64_t last = pSite.lastSummary.load(std::memory_order_relaxed);
+
+    /** The first suppressed hit only starts the interval. */
+    if (last == 0) {
+        pSite.lastSummary.compare_exchange_strong(last, now, std::memory_order_relaxed);
+        return;
+    }
+
+    const int64_t interval = g_errorSiteInterval.load(std::memory_order_relaxed);
+    if (now - last < interval || !pSite.lastSummary.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uint64_t suppressed = pSite.suppressed.exchange(0, std::memory_order_relaxed);
+    const std::string summary = std::to_string(suppressed) + " more errors suppressed in the last " +
+                                std::to_string((now - last + 500) / 1000) + "s (" + std::to_string(pSite.hits.load(std::memory_order_relaxed)) +
+                                " in total).";
+    dispatch(pSite.function, pSite.file, pSite.line, summary.c_str(), nullptr, false, ERROR_HANDLER_WARNING);
+}
+
+void errorPrintError(const char *p_function, const char *p_file, int_fast32_t p_line, const char *p_error,
+                     bool p_editorNotify, ErrorHandlerType p_type) {
+    dispatch(p_function, p_file, p_line, p_error, nullptr, p_editorNotify, p_type);
+}
+
+void errorPrintError(const char *p_function, const char *p_file, int_fast32_t p_line, const char *p_error,
+                     const char *p_message, bool p_editorNotify, ErrorHandlerType p_type) {
+    dispatch(p_function, p_file, p_line, p_error, p_message, p_editorNotify, p_type);
+}
+
+void errorPrintIndexError(const char *p_function, const char *p_file, int_fast32_t p_line, int64_t p_index,
+                          int64_t p_size, const char *p_indexStr, const char *p_sizeStr, const char *p_message,
+                          bool p_editorNotify, bool fatal) {
+    const std::string error = std::string(fatal ? "FATAL: " : "") + "Index " + p_indexStr + " = " + std::to_string(p_index) +
+                              " is out of bounds (" + p_sizeStr + " = " + std::to_string(p_size) + ").";
+    dispatch(p_function, p_file, p_line, error.c_str(), p_message, p_editorNotify, ERROR_HANDLER_ERROR);
+}
+
+void errorFlushStdout() {
+    Engine::AsyncLog::flush();
+    Engine::BinaryLog::flush();
+    std::fflush(stdout);
+}
@@ -0,0 +1,382 @@
+#include "../../../include/core/Errors/ErrorTelemetry.hpp"
+
+#include "../../../include/logger.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace {
+    /** Intrusive list of every site hit so far, only ever pushed to. */
+    std::atomic<ErrorSite *> g_errorSites{nullptr};
+}
+
+void errorSiteRegister(ErrorSite &pSite) {
+    ErrorSite *head = g_errorSites.load(std::memory_order_relaxed);
+    do {
+        pSite.next = head;
+    } while (!g_errorSites.compare_exchange_weak(head, &pSite, std::memory_order_release, std::memory_order_relaxed));
+}
+
+namespace Engine {
+    namespace {
+        constexpr std::chrono::seconds DEFAULT_EXPORT_INTERVAL{10};
+        /** Longest a connect, and then the whole send, may take before a collector counts as gone. */
+        constexpr std::chrono::seconds SOCKET_TIMEOUT{2};
+
+        /** Rates of the first snapshot are averaged over the run so far. */
+        const std::chrono::steady_clock::time_point g_processStart = std::chrono::steady_clock::now();
+
+        struct TelemetryState {
+            std::mutex exporterMutex;
+            std::condition_variable wakeExporter;
+            std::thread exporter;
+            bool exit = false;
+        };
+
+        TelemetryState &state() {
+            static TelemetryState instance;
+            return instance;
+        }
+
+        /** Label values escape backslashes, quotes and newlines. */
+        void appendLabel(std::string &out, const char *name, std::string_view value) {
+            out += name;
+            out += "=\"";
+            for (char character : value) {
+                if (character == '\\' || character == '"') {
+                    out += '\\';
+                    out += character;
+                } else if (character == '\n') {
+                    out += "\\n";
+                } else {
+                    out += character;
+                }
+            }
+            out += '"';
+        }
+
+        std::string labels(const ErrorSiteStats &site) {
+            std::string out = "{";
+            appendLabel(out, "kind", ErrorTelemetry::kindName(site.kind));
+            out += ',';
+            appendLabel(out, "function", site.function);
+            out += ',';
+            appendLabel(out, "file", site.file);
+            out += ',';
+            appendLabel(out, "line", std::to_string(site.line));
+            out += '}';
+            return out;
+        }
+
+        bool exportTo(const std::string &target, ErrorRateBaseline &baseline) {
+            constexpr std::string_view TCP_PREFIX = "tcp://";
+            if (target.compare(0, TCP_PREFIX.size(), TCP_PREFIX) != 0) {
+                return ErrorTelemetry::exportToFile(target, &baseline);
+            }
+
+            const std::string address = target.substr(TCP_PREFIX.size());
+            const size_t colon = address.rfind(':');
+            const int port = colon == std::string::npos ? 0 : std::atoi(address.c_str() + colon + 1);
+            if (port <= 0 || port > UINT16_MAX) {
+                spdlog::warn("Ignoring ENGINE_ERROR_METRICS=\"{}\", expected a path or tcp://host:port", target);
+                return false;
+            }
+
+            return ErrorTelemetry::exportToSocket(address.substr(0, colon), static_cast<uint16_t>(port), &baseline);
+        }
+    }
+
+    std::vector<ErrorSiteStats> ErrorTelemetry::snapshot(size_t limit, ErrorRateBaseline *baseline) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto since = baseline && baseline->started ? baseline->previousTime : g_processStart;
+        const double elapsed = std::max(std::chrono::duration<double>(now - since).count(), 1e-3);
+        if (baseline) {
+            baseline->previousTime = now;
+            baseline->started = true;
+        }
+
+        std::vector<ErrorSiteStats> stats;
+        for (ErrorSite *site = g_errorSites.load(std::memory_order_acquire); site; site = site->next) {
+            ErrorSiteStats entry;
+            entry.function = site->function;
+            entry.file = site->file;
+            entry.line = site->line;
+            entry.kind = site->kind;
+            entry.hits = site->hits.load(std::memory_order_relaxed);
+
+            uint64_t previous = 0;
+            if (baseline) {
+                uint64_t &stored = baseline->previousHits[site];
+                previous = stored;
+                stored = entry.hits;
+            }
+            entry.rate = static_cast<double>(entry.hits - previous) / elapsed;
+
+            stats.push_back(entry);
+        }
+
+        std::ranges::sort(stats, [](const ErrorSiteStats &a, const ErrorSiteStats &b) {
+            return a.rate != b.rate ? a.rate > b.rate : a.hits > b.hits;
+        });
+
+        if (limit != 0 && stats.size() > limit) {
+            stats.resize(limit);
+        }
+
+        return stats;
+    }
+
+    std::string ErrorTelemetry::formatMetrics(const std::vector<ErrorSiteStats> &stats) {
+        std::string out;
+        out += "# HELP engine_error_site_hits_total Times an ERR_*, WARN_* or CRASH_* call site was hit.\n";
+        out += "# TYPE engine_error_site_hits_total counter\n";
+        for (const ErrorSiteStats &site : stats) {
+            out += "engine_error_site_hits_total" + labels(site) + ' ' + std::to_string(site.hits) + '\n';
+        }
+
+        out += "# HELP engine_error_site_rate Hits per second of a call site since the previous export.\n";
+        out += "# TYPE engine_error_site_rate gauge\n";
+        for (const ErrorSiteStats &site : stats) {
+            out += "engine_error_site_rate" + labels(site) + ' ' + fmt::format("{:.3f}", site.rate) + '\n';
+        }
+
+        return out;
+    }
+
+    bool ErrorTelemetry::exportToFile(const std::string &path, ErrorRateBaseline *baseline) {
+        const std::string metrics = formatMetrics(snapshot(0, baseline));
+        const std::string temporary = path + ".tmp";
+
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file || !file.write(metrics.data(), static_cast<std::streamsize>(metrics.size()))) {
+                return false;
+            }
+        }
+
+#ifdef _WIN32
+        std::remove(path.c_str());
+#endif
+        return std::rename(temporary.c_str(), path.c_str()) == 0;
+    }
+
+    bool ErrorTelemetry::exportToSocket(const std::string &host, uint16_t port, ErrorRateBaseline *baseline) {
+#ifdef _WIN32
+        static const bool started = [] {
+            WSADATA data;
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        if (!started) {
+            return false;
+        }
+        using Socket = SOCKET;
+        using PollDescriptor = WSAPOLLFD;
+        constexpr Socket INVALID = INVALID_SOCKET;
+        constexpr int SEND_FLAGS = 0;
+        const auto closeSocket = [](Socket socket) { closesocket(socket); };
+        const auto pollSockets = [](PollDescriptor *descriptors, int timeoutMs) { return WSAPoll(descriptors, 1, timeoutMs); };
+        const auto makeNonBlocking = [](Socket socket) {
+            u_long nonBlocking = 1;
+            return ioctlsocket(socket, FIONBIO, &nonBlocking) == 0;
+        };
+        const auto wouldBlock = [] { return WSAGetLastError() == WSAEWOULDBLOCK; };
+        const auto connecting = wouldBlock;
+#else
+        using Socket = int;
+        using PollDescriptor = pollfd;
+        constexpr Socket INVALID = -1;
+    #ifdef MSG_NOSIGNAL
+        /** A collector that hangs up must not kill the process with SIGPIPE. */
+        constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+    #else
+        constexpr int SEND_FLAGS = 0;
+    #endif
+        const auto closeSocket = [](Socket socket) { ::close(socket); };
+        const auto pollSockets = [](PollDescriptor *descriptors, int timeoutMs) { return ::poll(descriptors, 1, timeoutMs); };
+        const auto makeNonBlocking = [](Socket socket) {
+    #ifdef SO_NOSIGPIPE
+            /** Apple has no MSG_NOSIGNAL, the socket itself opts out of SIGPIPE. */
+            const int noSignal = 1;
+            if (setsockopt(socket, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal)) != 0) {
+                return false;
+            }
+    #endif
+            return fcntl(socket, F_SETFL, fcntl(socket, F_GETFL, 0) | O_NONBLOCK) == 0;
+        };
+        const auto wouldBlock = [] { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; };
+        const auto connecting = [] { return errno == EINPROGRESS || errno == EINTR; };
+#endif
+
+        /** Waits for `connection` to become writable until `deadline`, a stalled collector cannot hold the exporter. */
+        const auto waitWritable = [&](Socket connection, std::chrono::steady_clock::time_point deadline) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                return false;
+            }
+            PollDescriptor descriptor{};
+            descriptor.fd = connection;
+            descriptor.events = POLLOUT;
+            return pollSockets(&descriptor, static_cast<int>(remaining.count())) == 1 && (descriptor.revents & POLLOUT) != 0;
+        };
+
+        const auto connectWithin = [&](Socket connection, const addrinfo &address) {
+            if (!makeNonBlocking(connection)) {
+                return false;
+            }
+            if (::connect(connection, address.ai_addr, static_cast<int>(address.ai_addrlen)) == 0) {
+                return true;
+            }
+            if (!connecting() || !waitWritable(connection, std::chrono::steady_clock::now() + SOCKET_TIMEOUT)) {
+                return false;
+            }
+            int error = 0;
+            socklen_t length = sizeof(error);
+            return getsockopt(connection, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &length) == 0 && error == 0;
+        };
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = nullptr;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+            return false;
+        }
+
+        Socket connection = INVALID;
+        for (addrinfo *address = addresses; address && connection == INVALID; address = address->ai_next) {
+            connection = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (connection != INVALID && !connectWithin(connection, *address)) {
+                closeSocket(connection);
+                connection = INVALID;
+            }
+        }
+        freeaddrinfo(addresses);
+
+        if (connection == INVALID) {
+            return false;
+        }
+
+        const std::string metrics = formatMetrics(snapshot(0, baseline));
+        const auto deadline = std::chrono::steady_clock::now() + SOCKET_TIMEOUT;
+        size_t sent = 0;
+        while (sent < metrics.size()) {
+            const auto written = ::send(connection, metrics.data() + sent, static_cast<int>(metrics.size() - sent), SEND_FLAGS);
+            if (written > 0) {
+                sent += static_cast<size_t>(written);
+            } else if (written == 0 || !wouldBlock() || !waitWritable(connection, deadline)) {
+                break;
+            }
+        }
+
+        closeSocket(connection);
+        return sent == metrics.size();
+    }
+
+    void ErrorTelemetry::startFromEnvironment() {
+        const char *target = std::getenv("ENGINE_ERROR_METRICS");
+        if (!target || !*target) {
+            return;
+        }
+
+        std::chrono::seconds interval = DEFAULT_EXPORT_INTERVAL;
+        if (const char *value = std::getenv("ENGINE_ERROR_METRICS_INTERVAL")) {
+            char *end = nullptr;
+            const long seconds = std::strtol(value, &end, 10);
+            if (end == value || *end != '\0' || seconds <= 0) {
+                spdlog::warn("Ignoring ENGINE_ERROR_METRICS_INTERVAL=\"{}\", expected a positive number of seconds", value);
+            } else {
+                interval = std::chrono::seconds(seconds);
+            }
+        }
+
+        start(target, interval);
+    }
+
+    void ErrorTelemetry::start(const std::string &target, std::chrono::seconds interval) {
+        TelemetryState &telemetry = state();
+        std::lock_guard<std::mutex> lock(telemetry.exporterMutex);
+        if (telemetry.exporter.joinable()) {
+            return;
+        }
+
+        telemetry.exit = false;
+        telemetry.exporter = std::thread([&telemetry, target, interval] {
+            ErrorRateBaseline baseline;
+            bool failing = false;
+
+            std::unique_lock<std::mutex> lock(telemetry.exporterMutex);
+            while (true) {
+                const bool exiting = telemetry.wakeExporter.wait_for(lock, interval, [&telemetry] { return telemetry.exit; });
+
+                lock.unlock();
+                const bool exported = exportTo(target, baseline);
+                if (!exported && !failing) {
+                    ENGINE_LOG_WARNING("Failed to export error metrics to {}", target)
+                }
+                failing = !exported;
+                lock.lock();
+
+                if (exiting) {
+                    break;
+                }
+            }
+        });
+    }
+
+    void ErrorTelemetry::stop() {
+        TelemetryState &telemetry = state();
+        {
+            std::lock_guard<std::mutex> lock(telemetry.exporterMutex);
+            if (!telemetry.exporter.joinable()) {
+                return;
+            }
+            telemetry.exit = true;
+        }
+
+        telemetry.wakeExporter.notify_one();
+        telemetry.exporter.join();
+    }
+
+    const char *ErrorTelemetry::kindName(ErrorSiteKind kind) {
+        switch (kind) {
+            case ERROR_SITE_ERROR: {
+                return "error";
+            }
+
+            case ERROR_SITE_WARNING: {
+                return "warning";
+            }
+
+            case ERROR_SITE_CRASH: {
+                return "crash";
+            }
+        }
+
+        return "unknown";
+    }
+}
@@ -1,5 +1,9 @@
 #include "../../../include/core/application/Application.hpp"
 
+#include "../../../include/logger.hpp"
+
+#include <chrono>
+
 namespace Engine {
     void Application::createInstance() {
         vk::ApplicationInfo appInfo{};
@@ -51,12 +55,14 @@ namespace Engine {
             return;
         }
 
-        vk::DebugUtilsMessageSeverityFlagsEXT severityFlags(vk::DebugUtilsMessageSeverityFlagBitsEXT::eVerbose | vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError);
+        /** Verbose output was never shown, not subscribing to it keeps the layers from calling back at all. */
+        vk::DebugUtilsMessageSeverityFlagsEXT severityFlags(vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning | vk::DebugUtilsMessageSeverityFlagBitsEXT::eError);
         vk::DebugUtilsMessageTypeFlagsEXT messageTypeFlags(vk::DebugUtilsMessageTypeFlagBitsEXT::eGeneral | vk::DebugUtilsMessageTypeFlagBitsEXT::ePerformance | vk::DebugUtilsMessageTypeFlagBitsEXT::eValidation);
         vk::DebugUtilsMessengerCreateInfoEXT debugUtilsMessengerCreateInfoEXT{};
         debugUtilsMessengerCreateInfoEXT.messageSeverity = severityFlags;
         debugUtilsMessengerCreateInfoEXT.messageType = messageTypeFlags;
-        debugUtilsMessengerCreateInfoEXT.pfnUserCallback = &debugCallback;
+        debugUtilsMessengerCreateInfoEXT.pfnUserCallback = &ValidationDiagnostics::callback;
+        debugUtilsMessengerCreateInfoEXT.pUserData = &m_validationDiagnostics;
         m_debugMessenger = m_instance.createDebugUtilsMessengerEXT(debugUtilsMessengerCreateInfoEXT);
     }
 
@@ -68,89 +74,45 @@ namespace Engine {
         m_surface = vk::raii::SurfaceKHR(m_instance, surface);
     }
 
-    void Application::pickPhysicalDevice()
-    {
-        std::vector<vk::raii::PhysicalDevice> devices = m_instance.enumeratePhysicalDevices();
-        const auto devIter = std::ranges::find_if(
-            devices,
-            [&](auto const &device)
-            {
-                bool supportsVulkan1_4 = device.getProperties().apiVersion >= VK_API_VERSION_1_3;
-
-                auto queueFamilies = device.getQueueFamilyProperties();
-                bool supportsGraphics =
-                    std::ranges::any_of(queueFamilies, [](auto const &qfp)
-                                        { return !!(qfp.queueFlags & vk::QueueFlagBits::eGraphics); });
-
-                auto availableDeviceExtensions = device.enumerateDeviceExtensionProperties();
-                bool supportsAllRequiredExtensions =
-                    std::ranges::all_of(m_requiredDeviceExtension,
-                                        [&availableDeviceExtensions](auto const &requiredDeviceExtension)
-                                        {
-                                            return std::ranges::any_of(availableDeviceExtensions,
-                                                                       [requiredDeviceExtension](auto const &availableDeviceExtension)
-                                                                       { return strcmp(availableDeviceExtension.extensionName, requiredDeviceExtension) == 0; });
-                                        });
-
-                auto features = device.template getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
-                bool supportsRequiredFeatures = features.template get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering &&
-                                                features.template get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState;
-
-                return supportsVulkan1_4 && supportsGraphics && supportsAllRequiredExtensions && supportsRequiredFeatures;
-            });
-        if (devIter != devices.end()) {
-            m_physicalDevice = *devIter;
-        } else {
-            throw std::runtime_error("failed to find a suitable GPU!");
-        }
+    void Application::pickPhysicalDevice() {
+        m_physicalDevice = DeviceSelector(m_requiredDeviceExtension, *m_surface).select(m_instance);
     }
 
     void Application::createLogicalDevice() {
-        std::vector<vk::QueueFamilyProperties> queueFamilyProperties = m_physicalDevice.getQueueFamilyProperties();
-
-        uint32_t queueIndex = ~0;
-
-        for (uint32_t familyIndex = 0; familyIndex < queueFamilyProperties.size(); ++familyIndex) {
-            if ((queueFamilyProperties[familyIndex].queueFlags & vk::QueueFlagBits::eGraphics) &&
-                m_physicalDevice.getSurfaceSupportKHR(familyIndex, *m_surface)) {
-                queueIndex = familyIndex;
-                break;
-            }
-        }
-
-        if (queueIndex == ~0) {
-            throw std::runtime_error("Could not find a queue for graphics and present -> terminating");
-        }
-
-        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain;
+        m_queues = std::make_unique<DeviceQueues>(m_physicalDevice, *m_surface);
+
+        vk::StructureChain<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features, vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain;
+        /** Optional, the GPU profiler only collects pipeline statistics when both are available. */
+        const vk::PhysicalDeviceFeatures supportedFeatures = m_physicalDevice.getFeatures();
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery && supportedFeatures.inheritedQueries;
+        featureChain.get<vk::PhysicalDeviceFeatures2>().features.inheritedQueries = supportedFeatures.pipelineStatisticsQuery && supportedFeatures.inheritedQueries;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().timelineSemaphore = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().drawIndirectCount = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().descriptorIndexing = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().runtimeDescriptorArray = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingPartiallyBound = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().descriptorBindingSampledImageUpdateAfterBind = true;
+        featureChain.get<vk::PhysicalDeviceVulkan12Features>().shaderSampledImageArrayNonUniformIndexing = true;
         featureChain.get<vk::PhysicalDeviceVulkan13Features>().dynamicRendering = true;
+        featureChain.get<vk::PhysicalDeviceVulkan13Features>().synchronization2 = true;
         featureChain.get<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>().extendedDynamicState = true;
 
-        float queuePriority = 0.0f;
-        vk::DeviceQueueCreateInfo deviceQueueCreateInfo(
-            vk::DeviceQueueCreateFlags(),
-            queueIndex,
-            1,
-            &queuePriority
-        );
-
         vk::DeviceCreateInfo deviceCreateInfo;
         deviceCreateInfo.pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>();
-        deviceCreateInfo.queueCreateInfoCount = 1;
-        deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
+        deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(m_queues->createInfos().size());
+        deviceCreateInfo.pQueueCreateInfos = m_queues->createInfos().data();
         deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(m_requiredDeviceExtension.size());
         deviceCreateInfo.ppEnabledExtensionNames = m_requiredDeviceExtension.data();
 
         m_device = vk::raii::Device(m_physicalDevice, deviceCreateInfo);
-        m_graphicsQueue = vk::raii::Queue(m_device, queueIndex, 0);
+        m_queues->retrieve(m_device);
     }
 
-    void Application::createSwapChain() {
+    void Application::createSwapChain(vk::SwapchainKHR oldSwapChain) {
         auto surfaceCapabilities = m_physicalDevice.getSurfaceCapabilitiesKHR(m_surface);
         m_swapChainImageFormat = chooseSwapSurfaceFormat(m_physicalDevice.getSurfaceFormatsKHR(m_surface));
         m_swapChainExtent = chooseSwapExtent(surfaceCapabilities);
-        auto minImageCount = std::max(3u, surfaceCapabilities.minImageCount);
-        minImageCount = ( surfaceCapabilities.maxImageCount > 0 && minImageCount > surfaceCapabilities.maxImageCount ) ? surfaceCapabilities.maxImageCount : minImageCount;
+        const uint32_t minImageCount = m_framePacer.chooseImageCount(surfaceCapabilities);
         vk::SwapchainCreateInfoKHR swapChainCreateInfo{};
         swapChainCreateInfo.surface = m_surface;
         swapChainCreateInfo.minImageCount = minImageCount;
@@ -164,11 +126,390 @@ namespace Engine {
         swapChainCreateInfo.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
         swapChainCreateInfo.presentMode = chooseSwapPresentMode(m_physicalDevice.getSurfacePresentModesKHR(m_surface)),
         swapChainCreateInfo.clipped = true;
+        swapChainCreateInfo.oldSwapchain = oldSwapChain;
 
         m_swapChain = vk::raii::SwapchainKHR(m_device, swapChainCreateInfo);
         m_swapChainImages = m_swapChain.getImages();
     }
 
+    void Application::recreateSwapChain() {
+        int32_t width = 0;
+        int32_t height = 0;
+        m_input.framebufferSize(width, height);
+        if (width == 0 || height == 0) {
+            /** Minimized, keep the flag set and retry once the window has an area again. */
+            m_framebufferResized = true;
+            return;
+        }
+
+        /**
+         * No device wait: the old swapchain is handed to the driver as oldSwapchain, and it stays
+         * alive with its views and present semaphores until the frames using them retire.
+         */
+        RetiredSwapChain retired;
+        retired.swapChain = std::move(m_swapChain);
+        retired.imageViews = std::move(m_swapChainImageViews);
+        retired.renderFinishedSemaphores = std::move(m_renderFinishedSemaphores);
+        retired.retiredAtFrame = m_frameCounter;
+
+        createSwapChain(*retired.swapChain);
+        createImageViews();
+        createPresentSemaphores();
+
+        m_retiredSwapChains.push_back(std::move(retired));
+        m_framebufferResized = false;
+
+        ENGINE_LOG_INFO("Swapchain recreated at {}x{} with {} images", m_swapChainExtent.width, m_swapChainExtent.height,
+                        m_swapChainImages.size())
+    }
+
+    void Application::releaseRetiredSwapChains() {
+        while (!m_retiredSwapChains.empty() && m_retiredSwapChains.front().retiredAtFrame + MAX_FRAMES_IN_FLIGHT + 1 <= m_frameCounter) {
+            m_retiredSwapChains.pop_front();
+        }
+    }
+
+    void Application::drainInput() {
+        m_input.drain([this](const InputEvent &event) {
+            if (event.type == InputEventType::FramebufferResized) {
+                m_framebufferResized = true;
+                m_events.post(WindowResizedEvent{static_cast<int32_t>(event.x), static_cast<int32_t>(event.y)});
+                return;
+            }
+
+            m_events.post(event);
+        });
+    }
+
+    void Application::createImageViews() {
+        m_swapChainImageViews.clear();
+
+        vk::ImageViewCreateInfo imageViewCreateInfo{};
+        imageViewCreateInfo.viewType = vk::ImageViewType::e2D;
+        imageViewCreateInfo.format = m_swapChainImageFormat;
+        imageViewCreateInfo.subresourceRange = vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1);
+
+        for (auto image : m_swapChainImages) {
+            imageViewCreateInfo.image = image;
+            m_swapChainImageViews.emplace_back(m_device, imageViewCreateInfo);
+        }
+    }
+
+    void Application::createCommandPool() {
+        vk::CommandPoolCreateInfo poolInfo{};
+        poolInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        poolInfo.queueFamilyIndex = m_queues->family(QueueType::Graphics);
+        m_commandPool = vk::raii::CommandPool(m_device, poolInfo);
+    }
+
+    void Application::createCommandBuffers() {
+        vk::CommandBufferAllocateInfo allocInfo{};
+        allocInfo.commandPool = *m_commandPool;
+        allocInfo.level = vk::CommandBufferLevel::ePrimary;
+        allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
+
+        m_commandBuffers.clear();
+        for (auto &commandBuffer : vk::raii::CommandBuffers(m_device, allocInfo)) {
+            m_commandBuffers.push_back(std::move(commandBuffer));
+        }
+    }
+
+    void Application::createSyncObjects() {
+        m_imageAvailableSemaphores.clear();
+        m_inFlightFences.clear();
+
+        createPresentSemaphores();
+
+        for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+            m_imageAvailableSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
+            m_inFlightFences.emplace_back(m_device, vk::FenceCreateInfo(vk::FenceCreateFlagBits::eSignaled));
+        }
+    }
+
+    void Application::createPresentSemaphores() {
+        /** One per swapchain image, a present may still wait on it while the frame slot is reused. */
+        m_renderFinishedSemaphores.clear();
+
+        for (size_t i = 0; i < m_swapChainImages.size(); ++i) {
+            m_renderFinishedSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
+        }
+    }
+
+    void Application::createUploadRing() {
+        m_uploadRing = std::make_unique<UploadRing>(m_physicalDevice, m_device, *m_queues);
+    }
+
+    void Application::createParallelRecorder() {
+        m_workerPool = std::make_unique<WorkerThreadPool>();
+        m_parallelRecorder = std::make_unique<ParallelRecorder>(m_device, m_queues->family(QueueType::Graphics), *m_workerPool);
+    }
+
+    void Application::createSystemScheduler() {
+        m_systems = std::make_unique<SystemScheduler>(m_world, *m_workerPool);
+    }
+
+    void Application::createShaderLibrary() {
+        m_shaderLibrary = std::make_unique<ShaderLibrary>(m_device);
+    }
+
+    void Application::createChunkCuller() {
+        const bool computeAvailable = !!(m_queues->familyFlags(QueueType::Graphics) & vk::QueueFlagBits::eCompute);
+
+        m_chunkCuller = std::make_unique<ChunkCuller>(m_physicalDevice, m_device, MAX_CHUNK_DRAWS, computeAvailable, *m_shaderLibrary);
+    }
+
+    void Application::createTextureHeap() {
+        m_textureHeap = std::make_unique<BindlessTextureHeap>(m_physicalDevice, m_device, *m_uploadRing);
+    }
+
+    void Application::createRenderGraph() {
+        m_renderGraph = std::make_unique<RenderGraph>(m_physicalDevice, m_device);
+    }
+
+    void Application::createGpuProfiler() {
+        const vk::PhysicalDeviceFeatures supportedFeatures = m_physicalDevice.getFeatures();
+        const bool statisticsSupported = supportedFeatures.pipelineStatisticsQuery && supportedFeatures.inheritedQueries;
+
+        m_gpuProfiler = std::make_unique<GpuProfiler>(m_physicalDevice, m_device, m_queues->family(QueueType::Graphics),
+                                                      GpuProfiler::modeFromEnvironment(), statisticsSupported);
+
+        if (m_gpuProfiler->mode() != GpuProfilerMode::Off) {
+            m_renderGraph->setPassHooks(
+                [this](const vk::raii::CommandBuffer &commandBuffer, const char *passName) { m_gpuProfiler->beginPass(commandBuffer, passName); },
+                [this](const vk::raii::CommandBuffer &commandBuffer, const char *passName) { m_gpuProfiler->endPass(commandBuffer, passName); });
+        }
+    }
+
+    void Application::finishGpuProfiling() {
+        m_gpuProfiler->resolveAll();
+
+        if (const char *tracePath = std::getenv("ENGINE_GPU_TRACE")) {
+            if (m_gpuProfiler->exportTrace(tracePath)) {
+                ENGINE_LOG_INFO("GPU trace written to {}", tracePath)
+            } else {
+                ENGINE_LOG_ERROR("Failed to write the GPU trace to {}", tracePath)
+            }
+        }
+
+        if (m_gpuProfiler->mode() != GpuProfilerMode::Off) {
+            ENGINE_LOG_INFO("GPU pass timings:\n{}", m_gpuProfiler->formatTable())
+        }
+    }
+
+    void Application::reportFrameTimings() {
+        constexpr uint64_t REPORT_INTERVAL = 600;
+
+        if (++m_frameCounter % REPORT_INTERVAL != 0) {
+            return;
+        }
+
+        if (!m_parallelRecorder->lastTimings().empty()) {
+            ENGINE_LOG_DEBUG("CPU frame breakdown: main thread submit {:.3f} ms\n{}",
+                             m_mainThreadSubmitMilliseconds, m_parallelRecorder->formatTimings())
+        }
+
+        const FramePacingStatistics pacing = m_framePacer.statistics();
+        ENGINE_LOG_DEBUG("Frame pacing ({}): {:.2f} ms/frame, deviation {:.2f} ms, worst {:.2f} ms, "
+                         "input-to-present {:.2f} ms (worst {:.2f} ms), {} frames in flight",
+                         FramePacer::modeName(m_framePacer.mode()), pacing.averageFrameMilliseconds,
+                         pacing.frameTimeDeviationMilliseconds, pacing.worstFrameMilliseconds,
+                         pacing.averageLatencyMilliseconds, pacing.worstLatencyMilliseconds, pacing.framesInFlight)
+
+        const InputLatencyStatistics input = m_input.takeStatistics();
+        ENGINE_CLOG_DEBUG(Input, "Input: {} events from {} samples, input-to-simulation {:.2f} ms (worst {:.2f} ms), {} dropped",
+                          input.events, input.samples, input.averageMilliseconds, input.worstMilliseconds, input.dropped)
+
+        const CullStatistics &cullStatistics = m_chunkCuller->statistics();
+        ENGINE_LOG_DEBUG("Chunk culling ({}): {} tested, {} frustum rejected, {} occlusion rejected, {} visible",
+                         m_chunkCuller->usesCompute() ? "GPU" : "CPU", cullStatistics.tested, cullStatistics.frustumRejected,
+                         cullStatistics.occlusionRejected, cullStatistics.visible)
+
+        const RenderGraph::Statistics &graphStatistics = m_renderGraph->statistics();
+        ENGINE_LOG_DEBUG("Render graph: {} passes, {} culled, {} barriers, {} transient images in {} bytes ({} bytes aliased)",
+                         graphStatistics.passes, graphStatistics.culledPasses, graphStatistics.barriers,
+                         graphStatistics.transientImages, graphStatistics.transientBytes, graphStatistics.aliasedBytes)
+
+        if (m_gpuProfiler->mode() != GpuProfilerMode::Off) {
+            ENGINE_LOG_DEBUG("GPU passes ({} frames behind):\n{}", MAX_FRAMES_IN_FLIGHT, m_gpuProfiler->formatTable())
+            m_gpuProfiler->resetTable();
+        }
+    }
+
+    void Application::waitForFramesInFlight() {
+        const auto waitStart = std::chrono::steady_clock::now();
+
+        /** With fewer frames in flight than slots, the previous slots must have retired as well. */
+        const uint32_t slotsToWait = MAX_FRAMES_IN_FLIGHT - m_framePacer.framesInFlight() + 1;
+        for (uint32_t i = 0; i < slotsToWait; ++i) {
+            const uint32_t frame = (m_currentFrame + MAX_FRAMES_IN_FLIGHT - i) % MAX_FRAMES_IN_FLIGHT;
+            while (vk::Result::eTimeout == m_device.waitForFences(*m_inFlightFences[frame], vk::True, UINT64_MAX)) {
+            }
+        }
+
+        m_framePacer.recordFenceWait(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count());
+    }
+
+    void Application::drawFrame() {
+        waitForFramesInFlight();
+        m_validationDiagnostics.drain();
+
+        if (m_framePacer.consumeSwapChainChange()) {
+            m_framebufferResized = true;
+        }
+
+        m_parallelRecorder->beginFrame(m_currentFrame);
+        m_textureHeap->beginFrame(m_currentFrame, m_frameCounter);
+        m_shaderLibrary->poll(m_frameCounter);
+        releaseRetiredSwapChains();
+
+        if (m_framebufferResized) {
+            recreateSwapChain();
+
+            if (m_framebufferResized) {
+                m_input.waitEvents(0.05);
+                return;
+            }
+        }
+
+        uint32_t imageIndex = 0;
+        try {
+            auto [result, acquiredIndex] = m_swapChain.acquireNextImage(UINT64_MAX, *m_imageAvailableSemaphores[m_currentFrame], nullptr);
+            imageIndex = acquiredIndex;
+
+            /** The image is acquired and its semaphore signalled, render it and rebuild after presenting. */
+            if (result == vk::Result::eSuboptimalKHR) {
+                m_framebufferResized = true;
+            }
+        } catch (const vk::OutOfDateKHRError &) {
+            /** Nothing was acquired and the fence is still signalled, so the frame slot can simply be retried. */
+            recreateSwapChain();
+            return;
+        }
+
+        m_device.resetFences(*m_inFlightFences[m_currentFrame]);
+
+        /** One transfer submit per frame carrying everything producers staged since the last one. */
+        m_uploadRing->flush();
+
+        m_chunkCuller->cullOnCpu(m_currentFrame, m_viewProjection);
+
+        const vk::raii::CommandBuffer &commandBuffer = m_commandBuffers[m_currentFrame];
+        commandBuffer.reset();
+        recordCommandBuffer(commandBuffer, imageIndex);
+
+        const auto submitStart = std::chrono::steady_clock::now();
+
+        std::vector<vk::SemaphoreSubmitInfo> waitInfos;
+        vk::SemaphoreSubmitInfo imageAvailableInfo{};
+        imageAvailableInfo.semaphore = *m_imageAvailableSemaphores[m_currentFrame];
+        imageAvailableInfo.stageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+        waitInfos.push_back(imageAvailableInfo);
+
+        if (auto uploadWait = m_uploadRing->graphicsWait()) {
+            waitInfos.push_back(*uploadWait);
+        }
+
+        vk::SemaphoreSubmitInfo renderFinishedInfo{};
+        renderFinishedInfo.semaphore = *m_renderFinishedSemaphores[imageIndex];
+        renderFinishedInfo.stageMask = vk::PipelineStageFlagBits2::eAllCommands;
+
+        vk::CommandBufferSubmitInfo commandBufferInfo{};
+        commandBufferInfo.commandBuffer = *commandBuffer;
+
+        vk::SubmitInfo2 submitInfo{};
+        submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(waitInfos.size());
+        submitInfo.pWaitSemaphoreInfos = waitInfos.data();
+        submitInfo.commandBufferInfoCount = 1;
+        submitInfo.pCommandBufferInfos = &commandBufferInfo;
+        submitInfo.signalSemaphoreInfoCount = 1;
+        submitInfo.pSignalSemaphoreInfos = &renderFinishedInfo;
+        m_queues->submit(QueueType::Graphics, submitInfo, *m_inFlightFences[m_currentFrame]);
+
+        vk::PresentInfoKHR presentInfo{};
+        presentInfo.waitSemaphoreCount = 1;
+        presentInfo.pWaitSemaphores = &*m_renderFinishedSemaphores[imageIndex];
+        presentInfo.swapchainCount = 1;
+        presentInfo.pSwapchains = &*m_swapChain;
+        presentInfo.pImageIndices = &imageIndex;
+        try {
+            if (m_queues->present(presentInfo) == vk::Result::eSuboptimalKHR) {
+                m_framebufferResized = true;
+            }
+        } catch (const vk::OutOfDateKHRError &) {
+            m_framebufferResized = true;
+        }
+        m_framePacer.markPresented();
+
+        m_mainThreadSubmitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submitStart).count();
+        reportFrameTimings();
+
+        m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    }
+
+    void Application::recordCommandBuffer(const vk::raii::CommandBuffer &commandBuffer, uint32_t imageIndex) {
+        /** Workers record the scene while this thread only stitches the results together. */
+        std::vector<vk::CommandBuffer> secondaryCommandBuffers;
+        if (!m_renderWorkItems.empty()) {
+            vk::CommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+            inheritanceRenderingInfo.colorAttachmentCount = 1;
+            inheritanceRenderingInfo.pColorAttachmentFormats = &m_swapChainImageFormat;
+            inheritanceRenderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+            secondaryCommandBuffers = m_parallelRecorder->record(inheritanceRenderingInfo, m_renderWorkItems,
+                                                                 m_gpuProfiler->inheritedStatistics());
+        }
+
+        const auto stitchStart = std::chrono::steady_clock::now();
+
+        commandBuffer.begin({});
+
+        m_gpuProfiler->beginFrame(commandBuffer, m_currentFrame);
+
+        m_uploadRing->recordAcquireBarriers(commandBuffer);
+
+        m_renderGraph->reset(m_currentFrame);
+
+        RenderGraphImageInfo backbufferInfo{};
+        backbufferInfo.format = m_swapChainImageFormat;
+        backbufferInfo.extent = m_swapChainExtent;
+        const RenderGraphHandle backbuffer = m_renderGraph->importImage("Backbuffer", m_swapChainImages[imageIndex],
+                                                                        *m_swapChainImageViews[imageIndex], backbufferInfo,
+                                                                        vk::ImageLayout::eUndefined,
+                                                                        vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                                                        vk::ImageLayout::ePresentSrcKHR);
+
+        /** The culler and the pyramid build synchronize their own buffers, the graph only orders them. */
+        m_renderGraph->addPass("ChunkCull",
+            [](RenderGraphPassBuilder &builder) { builder.sideEffects(); },
+            [this](const RenderGraphContext &context) {
+                m_chunkCuller->recordCull(context.commandBuffer, m_currentFrame, m_viewProjection);
+            });
+
+        const bool hasSecondaries = !secondaryCommandBuffers.empty();
+        m_renderGraph->addPass("Scene",
+            [&](RenderGraphPassBuilder &builder) {
+                builder.colorAttachment(backbuffer, vk::AttachmentLoadOp::eClear);
+                if (hasSecondaries) {
+                    builder.secondaryCommandBuffers();
+                }
+            },
+            [&secondaryCommandBuffers](const RenderGraphContext &context) {
+                if (!secondaryCommandBuffers.empty()) {
+                    context.commandBuffer.executeCommands(secondaryCommandBuffers);
+                }
+            });
+
+        m_renderGraph->addPass("HiZ",
+            [](RenderGraphPassBuilder &builder) { builder.sideEffects(); },
+            [this](const RenderGraphContext &context) { m_chunkCuller->buildHiZ(context.commandBuffer); });
+
+        m_renderGraph->compile();
+        m_renderGraph->execute(commandBuffer);
+
+        commandBuffer.end();
+
+        m_mainThreadSubmitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stitchStart).count();
+    }
+
     vk::Format Application::chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
         const auto formatIt = std::ranges::find_if(availableFormats,
         [](const auto& format) {
@@ -180,10 +521,7 @@ namespace Engine {
     }
 
     vk::PresentModeKHR Application::chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes) {
-        return std::ranges::any_of(availablePresentModes,
-            [](const vk::PresentModeKHR value) {
-                return vk::PresentModeKHR::eMailbox == value;
-            }) ? vk::PresentModeKHR::eMailbox : vk::PresentModeKHR::eFifo;
+        return m_framePacer.choosePresentMode(availablePresentModes);
     }
 
     vk::Extent2D Application::chooseSwapExtent(const vk::SurfaceCapabilitiesKHR& capabilities) {
@@ -193,7 +531,7 @@ namespace Engine {
 
         int32_t width;
         int32_t height;
-        glfwGetFramebufferSize(m_window, &width, &height);
+        m_input.framebufferSize(width, height);
 
         return {
             std::clamp<uint32_t>(width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
@@ -212,12 +550,4 @@ namespace Engine {
 
         return extensions;
     }
-
-    VKAPI_ATTR vk::Bool32 VKAPI_CALL Application::debugCallback(vk::DebugUtilsMessageSeverityFlagBitsEXT severity, vk::DebugUtilsMessageTypeFlagsEXT type, const vk::DebugUtilsMessengerCallbackDataEXT *pCallbackData, void *) {
-        if (severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eError || severity == vk::DebugUtilsMessageSeverityFlagBitsEXT::eWarning) {
-            std::cerr << "validation layer: type " << to_string(type) << " msg: " << pCallbackData->pMessage << std::endl;
-        }
-
-        return vk::False;
-    }
 }
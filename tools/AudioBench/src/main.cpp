@@ -0,0 +1,155 @@
+#include "../../../engine/include/core/Audio/Audio.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using Engine::AudioMixer;
+    using Engine::AudioSoundId;
+
+    constexpr uint32_t SAMPLE_RATE = 48000;
+
+    struct Options {
+        /** Voice counts measured one after the other, up to AUDIO_MAX_VOICES. */
+        std::vector<uint32_t> voices = { 32, 128, 256, Engine::AUDIO_MAX_VOICES };
+        double seconds = 5.0;
+        /** Writes the mix of the last run when set, to listen for clicks. */
+        std::string wavPath;
+    };
+
+    enum class Layout {
+        /** Every voice plays as authored, all of them are mixed. */
+        Flat,
+        /** Three in four voices are positional and spread around the listener, the far ones go virtual. */
+        Positional,
+    };
+
+    struct Result {
+        double nanosecondsPerVoiceFrame = 0.0;
+        double nanosecondsPerMixedVoiceFrame = 0.0;
+        double coreFraction = 0.0;
+        uint32_t virtualVoices = 0;
+        float peak = 0.0f;
+        bool finite = true;
+    };
+
+    Result run(const Options &p_options, uint32_t p_voices, Layout p_layout, std::vector<float> &p_output) {
+        AudioMixer mixer(SAMPLE_RATE);
+        std::mt19937 random(2);
+
+        /** Noise exercises the resampler without letting the mix cancel out; a mono clip at 44.1 kHz and a stereo one at the output rate. */
+        std::vector<float> clip(SAMPLE_RATE * 2);
+        for (float &sample : clip) {
+            sample = static_cast<float>(random() % 2000) / 1000.0f - 1.0f;
+        }
+        const AudioSoundId mono = mixer.createSound(clip, 1, 44100);
+        const AudioSoundId stereo = mixer.createSound(clip, 2, SAMPLE_RATE);
+
+        mixer.setListener(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+        for (uint32_t i = 0; i < p_voices; ++i) {
+            Engine::AudioPlayParams params;
+            params.gain = 0.05f;
+            params.pitch = 0.8f + static_cast<float>(random() % 40) / 100.0f;
+            params.loop = true;
+            params.positional = p_layout == Layout::Positional && i % 4 != 0;
+            params.x = static_cast<float>(random() % 80) - 40.0f;
+            params.z = static_cast<float>(random() % 80) - 40.0f;
+            params.maxDistance = 40.0f;
+            mixer.play(i % 4 == 0 ? stereo : mono, params);
+        }
+
+        /** One block first, so the plays are consumed and the measurement starts with every voice running. */
+        p_output.clear();
+        mixer.renderOffline(Engine::AUDIO_BLOCK_FRAMES, p_output);
+        const Engine::AudioMixerStatistics before = mixer.statistics();
+
+        const uint32_t frames = static_cast<uint32_t>(p_options.seconds * SAMPLE_RATE);
+        p_output.clear();
+        p_output.reserve(static_cast<size_t>(frames) * Engine::AUDIO_OUTPUT_CHANNELS);
+        mixer.renderOffline(frames, p_output);
+        const Engine::AudioMixerStatistics after = mixer.statistics();
+
+        Result result;
+        const double seconds = after.renderSeconds - before.renderSeconds;
+        const double voiceFrames = static_cast<double>(p_voices) * frames;
+        const double mixedFrames = static_cast<double>(p_voices - after.virtualVoices) * frames;
+        result.nanosecondsPerVoiceFrame = voiceFrames > 0.0 ? seconds * 1e9 / voiceFrames : 0.0;
+        result.nanosecondsPerMixedVoiceFrame = mixedFrames > 0.0 ? seconds * 1e9 / mixedFrames : 0.0;
+        result.coreFraction = seconds / p_options.seconds;
+        result.virtualVoices = after.virtualVoices;
+        for (float sample : p_output) {
+            result.finite = result.finite && std::isfinite(sample);
+            result.peak = std::max(result.peak, std::fabs(sample));
+        }
+        return result;
+    }
+
+    bool parseVoices(std::string_view p_text, std::vector<uint32_t> &p_voices) {
+        p_voices.clear();
+        while (!p_text.empty()) {
+            const size_t comma = p_text.find(',');
+            const std::string number(p_text.substr(0, comma));
+            const uint32_t count = static_cast<uint32_t>(std::strtoul(number.c_str(), nullptr, 10));
+            if (count == 0 || count > Engine::AUDIO_MAX_VOICES) {
+                return false;
+            }
+            p_voices.push_back(count);
+            p_text = comma == std::string_view::npos ? std::string_view() : p_text.substr(comma + 1);
+        }
+        return !p_voices.empty();
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        bool valid = i + 1 < argc;
+        if (valid && argument == "--voices") {
+            valid = parseVoices(argv[++i], options.voices);
+        } else if (valid && argument == "--seconds") {
+            options.seconds = std::max(std::strtod(argv[++i], nullptr), 0.1);
+        } else if (valid && argument == "--wav") {
+            options.wavPath = argv[++i];
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Usage: AudioBench [--voices <count>[,<count>...]] [--seconds <audio>] [--wav <path>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    fmt::print("{:.1f} s of audio per run at {} Hz, blocks of {} frames\n", options.seconds, SAMPLE_RATE, Engine::AUDIO_BLOCK_FRAMES);
+    fmt::print("{:<12} {:>7} {:>8} {:>14} {:>14} {:>9} {:>7}\n", "layout", "voices", "virtual", "ns/voice/frame", "ns/mixed/frame",
+               "% core", "peak");
+
+    std::vector<float> output;
+    bool success = true;
+    for (const Layout layout : { Layout::Flat, Layout::Positional }) {
+        for (const uint32_t voices : options.voices) {
+            const Result result = run(options, voices, layout, output);
+            fmt::print("{:<12} {:>7} {:>8} {:>14.3f} {:>14.3f} {:>8.2f}% {:>7.3f}\n", layout == Layout::Flat ? "flat" : "positional",
+                       voices, result.virtualVoices, result.nanosecondsPerVoiceFrame, result.nanosecondsPerMixedVoiceFrame,
+                       result.coreFraction * 100.0, result.peak);
+            success = success && result.finite && result.peak > 0.0f;
+        }
+    }
+
+    if (!options.wavPath.empty() && !AudioMixer::writeWav(options.wavPath, output, Engine::AUDIO_OUTPUT_CHANNELS, SAMPLE_RATE)) {
+        success = false;
+    }
+    if (!success) {
+        std::cerr << "A mix was silent, not finite, or could not be written\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
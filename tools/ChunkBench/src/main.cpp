@@ -0,0 +1,323 @@
+#include "../../../engine/include/Networking/ChunkSync.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace {
+    using namespace Engine;
+
+    constexpr double TICK_SECONDS = 1.0 / 60.0;
+    /** Ticks a phase may take before the run counts as stuck. */
+    constexpr uint32_t MAX_PHASE_TICKS = 60 * 600;
+
+    struct Options {
+        /** Sections loaded around the origin, (2 * radius)^2 columns of HEIGHT sections. */
+        int32_t radius = 12;
+        uint32_t clients = 4;
+        /** Section data each client may receive per tick. */
+        size_t budgetBytes = 64 * 1024;
+        uint32_t edits = 10'000;
+    };
+
+    constexpr int32_t HEIGHT = 8;
+
+    double secondsSince(std::chrono::steady_clock::time_point p_start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - p_start).count();
+    }
+
+    /** Rolling terrain: stone, dirt, grass, water up to y 44 and scattered ores. */
+    ChunkBlocks terrain(const ChunkCoord &p_coord) {
+        ChunkBlocks blocks;
+        std::mt19937 random(static_cast<uint32_t>(p_coord.key()) * 2654435761u ^ 7);
+        for (uint32_t y = 0; y < CHUNK_SECTION_EDGE; ++y) {
+            for (uint32_t z = 0; z < CHUNK_SECTION_EDGE; ++z) {
+                for (uint32_t x = 0; x < CHUNK_SECTION_EDGE; ++x) {
+                    const int32_t worldX = p_coord.x * 16 + static_cast<int32_t>(x);
+                    const int32_t worldY = p_coord.y * 16 + static_cast<int32_t>(y);
+                    const int32_t worldZ = p_coord.z * 16 + static_cast<int32_t>(z);
+                    const int32_t height = 40 + static_cast<int32_t>(8.0 * std::sin(worldX * 0.07) + 6.0 * std::cos(worldZ * 0.05));
+
+                    uint16_t block = 1;
+                    if (worldY > height) {
+                        block = worldY < 44 ? 9 : 0;
+                    } else if (worldY == height) {
+                        block = 2;
+                    } else if (worldY > height - 4) {
+                        block = 3;
+                    } else if (random() % 64 == 0) {
+                        block = static_cast<uint16_t>(14 + random() % 4);
+                    }
+                    blocks[ChunkCodec::blockIndex(x, y, z)] = block;
+                }
+            }
+        }
+        return blocks;
+    }
+
+    struct Client {
+        std::unique_ptr<NetTransport> transport;
+        ChunkCache cache{ 256 * 1024 * 1024 };
+        std::unique_ptr<ChunkReceiver> receiver;
+    };
+
+    /** One server and its clients over loopback, stepped a tick at a time. */
+    class Session {
+    public:
+        explicit Session(const Options &p_options) :
+                m_options(p_options) {
+            m_server.listen(NetAddress::loopback(0));
+            m_clients.resize(p_options.clients);
+            for (uint32_t i = 0; i < p_options.clients; ++i) {
+                NetTransportConfig config;
+                config.simulatorSeed = i + 3;
+                Client &client = m_clients[i];
+                client.transport = std::make_unique<NetTransport>(config);
+                const ConnectionId connection = client.transport->connect(m_server.localAddress(), NetAddress::loopback(0));
+                client.receiver = std::make_unique<ChunkReceiver>(*client.transport, connection, client.cache);
+            }
+        }
+
+        bool connect() {
+            for (uint32_t i = 0; i < MAX_PHASE_TICKS && m_senders.size() < m_clients.size(); ++i) {
+                tick();
+            }
+            return m_senders.size() == m_clients.size();
+        }
+
+        void tick() {
+            m_time += TICK_SECONDS;
+            m_server.receive(m_time);
+            for (const NetEvent &event : m_server.events()) {
+                if (event.type == NetEventType::Connected) {
+                    m_senders[event.connection] = std::make_unique<ChunkSender>(m_server, event.connection);
+                } else if (event.type == NetEventType::Message) {
+                    m_senders[event.connection]->handleMessage(event.payload);
+                }
+            }
+            for (auto &[connection, sender] : m_senders) {
+                sender->flush(m_options.budgetBytes);
+            }
+            m_server.flush(m_time);
+
+            for (Client &client : m_clients) {
+                client.transport->receive(m_time);
+                for (const NetEvent &event : client.transport->events()) {
+                    if (event.type == NetEventType::Message) {
+                        client.receiver->handleMessage(event.payload);
+                    }
+                }
+                client.receiver->flush();
+                client.receiver->takeChanged();
+                client.transport->flush(m_time);
+            }
+        }
+
+        /** Ticks until every client holds `p_sections` sections and nothing is left to send. */
+        uint32_t settle(size_t p_sections) {
+            uint32_t ticks = 0;
+            while (!settled(p_sections) && ticks < MAX_PHASE_TICKS) {
+                tick();
+                ++ticks;
+            }
+            return ticks;
+        }
+
+        bool settled(size_t p_sections) const {
+            for (const Client &client : m_clients) {
+                if (client.receiver->loadedSections() != p_sections) {
+                    return false;
+                }
+            }
+            for (const auto &[connection, sender] : m_senders) {
+                if (sender->pendingSections() != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Visit>
+        void forEachSender(Visit &&p_visit) {
+            for (auto &[connection, sender] : m_senders) {
+                p_visit(*sender);
+            }
+        }
+
+        uint64_t serverBytesSent() const { return m_server.statistics().bytesSent; }
+        const std::vector<Client> &clients() const { return m_clients; }
+
+    private:
+        const Options &m_options;
+        NetTransport m_server;
+        std::vector<Client> m_clients;
+        std::map<ConnectionId, std::unique_ptr<ChunkSender>> m_senders;
+        double m_time = 0.0;
+    };
+
+    using World = std::map<uint64_t, std::pair<ChunkCoord, ChunkBlocks>>;
+
+    /** Sections missing or different on any client. */
+    size_t mismatches(const Session &p_session, const World &p_world) {
+        size_t count = 0;
+        for (const Client &client : p_session.clients()) {
+            for (const auto &[key, section] : p_world) {
+                const ChunkBlocks *blocks = client.receiver->section(section.first);
+                count += !blocks || *blocks != section.second;
+            }
+        }
+        return count;
+    }
+
+    /** Offers the whole world to every client and reports how the transfer went. */
+    bool load(Session &p_session, const World &p_world, std::string_view p_name) {
+        std::vector<EncodedSection> sections;
+        sections.reserve(p_world.size());
+        for (const auto &[key, section] : p_world) {
+            sections.push_back(ChunkCodec::encodeSection(section.first, section.second));
+        }
+
+        const uint64_t bytesBefore = p_session.serverBytesSent();
+        const auto start = std::chrono::steady_clock::now();
+        p_session.forEachSender([&](ChunkSender &p_sender) {
+            for (const EncodedSection &section : sections) {
+                p_sender.offer(section);
+            }
+        });
+        const uint32_t ticks = p_session.settle(p_world.size());
+        const double wall = secondsSince(start);
+
+        const double chunks = static_cast<double>(p_world.size() * p_session.clients().size());
+        const size_t bad = mismatches(p_session, p_world);
+        fmt::print("{:<10} {:>8.1f} {:>12.0f} {:>11.2f} {:>8}\n", p_name, (p_session.serverBytesSent() - bytesBefore) / chunks,
+                   chunks / wall, ticks * TICK_SECONDS, bad);
+        return bad == 0 && ticks < MAX_PHASE_TICKS;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--radius" && i + 1 < argc) {
+            options.radius = static_cast<int32_t>(std::strtol(argv[++i], nullptr, 10));
+        } else if (argument == "--clients" && i + 1 < argc) {
+            options.clients = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--budget" && i + 1 < argc) {
+            options.budgetBytes = std::strtoull(argv[++i], nullptr, 10) * 1024;
+        } else if (argument == "--edits" && i + 1 < argc) {
+            options.edits = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: ChunkBench [--radius <sections>] [--clients <count>] [--budget <KiB per client and tick>] [--edits <count>]\n"
+                         "The link defaults to ENGINE_NET_SIMULATE.\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.radius = std::clamp(options.radius, 1, 64);
+    options.clients = std::clamp(options.clients, 1u, 64u);
+    options.budgetBytes = std::max<size_t>(options.budgetBytes, 1024);
+
+    World world;
+    for (int32_t x = -options.radius; x < options.radius; ++x) {
+        for (int32_t z = -options.radius; z < options.radius; ++z) {
+            for (int32_t y = 0; y < HEIGHT; ++y) {
+                const ChunkCoord coord{ x, y, z };
+                world[coord.key()] = { coord, terrain(coord) };
+            }
+        }
+    }
+
+    /** The codec alone, once per section as the server does it. */
+    std::vector<EncodedSection> encoded;
+    encoded.reserve(world.size());
+    size_t encodedBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &[key, section] : world) {
+        encoded.push_back(ChunkCodec::encodeSection(section.first, section.second));
+        encodedBytes += encoded.back().data->size();
+    }
+    const double encodeSeconds = secondsSince(start);
+
+    ChunkBlocks decoded;
+    bool decodeFailed = false;
+    start = std::chrono::steady_clock::now();
+    for (const EncodedSection &section : encoded) {
+        decodeFailed = !ChunkCodec::decode(*section.data, decoded) || decodeFailed;
+    }
+    const double decodeSeconds = secondsSince(start);
+
+    const double sections = static_cast<double>(world.size());
+    fmt::print("{} sections of {} bytes raw, {} clients, {} KiB per client and tick at 60 Hz\n", world.size(),
+               sizeof(ChunkBlocks), options.clients, options.budgetBytes / 1024);
+    fmt::print("codec: {:.1f} bytes/section, encode {:.0f} sections/s, decode {:.0f} sections/s\n", encodedBytes / sections,
+               sections / encodeSeconds, sections / decodeSeconds);
+
+    Session session(options);
+    if (!session.connect()) {
+        std::cerr << "Not every client connected\n";
+        return EXIT_FAILURE;
+    }
+
+    fmt::print("{:<10} {:>8} {:>12} {:>11} {:>8}\n", "", "B/chunk", "chunks/s", "game s", "wrong");
+    bool success = !decodeFailed && load(session, world, "cold");
+
+    /** Single block edits spread over the world, sent as deltas. */
+    std::mt19937 random(1);
+    const uint64_t bytesBefore = session.serverBytesSent();
+    for (uint32_t edit = 0; edit < options.edits; ++edit) {
+        auto it = world.begin();
+        std::advance(it, random() % world.size());
+        const uint32_t index = random() % CHUNK_SECTION_VOLUME;
+        const uint16_t block = static_cast<uint16_t>(random() % 20);
+        it->second.second[index] = block;
+        session.forEachSender([&](ChunkSender &p_sender) { p_sender.blockChanged(it->second.first, index, block); });
+        if (edit % 200 == 199) {
+            session.tick();
+        }
+    }
+    /** Deltas ride the reliable channel, under loss they keep arriving after the senders went idle. */
+    uint32_t editTicks = 0;
+    size_t badEdits = mismatches(session, world);
+    while (badEdits != 0 && editTicks < MAX_PHASE_TICKS) {
+        for (uint32_t i = 0; i < 30; ++i) {
+            session.tick();
+        }
+        editTicks += 30;
+        badEdits = mismatches(session, world);
+    }
+    fmt::print("edits: {} applied, {:.1f} wire bytes per edit and client, {:.2f} game s to converge, {} sections wrong\n",
+               options.edits, (session.serverBytesSent() - bytesBefore) / static_cast<double>(std::max(options.edits, 1u) * options.clients),
+               editTicks * TICK_SECONDS, badEdits);
+    success = success && badEdits == 0;
+
+    /** Everything scrolls out of view and back, the caches answer for whatever was not edited. */
+    session.forEachSender([&](ChunkSender &p_sender) {
+        for (const auto &[key, section] : world) {
+            p_sender.unload(section.first);
+        }
+    });
+    session.settle(0);
+    success = load(session, world, "revisit") && success;
+
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    for (const Client &client : session.clients()) {
+        hits += client.receiver->statistics().cacheHits;
+        misses += client.receiver->statistics().cacheMisses;
+    }
+    fmt::print("client caches: {} hits, {} misses\n", hits, misses);
+
+    if (!success) {
+        std::cerr << "A client ended up with missing or wrong sections\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,290 @@
+#include "../../../engine/include/core/DataStructures/BTree/BTreeMap.hpp"
+#include "../../../engine/include/core/DataStructures/HashMap/HashMap.hpp"
+#include "../../../engine/include/core/DataStructures/List/List.hpp"
+#include "../../../engine/include/core/DataStructures/LocalVector/LocalVector.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    struct Options {
+        uint32_t count = 1'000'000;
+        uint64_t seed = 3;
+    };
+
+    /** Sums of what both sides read, compared so the work cannot be optimized away or silently differ. */
+    struct Checksums {
+        uint64_t standard = 0;
+        uint64_t engine = 0;
+    };
+
+    bool g_mismatch = false;
+
+    template <typename Body>
+    double milliseconds(Body &&p_body) {
+        const auto start = std::chrono::steady_clock::now();
+        p_body();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /** `p_standard` and `p_engine` return a checksum of what they read. */
+    template <typename Standard, typename Container>
+    void report(std::string_view p_name, uint32_t p_count, Standard &&p_standard, Container &&p_engine) {
+        Checksums sums;
+        const double standard = milliseconds([&]() { sums.standard = p_standard(); });
+        const double engine = milliseconds([&]() { sums.engine = p_engine(); });
+        const bool match = sums.standard == sums.engine;
+        g_mismatch = g_mismatch || !match;
+
+        fmt::print("{:<24} {:>10.2f} {:>10.2f} {:>8.2f}x{}\n", p_name, standard * 1e6 / p_count, engine * 1e6 / p_count,
+                   standard / engine, match ? "" : "  checksum mismatch");
+    }
+
+    void hashMaps(const std::vector<uint64_t> &p_keys) {
+        const uint32_t count = static_cast<uint32_t>(p_keys.size());
+        std::unordered_map<uint64_t, uint64_t> standard;
+        HashMap<uint64_t, uint64_t> engine;
+
+        report("HashMap insert", count, [&]() {
+            for (uint64_t key : p_keys) {
+                standard[key] = key;
+            }
+            return static_cast<uint64_t>(standard.size());
+        }, [&]() {
+            for (uint64_t key : p_keys) {
+                engine[key] = key;
+            }
+            return static_cast<uint64_t>(engine.size());
+        });
+        report("HashMap find", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += standard.find(key)->second;
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += *engine.getPtr(key);
+            }
+            return sum;
+        });
+        report("HashMap miss", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += standard.count(key + 1);
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += engine.has(key + 1);
+            }
+            return sum;
+        });
+        report("HashMap iterate", count, [&]() {
+            uint64_t sum = 0;
+            for (const auto &entry : standard) {
+                sum += entry.second;
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (const auto &entry : engine) {
+                sum += entry.value;
+            }
+            return sum;
+        });
+        report("HashMap erase", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += standard.erase(key);
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += engine.erase(key);
+            }
+            return sum;
+        });
+    }
+
+    void treeMaps(const std::vector<uint64_t> &p_keys) {
+        const uint32_t count = static_cast<uint32_t>(p_keys.size());
+        std::map<uint64_t, uint64_t> standard;
+        BTreeMap<uint64_t, uint64_t> engine;
+
+        report("BTreeMap insert", count, [&]() {
+            for (uint64_t key : p_keys) {
+                standard[key] = key;
+            }
+            return static_cast<uint64_t>(standard.size());
+        }, [&]() {
+            for (uint64_t key : p_keys) {
+                engine[key] = key;
+            }
+            return static_cast<uint64_t>(engine.size());
+        });
+        report("BTreeMap find", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += standard.find(key)->second;
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += *engine.getPtr(key);
+            }
+            return sum;
+        });
+        report("BTreeMap iterate", count, [&]() {
+            uint64_t sum = 0;
+            for (const auto &entry : standard) {
+                sum = sum * 31 + entry.second;
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (auto it = engine.begin(); it != engine.end(); ++it) {
+                sum = sum * 31 + it.value();
+            }
+            return sum;
+        });
+        report("BTreeMap erase", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += standard.erase(key);
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t key : p_keys) {
+                sum += engine.erase(key);
+            }
+            return sum;
+        });
+    }
+
+    void lists(const std::vector<uint64_t> &p_keys) {
+        const uint32_t count = static_cast<uint32_t>(p_keys.size());
+        std::list<uint64_t> standard;
+        List<uint64_t> engine;
+
+        report("List pushBack", count, [&]() {
+            for (uint64_t key : p_keys) {
+                standard.push_back(key);
+            }
+            return static_cast<uint64_t>(standard.size());
+        }, [&]() {
+            for (uint64_t key : p_keys) {
+                engine.pushBack(key);
+            }
+            return static_cast<uint64_t>(engine.size());
+        });
+        report("List iterate", count, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t value : standard) {
+                sum = sum * 31 + value;
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint64_t value : engine) {
+                sum = sum * 31 + value;
+            }
+            return sum;
+        });
+        report("List popFront", count, [&]() {
+            uint64_t sum = 0;
+            while (!standard.empty()) {
+                sum += standard.front();
+                standard.pop_front();
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            while (!engine.isEmpty()) {
+                sum += engine.front();
+                engine.popFront();
+            }
+            return sum;
+        });
+    }
+
+    /** Refilled ten times, so the capacity kept by clear() is what is compared after the first pass. */
+    void vectors(const std::vector<uint64_t> &p_keys) {
+        constexpr uint32_t PASSES = 10;
+        const uint32_t count = static_cast<uint32_t>(p_keys.size()) * PASSES;
+        std::vector<uint64_t> standard;
+        LocalVector<uint64_t> engine;
+
+        report("LocalVector pushBack", count, [&]() {
+            uint64_t sum = 0;
+            for (uint32_t pass = 0; pass < PASSES; ++pass) {
+                standard.clear();
+                for (uint64_t key : p_keys) {
+                    standard.push_back(key);
+                }
+                sum += standard.back();
+            }
+            return sum;
+        }, [&]() {
+            uint64_t sum = 0;
+            for (uint32_t pass = 0; pass < PASSES; ++pass) {
+                engine.clear();
+                for (uint64_t key : p_keys) {
+                    engine.pushBack(key);
+                }
+                sum += engine[engine.size() - 1];
+            }
+            return sum;
+        });
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--count" && i + 1 < argc) {
+            options.count = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--seed" && i + 1 < argc) {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::cerr << "Usage: ContainerBench [--count <elements>] [--seed <value>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.count = std::max(options.count, 1000u);
+
+    /** Even random keys, so every key + 1 misses. */
+    std::vector<uint64_t> keys(options.count);
+    std::mt19937_64 random(options.seed);
+    for (uint64_t &key : keys) {
+        key = random() & ~1ull;
+    }
+
+    fmt::print("{} random 64-bit keys\n", options.count);
+    fmt::print("{:<24} {:>10} {:>10} {:>9}\n", "ns per element", "std", "engine", "speedup");
+    hashMaps(keys);
+    treeMaps(keys);
+    lists(keys);
+    vectors(keys);
+
+    if (g_mismatch) {
+        std::cerr << "The engine containers disagreed with the standard ones\n";
+    }
+    return g_mismatch ? EXIT_FAILURE : EXIT_SUCCESS;
+}
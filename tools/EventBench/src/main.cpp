@@ -0,0 +1,185 @@
+#include "../../../engine/include/core/Events/Event.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    /** Allocations made by the current thread, so thread start-up does not count against the bus. */
+    thread_local uint64_t t_allocations = 0;
+
+    struct Options {
+        uint32_t events = 100'000;
+        uint32_t threads = 4;
+        uint32_t ticks = 50;
+        /** Ticks before the queues reached their steady size, not checked for allocations. */
+        uint32_t warmupTicks = 3;
+    };
+
+    struct TickResult {
+        uint64_t postAllocations = 0;
+        uint64_t dispatchAllocations = 0;
+        double postSeconds = 0.0;
+        double dispatchSeconds = 0.0;
+        size_t dispatched = 0;
+    };
+
+    Engine::BlockChangedEvent blockChange(uint32_t p_index) {
+        Engine::BlockChangedEvent event;
+        event.x = static_cast<int32_t>(p_index & 15);
+        event.y = static_cast<int32_t>(p_index >> 8);
+        event.z = static_cast<int32_t>(p_index >> 4 & 15);
+        event.block = static_cast<uint16_t>(p_index);
+        return event;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point p_start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - p_start).count();
+    }
+
+    /** One tick: `p_threads` workers post through postConcurrent(), or the dispatching thread through post() when 0. */
+    TickResult tick(Engine::EngineEventBus &p_bus, const Options &p_options, uint32_t p_threads) {
+        TickResult result;
+
+        if (p_threads == 0) {
+            const uint64_t allocations = t_allocations;
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < p_options.events; ++i) {
+                p_bus.post(blockChange(i));
+            }
+            result.postSeconds = secondsSince(start);
+            result.postAllocations = t_allocations - allocations;
+        } else {
+            std::vector<uint64_t> allocations(p_threads);
+            std::vector<double> seconds(p_threads);
+            std::vector<std::thread> workers;
+            for (uint32_t thread = 0; thread < p_threads; ++thread) {
+                workers.emplace_back([&, thread]() {
+                    const uint32_t begin = p_options.events / p_threads * thread;
+                    const uint32_t end = thread + 1 == p_threads ? p_options.events : begin + p_options.events / p_threads;
+                    const uint64_t before = t_allocations;
+                    const auto start = std::chrono::steady_clock::now();
+                    for (uint32_t i = begin; i < end; ++i) {
+                        p_bus.postConcurrent(blockChange(i));
+                    }
+                    seconds[thread] = secondsSince(start);
+                    allocations[thread] = t_allocations - before;
+                });
+            }
+            for (std::thread &worker : workers) {
+                worker.join();
+            }
+            for (uint32_t thread = 0; thread < p_threads; ++thread) {
+                result.postAllocations += allocations[thread];
+                result.postSeconds = std::max(result.postSeconds, seconds[thread]);
+            }
+        }
+
+        const uint64_t allocations = t_allocations;
+        const auto start = std::chrono::steady_clock::now();
+        result.dispatched = p_bus.dispatch();
+        result.dispatchSeconds = secondsSince(start);
+        result.dispatchAllocations = t_allocations - allocations;
+        return result;
+    }
+
+    /** Returns false when a steady tick allocated or lost events. */
+    bool run(const Options &p_options, uint32_t p_threads) {
+        Engine::EngineEventBus bus;
+        uint64_t received = 0;
+        int64_t checksum = 0;
+        bus.subscribe<Engine::BlockChangedEvent>([&](std::span<const Engine::BlockChangedEvent> p_events) {
+            received += p_events.size();
+            for (const Engine::BlockChangedEvent &event : p_events) {
+                checksum += event.x + event.block;
+            }
+        });
+
+        TickResult total;
+        uint64_t steadyAllocations = 0;
+        bool complete = true;
+        for (uint32_t i = 0; i < p_options.warmupTicks + p_options.ticks; ++i) {
+            received = 0;
+            const TickResult result = tick(bus, p_options, p_threads);
+            complete = complete && result.dispatched == p_options.events && received == p_options.events;
+            if (i < p_options.warmupTicks) {
+                continue;
+            }
+
+            steadyAllocations += result.postAllocations + result.dispatchAllocations;
+            total.postSeconds += result.postSeconds;
+            total.dispatchSeconds += result.dispatchSeconds;
+        }
+
+        const double events = static_cast<double>(p_options.events) * p_options.ticks;
+        fmt::print("{:<28} {:>12.2f} {:>14.2f} {:>12}\n",
+                   p_threads == 0 ? std::string("post()") : fmt::format("postConcurrent() x{}", p_threads),
+                   total.postSeconds / events * 1e9, total.dispatchSeconds / events * 1e9, steadyAllocations);
+
+        if (checksum == 0) {
+            std::cerr << "No event reached the handler\n";
+            return false;
+        }
+        if (!complete) {
+            std::cerr << "Events were lost between post and dispatch\n";
+            return false;
+        }
+        return steadyAllocations == 0;
+    }
+}
+
+void *operator new(std::size_t p_size) {
+    ++t_allocations;
+    if (void *memory = std::malloc(p_size ? p_size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p_memory) noexcept {
+    std::free(p_memory);
+}
+
+void operator delete(void *p_memory, std::size_t) noexcept {
+    std::free(p_memory);
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--events" && i + 1 < argc) {
+            options.events = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--ticks" && i + 1 < argc) {
+            options.ticks = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: EventBench [--events <per tick>] [--threads <posting threads>] [--ticks <count>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.events = std::max(options.events, 1u);
+    options.threads = std::max(options.threads, 1u);
+    options.ticks = std::max(options.ticks, 1u);
+
+    fmt::print("{} BlockChangedEvents per tick, {} ticks after {} warm-up ticks\n", options.events, options.ticks, options.warmupTicks);
+    fmt::print("{:<28} {:>12} {:>14} {:>12}\n", "", "post ns/evt", "dispatch ns/evt", "allocations");
+
+    bool success = run(options, 0);
+    success = run(options, 1) && success;
+    success = run(options, options.threads) && success;
+
+    if (!success) {
+        std::cerr << "A steady tick allocated or dropped events\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,306 @@
+#include "../../../engine/include/Networking/Interest.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using namespace Engine;
+
+    constexpr double TICK_SECONDS = 1.0 / 30.0;
+    /** Ticks left out of the timings while the clients connect and the first full snapshots go out. */
+    constexpr uint32_t WARMUP_TICKS = 30;
+    /** Snapshots kept per client to check what it decodes, well past SNAPSHOT_HISTORY. */
+    constexpr uint32_t KEPT_SNAPSHOTS = 64;
+
+    struct Options {
+        uint32_t entities = 5000;
+        uint32_t clients = 200;
+        /** 0 runs the interest manager on the calling thread only. */
+        uint32_t workers = 0;
+        uint32_t ticks = 300;
+        float worldSize = 2048.0f;
+        uint32_t budgetBytes = InterestConfig().bytesPerUpdate;
+    };
+
+    struct WorldEntity {
+        float x = 0.0f;
+        float y = 64.0f;
+        float z = 0.0f;
+        float velocityX = 0.0f;
+        float velocityZ = 0.0f;
+        bool alive = true;
+        SnapshotEntity state;
+    };
+
+    struct Client {
+        std::unique_ptr<NetTransport> transport;
+        ConnectionId connection = INVALID_CONNECTION;
+        /** The same connection as the server numbers it. */
+        ConnectionId serverConnection = INVALID_CONNECTION;
+        SnapshotDecoder decoder;
+        float x = 0.0f;
+        float z = 0.0f;
+    };
+
+    /** Server side of one client: which Client it is and what it was sent, by snapshot id. */
+    struct Peer {
+        uint32_t client = UINT32_MAX;
+        std::map<uint32_t, std::vector<SnapshotEntity>> sent;
+    };
+
+    struct Totals {
+        uint64_t updates = 0;
+        uint64_t relevant = 0;
+        uint64_t sent = 0;
+        uint64_t deferred = 0;
+        uint64_t entered = 0;
+        uint64_t left = 0;
+        uint64_t removalsDeferred = 0;
+        uint64_t estimatedBytes = 0;
+        uint64_t snapshotBytes = 0;
+        uint32_t largestSnapshot = 0;
+        /** Snapshots larger than their estimate or the budget, and failed encodes. */
+        uint64_t overBudget = 0;
+        uint64_t encodeFailures = 0;
+        uint64_t decoded = 0;
+        uint64_t verified = 0;
+        uint64_t mismatches = 0;
+        double updateSeconds = 0.0;
+    };
+
+    double secondsSince(std::chrono::steady_clock::time_point p_start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - p_start).count();
+    }
+
+    bool sameEntities(const std::vector<SnapshotEntity> &p_a, const std::vector<SnapshotEntity> &p_b) {
+        return p_a.size() == p_b.size() && (p_a.empty() || std::memcmp(p_a.data(), p_b.data(), p_a.size() * sizeof(SnapshotEntity)) == 0);
+    }
+
+    /** A third of the entities move each tick, one in fifty changes another field, and a few spawn or despawn. */
+    void simulateWorld(std::vector<WorldEntity> &p_world, InterestManager &p_interest, std::mt19937 &p_random) {
+        for (WorldEntity &entity : p_world) {
+            if (p_random() % 3 == 0) {
+                entity.x += entity.velocityX;
+                entity.z += entity.velocityZ;
+                entity.state.words[0] = static_cast<uint32_t>(entity.x * 16.0f);
+                entity.state.words[2] = static_cast<uint32_t>(entity.z * 16.0f);
+            }
+            if (p_random() % 50 == 0) {
+                entity.state.words[5]++;
+            }
+            if (p_random() % 2000 == 0) {
+                entity.alive = !entity.alive;
+            }
+
+            if (entity.alive) {
+                /** Every tenth entity stands for a player and outweighs the rest. */
+                p_interest.updateEntity(entity.state, entity.x, entity.y, entity.z, entity.state.id % 10 == 0 ? 4.0f : 1.0f);
+            } else {
+                p_interest.removeEntity(entity.state.id);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--entities" && i + 1 < argc) {
+            options.entities = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--clients" && i + 1 < argc) {
+            options.clients = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--workers" && i + 1 < argc) {
+            options.workers = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--ticks" && i + 1 < argc) {
+            options.ticks = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--world" && i + 1 < argc) {
+            options.worldSize = std::strtof(argv[++i], nullptr);
+        } else if (argument == "--budget" && i + 1 < argc) {
+            options.budgetBytes = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: InterestBench [--entities <count>] [--clients <count>] [--workers <count>] [--ticks <count>]\n"
+                         "                     [--world <size>] [--budget <bytes per client and update>]\n"
+                         "The link defaults to ENGINE_NET_SIMULATE.\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.entities = std::max(options.entities, 1u);
+    options.clients = std::clamp(options.clients, 1u, 1000u);
+    options.ticks = std::max(options.ticks, WARMUP_TICKS + 1);
+    options.worldSize = std::max(options.worldSize, 64.0f);
+    options.budgetBytes = std::clamp(options.budgetBytes, 24u, NetTransport::MAX_MESSAGE_SIZE);
+
+    std::unique_ptr<WorkerThreadPool> pool;
+    if (options.workers != 0) {
+        pool = std::make_unique<WorkerThreadPool>(options.workers);
+    }
+    InterestConfig interestConfig;
+    interestConfig.bytesPerUpdate = options.budgetBytes;
+    InterestManager interest(interestConfig, pool.get());
+
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> position(0.0f, options.worldSize);
+    std::vector<WorldEntity> world(options.entities);
+    for (uint32_t i = 0; i < options.entities; ++i) {
+        WorldEntity &entity = world[i];
+        entity.x = position(random);
+        entity.z = position(random);
+        entity.velocityX = static_cast<float>(static_cast<int32_t>(random() % 5) - 2);
+        entity.velocityZ = static_cast<float>(static_cast<int32_t>(random() % 5) - 2);
+        entity.state.id = i + 1;
+    }
+
+    NetTransportConfig serverConfig;
+    serverConfig.maxConnections = options.clients;
+    NetTransport server(serverConfig);
+    if (!server.listen(NetAddress::loopback(0))) {
+        std::cerr << "Cannot listen on loopback\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Client> clients(options.clients);
+    std::unordered_map<uint16_t, uint32_t> clientsByPort;
+    for (uint32_t i = 0; i < options.clients; ++i) {
+        NetTransportConfig clientConfig = serverConfig;
+        clientConfig.simulatorSeed = i + 9;
+        Client &client = clients[i];
+        client.transport = std::make_unique<NetTransport>(clientConfig);
+        client.connection = client.transport->connect(server.localAddress(), NetAddress::loopback(0));
+        client.x = position(random);
+        client.z = position(random);
+        clientsByPort[client.transport->localAddress().port] = i;
+    }
+
+    std::unordered_map<ConnectionId, Peer> peers;
+    Totals totals;
+    uint8_t buffer[16];
+
+    for (uint32_t tick = 0; tick < options.ticks; ++tick) {
+        const double time = (tick + 1) * TICK_SECONDS;
+        const bool measured = tick >= WARMUP_TICKS;
+
+        server.receive(time);
+        for (const NetEvent &event : server.events()) {
+            if (event.type == NetEventType::Connected) {
+                interest.addClient(event.connection);
+                const uint32_t client = clientsByPort.at(server.remoteAddress(event.connection).port);
+                peers[event.connection].client = client;
+                clients[client].serverConnection = event.connection;
+            } else if (event.type == NetEventType::Disconnected) {
+                interest.removeClient(event.connection);
+                peers.erase(event.connection);
+            } else if (event.type == NetEventType::Message) {
+                ByteReader reader(event.payload);
+                interest.acknowledge(event.connection, reader.readVarU32());
+            }
+        }
+
+        simulateWorld(world, interest, random);
+        for (auto &[connection, peer] : peers) {
+            Client &client = clients[peer.client];
+            client.x += 0.5f;
+            interest.setViewer(connection, client.x, 64.0f, client.z);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        interest.update();
+        if (measured) {
+            totals.updateSeconds += secondsSince(start);
+        }
+
+        for (auto &[connection, peer] : peers) {
+            const InterestClientStatistics &statistics = *interest.statistics(connection);
+            const std::span<const uint8_t> message = interest.message(connection);
+            totals.encodeFailures += message.empty();
+            totals.overBudget += statistics.snapshotBytes > statistics.estimatedBytes || statistics.snapshotBytes > options.budgetBytes;
+            if (measured) {
+                totals.updates++;
+                totals.relevant += statistics.relevant;
+                totals.sent += statistics.sent;
+                totals.deferred += statistics.deferred;
+                totals.entered += statistics.entered;
+                totals.left += statistics.left;
+                totals.removalsDeferred += statistics.removalsDeferred;
+                totals.estimatedBytes += statistics.estimatedBytes;
+                totals.snapshotBytes += statistics.snapshotBytes;
+                totals.largestSnapshot = std::max(totals.largestSnapshot, statistics.snapshotBytes);
+            }
+            if (message.empty()) {
+                continue;
+            }
+
+            ByteReader reader(message);
+            const uint32_t id = reader.readVarU32();
+            const std::span<const SnapshotEntity> snapshot = interest.snapshot(connection);
+            peer.sent[id].assign(snapshot.begin(), snapshot.end());
+            peer.sent.erase(peer.sent.begin(), peer.sent.lower_bound(id > KEPT_SNAPSHOTS ? id - KEPT_SNAPSHOTS : 0));
+            server.send(connection, NetChannel::Unreliable, message);
+        }
+        server.flush(time);
+
+        for (uint32_t i = 0; i < options.clients; ++i) {
+            Client &client = clients[i];
+            NetTransport &transport = *client.transport;
+            transport.receive(time);
+            for (const NetEvent &event : transport.events()) {
+                if (event.type != NetEventType::Message) {
+                    continue;
+                }
+                ByteReader reader(event.payload);
+                const std::vector<SnapshotEntity> *entities = client.decoder.decode(reader);
+                if (!entities) {
+                    continue;
+                }
+                totals.decoded++;
+
+                /** The client holds exactly what the server selected for that snapshot. */
+                const auto peer = peers.find(client.serverConnection);
+                if (peer != peers.end()) {
+                    const auto sent = peer->second.sent.find(client.decoder.latestId());
+                    totals.verified++;
+                    totals.mismatches += sent == peer->second.sent.end() || !sameEntities(sent->second, *entities);
+                }
+            }
+
+            if (transport.isConnected(client.connection)) {
+                ByteWriter writer(buffer, sizeof(buffer));
+                writer.writeVarU32(client.decoder.latestId());
+                transport.send(client.connection, NetChannel::Unreliable, { buffer, writer.size() });
+            }
+            transport.flush(time);
+        }
+    }
+
+    const double measuredTicks = options.ticks - WARMUP_TICKS;
+    const double updates = static_cast<double>(std::max<uint64_t>(totals.updates, 1));
+    fmt::print("{} entities, {} clients, {} workers, {} ticks at 30 Hz, budget {} B\n", options.entities, options.clients,
+               options.workers, options.ticks, options.budgetBytes);
+    fmt::print("update: {:.3f} ms/tick, {:.2f} us per client\n", totals.updateSeconds / measuredTicks * 1e3,
+               totals.updateSeconds / measuredTicks / options.clients * 1e6);
+    fmt::print("per client and update: relevant {:.1f}, sent {:.1f}, deferred {:.1f}, entered {:.2f}, left {:.2f}, removals deferred {:.3f}\n",
+               totals.relevant / updates, totals.sent / updates, totals.deferred / updates, totals.entered / updates, totals.left / updates,
+               totals.removalsDeferred / updates);
+    fmt::print("snapshot: estimated {:.0f} B, actual {:.0f} B, largest {} B, {:.1f} kbit/s per client\n", totals.estimatedBytes / updates,
+               totals.snapshotBytes / updates, totals.largestSnapshot, totals.snapshotBytes * 8.0 / 1000.0 / (measuredTicks * TICK_SECONDS) / options.clients);
+    fmt::print("over budget {}, encode failures {}, decoded {}, verified {}, mismatches {}\n", totals.overBudget, totals.encodeFailures,
+               totals.decoded, totals.verified, totals.mismatches);
+
+    const bool success = peers.size() == options.clients && totals.overBudget == 0 && totals.encodeFailures == 0 &&
+                         totals.mismatches == 0 && totals.verified > 0;
+    if (!success) {
+        std::cerr << "A snapshot broke its budget, failed to encode or decoded differently\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
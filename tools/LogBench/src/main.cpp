@@ -0,0 +1,149 @@
+#include "../../../engine/include/logger.hpp"
+
+#include "spdlog/sinks/null_sink.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Engine::LogCategory;
+    using Engine::LogFilter;
+
+    /** Calls timed in one go; between bursts the backend may drain untimed, so a ring of this many messages never fills. */
+    constexpr uint64_t BURST_CALLS = 16384;
+
+    struct Options {
+        uint64_t calls = 2'000'000;
+        uint32_t threads = 4;
+    };
+
+    using Body = std::function<void(uint32_t, uint64_t)>;
+
+    /**
+     * Runs `p_body(thread, calls)` in bursts on `p_threads` threads at once, calling `p_drain`
+     * untimed between bursts, and returns the mean wall time of one call in nanoseconds.
+     */
+    double measure(const Options &p_options, uint32_t p_threads, const Body &p_body, void (*p_drain)()) {
+        const uint64_t perThread = p_options.calls / p_threads;
+        std::vector<double> seconds(p_threads);
+        std::vector<std::thread> workers;
+
+        for (uint32_t thread = 0; thread < p_threads; ++thread) {
+            workers.emplace_back([&, thread]() {
+                for (uint64_t done = 0; done < perThread; done += BURST_CALLS) {
+                    const auto start = std::chrono::steady_clock::now();
+                    p_body(thread, std::min(BURST_CALLS, perThread - done));
+                    seconds[thread] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (p_drain) {
+                        p_drain();
+                    }
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+
+        double total = 0.0;
+        for (double value : seconds) {
+            total += value;
+        }
+        return total / static_cast<double>(perThread * p_threads) * 1e9;
+    }
+
+    /** A typical message: an integer, a float and a short string. */
+    void logInfo(uint32_t p_thread, uint64_t p_calls) {
+        const std::string name = "chunk";
+        for (uint64_t i = 0; i < p_calls; ++i) {
+            ENGINE_CLOG_INFO(World, "Thread {} loaded {} {} in {:.3f} ms", p_thread, name, i, static_cast<double>(i) * 0.25)
+        }
+    }
+
+    void logTrace(uint32_t p_thread, uint64_t p_calls) {
+        for (uint64_t i = 0; i < p_calls; ++i) {
+            ENGINE_CLOG_TRACE(Core, "Thread {} step {}", p_thread, i)
+        }
+    }
+
+    void report(const Options &p_options, std::string_view p_name, const Body &p_body, void (*p_drain)() = nullptr) {
+        const double single = measure(p_options, 1, p_body, p_drain);
+        const double contended = measure(p_options, p_options.threads, p_body, p_drain);
+        fmt::print("{:<40} {:>10.2f} {:>10.2f}\n", p_name, single, contended);
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--calls" && i + 1 < argc) {
+            options.calls = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argument == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::cerr << "Usage: LogBench [--calls <count>] [--threads <count>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.calls = std::max<uint64_t>(options.calls, 1000);
+    options.threads = std::max(options.threads, 1u);
+
+    /** The sinks are not what is measured, every message ends in a null sink. */
+    auto logger = std::make_shared<spdlog::logger>("bench", std::make_shared<spdlog::sinks::null_sink_mt>());
+    spdlog::set_default_logger(logger);
+    LogFilter::setAllLevels(spdlog::level::trace);
+
+    fmt::print("{} calls per case, {} threads for the contended column\n", options.calls, options.threads);
+    fmt::print("{:<40} {:>10} {:>10}\n", "ns per call", "1 thread", fmt::format("{} threads", options.threads));
+
+    if (LogFilter::compiledIn(LogCategory::Core, spdlog::level::trace)) {
+        LogFilter::setLevel(LogCategory::Core, spdlog::level::info);
+        report(options, "trace, disabled at runtime", logTrace);
+        LogFilter::setLevel(LogCategory::Core, spdlog::level::trace);
+    } else {
+        report(options, "trace, compiled out", logTrace);
+    }
+
+    LogFilter::setLevel(LogCategory::World, spdlog::level::warn);
+    report(options, "info, disabled at runtime", logInfo);
+    LogFilter::setLevel(LogCategory::World, spdlog::level::trace);
+
+    report(options, "info, synchronous spdlog", logInfo);
+
+    /** Only the call site is timed, formatting on the flusher happens between bursts. */
+    Engine::AsyncLogConfig asyncConfig;
+    asyncConfig.threadBufferBytes = 4 * 1024 * 1024;
+    asyncConfig.overflow = Engine::LogOverflowPolicy::Block;
+    Engine::AsyncLog::start(asyncConfig);
+    report(options, "info, async ring", logInfo, Engine::AsyncLog::flush);
+    Engine::AsyncLog::flush();
+    const uint64_t asyncDropped = Engine::AsyncLog::droppedMessages();
+    Engine::AsyncLog::stop();
+
+    const std::filesystem::path binaryPath = std::filesystem::temp_directory_path() / "LogBench.blog";
+    Engine::BinaryLogConfig binaryConfig;
+    binaryConfig.path = binaryPath.string();
+    binaryConfig.keepSegments = 2;
+    Engine::BinaryLog::start(binaryConfig);
+    report(options, "info, binary log", logInfo);
+    const uint64_t binaryDropped = Engine::BinaryLog::droppedMessages();
+    Engine::BinaryLog::stop();
+
+    std::error_code error;
+    for (const auto &entry : std::filesystem::directory_iterator(binaryPath.parent_path(), error)) {
+        if (entry.path().filename().string().starts_with(binaryPath.filename().string() + ".")) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    fmt::print("dropped: async {}, binary {}\n", asyncDropped, binaryDropped);
+    return asyncDropped == 0 && binaryDropped == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
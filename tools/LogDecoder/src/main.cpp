@@ -0,0 +1,309 @@
+#include "../../../engine/include/core/Logging/BinaryLogFormat.hpp"
+#include "../../../engine/include/core/Logging/LogCategory.hpp"
+
+#include "spdlog/fmt/chrono.h"
+
+#if defined(SPDLOG_FMT_EXTERNAL)
+    #include <fmt/args.h>
+#else
+    #include "spdlog/fmt/bundled/args.h"
+#endif
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using namespace Engine::BinaryLogFormat;
+
+    struct Site {
+        uint8_t level = 0;
+        uint8_t category = 0;
+        uint32_t line = 0;
+        std::string file;
+        std::string format;
+        std::vector<ArgumentType> arguments;
+    };
+
+    /** Bounds-checked reads from one record. */
+    class Reader {
+    public:
+        Reader(const std::byte *data, size_t size) : m_data(data), m_size(size) {}
+
+        template <typename T>
+        bool read(T &value) {
+            if (m_size - m_offset < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, m_data + m_offset, sizeof(T));
+            m_offset += sizeof(T);
+            return true;
+        }
+
+        bool readString(size_t length, std::string &text) {
+            if (m_size - m_offset < length) {
+                return false;
+            }
+            text.assign(reinterpret_cast<const char *>(m_data + m_offset), length);
+            m_offset += length;
+            return true;
+        }
+
+    private:
+        const std::byte *m_data;
+        size_t m_size;
+        size_t m_offset = 0;
+    };
+
+    std::string_view levelName(uint8_t level) {
+        if (level > static_cast<uint8_t>(spdlog::level::off)) {
+            return "?";
+        }
+        const auto name = spdlog::level::to_string_view(static_cast<spdlog::level::level_enum>(level));
+        return std::string_view(name.data(), name.size());
+    }
+
+    std::string_view categoryName(uint8_t category) {
+        return category < Engine::LOG_CATEGORY_COUNT ? Engine::LOG_CATEGORY_NAMES[category] : "?";
+    }
+
+    bool pushArgument(Reader &reader, ArgumentType type, fmt::dynamic_format_arg_store<fmt::format_context> &store) {
+        switch (type) {
+            case ArgumentType::Float: {
+                float value = 0.0f;
+                if (!reader.read(value)) {
+                    return false;
+                }
+                store.push_back(value);
+                return true;
+            }
+            case ArgumentType::String: {
+                uint32_t length = 0;
+                std::string text;
+                if (!reader.read(length) || !reader.readString(length, text)) {
+                    return false;
+                }
+                store.push_back(std::move(text));
+                return true;
+            }
+            default: {
+                uint64_t bits = 0;
+                if (!reader.read(bits)) {
+                    return false;
+                }
+
+                if (type == ArgumentType::Bool) {
+                    store.push_back(bits != 0);
+                } else if (type == ArgumentType::Char) {
+                    store.push_back(static_cast<char>(bits));
+                } else if (type == ArgumentType::Int) {
+                    int64_t value = 0;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    store.push_back(value);
+                } else if (type == ArgumentType::Double) {
+                    double value = 0.0;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    store.push_back(value);
+                } else if (type == ArgumentType::Pointer) {
+                    store.push_back(reinterpret_cast<const void *>(static_cast<uintptr_t>(bits)));
+                } else {
+                    store.push_back(bits);
+                }
+                return true;
+            }
+        }
+    }
+
+    std::optional<std::vector<std::byte>> readFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> bytes(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return bytes;
+    }
+
+    /** Prints every committed message of one segment, returns false when it is not a binary log. */
+    bool decodeSegment(const std::filesystem::path &path, bool listSites) {
+        const std::optional<std::vector<std::byte>> bytes = readFile(path);
+        if (!bytes) {
+            std::cerr << "Cannot read " << path.string() << '\n';
+            return false;
+        }
+
+        SegmentHeader header{};
+        if (bytes->size() < sizeof(header)) {
+            std::cerr << path.string() << " is not a binary log\n";
+            return false;
+        }
+        std::memcpy(&header, bytes->data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+            std::cerr << path.string() << " is not a binary log of version " << VERSION << '\n';
+            return false;
+        }
+
+        std::unordered_map<uint32_t, Site> sites;
+        size_t offset = header.headerBytes;
+        uint64_t uncommitted = 0;
+
+        while (offset + sizeof(RecordHeader) <= bytes->size()) {
+            RecordHeader record{};
+            std::memcpy(&record, bytes->data() + offset, sizeof(record));
+
+            /** Zero marks the end of what was written. */
+            if (record.size < sizeof(RecordHeader) || offset + record.size > bytes->size()) {
+                break;
+            }
+
+            Reader reader(bytes->data() + offset + sizeof(RecordHeader), record.size - sizeof(RecordHeader));
+            offset += record.size;
+
+            /** Its writer was still busy or died, the records after it are intact. */
+            if (record.kind == RecordKind::Uncommitted) {
+                ++uncommitted;
+                continue;
+            }
+
+            if (record.kind == RecordKind::Definition) {
+                DefinitionBody body{};
+                Site site;
+                if (!reader.read(body)) {
+                    continue;
+                }
+
+                site.level = record.level;
+                site.category = record.category;
+                site.line = body.line;
+                site.arguments.resize(body.argumentCount);
+                for (ArgumentType &type : site.arguments) {
+                    reader.read(type);
+                }
+                reader.readString(body.fileBytes, site.file);
+                reader.readString(body.formatBytes, site.format);
+
+                if (listSites) {
+                    fmt::print("site {} [{}] [{}] {}:{} \"{}\"\n", body.siteId, levelName(site.level), categoryName(site.category),
+                               site.file, site.line, site.format);
+                }
+                sites[body.siteId] = std::move(site);
+                continue;
+            }
+
+            if (record.kind != RecordKind::Message || listSites) {
+                continue;
+            }
+
+            MessageBody body{};
+            if (!reader.read(body)) {
+                continue;
+            }
+
+            const auto time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(body.time / 1000000000)));
+            const uint64_t microseconds = body.time % 1000000000 / 1000;
+            const auto found = sites.find(body.siteId);
+            if (found == sites.end()) {
+                fmt::print("[{:%Y-%m-%d %H:%M:%S}.{:06}] [{}] [{}] [thread {}] <unknown site {}>\n", time, microseconds, levelName(record.level),
+                           categoryName(record.category), body.threadIndex, body.siteId);
+                continue;
+            }
+
+            const Site &site = found->second;
+            fmt::dynamic_format_arg_store<fmt::format_context> store;
+            bool complete = true;
+            for (ArgumentType type : site.arguments) {
+                complete = complete && pushArgument(reader, type, store);
+            }
+
+            std::string text;
+            if (!complete) {
+                text = "<truncated> " + site.format;
+            } else {
+                try {
+                    text = fmt::vformat(site.format, store);
+                } catch (const fmt::format_error &error) {
+                    text = fmt::format("<format error: {}> {}", error.what(), site.format);
+                }
+            }
+
+            fmt::print("[{:%Y-%m-%d %H:%M:%S}.{:06}] [{}] [{}] [thread {}] {}\n", time, microseconds, levelName(record.level), categoryName(record.category),
+                       body.threadIndex, text);
+        }
+
+        if (uncommitted != 0) {
+            std::cerr << path.string() << ": skipped " << uncommitted << " uncommitted records\n";
+        }
+        return true;
+    }
+}
+
+int main(int argc, char **argv) {
+    bool listSites = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--sites") {
+            listSites = true;
+        } else {
+            inputs.emplace_back(argument);
+        }
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Usage: LogDecoder [--sites] <segment file or ENGINE_LOG_BINARY path>...\n";
+        return EXIT_FAILURE;
+    }
+
+    bool success = true;
+    for (const std::string &input : inputs) {
+        if (std::filesystem::exists(input)) {
+            success = decodeSegment(input, listSites) && success;
+            continue;
+        }
+
+        /** A base path decodes every segment still on disk, oldest first. */
+        std::vector<std::pair<uint64_t, std::filesystem::path>> segments;
+        const std::filesystem::path base(input);
+        const std::filesystem::path directory = base.has_parent_path() ? base.parent_path() : std::filesystem::path(".");
+        const std::string prefix = base.filename().string() + ".";
+
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) {
+                continue;
+            }
+
+            char *end = nullptr;
+            const uint64_t index = std::strtoull(name.c_str() + prefix.size(), &end, 10);
+            if (*end == '\0') {
+                segments.emplace_back(index, entry.path());
+            }
+        }
+
+        if (segments.empty()) {
+            std::cerr << "No binary log segments found for " << input << '\n';
+            success = false;
+            continue;
+        }
+
+        std::sort(segments.begin(), segments.end());
+        for (const auto &[index, path] : segments) {
+            success = decodeSegment(path, listSites) && success;
+        }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,252 @@
+#include "../../../engine/include/Networking/Snapshot.hpp"
+#include "../../../engine/include/Networking/Transport.hpp"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using namespace Engine;
+
+    constexpr double TICK_SECONDS = 1.0 / 30.0;
+    /** Ticks after the last message, for resends to land before delivery is checked. */
+    constexpr uint32_t DRAIN_TICKS = 150;
+
+    struct Options {
+        uint32_t clients = 16;
+        uint32_t entities = 100;
+        double seconds = 20.0;
+        /** Starts from ENGINE_NET_SIMULATE, the flags override single fields. */
+        PacketSimulatorConfig simulator = PacketSimulatorConfig::fromEnvironment();
+    };
+
+    struct Client {
+        std::unique_ptr<NetTransport> transport;
+        ConnectionId connection = INVALID_CONNECTION;
+        SnapshotDecoder decoder;
+        uint32_t reliableSent = 0;
+        uint64_t snapshotsDecoded = 0;
+    };
+
+    /** Server side of one client. */
+    struct Peer {
+        SnapshotEncoder encoder;
+        uint32_t nextReliable = 0;
+    };
+
+    bool parsePercent(const char *p_text, double &p_value) {
+        char *end = nullptr;
+        const double value = std::strtod(p_text, &end);
+        p_value = value / 100.0;
+        return end != p_text && value >= 0.0 && value <= 100.0;
+    }
+
+    bool parseMilliseconds(const char *p_text, double &p_value) {
+        char *end = nullptr;
+        const double value = std::strtod(p_text, &end);
+        p_value = value / 1000.0;
+        return end != p_text && value >= 0.0;
+    }
+
+    /** A fifth of the entities move every tick, the rest stay as in the baseline. */
+    void simulateWorld(std::vector<SnapshotEntity> &p_world, std::mt19937 &p_random) {
+        for (SnapshotEntity &entity : p_world) {
+            if (p_random() % 5 == 0) {
+                entity.words[0] += p_random() % 32 - 16;
+                entity.words[1] += p_random() % 8;
+                entity.words[2] -= 3;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        bool valid = i + 1 < argc;
+        if (valid && argument == "--clients") {
+            options.clients = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (valid && argument == "--entities") {
+            options.entities = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (valid && argument == "--seconds") {
+            options.seconds = std::strtod(argv[++i], nullptr);
+        } else if (valid && argument == "--loss") {
+            valid = parsePercent(argv[++i], options.simulator.loss);
+        } else if (valid && argument == "--duplicate") {
+            valid = parsePercent(argv[++i], options.simulator.duplicate);
+        } else if (valid && argument == "--latency") {
+            valid = parseMilliseconds(argv[++i], options.simulator.latencySeconds);
+        } else if (valid && argument == "--jitter") {
+            valid = parseMilliseconds(argv[++i], options.simulator.jitterSeconds);
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Usage: NetBench [--clients <count>] [--entities <count>] [--seconds <duration>]\n"
+                         "                [--loss <%>] [--duplicate <%>] [--latency <ms>] [--jitter <ms>]\n"
+                         "The link defaults to ENGINE_NET_SIMULATE, the flags override it.\n";
+            return EXIT_FAILURE;
+        }
+    }
+    options.clients = std::clamp(options.clients, 1u, 1000u);
+    options.entities = std::max(options.entities, 1u);
+    options.seconds = std::max(options.seconds, 1.0);
+
+    NetTransportConfig serverConfig;
+    serverConfig.simulator = options.simulator;
+    serverConfig.maxConnections = options.clients;
+    NetTransport server(serverConfig);
+    if (!server.listen(NetAddress::loopback(0))) {
+        std::cerr << "Cannot listen on loopback\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Client> clients(options.clients);
+    for (uint32_t i = 0; i < options.clients; ++i) {
+        NetTransportConfig clientConfig = serverConfig;
+        clientConfig.simulatorSeed = i + 2;
+        clients[i].transport = std::make_unique<NetTransport>(clientConfig);
+        clients[i].connection = clients[i].transport->connect(server.localAddress(), NetAddress::loopback(0));
+    }
+
+    std::vector<SnapshotEntity> world(options.entities);
+    for (uint32_t i = 0; i < options.entities; ++i) {
+        world[i].id = i * 3;
+    }
+
+    std::unordered_map<ConnectionId, Peer> peers;
+    std::mt19937 random(3);
+    uint8_t buffer[NetTransport::MAX_MESSAGE_SIZE];
+    uint64_t outOfOrder = 0;
+    uint64_t reliableReceived = 0;
+    uint64_t encodeFailures = 0;
+
+    const uint32_t ticks = static_cast<uint32_t>(options.seconds / TICK_SECONDS);
+    double time = 0.0;
+    for (uint32_t tick = 0; tick < ticks + DRAIN_TICKS; ++tick) {
+        time += TICK_SECONDS;
+        const bool sending = tick < ticks;
+        simulateWorld(world, random);
+
+        server.receive(time);
+        for (const NetEvent &event : server.events()) {
+            if (event.type == NetEventType::Connected) {
+                peers.try_emplace(event.connection);
+            } else if (event.type == NetEventType::Disconnected) {
+                peers.erase(event.connection);
+            } else if (event.channel == NetChannel::Reliable) {
+                uint32_t value = 0;
+                std::memcpy(&value, event.payload.data(), sizeof(value));
+                outOfOrder += value != peers[event.connection].nextReliable++;
+                ++reliableReceived;
+            } else {
+                ByteReader reader(event.payload);
+                peers[event.connection].encoder.acknowledge(reader.readVarU32());
+            }
+        }
+
+        for (auto &[connection, peer] : peers) {
+            if (!sending || !server.isConnected(connection)) {
+                continue;
+            }
+            ByteWriter writer(buffer, sizeof(buffer));
+            if (!peer.encoder.encode(world, writer)) {
+                ++encodeFailures;
+                continue;
+            }
+            server.send(connection, NetChannel::Unreliable, { buffer, writer.size() });
+        }
+        server.flush(time);
+
+        for (Client &client : clients) {
+            NetTransport &transport = *client.transport;
+            transport.receive(time);
+            for (const NetEvent &event : transport.events()) {
+                if (event.type == NetEventType::Message && event.channel == NetChannel::Unreliable) {
+                    ByteReader reader(event.payload);
+                    client.snapshotsDecoded += client.decoder.decode(reader) != nullptr;
+                }
+            }
+
+            if (transport.isConnected(client.connection)) {
+                /** Input every tick carries the snapshot acknowledgement, an edit every few ticks goes reliable. */
+                ByteWriter writer(buffer, sizeof(buffer));
+                writer.writeVarU32(client.decoder.latestId());
+                writer.writeU32(tick);
+                transport.send(client.connection, NetChannel::Unreliable, { buffer, writer.size() });
+
+                if (sending && random() % 3 == 0) {
+                    const uint32_t value = client.reliableSent++;
+                    transport.send(client.connection, NetChannel::Reliable, { reinterpret_cast<const uint8_t *>(&value), sizeof(value) });
+                }
+            }
+            transport.flush(time);
+        }
+    }
+
+    /** Packets lost both ways; only the clients send reliable messages, so only they resend. */
+    uint64_t packetsLost = 0;
+    uint64_t messagesResent = 0;
+    uint64_t reliableSent = 0;
+    uint64_t snapshotsDecoded = 0;
+    uint32_t connected = 0;
+    NetTransportStatistics clientTotals;
+    for (Client &client : clients) {
+        reliableSent += client.reliableSent;
+        snapshotsDecoded += client.snapshotsDecoded;
+        connected += client.transport->isConnected(client.connection);
+        const NetTransportStatistics statistics = client.transport->statistics();
+        clientTotals.packetsSent += statistics.packetsSent;
+        clientTotals.packetsReceived += statistics.packetsReceived;
+        clientTotals.bytesSent += statistics.bytesSent;
+        clientTotals.cpuSeconds += statistics.cpuSeconds;
+        if (const NetConnectionStatistics *connection = client.transport->connectionStatistics(client.connection)) {
+            packetsLost += connection->packetsLost;
+            messagesResent += connection->messagesResent;
+        }
+    }
+
+    double rtt = 0.0;
+    for (const auto &[connection, peer] : peers) {
+        if (const NetConnectionStatistics *statistics = server.connectionStatistics(connection)) {
+            rtt += statistics->rttSeconds;
+            packetsLost += statistics->packetsLost;
+        }
+    }
+
+    const NetTransportStatistics serverTotals = server.statistics();
+    const double seconds = (ticks + DRAIN_TICKS) * TICK_SECONDS;
+    const double players = static_cast<double>(options.clients);
+    const PacketSimulatorConfig &link = options.simulator;
+
+    fmt::print("{} clients, {} entities, {:.0f} s at 30 Hz + {:.0f} s drain\n", options.clients, options.entities,
+               ticks * TICK_SECONDS, DRAIN_TICKS * TICK_SECONDS);
+    fmt::print("link: loss {:.1f}%, duplicate {:.1f}%, latency {:.0f} ms, jitter {:.0f} ms\n", link.loss * 100.0,
+               link.duplicate * 100.0, link.latencySeconds * 1000.0, link.jitterSeconds * 1000.0);
+    fmt::print("connected {}/{}, mean rtt {:.1f} ms, {} packets lost, {} messages resent\n", connected, options.clients,
+               peers.empty() ? 0.0 : rtt / static_cast<double>(peers.size()) * 1000.0, packetsLost, messagesResent);
+    fmt::print("per player: down {:.1f} kbit/s, up {:.1f} kbit/s\n", serverTotals.bytesSent * 8.0 / 1000.0 / seconds / players,
+               clientTotals.bytesSent * 8.0 / 1000.0 / seconds / players);
+    fmt::print("cpu per packet: server {:.2f} us ({} syscalls for {} packets), client {:.2f} us\n",
+               serverTotals.cpuSecondsPerPacket() * 1e6, serverTotals.syscalls, serverTotals.packetsSent + serverTotals.packetsReceived,
+               clientTotals.cpuSecondsPerPacket() * 1e6);
+    fmt::print("snapshots decoded {}, reliable delivered {}/{}, out of order {}, encode failures {}\n", snapshotsDecoded,
+               reliableReceived, reliableSent, outOfOrder, encodeFailures);
+
+    const bool success = connected == options.clients && reliableReceived == reliableSent && outOfOrder == 0 &&
+                         encodeFailures == 0 && snapshotsDecoded > 0;
+    if (!success) {
+        std::cerr << "Connections, reliable delivery or snapshots failed\n";
+    }
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}